@@ -0,0 +1,65 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DATAIDX_H
+# define DATAIDX_H
+
+# include "global.h"
+
+/*
+ * The index at the start of the 'data' file, which makedefs compiles from
+ * data.base, and which checkfile() in pager.c uses to find encyclopedia
+ * entries.  After the "do not edit" comment line and the (hexadecimal) offset
+ * to the text area, the file contains:
+ *
+ *   ngroups nkeys nslots nbuckets nwild     the sizes of the sections below
+ *   offset,count                            one line per group of keys that
+ *                                           share a description: where its
+ *                                           text is relative to the text area,
+ *                                           and how many lines it is
+ *   group neg next key                      one line per key, in the order they
+ *                                           appear in data.base; neg is 1 for a
+ *                                           key that started with '~' (which
+ *                                           isn't included in key), and next is
+ *                                           the number of the next key with the
+ *                                           same text, or -1
+ *   seed                                    one line per hash bucket
+ *   key                                     one line per hash slot: the number
+ *                                           of the first key with text that
+ *                                           hashes there, or -1
+ *   key                                     one line per key that contains
+ *                                           wildcards, in order
+ *
+ * The keys without wildcards are placed in a perfect hash table: a key with
+ * text t can only be in slot
+ *   data_key_hash(t, seed[data_key_hash(t, 0) % nbuckets]) % nslots
+ * and no two different texts share a slot.  Keys with wildcards are listed
+ * separately; pager.c buckets them by their literal prefix or suffix when it
+ * loads the index, so that a lookup only has to match a few of them.
+ */
+
+struct data_key {
+    int group;          /* which group of keys this is part of */
+    boolean neg;        /* a match means this group doesn't apply */
+    int next;           /* next key with the same text, or -1 */
+    char *text;
+};
+
+static inline unsigned int
+data_key_hash(const char *text, unsigned int seed)
+{
+    unsigned int h = 2166136261u ^ (seed * 0x9E3779B1u);
+
+    while (*text) {
+        h ^= (unsigned char)*text++;
+        h *= 16777619u;
+    }
+
+    /* spread the bits out, so that nearby seeds give unrelated results */
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    return h;
+}
+
+#endif /* DATAIDX_H */
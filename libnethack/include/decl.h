@@ -317,6 +317,14 @@ enum target_location_units {
     TLU_EOF
 };
 
+/* How thoroughly log_neutral_turnstate() checks the save diffs it writes;
+   set via the NH4SAVEVERIFY environment variable. */
+enum save_verification {
+    SV_FULL,            /* check the diff, then reload the game from it */
+    SV_PERIODIC,        /* as SV_FULL every few turns, SV_CRC otherwise */
+    SV_CRC,             /* only check the diff against its checksum */
+};
+
 extern struct sinfo {
     int game_running;   /* ok to call nh_do_move */
     int gameover;       /* self explanatory? */
@@ -358,8 +366,6 @@ extern struct sinfo {
      *   the one that gamestate_location point to.
      */
     volatile int logfile;                             /* file descriptor */
-    void *logfile_watchers;                /* on UNIX, an array of pid_t */
-    int logfile_watcher_count;
     struct memfile binary_save;
     boolean binary_save_allocated;
     int expected_recovery_count;
@@ -371,6 +377,10 @@ extern struct sinfo {
     long emergency_recover_location;         /* bytes from start of file */
     boolean input_was_just_replayed;
     boolean ok_to_diff;
+
+    enum save_verification save_verification;
+    int save_verification_interval;   /* turns between checks, SV_PERIODIC */
+    long last_save_verification;      /* value of moves at last full check */
 } program_state;
 
 #define panic(...) panic_core(__FILE__, __LINE__, __VA_ARGS__)
@@ -20,8 +20,12 @@ typedef struct dlb_directory {
 /* information about each open library */
 typedef struct dlb_library {
     FILE *fdata;        /* opened data file */
-    long fmark; /* current file mark */
+    const char *data;   /* contents of the data file, in memory */
+    long datasize;      /* size of data */
+    boolean mapped;     /* data is mmap()ed, rather than malloc()ed */
     libdir *dir;        /* directory of library file */
+    int *dirindex;      /* hash table of (dir entry number + 1), 0 = unused */
+    long dirindexsize;  /* size of dirindex; a power of 2 */
     char *sspace;       /* pointer to string space */
     long nentries;      /* # of files in directory */
     long rev;   /* dlb file revision */
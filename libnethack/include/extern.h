@@ -27,6 +27,7 @@ struct attack;
 struct damage;
 struct def_skill;
 struct distmap_state;
+struct dlb_handle;
 struct d_level;
 struct engr;
 struct flag;
@@ -606,7 +607,6 @@ extern int delete_bonesfile(char *bonesid);
 extern void paniclog(const char *, const char *);
 extern boolean change_fd_lock(int fd, boolean on_logfile,
                               enum locktype type, int timeout);
-extern void flush_logfile_watchers(void);
 
 /* ### fountain.c ### */
 
@@ -634,8 +634,10 @@ extern boolean travelling(void);
 extern void init_test_move_cache(struct test_move_cache *);
 extern boolean test_move(int, int, int, int, int, int,
                          const struct test_move_cache *);
-extern void distmap_init(struct distmap_state *, int, int, struct monst *mtmp);
+extern void mark_terrain_changed(void);
+extern struct distmap_state *distmap_init(int, int, struct monst *mtmp);
 extern int distmap(struct distmap_state *, int, int);
+extern void travel_step(boolean, boolean, schar *, schar *);
 extern int domove(const struct nh_cmd_arg *, enum u_interaction_mode,
                   enum occupation);
 extern void invocation_message(void);
@@ -753,6 +755,9 @@ extern void del_light_source(struct level *lev, int type, void *id);
 extern void do_light_sources(char **);
 extern struct monst *find_mid(struct level *lev, unsigned nid,
                               unsigned fmflags);
+extern void index_mid(struct monst *mtmp);
+extern void unindex_mid(struct monst *mtmp);
+extern void clear_mid_index(void);
 extern void transfer_lights(struct level *oldlev, struct level *newlev,
                             unsigned int obj_id);
 extern void save_light_sources(struct memfile *mf, struct level *lev,
@@ -778,6 +783,7 @@ extern int phase_of_the_moon(void);
 extern boolean friday_13th(void);
 extern boolean night(void);
 extern boolean midnight(void);
+extern void freeze_utc_time(microseconds);
 extern microseconds utc_time(void);
 extern microseconds time_for_time_line(void);
 
@@ -819,6 +825,13 @@ extern noreturn void log_replay_no_more_options(void);
 extern boolean log_want_replay(char firstchar);
 
 extern void log_time_line(void);
+extern void discard_log_read_buffer(int fd);
+extern void log_forget_save_line_index(void);
+extern boolean log_save_line_indexed(long offset, long *moves, long *next);
+extern int base64size(int n);
+extern int select_base64_kernels(int maxlevel);
+extern int base64_encode_binary(const unsigned char *in, char *out, int len);
+extern void base64_decode(const char *in, char *out, int outlen);
 
 extern void log_init(int fd);
 extern void log_uninit(void);
@@ -832,6 +845,7 @@ extern void checkformail(void);
 /* ### makemon.c ### */
 
 extern struct monst *newmonst(int extyp, int namelen);
+extern void dealloc_monst(struct monst *mon);
 extern boolean is_home_elemental(const struct d_level *dlev,
                                  const struct permonst *);
 extern struct monst *clone_mon(struct monst *, xchar, xchar);
@@ -871,7 +885,9 @@ extern int castum(struct monst *, const struct attack *);
 extern void mnew(struct memfile *mf, struct memfile *relativeto);
 extern void mclone(struct memfile *to, const struct memfile *from);
 extern void mfree(struct memfile *mf);
+extern void mtrim(struct memfile *mf);
 extern void *mmmap(struct memfile *mf, long len, long off);
+extern int select_mdiff_kernel(int maxlevel);
 extern void mwrite(struct memfile *mf, const void *buf, unsigned int num);
 extern void mwrite8(struct memfile *mf, int8_t value);
 extern void mwrite16(struct memfile *mf, int16_t value);
@@ -880,11 +896,17 @@ extern void mwrite64(struct memfile *mf, int64_t value);
 extern void store_mf(int fd, struct memfile *mf);
 extern void mtag(struct memfile *mf, long tagdata,
                  enum memfile_tagtype tagtype);
+extern long mtag_memory_usage(const struct memfile *mf);
 extern void mhint_mon_coordinates(struct memfile *mf);
 extern void mdiffflush(struct memfile *mf, boolean eof);
 extern void mdiffapply(char *diff, long difflen, struct memfile *diff_base,
                        struct memfile *new_memfile,
                        void (*errfunction)(const char *, char *));
+extern void msection_save(struct memfile_section *ms, struct memfile *mf,
+                          int start);
+extern void msection_write(struct memfile *mf,
+                           const struct memfile_section *ms);
+extern void msection_free(struct memfile_section *ms);
 
 extern void mread(struct memfile *mf, void *, unsigned int);
 extern int8_t mread8(struct memfile *mf);
@@ -1298,6 +1320,8 @@ extern int doquickwhatis(const struct nh_cmd_arg *);
 extern int doidtrap(const struct nh_cmd_arg *);
 extern int dolicense(const struct nh_cmd_arg *);
 extern int doverhistory(const struct nh_cmd_arg *);
+extern int find_data_entry(struct dlb_handle *fp, const char *str,
+                           const char *alt, long *pos);
 
 /* ### pickup.c ### */
 
@@ -1524,6 +1548,10 @@ extern void savelev(struct memfile *mf, xchar levnum);
 extern void freelev(xchar levnum);
 extern void savefruitchn(struct memfile *mf);
 extern void freedynamicdata(void);
+extern void mark_level_dirty(struct level *lev);
+extern void level_save_cache_restored(xchar levnum, struct memfile *mf,
+                                      int start);
+extern void free_level_save_cache(void);
 extern int8_t save_encode_8(int8_t, int, int);
 extern int16_t save_encode_16(int16_t, int, int);
 extern int32_t save_encode_32(int32_t, int, int);
@@ -1559,6 +1587,9 @@ extern int dopay(const struct nh_cmd_arg *);
 extern boolean paybill(int);
 extern void finish_paybill(void);
 extern struct obj *find_oid(unsigned id);
+extern void index_oid(struct obj *obj);
+extern void unindex_oid(struct obj *obj);
+extern void clear_oid_index(void);
 extern int shop_item_cost(const struct obj *obj);
 extern long contained_cost(const struct obj *, struct monst *, long, boolean,
                            boolean);
@@ -1835,7 +1866,9 @@ extern void vision_reset(void);
 extern void vision_recalc(int);
 extern void block_point(int, int);
 extern void unblock_point(int, int);
+extern unsigned long vision_clear_epoch(void);
 extern boolean clear_path(int, int, int, int, char **);
+extern boolean clear_path_uncached(int, int, int, int);
 extern void do_clear_area(int, int, int, void (*)(int, int, void *), void *);
 
 /* ### weapon.c ### */
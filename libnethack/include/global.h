@@ -17,6 +17,7 @@
  */
 
 # define RECORD        "record" /* file containing list of topscorers */
+# define RECORD_INDEX  "record.idx"     /* binary index of RECORD */
 # define LOGFILE       "logfile"/* records all game endings regardless of score
                                    for debugging purposes */
 # define XLOGFILE      "xlogfile"       /* records game endings in detail */
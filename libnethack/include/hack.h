@@ -122,8 +122,9 @@ extern coord bhitpos;   /* place where throw or zap hits or stops */
 
 # define NO_SPELL         0
 
-/* internal state of distmap; caller allocates so that it can be reused by
-   multiple distmap calls */
+/* internal state of distmap; these live in a cache in hack.c, so that
+   monsters that would see the same passability can share a BFS towards the
+   same square */
 struct distmap_state {
     int onmap[COLNO][ROWNO];
     xchar travelstepx[2][COLNO * ROWNO];
@@ -132,6 +133,12 @@ struct distmap_state {
     int tslen;
     struct monst *mon;
     int mmflags;
+
+    /* the cache key; lev is NULL if the state can't be shared */
+    struct level *lev;
+    int startx, starty;
+    int signature;
+    unsigned long last_used;
 };
 
 /* flags to control makemon() and/or goodpos() */
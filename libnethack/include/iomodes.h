@@ -36,7 +36,7 @@ enum locktype
 {
     LT_NONE,    /* do not lock at all */
     LT_MONITOR, /* for use only on program_state.logfile; do a server cancel
-                   whenever the file is write-locked by another process */
+                   whenever another process finishes writing to the file */
     LT_READ,    /* do not allow other processes to write to this file */
     LT_WRITE,   /* do not allow other processes to read or write to this file */
 };
@@ -32,6 +32,8 @@ struct bubble {
 };
 
 /* used in light.c */
+# define LS_FOOTPRINT_SIZE (2 * MAX_RADIUS + 1)
+
 typedef struct ls_t {
     struct ls_t *next;
     xchar x, y; /* source's position */
@@ -39,6 +41,14 @@ typedef struct ls_t {
     short flags;
     short type; /* type of light source */
     void *id;   /* source's identifier */
+
+    /* The squares the source lit when it was last at (lit_x, lit_y) with
+       range lit_range, as a bitmap centred on the source; valid while
+       vision_clear_epoch() still returns lit_epoch. Not saved. */
+    unsigned long lit_epoch;
+    xchar lit_x, lit_y;
+    short lit_range;
+    unsigned char lit[(LS_FOOTPRINT_SIZE * LS_FOOTPRINT_SIZE + 7) / 8];
 } light_source;
 
 extern int n_dgns;
@@ -6,7 +6,7 @@
 #ifndef MEMFILE_H
 # define MEMFILE_H
 
-# define MEMFILE_HASHTABLE_SIZE 1009
+# define MEMFILE_TAGS_INITIAL_SIZE 1024 /* must be a power of 2 */
 
 /* SAVEBREAK (4.3-beta1 -> 4.3-beta2): these constants are only needed to parse
    the old -beta1 diff format. */
@@ -130,7 +130,6 @@ enum memfile_tagtype {
     MTAG_SPELLBOOK,
 };
 struct memfile_tag {
-    struct memfile_tag *next;
     long tagdata;
     enum memfile_tagtype tagtype;
     int pos;
@@ -184,14 +183,35 @@ struct memfile {
        coordinate is in the byte afterwards). */
     int mon_coord_hint;
 
-    /* Tags to help in diffing. This is a hashtable for efficiency, using
-       chaining in the case of collisions. */
-    struct memfile_tag *tags[MEMFILE_HASHTABLE_SIZE];
+    /* Tags to help in diffing. These are stored in an array in the order they
+       were placed (and thus in order of position), which is grown as needed.
+       To find them efficiently, tagindex is an open-addressing hashtable with
+       tagindexsize (a power of 2) entries, each of which is 0 for an empty
+       slot, or 1 + the index in tags of the most recent tag with a particular
+       tagdata and tagtype. */
+    struct memfile_tag *tags;
+    int tagcount;
+    int tagsize;
+    int *tagindex;
+    int tagindexsize;
+
+    /* Where we are "semantically", for debug purposes, as an index into tags,
+       or -1. (It's possible this could someday be used to construct better
+       error messages, too, but so far it isn't.) */
+    int last_tag;
+};
 
-    /* Where we are "semantically", for debug purposes. (It's possible this
-       could someday be used to construct better error messages, too, but so
-       far it isn't.) */
-    struct memfile_tag *last_tag;
+/* A copy of part of a memfile, together with the tags that were placed within
+   it (in the order they were placed, with pos relative to the start of the
+   section). This allows data that is known not to have changed to be written
+   to a new memfile without needing to regenerate it. */
+struct memfile_section {
+    char *buf;
+    int len;
+    int bufsize;
+    struct memfile_tag *tags;
+    int tagcount;
+    int tagsize;
 };
 
 #endif
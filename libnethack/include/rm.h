@@ -476,7 +476,7 @@ struct level {
     struct damage *damagelist;
     struct levelflags flags;
 
-    timer_element *lev_timers;
+    struct timer_queue lev_timers;
     struct ls_t *lev_lights;
     struct trap *lev_traps;
     struct engr *lev_engr;
@@ -501,6 +501,10 @@ struct level {
     int n_regions;
     int max_regions;
 
+    /* TRUE if the save data for this level, as cached by savegame(), is known
+       to be up to date; see mark_level_dirty() */
+    boolean save_cached;
+
     d_level z;
 };
 
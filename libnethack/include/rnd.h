@@ -146,6 +146,10 @@ static_assert((first_level_rng + NUMBER_OF_LEVEL_RNGS) *
 extern int rn2_on_rng(int, enum rng);
 extern int rnl(int);
 extern int rn2_on_display_rng(int);
+extern long rng_benchmark(long *);
+extern int rn2_on_seed_uncached(
+    int, unsigned char [static RNG_SEED_SIZE_BYTES]);
+extern int select_sha256_kernel(int);
 
 extern void seed_rng_from_entropy(void);
 extern boolean seed_rng_from_base64(const char [static RNG_SEED_SIZE_BASE64]);
@@ -34,14 +34,28 @@ typedef void (*timeout_proc) (void *, long);
 
 /* used in timeout.c */
 typedef struct timer_element {
-    struct timer_element *next; /* next item in chain */
+    struct timer_element *next; /* next item in the same index chain */
     void *arg;  /* pointer to timeout argument */
     unsigned int timeout;       /* when we time out */
     unsigned int tid;   /* timer ID */
+    unsigned int seq;   /* insertion order, for breaking ties */
+    int heappos;        /* where we are in the heap */
     short kind; /* kind of use */
     uchar func_index;   /* what to call when we time out */
     unsigned needs_fixup:1;     /* does arg need to be patched? */
 } timer_element;
 
+/* A level's timers: a binary heap, ordered "sooner" to "later" (among timers
+   with the same timeout, the one inserted most recently comes first), and a
+   hash table of chains of timers with the same (func_index, arg) hash. */
+struct timer_queue {
+    timer_element **heap;
+    timer_element **index;
+    int count;          /* number of timers */
+    int heapsize;       /* allocated length of heap */
+    int indexsize;      /* length of index; 0 or a power of 2 */
+    unsigned int seq;   /* seq of the next timer inserted */
+};
+
 #endif /* TIMEOUT_H */
 
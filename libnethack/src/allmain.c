@@ -50,12 +50,10 @@ nh_lib_init(const struct nh_window_procs *procs, const char *const *paths)
     u.uhp = 1;  /* prevent RIP on early quits */
 
 #ifdef AIMAKE_BUILDOS_linux
-    /* SIGRTMIN+{1,2} are used by the lock monitoring code. This means that we
-       could end up with spurious signals due to race conditions after a game
-       exits or when reading save files in the main menu of the client. In such
-       cases, we just ignore the signals; we're not doing any lock monitoring
-       anyway, so this is safe unless the process is stuck (in which case,
-       things are broken anyway). */
+    /* SIGRTMIN+1 is used by the lock monitoring code (and SIGRTMIN+2 was used
+       by older versions of it). This means that we could end up with spurious
+       signals due to race conditions after a game exits. In such cases, we
+       just ignore the signals; we're not doing any lock monitoring anyway. */
     signal(SIGRTMIN+1, SIG_IGN);
     signal(SIGRTMIN+2, SIG_IGN);
 #endif
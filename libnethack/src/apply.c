@@ -290,6 +290,7 @@ use_stethoscope(struct obj *obj, const struct nh_cmd_arg *arg)
     case SCORR:
         You_hear(msgc_youdiscover, hollow_str, "passage");
         loc->typ = CORR;
+        mark_terrain_changed();
         unblock_point(rx, ry);
         if (Blind)
             feel_location(rx, ry);
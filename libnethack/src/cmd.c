@@ -47,6 +47,7 @@ static int wiz_mon_polycontrol(const struct nh_cmd_arg *);
 static int wiz_togglegen(const struct nh_cmd_arg *);
 static int wiz_show_wmodes(const struct nh_cmd_arg *);
 static int wiz_show_stats(const struct nh_cmd_arg *);
+static int wiz_rng_benchmark(const struct nh_cmd_arg *);
 static void count_obj(struct obj *, long *, long *, boolean, boolean);
 static void obj_chain(struct nh_menulist *, const char *, struct obj *, long *,
                       long *);
@@ -267,6 +268,8 @@ const struct cmd_desc cmdlist[] = {
      CMD_DEBUG | CMD_NOTIME | CMD_EXT},
     {"rewind", "(DEBUG) permanently undo gamestate changes", 0, 0, TRUE,
      wiz_rewind, CMD_DEBUG | CMD_NOTIME | CMD_EXT},
+    {"rngbench", "(DEBUG) measure the speed of the RNG", 0, 0, TRUE,
+     wiz_rng_benchmark, CMD_DEBUG | CMD_NOTIME | CMD_EXT},
     {"seenv", "(DEBUG) show seen vectors", 0, 0, TRUE, wiz_show_seenv,
      CMD_DEBUG | CMD_EXT | CMD_NOTIME},
     {"showmap", "(DEBUG) reveal the entire map", 0, 0, TRUE, wiz_map,
@@ -594,6 +597,20 @@ wiz_rewind(const struct nh_cmd_arg *arg)
                          "Manual rewind requested", __FILE__, __LINE__);
 }
 
+/* #rngbench command - measure the speed of the random number generator */
+static int
+wiz_rng_benchmark(const struct nh_cmd_arg *arg)
+{
+    long unbuffered, rate;
+
+    (void) arg;
+
+    rate = rng_benchmark(&unbuffered);
+    pline(msgc_debug, "The RNG produces %ld numbers per second "
+          "(%ld without look-ahead).", rate, unbuffered);
+    return 0;
+}
+
 /* #polyself command - change hero's form */
 static int
 wiz_polyself(const struct nh_cmd_arg *arg)
@@ -1457,6 +1474,21 @@ wiz_show_stats(const struct nh_cmd_arg *arg)
     buf = msgprintf(template, "Total", total_mon_count, total_mon_size);
     add_menutext(&menu, buf);
 
+    if (program_state.binary_save_allocated) {
+        add_menutext(&menu, "");
+        add_menutext(&menu, "");
+        add_menutext(&menu, "Last save");
+        add_menutext(&menu, "");
+        add_menutext(&menu, count_str);
+        buf = msgprintf(template, "tags",
+                        (long)program_state.binary_save.tagcount,
+                        mtag_memory_usage(&program_state.binary_save));
+        add_menutext(&menu, buf);
+        buf = msgprintf(template, "data", 1L,
+                        (long)program_state.binary_save.pos);
+        add_menutext(&menu, buf);
+    }
+
     display_menu(&menu, NULL, PICK_NONE, PLHINT_ANYWHERE,
                  NULL);
     return 0;
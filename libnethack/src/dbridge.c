@@ -241,6 +241,7 @@ create_drawbridge(struct level *lev, int x, int y, int dir, boolean flag)
     lev->locations[x][y].drawbridgemask = dir;
     if (lava)
         lev->locations[x][y].drawbridgemask |= DB_LAVA;
+    mark_terrain_changed();
     return TRUE;
 }
 
@@ -681,6 +682,7 @@ close_drawbridge(int x, int y)
         break;
     }
     loc2->wall_info = W_NONDIGGABLE;
+    mark_terrain_changed();
     set_entity(x, y, &(occupants[0]));
     set_entity(x2, y2, &(occupants[1]));
     do_entity(&(occupants[0])); /* Do set_entity after first */
@@ -724,6 +726,7 @@ open_drawbridge(int x, int y)
     loc2 = &level->locations[x2][y2];
     loc2->typ = DOOR;
     loc2->doormask = D_NODOOR;
+    mark_terrain_changed();
     set_entity(x, y, &(occupants[0]));
     set_entity(x2, y2, &(occupants[1]));
     do_entity(&(occupants[0])); /* do set_entity after first */
@@ -798,6 +801,7 @@ destroy_drawbridge(int x, int y)
     wake_nearto(x, y, 500);
     loc2->typ = DOOR;
     loc2->doormask = D_NODOOR;
+    mark_terrain_changed();
     if ((t = t_at(level, x, y)) != 0)
         deltrap(level, t);
     if ((t = t_at(level, x2, y2)) != 0)
@@ -977,6 +977,7 @@ show_map_spot(int x, int y)
     /* Secret corridors are found, but not secret doors. */
     if (loc->typ == SCORR) {
         loc->typ = CORR;
+        mark_terrain_changed();
         unblock_point(x, y);
     }
 
@@ -1048,6 +1049,7 @@ cvt_sdoor_to_door(struct rm *loc, const d_level * dlev)
 
     loc->typ = DOOR;
     loc->doormask = newmask;
+    mark_terrain_changed();
 }
 
 
@@ -1064,6 +1066,7 @@ findone(int zx, int zy, void *num)
         (*(int *)num)++;
     } else if (level->locations[zx][zy].typ == SCORR) {
         level->locations[zx][zy].typ = CORR;
+        mark_terrain_changed();
         unblock_point(zx, zy);
         magic_map_background(zx, zy, 0);
         newsym(zx, zy);
@@ -1131,6 +1134,7 @@ openone(int zx, int zy, void *num)
         (*(int *)num)++;
     } else if (level->locations[zx][zy].typ == SCORR) {
         level->locations[zx][zy].typ = CORR;
+        mark_terrain_changed();
         unblock_point(zx, zy);
         newsym(zx, zy);
         (*(int *)num)++;
@@ -1301,6 +1305,7 @@ dosearch0(int aflag)
                         if (rnl(7 - fund))
                             continue;
                         level->locations[x][y].typ = CORR;
+                        mark_terrain_changed();
                         unblock_point(x, y);    /* vision */
                         exercise(A_WIS, TRUE);
                         action_completed();
@@ -82,6 +82,7 @@ mkcavepos(xchar x, xchar y, int dist, boolean waslit, boolean rockit)
         (IN_SIGHT | COULD_SEE) :     /* short-circuit vision recalc */
         COULD_SEE;
     loc->typ = (rockit ? STONE : ROOM);
+    mark_terrain_changed();
     if (dist >= 3)
         impossible("mkcavepos called with dist %d", dist);
     if (Blind)
@@ -133,6 +134,7 @@ mkcavearea(boolean rockit)
 
     if (!rockit && level->locations[u.ux][u.uy].typ == CORR) {
         level->locations[u.ux][u.uy].typ = ROOM;
+        mark_terrain_changed();
         if (waslit)
             level->locations[u.ux][u.uy].waslit = TRUE;
         newsym(u.ux, u.uy);     /* in case player is invisible */
@@ -404,6 +406,7 @@ dig(void)
         } else
             return 0;   /* statue or boulder got taken */
 
+        mark_terrain_changed();
         if (!does_block(level, dpx, dpy))
             unblock_point(dpx, dpy);    /* vision: can see through */
         if (Blind)
@@ -778,6 +781,7 @@ dighole(boolean pit_only, boolean instant)
         loc->drawbridgemask |= (typ == LAVAPOOL) ? DB_LAVA : DB_MOAT;
 
     liquid_flow:
+        mark_terrain_changed();
         if (ttmp)
             delfloortrap(level, ttmp);
         /* if any objects were frozen here, they're released now */
@@ -867,6 +871,7 @@ dig_up_grave(void)
         break;
     }
     level->locations[u.ux][u.uy].typ = ROOM;
+    mark_terrain_changed();
     del_engr_at(level, u.ux, u.uy);
     newsym(u.ux, u.uy);
     return;
@@ -1207,6 +1212,7 @@ mdig_tunnel(struct monst *mtmp)
             mksobj_at((pile == 1) ? BOULDER : ROCK, level, mtmp->mx, mtmp->my,
                       TRUE, FALSE, rng_main);
     }
+    mark_terrain_changed();
     newsym(mtmp->mx, mtmp->my);
     if (!sobj_at(BOULDER, level, mtmp->mx, mtmp->my))
         unblock_point(mtmp->mx, mtmp->my);      /* vision */
@@ -1362,6 +1368,7 @@ zap_dig(schar dx, schar dy, schar dz)
         zy += dy;
     }   /* while */
 
+    mark_terrain_changed();
     tmpsym_end(tsym);
     if (shopdoor || shopwall)
         pay_for_damage(shopdoor ? "destroy" : "dig into", FALSE);
@@ -7,6 +7,13 @@
 #include "config.h"
 #include "dlb.h"
 
+#include <ctype.h>
+#include <limits.h>
+
+#ifndef WIN32
+# include <sys/mman.h>
+#endif
+
 /* without extern.h via hack.h, these haven't been declared for us */
 extern FILE *fopen_datafile(const char *, const char *, int);
 
@@ -32,12 +39,14 @@ typedef struct dlb_procs {
 /*
  * Library Implementation:
  *
- * When initialized, we open all library files and read in their tables
- * of contents.  The library files stay open all the time.  When
- * a open is requested, the libraries' directories are searched.  If
- * successful, we return a descriptor that contains the library, file
- * size, and current file mark.  This descriptor is used for all
- * successive calls.
+ * When initialized, we open all library files, load them into memory (mapping
+ * them, where the system allows, so that every process running the game shares
+ * one copy), and read in their tables of contents, which are indexed by file
+ * name.  The library files stay open all the time.  When a open is requested,
+ * the libraries' directories are searched.  If successful, we return a
+ * descriptor that contains the library, file size, and current file mark.
+ * This descriptor is used for all successive calls, which copy out of the
+ * library's memory.
  *
  * The ability to open more than one library is supported but used
  * only in the Amiga port (the second library holds the sound files).
@@ -48,7 +57,12 @@ typedef struct dlb_procs {
 #define MAX_LIBS 4
 static library dlb_libs[MAX_LIBS];
 
+static boolean load_library(library * lp);
+static void unload_library(library * lp);
+static boolean parse_long(const char **pp, const char *end, long *val);
 static boolean readlibdir(library * lp);
+static unsigned int filename_hash(const char *name);
+static void index_libdir(library * lp);
 static boolean find_file(const char *name, library ** lib, long *startp,
                          long *sizep);
 static boolean lib_dlb_init(void);
@@ -102,9 +116,89 @@ void close_library(library * lp);
 #define DLB_MAX_VERS  1 /* max library version readable by this code */
 
 /*
- * Read the directory from the library file.   This will allocate and
- * fill in our globals.  The file pointer is reset back to position
- * zero.  If any part fails, leave nothing that needs to be deallocated.
+ * Load the contents of the (already opened) library file into memory.  Return
+ * TRUE on success, FALSE on failure, in which case nothing needs to be
+ * deallocated.
+ */
+static boolean
+load_library(library * lp)
+{
+    char *buf;
+    long size;
+
+    if (fseek(lp->fdata, 0L, SEEK_END) != 0 || (size = ftell(lp->fdata)) <= 0)
+        return FALSE;
+
+#ifndef WIN32
+    buf = mmap(NULL, size, PROT_READ, MAP_SHARED, fileno(lp->fdata), 0);
+    if (buf != MAP_FAILED) {
+        fseek(lp->fdata, 0L, SEEK_SET);
+        lp->data = buf;
+        lp->datasize = size;
+        lp->mapped = TRUE;
+        return TRUE;
+    }
+#endif
+
+    /* no mmap(); read the whole thing instead (it isn't very large) */
+    buf = malloc(size);
+    if (fseek(lp->fdata, 0L, SEEK_SET) != 0 ||
+        fread(buf, 1, size, lp->fdata) != (size_t)size) {
+        free(buf);
+        fseek(lp->fdata, 0L, SEEK_SET);
+        return FALSE;
+    }
+    fseek(lp->fdata, 0L, SEEK_SET);
+    lp->data = buf;
+    lp->datasize = size;
+    lp->mapped = FALSE;
+    return TRUE;
+}
+
+static void
+unload_library(library * lp)
+{
+#ifndef WIN32
+    if (lp->mapped)
+        munmap((void *)lp->data, lp->datasize);
+    else
+#endif
+        free((void *)lp->data);
+
+    lp->data = NULL;
+    lp->datasize = 0;
+    lp->mapped = FALSE;
+}
+
+/*
+ * Read a number from the directory, the same way "%ld" would, without going
+ * past end.  Return FALSE if there's no number there.
+ */
+static boolean
+parse_long(const char **pp, const char *end, long *val)
+{
+    const char *p = *pp;
+    long n = 0;
+
+    while (p < end && isspace((unsigned char)*p))
+        p++;
+    if (p == end || !isdigit((unsigned char)*p))
+        return FALSE;
+    while (p < end && isdigit((unsigned char)*p)) {
+        if (n > (LONG_MAX - 9) / 10)
+            return FALSE;
+        n = n * 10 + (*p++ - '0');
+    }
+
+    *pp = p;
+    *val = n;
+    return TRUE;
+}
+
+/*
+ * Read the directory from the library in memory.  This will allocate and
+ * fill in our globals.  If any part fails, leave nothing that needs to be
+ * deallocated.
  *
  * Return TRUE on success, FALSE on failure.
  */
@@ -114,31 +208,47 @@ readlibdir(library * lp)
 {
     int i;
     char *sp;
-    long liboffset, totalsize;
-
-    if (fscanf
-        (lp->fdata, "%ld %ld %ld %ld %ld\n", &lp->rev, &lp->nentries,
-         &lp->strsize, &liboffset, &totalsize) != 5)
+    const char *p = lp->data, *end = lp->data + lp->datasize, *name;
+    long liboffset, totalsize, len;
+
+    if (!parse_long(&p, end, &lp->rev) ||
+        !parse_long(&p, end, &lp->nentries) ||
+        !parse_long(&p, end, &lp->strsize) ||
+        !parse_long(&p, end, &liboffset) ||
+        !parse_long(&p, end, &totalsize))
         return FALSE;
     if (lp->rev > DLB_MAX_VERS || lp->rev < DLB_MIN_VERS)
         return FALSE;
+    /* everything we hand out has to be within the data we have */
+    if (lp->nentries <= 0 || totalsize > lp->datasize ||
+        liboffset > totalsize || lp->strsize <= 0)
+        return FALSE;
 
     lp->dir = malloc(lp->nentries * sizeof (libdir));
     lp->sspace = malloc(lp->strsize);
 
     /* read in each directory entry */
     for (i = 0, sp = lp->sspace; i < lp->nentries; i++) {
+        while (p < end && isspace((unsigned char)*p))
+            p++;
+        if (p == end)
+            goto fail;
+        lp->dir[i].handling = *p++;
+
+        for (name = p; p < end && !isspace((unsigned char)*p); p++)
+            ;
+        len = p - name;
+        if (!len || len >= lp->strsize - (sp - lp->sspace))
+            goto fail;
+        memcpy(sp, name, len);
+        sp[len] = '\0';
         lp->dir[i].fname = sp;
-        if (fscanf
-            (lp->fdata, "%c%s %ld\n", &lp->dir[i].handling, sp,
-             &lp->dir[i].foffset) != 3) {
-            free(lp->dir);
-            free(lp->sspace);
-            lp->dir = NULL;
-            lp->sspace = NULL;
-            return FALSE;
-        }
-        sp = sp + strlen(sp) + 1;
+        sp += len + 1;
+
+        if (!parse_long(&p, end, &lp->dir[i].foffset) ||
+            lp->dir[i].foffset > totalsize ||
+            (i && lp->dir[i].foffset < lp->dir[i - 1].foffset))
+            goto fail;
     }
 
     /* calculate file sizes using offset information */
@@ -149,10 +259,58 @@ readlibdir(library * lp)
             lp->dir[i].fsize = lp->dir[i + 1].foffset - lp->dir[i].foffset;
     }
 
-    fseek(lp->fdata, 0L, SEEK_SET);     /* reset back to zero */
-    lp->fmark = 0;
+    index_libdir(lp);
 
     return TRUE;
+
+fail:
+    free(lp->dir);
+    free(lp->sspace);
+    lp->dir = NULL;
+    lp->sspace = NULL;
+    return FALSE;
+}
+
+/* Hashes a file name in a way that's consistent with FILENAME_CMP, whether
+   that's case sensitive or not. */
+static unsigned int
+filename_hash(const char *name)
+{
+    unsigned int h = 2166136261u;
+
+    while (*name) {
+        h ^= (unsigned char)tolower((unsigned char)*name++);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*
+ * Build the hash table used by find_file.  If a name appears in the directory
+ * more than once, the first entry with that name is the one that's found.
+ */
+static void
+index_libdir(library * lp)
+{
+    unsigned int mask, h;
+    int i;
+
+    for (lp->dirindexsize = 16; lp->dirindexsize < lp->nentries * 2;
+         lp->dirindexsize *= 2)
+        ;
+    lp->dirindex = malloc(lp->dirindexsize * sizeof (int));
+    memset(lp->dirindex, 0, lp->dirindexsize * sizeof (int));
+    mask = lp->dirindexsize - 1;
+
+    for (i = 0; i < lp->nentries; i++) {
+        for (h = filename_hash(lp->dir[i].fname) & mask; lp->dirindex[h];
+             h = (h + 1) & mask)
+            if (FILENAME_CMP(lp->dir[lp->dirindex[h] - 1].fname,
+                             lp->dir[i].fname) == 0)
+                break;
+        if (!lp->dirindex[h])
+            lp->dirindex[h] = i + 1;
+    }
 }
 
 /*
@@ -162,16 +320,20 @@ readlibdir(library * lp)
 static boolean
 find_file(const char *name, library ** lib, long *startp, long *sizep)
 {
-    int i, j;
+    int i;
+    unsigned int h, mask, hash = filename_hash(name);
     library *lp;
+    libdir *dp;
 
     for (i = 0; i < MAX_LIBS && dlb_libs[i].fdata; i++) {
         lp = &dlb_libs[i];
-        for (j = 0; j < lp->nentries; j++) {
-            if (FILENAME_CMP(name, lp->dir[j].fname) == 0) {
+        mask = lp->dirindexsize - 1;
+        for (h = hash & mask; lp->dirindex[h]; h = (h + 1) & mask) {
+            dp = &lp->dir[lp->dirindex[h] - 1];
+            if (FILENAME_CMP(name, dp->fname) == 0) {
                 *lib = lp;
-                *startp = lp->dir[j].foffset;
-                *sizep = lp->dir[j].fsize;
+                *startp = dp->foffset;
+                *sizep = dp->fsize;
                 return TRUE;
             }
         }
@@ -192,9 +354,13 @@ open_library(const char *lib_name, library * lp)
 
     lp->fdata = fopen_datafile(lib_name, RDBMODE, DATAPREFIX);
     if (lp->fdata) {
-        if (readlibdir(lp)) {
-            status = TRUE;
-        } else {
+        if (load_library(lp)) {
+            if (readlibdir(lp))
+                status = TRUE;
+            else
+                unload_library(lp);
+        }
+        if (!status) {
             fclose(lp->fdata);
             lp->fdata = NULL;
         }
@@ -206,15 +372,16 @@ void
 close_library(library * lp)
 {
     fclose(lp->fdata);
+    unload_library(lp);
     free(lp->dir);
+    free(lp->dirindex);
     free(lp->sspace);
 
     memset((char *)lp, 0, sizeof (library));
 }
 
 /*
- * Open the library file once using stdio.  Keep it open, but
- * keep track of the file position.
+ * Open the library file once, and load it into memory.  Keep it open.
  */
 static boolean
 lib_dlb_init(void)
@@ -274,7 +441,7 @@ lib_dlb_fclose(dlb * dp)
 static int
 lib_dlb_fread(char *buf, int size, int quan, dlb * dp)
 {
-    long pos, nread, nbytes;
+    long nbytes;
 
     /* make sure we don't read into the next file */
     if ((dp->size - dp->mark) < (size * quan))
@@ -282,18 +449,11 @@ lib_dlb_fread(char *buf, int size, int quan, dlb * dp)
     if (quan == 0)
         return 0;
 
-    pos = dp->start + dp->mark;
-    if (dp->lib->fmark != pos) {
-        fseek(dp->lib->fdata, pos, SEEK_SET);   /* check for error??? */
-        dp->lib->fmark = pos;
-    }
-
-    nread = fread(buf, size, quan, dp->lib->fdata);
-    nbytes = nread * size;
+    nbytes = (long)quan * size;
+    memcpy(buf, dp->lib->data + dp->start + dp->mark, nbytes);
     dp->mark += nbytes;
-    dp->lib->fmark += nbytes;
 
-    return nread;
+    return quan;
 }
 
 static int
@@ -324,8 +484,8 @@ lib_dlb_fseek(dlb * dp, long pos, int whence)
 static char *
 lib_dlb_fgets(char *buf, int len, dlb * dp)
 {
-    int i;
-    char *bp, c = 0;
+    const char *start, *nl;
+    long n;
 
     if (len <= 0)
         return buf;     /* sanity check */
@@ -335,15 +495,20 @@ lib_dlb_fgets(char *buf, int len, dlb * dp)
         return NULL;
 
     len--;      /* save room for null */
-    for (i = 0, bp = buf; i < len && dp->mark < dp->size && c != '\n';
-         i++, bp++) {
-        if (dlb_fread(bp, 1, 1, dp) <= 0)
-            break;      /* EOF or error */
-        c = *bp;
-    }
-    *bp = '\0';
+    n = dp->size - dp->mark;
+    if (n > len)
+        n = len;
+    start = dp->lib->data + dp->start + dp->mark;
+    if ((nl = memchr(start, '\n', n)) != 0)
+        n = nl - start + 1;
+
+    memcpy(buf, start, n);
+    buf[n] = '\0';
+    dp->mark += n;
 
 #if defined(WIN32)
+    char *bp;
+
     if ((bp = strchr(buf, '\r')) != 0) {
         *bp++ = '\n';
         *bp = '\0';
@@ -66,6 +66,7 @@ boulder_hits_pool(struct obj * otmp, int rx, int ry, boolean pushing)
                 level->locations[rx][ry].drawbridgemask |= DB_FLOOR;
             } else
                 level->locations[rx][ry].typ = ROOM;
+            mark_terrain_changed();
 
             if (ttmp)
                 delfloortrap(level, ttmp);
@@ -1037,6 +1038,7 @@ goto_level(d_level * newlevel, boolean at_stairs, boolean falling,
     reset_rndmonst(NON_PM);     /* u.uz change affects monster generation */
 
     origlev = level;
+    mark_level_dirty(origlev);
     level = NULL;
 
     if (!levels[new_ledger]) {
@@ -1047,6 +1049,7 @@ goto_level(d_level * newlevel, boolean at_stairs, boolean falling,
     } else {
         /* returning to previously visited level */
         level = levels[new_ledger];
+        mark_level_dirty(level);
 
         /* regenerate animals while on another level */
         for (mtmp = level->monlist; mtmp; mtmp = mtmp2) {
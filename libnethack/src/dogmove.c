@@ -668,7 +668,7 @@ dog_move(struct monst *mtmp, int after)
     coord poss[9];
     long info[9], allowflags;
     struct musable m;
-    struct distmap_state ds;
+    struct distmap_state *ds;
 
     /*
      * Tame Angels have isminion set and an ispriest structure instead of
@@ -819,9 +819,9 @@ dog_move(struct monst *mtmp, int after)
         uncursedcnt++;
     }
 
-    distmap_init(&ds, gx, gy, mtmp);
+    ds = distmap_init(gx, gy, mtmp);
 
-#define GDIST(x,y) (distmap(&ds,(x),(y)))
+#define GDIST(x,y) (distmap(ds,(x),(y)))
 
     chcnt = 0;
     chi = -1;
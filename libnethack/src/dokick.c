@@ -885,6 +885,7 @@ dokick(const struct nh_cmd_arg *arg)
                       "Crash!  You kick open a secret passage!");
                 exercise(A_DEX, TRUE);
                 maploc->typ = CORR;
+                mark_terrain_changed();
                 if (Blind)
                     feel_location(x, y);        /* we know it's gone */
                 else
@@ -906,6 +907,7 @@ dokick(const struct nh_cmd_arg *arg)
             if ((Luck < 0 || maploc->doormask) && kickedloose) {
                 maploc->typ = ROOM;
                 maploc->doormask = 0;   /* don't leave loose ends.. */
+                mark_terrain_changed();
                 mkgold(goldamt, level, x, y, rng_main);
                 if (Blind)
                     pline(msgc_substitute, "CRASH!  You destroy it.");
@@ -1520,6 +1522,7 @@ deliver_object(struct obj *obj, xchar dnum, xchar dlevel, int where)
         lev = mklev(&levnum);
         reset_rndmonst(NON_PM);
     }
+    mark_level_dirty(lev);
 
     obj_extract_self(obj);
 
@@ -1090,6 +1090,7 @@ terminate(enum nh_play_status playstatus)
     /* don't bother to try to release memory if we're in panic mode, to avoid
        trouble in case that happens to be due to memory problems */
     if (!program_state.panicking) {
+        free_level_save_cache();
         freedynamicdata();
         dlb_cleanup();
     }
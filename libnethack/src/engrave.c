@@ -1394,6 +1394,7 @@ make_grave(struct level *lev, int x, int y, const char *str)
 
     /* Make the grave */
     lev->locations[x][y].typ = GRAVE;
+    mark_terrain_changed();
 
     /* Engrave the headstone. */
     if (!str)
@@ -161,6 +161,7 @@ gush(int x, int y, void *poolcnt)
 
     /* Put a pool at x, y */
     level->locations[x][y].typ = POOL;
+    mark_terrain_changed();
     /* No kelp! */
     del_engr_at(level, x, y);
     water_damage_chain(level->objects[x][y], TRUE);
@@ -223,6 +224,7 @@ dryup(xchar x, xchar y, boolean isyou)
         level->locations[x][y].typ = ROOM;
         level->locations[x][y].looted = 0;
         level->locations[x][y].blessedftn = 0;
+        mark_terrain_changed();
         if (cansee(x, y))
             pline(msgc_consequence, "The fountain dries up!");
         /* The location is seen if the hero/monster is invisible */
@@ -422,6 +424,7 @@ dipfountain(struct obj *obj)
         update_inventory();
         level->locations[u.ux][u.uy].typ = ROOM;
         level->locations[u.ux][u.uy].looted = 0;
+        mark_terrain_changed();
         newsym(u.ux, u.uy);
         if (in_town(u.ux, u.uy))
             angry_guards(FALSE);
@@ -532,6 +535,7 @@ breaksink(int x, int y)
         pline(msgc_consequence, "The pipes break!  Water spurts out!");
     level->locations[x][y].doormask = 0;
     level->locations[x][y].typ = FOUNTAIN;
+    mark_terrain_changed();
     newsym(x, y);
 }
 
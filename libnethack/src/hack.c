@@ -12,7 +12,8 @@ static void maybe_wail(void);
 static boolean moverock(schar dx, schar dy);
 static int still_chewing(xchar, xchar);
 static void dosinkfall(void);
-static boolean findtravelpath(boolean(*)(int, int), schar *, schar *);
+static boolean findtravelpath(boolean(*)(int, int), boolean, schar *,
+                              schar *);
 static struct monst *monstinroom(const struct permonst *, int);
 static boolean check_interrupt(struct monst *mtmp);
 static boolean couldsee_func(int, int);
@@ -637,6 +638,7 @@ still_chewing(xchar x, xchar y)
         loc->typ = CORR;
     }
 
+    mark_terrain_changed();
     unblock_point(x, y);        /* vision */
     newsym(x, y);
     if (digtxt)
@@ -1089,29 +1091,133 @@ autotravel_weighting(int x, int y, unsigned distance)
     return distance * 10;
 }
 
+/* distmap_init() is called for every monster move, and the monsters in
+   question very often share a goal (typically, where they think the hero is).
+   The BFS only depends on the terrain and on a few properties of the monster,
+   so we keep a small cache of distance fields, and monsters that would get
+   the same results from goodpos() share one. The fields are filled in
+   lazily, which is fine, because a partially complete BFS is the same no
+   matter which monster started it.
+
+   MM_IGNOREMONST | MM_IGNOREDOORS means that monsters, doors and boulders
+   don't matter; the remaining terrain is tracked with a terrain epoch, and
+   the entire cache is dropped whenever it changes. */
+#define DISTMAP_CACHE_SIZE   8
+
+#define DISTMAP_SIG_POOL     0x01   /* can enter water */
+#define DISTMAP_SIG_EEL      0x02   /* can't leave water */
+#define DISTMAP_SIG_LAVA     0x04   /* can enter lava */
+#define DISTMAP_SIG_PASSWALL 0x08   /* can phase through walls */
+#define DISTMAP_SIG_UNSHARED 0x10   /* goodpos() special-cases the hero */
+
+static struct distmap_state distmap_cache[DISTMAP_CACHE_SIZE];
+static unsigned long distmap_cache_clock;
+
+static unsigned long terrain_epoch = 1;
+static unsigned long distmap_terrain_epoch;
+
+/* Anything that changes the typ of a location, or the flags of a wall or
+   drawbridge, must call this; alloc_level() calls it for new and restored
+   levels, so a level pointer can't be reused behind the cache's back. */
+void
+mark_terrain_changed(void)
+{
+    terrain_epoch++;
+}
+
+static void
+distmap_check_terrain(void)
+{
+    int i;
+
+    if (distmap_terrain_epoch == terrain_epoch)
+        return;
+
+    distmap_terrain_epoch = terrain_epoch;
+    for (i = 0; i < DISTMAP_CACHE_SIZE; i++)
+        distmap_cache[i].lev = NULL;
+}
+
+/* Everything about the monster that goodpos() looks at, given the flags that
+   distmap uses. */
+static int
+distmap_signature(const struct monst *mtmp)
+{
+    const struct permonst *mdat = mtmp->data;
+    int signature = 0;
+
+    if (mtmp == &youmonst)
+        return DISTMAP_SIG_UNSHARED;
+
+    if (is_flyer(mdat) || is_swimmer(mdat) || is_clinger(mdat))
+        signature |= DISTMAP_SIG_POOL;
+    if (mdat->mlet == S_EEL)
+        signature |= DISTMAP_SIG_EEL;
+    if (is_flyer(mdat) || likes_lava(mdat))
+        signature |= DISTMAP_SIG_LAVA;
+    if (passes_walls(mdat))
+        signature |= DISTMAP_SIG_PASSWALL;
+
+    return signature;
+}
+
 /* Sort-of like findtravelpath, but simplified. This is for monster travel.
    Assumption: monsters know the layout of the dungeon, but not the locations of
    items. Monsters will avoid the square they believe the player to be on. The
-   return value is the distance between the two points given. */
-void
-distmap_init(struct distmap_state *ds, int x1, int y1, struct monst *mtmp)
+   return value is the distance between the two points given.
+
+   The returned state belongs to the cache; it stays valid until
+   DISTMAP_CACHE_SIZE more calls to distmap_init have been made. */
+struct distmap_state *
+distmap_init(int x1, int y1, struct monst *mtmp)
 {
-    memset(ds->onmap, 0, sizeof ds->onmap);
+    struct distmap_state *ds = NULL;
+    int signature = distmap_signature(mtmp);
+    int mmflags = MM_IGNOREMONST | MM_IGNOREDOORS;
+    int i;
 
-    ds->curdist = 0;
-    ds->tslen = 1;
+    struct obj *monwep = MON_WEP(mtmp);
+    if (tunnels(mtmp->data) && (!needspick(mtmp->data) ||
+                                (monwep && is_pick(monwep))))
+        mmflags |= MM_CHEWROCK;
 
-    ds->travelstepx[0][0] = x1;
-    ds->travelstepy[0][0] = y1;
+    distmap_check_terrain();
 
-    ds->mon = mtmp;
-    ds->mmflags = MM_IGNOREMONST | MM_IGNOREDOORS;
+    for (i = 0; i < DISTMAP_CACHE_SIZE; i++) {
+        struct distmap_state *c = distmap_cache + i;
+
+        if (c->lev == mtmp->dlevel && c->startx == x1 && c->starty == y1 &&
+            c->signature == signature && c->mmflags == mmflags) {
+            ds = c;
+            break;
+        }
+    }
+
+    if (!ds) {
+        ds = distmap_cache;
+        for (i = 1; i < DISTMAP_CACHE_SIZE; i++)
+            if (distmap_cache[i].last_used < ds->last_used)
+                ds = distmap_cache + i;
+
+        memset(ds->onmap, 0, sizeof ds->onmap);
 
-    struct obj *monwep = MON_WEP(ds->mon);
-    if (tunnels(ds->mon->data) && (!needspick(ds->mon->data) ||
-                                   (monwep && is_pick(monwep))))
-        ds->mmflags |= MM_CHEWROCK;
+        ds->curdist = 0;
+        ds->tslen = 1;
 
+        ds->travelstepx[0][0] = x1;
+        ds->travelstepy[0][0] = y1;
+        ds->onmap[x1][y1] = 1;
+
+        ds->mmflags = mmflags;
+        ds->lev = (signature & DISTMAP_SIG_UNSHARED) ? NULL : mtmp->dlevel;
+        ds->startx = x1;
+        ds->starty = y1;
+        ds->signature = signature;
+    }
+
+    ds->mon = mtmp;
+    ds->last_used = ++distmap_cache_clock;
+    return ds;
 }
 
 int
@@ -1128,20 +1234,21 @@ distmap(struct distmap_state *ds, int x2, int y2)
         for (i = 0; i < oldtslen; i++) {
             int x = ds->travelstepx[ds->curdist % 2][i];
             int y = ds->travelstepy[ds->curdist % 2][i];
-            if (ds->onmap[x][y])
-                continue;
-
-            ds->onmap[x][y] = ds->curdist + 1;
 
+            /* squares are marked when they're queued, so that none is queued
+               twice and the queue can't outgrow travelstepx/y */
             int dx, dy;
             for (dy = -1; dy <= 1; dy++)
                 for (dx = -1; dx <= 1; dx++) {
                     if (!isok(x + dx, y + dy))
                         continue;
+                    if (ds->onmap[x + dx][y + dy])
+                        continue;
                     if (!goodpos(ds->mon->dlevel, x + dx, y + dy,
                                  ds->mon, ds->mmflags))
                         continue;
 
+                    ds->onmap[x + dx][y + dy] = ds->curdist + 2;
                     ds->travelstepx[(ds->curdist + 1) % 2][ds->tslen] = x + dx;
                     ds->travelstepy[(ds->curdist + 1) % 2][ds->tslen] = y + dy;
                     ds->tslen++;
@@ -1156,15 +1263,307 @@ distmap(struct distmap_state *ds, int x2, int y2)
 }
 
 
+/* The state of a breadth-first search outwards from a square, on behalf of
+   findtravelpath(). The search can be stopped and later resumed, so that it
+   need only go as far as the hero; travel and fromdir are valid for the
+   squares reached so far. */
+struct travel_search {
+    unsigned travel[COLNO][ROWNO];  /* distance, or 0 if not reached */
+    xchar fromdir[COLNO][ROWNO];    /* 1 + index into xdir/ydir of the step
+                                       that reached the square, or 0 */
+    xchar travelstepx[2][COLNO * ROWNO];
+    xchar travelstepy[2][COLNO * ROWNO];
+    int n;                          /* max offset in travelsteps */
+    int nn;                         /* offset in the next set */
+    int set;                        /* two sets current and previous */
+    int radius;                     /* search radius */
+    int i, dir;                     /* how far through the current set */
+    boolean alreadyrepeated;
+};
+
+static void
+travel_search_start(struct travel_search *ts, xchar tx, xchar ty)
+{
+    memset(ts->travel, 0, sizeof ts->travel);
+    memset(ts->fromdir, 0, sizeof ts->fromdir);
+    ts->travelstepx[0][0] = tx;
+    ts->travelstepy[0][0] = ty;
+    ts->n = 1;
+    ts->nn = 0;
+    ts->set = 0;
+    ts->radius = 1;
+    ts->i = 0;
+    ts->dir = 0;
+    ts->alreadyrepeated = FALSE;
+}
+
+/* Continues a search until it reaches (ux,uy), returning TRUE, or runs out of
+   squares, returning FALSE. If guess is non-NULL, (ux,uy) is instead left out
+   of the search entirely, as are squares that guess rejects. */
+static boolean
+travel_search_run(struct travel_search *ts, xchar ux, xchar uy,
+                  boolean(*guess) (int, int),
+                  const struct test_move_cache *cache)
+{
+    static const int ordered[] = { 0, 2, 4, 6, 1, 3, 5, 7 };
+    /* no diagonal movement for grid bugs */
+    int dirmax = u.umonnum == PM_GRID_BUG ? 4 : 8;
+
+    while (ts->n != 0) {
+        for (; ts->i < ts->n;
+             ts->i++, ts->dir = 0, ts->alreadyrepeated = FALSE) {
+            int x = ts->travelstepx[ts->set][ts->i];
+            int y = ts->travelstepy[ts->set][ts->i];
+
+            for (; ts->dir < dirmax; ts->dir++) {
+                int nx = x + xdir[ordered[ts->dir]];
+                int ny = y + ydir[ordered[ts->dir]];
+
+                /*
+                 * When guessing and trying to travel as close as possible
+                 * to an unreachable target space, don't include spaces
+                 * that would never be picked as a guessed target in the
+                 * travel matrix describing player-reachable spaces.
+                 * This stops travel from getting confused and moving the
+                 * player back and forth in certain degenerate
+                 * configurations of sight-blocking obstacles, e.g.
+                 *
+                 *    T         1. Dig this out and carry enough to not be
+                 *      ####       able to squeeze through diagonal gaps.
+                 *      #--.---    Stand at @ and target travel at space T.
+                 *       @.....
+                 *       |.....
+                 *
+                 *    T         2. couldsee() marks spaces marked a and x as
+                 *      ####       eligible guess spaces to move the player
+                 *      a--.---    towards.  Space a is closest to T, so it
+                 *       @xxxxx    gets chosen.  Travel system moves
+                 *       |xxxxx    right to travel to space a.
+                 *
+                 *    T         3. couldsee() marks spaces marked b, c and x
+                 *      ####       as eligible guess spaces to move the
+                 *      a--c---    player towards.  Since findtravelpath()
+                 *       b@xxxx    is called repeatedly during travel, it
+                 *       |xxxxx    doesn't remember that it wanted to go to
+                 *                 space a, so in comparing spaces b and c,
+                 *                 b is chosen, since it seems like the
+                 *                 closest eligible space to T. Travel
+                 *                 system moves @ left to go to space b.
+                 *
+                 *              4. Go to 2.
+                 *
+                 * By limiting the travel matrix here, space a in the
+                 * example above is never included in it, preventing the
+                 * cycle.
+                 */
+                if (!isok(nx, ny) ||
+                    (guess == couldsee_func && !guess(nx, ny)))
+                    continue;
+
+                if (test_move(x, y, nx - x, ny - y, 0, TEST_SLOW, cache)) {
+                    /* closed doors and boulders usually cause a delay, so
+                       prefer another path */
+                    if ((int)ts->travel[x][y] > ts->radius - 5) {
+                        if (!ts->alreadyrepeated) {
+                            ts->travelstepx[1 - ts->set][ts->nn] = x;
+                            ts->travelstepy[1 - ts->set][ts->nn] = y;
+                            /* don't change travel matrix! */
+                            ts->nn++;
+                            ts->alreadyrepeated = TRUE;
+                        }
+                        continue;
+                    }
+                }
+                if (test_move(x, y, nx - x, ny - y, 0, TEST_SLOW, cache) ||
+                    test_move(x, y, nx - x, ny - y, 0, TEST_TRAV, cache)) {
+                    if ((level->locations[nx][ny].seenv ||
+                         (!cache->blind && couldsee(nx, ny)))) {
+                        if (guess && nx == ux && ny == uy) {
+                            ;   /* not a useful place to guess */
+                        } else if (!ts->travel[nx][ny]) {
+                            ts->travelstepx[1 - ts->set][ts->nn] = nx;
+                            ts->travelstepy[1 - ts->set][ts->nn] = ny;
+                            ts->travel[nx][ny] = ts->radius;
+                            ts->fromdir[nx][ny] = ordered[ts->dir] + 1;
+                            ts->nn++;
+                            if (nx == ux && ny == uy) {
+                                ts->dir++;
+                                return TRUE;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        ts->n = ts->nn;
+        ts->nn = 0;
+        ts->set = 1 - ts->set;
+        ts->radius++;
+        ts->i = 0;
+    }
+
+    return FALSE;
+}
+
+/* Travel and autoexplore call findtravelpath() once per step, and usually
+   nothing that the search depends on has changed since the previous step. So
+   the search towards a given target is kept, together with a snapshot of
+   everything test_move() looks at in TEST_SLOW and TEST_TRAV modes, and
+   resumed (if it hasn't already reached the hero) while the snapshot still
+   matches. Because it's a breadth-first search, the step that first reached
+   the hero's square is the one that a fresh search would find. */
+#define TSQ_SEEN     0x01   /* seenv, or couldsee() while not blind */
+#define TSQ_BOULDER  0x02   /* remembered boulder */
+#define TSQ_AVOID    0x04   /* seen trap, or remembered water or lava, that
+                               travel avoids (never the hero's square) */
+#define TSQ_HASTRAP  0x08   /* a trap has been considered for the square */
+
+struct travel_square {
+    schar typ;
+    uchar flags;
+    uchar bits;
+};
+
+struct travel_key {
+    xchar tx, ty;
+    const struct level *lev;
+    d_level z;
+    const struct permonst *data;
+    int umonnum;
+    boolean blind, passwall, grounded, travelling;
+    boolean ooze, overweight, boulders_block;
+    struct travel_square squares[COLNO][ROWNO];
+};
+
+static struct travel_key travel_cache_key, travel_new_key;
+static boolean travel_cache_valid;
+static struct travel_search travel_cache_search, travel_guess_search;
+static struct travel_search travel_fresh_search;
+
+/* Fills in key for a search from (tx,ty). Returns FALSE if the search can't
+   be reused: block_door() and block_entry() can print messages and depend on
+   the shopkeeper, and in Sokoban the boulders are checked directly. */
+static boolean
+travel_key_init(struct travel_key *key, xchar tx, xchar ty,
+                const struct test_move_cache *cache)
+{
+    const struct rm *uloc = &level->locations[u.ux][u.uy];
+    struct trap *t;
+    int x, y;
+
+    if (*u.ushops || In_sokoban(&u.uz) ||
+        (IS_DOOR(uloc->typ) && uloc->doormask == D_BROKEN))
+        return FALSE;
+
+    key->tx = tx;
+    key->ty = ty;
+    key->lev = level;
+    key->z = u.uz;
+    key->data = youmonst.data;
+    key->umonnum = u.umonnum;
+    key->blind = cache->blind;
+    key->passwall = cache->passwall;
+    key->grounded = cache->grounded;
+    key->travelling = travelling();
+    key->ooze = can_ooze(&youmonst);
+    key->overweight = invent && inv_weight_total() > 600;
+    key->boulders_block = !throws_rocks(youmonst.data) &&
+        !(verysmall(youmonst.data) && !u.usteed) &&
+        !((!invent || inv_weight_over_cap() <= -850) && !u.usteed);
+
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++) {
+            const struct rm *loc = &level->locations[x][y];
+            struct travel_square *sq = &key->squares[x][y];
+
+            sq->typ = loc->typ;
+            sq->flags = loc->flags;
+            sq->bits = 0;
+            if (loc->seenv || (!cache->blind && couldsee(x, y)))
+                sq->bits |= TSQ_SEEN;
+            if (loc->mem_obj == BOULDER + 1)
+                sq->bits |= TSQ_BOULDER;
+            if (cache->grounded &&
+                (loc->mem_bg == S_pool || loc->mem_bg == S_lava))
+                sq->bits |= TSQ_AVOID;
+        }
+
+    /* only the first trap on a square counts, as with t_at() */
+    for (t = level->lev_traps; t; t = t->ntrap) {
+        struct travel_square *sq = &key->squares[t->tx][t->ty];
+
+        if (sq->bits & TSQ_HASTRAP)
+            continue;
+        sq->bits |= TSQ_HASTRAP;
+        if (t->tseen)
+            sq->bits |= TSQ_AVOID;
+    }
+
+    key->squares[u.ux][u.uy].bits &= ~TSQ_AVOID;
+
+    return TRUE;
+}
+
+static boolean
+travel_key_matches(const struct travel_key *a, const struct travel_key *b)
+{
+    return a->tx == b->tx && a->ty == b->ty && a->lev == b->lev &&
+        on_level(&a->z, &b->z) && a->data == b->data &&
+        a->umonnum == b->umonnum && a->blind == b->blind &&
+        a->passwall == b->passwall && a->grounded == b->grounded &&
+        a->travelling == b->travelling && a->ooze == b->ooze &&
+        a->overweight == b->overweight &&
+        a->boulders_block == b->boulders_block &&
+        !memcmp(a->squares, b->squares, sizeof a->squares);
+}
+
+/* Returns 1 + the index into xdir/ydir of the step that reaches the hero
+   when searching outwards from (tx,ty), or 0 if there's no path. */
+static int
+travel_step_towards(xchar tx, xchar ty, const struct test_move_cache *cache)
+{
+    struct travel_search *ts = &travel_cache_search;
+
+    if (!travel_key_init(&travel_new_key, tx, ty, cache)) {
+        travel_cache_valid = FALSE;
+        travel_search_start(ts, tx, ty);
+    } else if (!travel_cache_valid ||
+               !travel_key_matches(&travel_new_key, &travel_cache_key)) {
+        travel_cache_key = travel_new_key;
+        travel_cache_valid = TRUE;
+        travel_search_start(ts, tx, ty);
+    }
+
+    if (!ts->fromdir[u.ux][u.uy])
+        travel_search_run(ts, u.ux, u.uy, NULL, cache);
+
+    return ts->fromdir[u.ux][u.uy];
+}
+
+/* travel_step_towards() with a fresh search, which leaves the kept search
+   alone. */
+static int
+travel_step_uncached(xchar tx, xchar ty, const struct test_move_cache *cache)
+{
+    struct travel_search *ts = &travel_fresh_search;
+
+    travel_search_start(ts, tx, ty);
+    travel_search_run(ts, u.ux, u.uy, NULL, cache);
+    return ts->fromdir[u.ux][u.uy];
+}
+
 /*
  * Find a path from the destination (u.tx,u.ty) back to (u.ux,u.uy).
  * A shortest path is returned.  If guess is non-NULL, instead travel
  * as near to the target as you can, using guess as a function that
- * specifies what is considered to be a valid target.
+ * specifies what is considered to be a valid target.  If cached is
+ * FALSE, the search kept from the previous step isn't used.
  * Returns TRUE if a path was found.
  */
 static boolean
-findtravelpath(boolean(*guess) (int, int), schar *dx, schar *dy)
+findtravelpath(boolean(*guess) (int, int), boolean cached, schar *dx,
+               schar *dy)
 {
     struct test_move_cache cache;
     init_test_move_cache(&cache);
@@ -1187,143 +1586,25 @@ findtravelpath(boolean(*guess) (int, int), schar *dx, schar *dy)
         }
     }
     if (u.tx != u.ux || u.ty != u.uy || guess == unexplored) {
-        unsigned travel[COLNO][ROWNO];
-        xchar travelstepx[2][COLNO * ROWNO];
-        xchar travelstepy[2][COLNO * ROWNO];
-        xchar tx, ty, ux, uy;
-        int n = 1;      /* max offset in travelsteps */
-        int set = 0;    /* two sets current and previous */
-        int radius = 1; /* search radius */
-        int i;
+        xchar tx, ty;
+        int dir;
 
         /* If guessing, first find an "obvious" goal location.  The obvious
            goal is the position the player knows of, or might figure out
            (couldsee) that is closest to the target on a straight path. */
         if (guess) {
-            tx = u.ux;
-            ty = u.uy;
-            ux = u.tx;
-            uy = u.ty;
-        } else {
-            tx = u.tx;
-            ty = u.ty;
-            ux = u.ux;
-            uy = u.uy;
-        }
-
-    noguess:
-        memset(travel, 0, sizeof (travel));
-        travelstepx[0][0] = tx;
-        travelstepy[0][0] = ty;
-
-        while (n != 0) {
-            int nn = 0;
-
-            for (i = 0; i < n; i++) {
-                int dir;
-                int x = travelstepx[set][i];
-                int y = travelstepy[set][i];
-                static const int ordered[] = { 0, 2, 4, 6, 1, 3, 5, 7 };
-                /* no diagonal movement for grid bugs */
-                int dirmax = u.umonnum == PM_GRID_BUG ? 4 : 8;
-                boolean alreadyrepeated = FALSE;
-
-                for (dir = 0; dir < dirmax; ++dir) {
-                    int nx = x + xdir[ordered[dir]];
-                    int ny = y + ydir[ordered[dir]];
-
-                    /*
-                     * When guessing and trying to travel as close as possible
-                     * to an unreachable target space, don't include spaces
-                     * that would never be picked as a guessed target in the
-                     * travel matrix describing player-reachable spaces.
-                     * This stops travel from getting confused and moving the
-                     * player back and forth in certain degenerate
-                     * configurations of sight-blocking obstacles, e.g.
-                     *
-                     *    T         1. Dig this out and carry enough to not be
-                     *      ####       able to squeeze through diagonal gaps.
-                     *      #--.---    Stand at @ and target travel at space T.
-                     *       @.....
-                     *       |.....
-                     *
-                     *    T         2. couldsee() marks spaces marked a and x as
-                     *      ####       eligible guess spaces to move the player
-                     *      a--.---    towards.  Space a is closest to T, so it
-                     *       @xxxxx    gets chosen.  Travel system moves
-                     *       |xxxxx    right to travel to space a.
-                     *
-                     *    T         3. couldsee() marks spaces marked b, c and x
-                     *      ####       as eligible guess spaces to move the
-                     *      a--c---    player towards.  Since findtravelpath()
-                     *       b@xxxx    is called repeatedly during travel, it
-                     *       |xxxxx    doesn't remember that it wanted to go to
-                     *                 space a, so in comparing spaces b and c,
-                     *                 b is chosen, since it seems like the
-                     *                 closest eligible space to T. Travel
-                     *                 system moves @ left to go to space b.
-                     *
-                     *              4. Go to 2.
-                     *
-                     * By limiting the travel matrix here, space a in the
-                     * example above is never included in it, preventing the
-                     * cycle.
-                     */
-                    if (!isok(nx, ny) ||
-                        (guess == couldsee_func && !guess(nx, ny)))
-                        continue;
-
-                    if (test_move(x, y, nx - x, ny - y, 0, TEST_SLOW, &cache)) {
-                        /* closed doors and boulders usually cause a delay, so
-                           prefer another path */
-                        if ((int)travel[x][y] > radius - 5) {
-                            if (!alreadyrepeated) {
-                                travelstepx[1 - set][nn] = x;
-                                travelstepy[1 - set][nn] = y;
-                                /* don't change travel matrix! */
-                                nn++;
-                                alreadyrepeated = TRUE;
-                            }
-                            continue;
-                        }
-                    }
-                    if (test_move(x, y, nx - x, ny - y, 0, TEST_SLOW, &cache) ||
-                        test_move(x, y, nx - x, ny - y, 0, TEST_TRAV, &cache)) {
-                        if ((level->locations[nx][ny].seenv ||
-                             (!cache.blind && couldsee(nx, ny)))) {
-                            if (nx == ux && ny == uy) {
-                                if (!guess) {
-                                    *dx = x - ux;
-                                    *dy = y - uy;
-                                    if (x == u.tx && y == u.ty) {
-                                        action_completed();
-                                        flags.travelcc.x =
-                                            flags.travelcc.y = -1;
-                                    }
-                                    return TRUE;
-                                }
-                            } else if (!travel[nx][ny]) {
-                                travelstepx[1 - set][nn] = nx;
-                                travelstepy[1 - set][nn] = ny;
-                                travel[nx][ny] = radius;
-                                nn++;
-                            }
-                        }
-                    }
-                }
-            }
-
-            n = nn;
-            set = 1 - set;
-            radius++;
-        }
-
-        /* if guessing, find best location in travel matrix and go there */
-        if (guess) {
-            int px = tx, py = ty;       /* pick location */
+            unsigned (*travel)[ROWNO] = travel_guess_search.travel;
+            xchar ux = u.tx, uy = u.ty;
+            int px, py;                 /* pick location */
             int dist, nxtdist, d2, nd2;
             boolean autoexploring = (guess == unexplored);
 
+            tx = px = u.ux;
+            ty = py = u.uy;
+            travel_search_start(&travel_guess_search, tx, ty);
+            travel_search_run(&travel_guess_search, ux, uy, guess, &cache);
+
+            /* find best location in travel matrix and go there */
             dist = distmin(ux, uy, tx, ty);
             d2 = dist2(ux, uy, tx, ty);
             if (autoexploring) {
@@ -1369,14 +1650,25 @@ findtravelpath(boolean(*guess) (int, int), schar *dx, schar *dy)
             }
             tx = px;
             ty = py;
-            ux = u.ux;
-            uy = u.uy;
-            set = 0;
-            n = radius = 1;
-            guess = NULL;
-            goto noguess;
+        } else {
+            tx = u.tx;
+            ty = u.ty;
         }
-        return FALSE;
+
+        if (cached)
+            dir = travel_step_towards(tx, ty, &cache);
+        else
+            dir = travel_step_uncached(tx, ty, &cache);
+        if (!dir)
+            return FALSE;
+
+        *dx = -xdir[dir - 1];
+        *dy = -ydir[dir - 1];
+        if (u.ux + *dx == u.tx && u.uy + *dy == u.ty) {
+            action_completed();
+            flags.travelcc.x = flags.travelcc.y = -1;
+        }
+        return TRUE;
     }
 
 found:
@@ -1386,6 +1678,22 @@ found:
     return FALSE;
 }
 
+/* Works out the next step of autoexplore, or of travel towards (u.tx,u.ty),
+   the way domove() does, setting *dx and *dy (both 0 if there isn't one).
+   With cached FALSE, the search kept between travel steps is bypassed; the
+   unit tests compare the two. */
+void
+travel_step(boolean autoexplore, boolean cached, schar *dx, schar *dy)
+{
+    *dx = *dy = 0;
+    if (autoexplore) {
+        u.tx = u.ux;
+        u.ty = u.uy;
+        findtravelpath(unexplored, cached, dx, dy);
+    } else if (!findtravelpath(NULL, cached, dx, dy))
+        findtravelpath(couldsee_func, cached, dx, dy);
+}
+
 /* A function version of couldsee, so we can take a pointer to it. */
 static boolean
 couldsee_func(int x, int y)
@@ -1484,14 +1792,14 @@ domove(const struct nh_cmd_arg *arg, enum u_interaction_mode uim,
             }
             u.tx = u.ux;
             u.ty = u.uy;
-            if (!findtravelpath(unexplored, &turnstate.move.dx,
+            if (!findtravelpath(unexplored, TRUE, &turnstate.move.dx,
                                 &turnstate.move.dy)) {
                 pline(msgc_cancelled, "Nowhere else around here can be "
                       "automatically explored.");
             }
-        } else if (!findtravelpath(NULL, &turnstate.move.dx,
+        } else if (!findtravelpath(NULL, TRUE, &turnstate.move.dx,
                                    &turnstate.move.dy)) {
-            findtravelpath(couldsee_func, &turnstate.move.dx,
+            findtravelpath(couldsee_func, TRUE, &turnstate.move.dx,
                            &turnstate.move.dy);
         }
 
@@ -5,6 +5,7 @@
 
 #include "hack.h"
 #include "lev.h"
+#include "trietable.h"
 #include <stdint.h>
 
 /*
@@ -24,11 +25,10 @@
  * The major working function is do_light_sources(). It is called when the
  * vision system is recreating its "could see" array.  Here we add a flag
  * (TEMP_LIT) to the array for all locations that are lit via a light source.
- * The bad part of this is that we have to re-calculate the LOS of each light
- * source every time the vision system runs.  Even if the light sources and any
- * topology (vision blocking positions) have not changed.  The good part is that
- * no extra memory is used, plus we don't have to figure out how far the sources
- * have moved, or if the topology has changed.
+ * Each light source remembers which squares it lit last time, together with
+ * its position and range, and the vision system's epoch for the topology
+ * (vision blocking positions); the LOS is only re-calculated if one of those
+ * has changed.
  *
  * The structure of the save/restore mechanism is amazingly similar to the timer
  * save/restore.  This is because they both have the same principals of having
@@ -64,6 +64,7 @@ new_light_source(struct level *lev, xchar x, xchar y, int range, int type,
     ls->type = type;
     ls->id = id;
     ls->flags = 0;
+    ls->lit_epoch = 0;
     lev->lev_lights = ls;
 
     turnstate.vision_full_recalc = TRUE;     /* make the source show up */
@@ -122,15 +123,14 @@ do_light_sources(char **cs_rows)
     short at_hero_range = 0;
     light_source *ls;
     char *row;
+    unsigned long epoch = vision_clear_epoch();
 
     for (ls = level->lev_lights; ls; ls = ls->next) {
         ls->flags &= ~LSF_SHOW;
 
         /* 
-         * Check for moved light sources.  It may be possible to
-         * save some effort if an object has not moved, but not in
-         * the current setup -- we need to recalculate for every
-         * vision recalc.
+         * Check for moved light sources.  If a source hasn't moved, its
+         * cached footprint is checked against its position below.
          */
         if (ls->type == LS_OBJECT) {
             if (get_obj_location((struct obj *)ls->id, &ls->x, &ls->y, 0))
@@ -156,7 +156,24 @@ do_light_sources(char **cs_rows)
              *
              * Kevin's tests indicated that doing this brute-force
              * method is faster for radius <= 3 (or so).
+             *
+             * The paths from the source are remembered in its footprint,
+             * except for the hero's square (and for sources at the hero),
+             * for which clear_path() uses cs_rows instead.
              */
+            boolean at_hero = ls->x == u.ux && ls->y == u.uy;
+            boolean recalc = !at_hero &&
+                (ls->lit_epoch != epoch || ls->lit_x != ls->x ||
+                 ls->lit_y != ls->y || ls->lit_range != ls->range);
+
+            if (recalc) {
+                memset(ls->lit, 0, sizeof ls->lit);
+                ls->lit_epoch = epoch;
+                ls->lit_x = ls->x;
+                ls->lit_y = ls->y;
+                ls->lit_range = ls->range;
+            }
+
             limits = circle_ptr(ls->range);
             if ((max_y = (ls->y + ls->range)) >= ROWNO)
                 max_y = ROWNO - 1;
@@ -170,9 +187,21 @@ do_light_sources(char **cs_rows)
                 if ((max_x = (ls->x + offset)) >= COLNO)
                     max_x = COLNO - 1;
 
-                for (x = min_x; x <= max_x; x++)
-                    if (clear_path((int)ls->x, (int)ls->y, x, y, cs_rows))
+                for (x = min_x; x <= max_x; x++) {
+                    int bit = (y - ls->y + MAX_RADIUS) * LS_FOOTPRINT_SIZE +
+                        (x - ls->x + MAX_RADIUS);
+                    unsigned char mask = 1 << (bit % 8);
+
+                    if (recalc && clear_path((int)ls->x, (int)ls->y, x, y,
+                                             NULL))
+                        ls->lit[bit / 8] |= mask;
+
+                    if (at_hero || (x == u.ux && y == u.uy)) {
+                        if (clear_path((int)ls->x, (int)ls->y, x, y, cs_rows))
+                            row[x] |= TEMP_LIT;
+                    } else if (ls->lit[bit / 8] & mask)
                         row[x] |= TEMP_LIT;
+                }
             }
         }
     }
@@ -181,6 +210,35 @@ do_light_sources(char **cs_rows)
 /* (mon->mx == COLNO) implies migrating */
 #define mon_is_local(mon) ((mon) != &youmonst && (mon)->mx != COLNO)
 
+/*
+ * An index from monster IDs to monsters, to save find_mid() from searching
+ * monster chains. It's filled in as monsters are restored and whenever a search
+ * finds one, and monsters are removed from it as they're deallocated, so it
+ * never points to freed memory. However, monsters move between chains without
+ * updating it, so an entry is just a hint as to where the monster might be, and
+ * has to be checked before it's used.
+ */
+static struct trietable *mid_index = NULL;
+
+void
+index_mid(struct monst *mtmp)
+{
+    trietable_add(&mid_index, mtmp->m_id, mtmp);
+}
+
+void
+unindex_mid(struct monst *mtmp)
+{
+    if (trietable_find(&mid_index, mtmp->m_id) == mtmp)
+        trietable_remove(&mid_index, mtmp->m_id);
+}
+
+void
+clear_mid_index(void)
+{
+    trietable_empty(&mid_index);
+}
+
 struct monst *
 find_mid(struct level *lev, unsigned nid, unsigned fmflags)
 {
@@ -188,19 +246,35 @@ find_mid(struct level *lev, unsigned nid, unsigned fmflags)
 
     if (!nid)
         return &youmonst;
+
+    /* A live monster on lev's map (or the steed, which isn't placed on the map)
+       is on lev->monlist, which is searched first, so if the index gives us
+       one, it's what the search would have found. */
+    if (fmflags & FM_FMON) {
+        mtmp = trietable_find(&mid_index, nid);
+        if (mtmp && mtmp->m_id == nid && !DEADMONSTER(mtmp) &&
+            mtmp->dlevel == lev && mon_is_local(mtmp) &&
+            (lev->monsters[mtmp->mx][mtmp->my] == mtmp || mtmp == u.usteed))
+            return mtmp;
+    }
+
+    mtmp = NULL;
     if (fmflags & FM_FMON)
         for (mtmp = lev->monlist; mtmp; mtmp = mtmp->nmon)
             if (!DEADMONSTER(mtmp) && mtmp->m_id == nid)
-                return mtmp;
-    if (fmflags & FM_MIGRATE)
+                break;
+    if (!mtmp && (fmflags & FM_MIGRATE))
         for (mtmp = migrating_mons; mtmp; mtmp = mtmp->nmon)
             if (mtmp->m_id == nid)
-                return mtmp;
-    if (fmflags & FM_MYDOGS)
+                break;
+    if (!mtmp && (fmflags & FM_MYDOGS))
         for (mtmp = turnstate.migrating_pets; mtmp; mtmp = mtmp->nmon)
             if (mtmp->m_id == nid)
-                return mtmp;
-    return NULL;
+                break;
+
+    if (mtmp)
+        index_mid(mtmp);
+    return mtmp;
 }
 
 
@@ -307,6 +381,7 @@ restore_light_sources(struct memfile *mf, struct level *lev)
         ls->id = (void *)id;
         ls->x = mread8(mf);
         ls->y = mread8(mf);
+        ls->lit_epoch = 0;
 
         ls->next = rest;
         if (prev)
@@ -39,10 +39,23 @@
  * flags.turntime, with the timezone offset already applied.
  */
 
+/* If nonzero, the clock is stopped at this time. */
+static microseconds frozen_time;
+
+/* Stops the clock at the given time, or restarts it if that's 0. The unit tests
+   use this to play the same game twice and get the same log. */
+void
+freeze_utc_time(microseconds when)
+{
+    frozen_time = when;
+}
+
 /* Outside-the-game time. */
 microseconds
 utc_time(void)
 {
+    if (frozen_time)
+        return frozen_time;
 #ifdef UNIX
     struct timeval tv;
     gettimeofday(&tv, NULL);
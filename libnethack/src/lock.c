@@ -871,6 +871,7 @@ doorlock(struct obj * otmp, int x, int y)
         case SPE_FORCE_BOLT:
             door->typ = DOOR;
             door->doormask = D_CLOSED | (door->doormask & D_TRAPPED);
+            mark_terrain_changed();
             newsym(x, y);
             if (cansee(x, y))
                 pline(msgc_youdiscover, "A door appears in the wall!");
@@ -904,6 +905,7 @@ doorlock(struct obj * otmp, int x, int y)
             }
             block_point(x, y);
             door->typ = SDOOR;
+            mark_terrain_changed();
             if (vis)
                 pline(msgc_actionok, "The doorway vanishes!");
             newsym(x, y);
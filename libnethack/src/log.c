@@ -3,6 +3,13 @@
 /* Copyright (c) Daniel Thaler, 2011.                             */
 /* NetHack may be freely redistributed.  See license for details. */
 
+/* The intrinsics headers must come before hack.h, as they use identifiers that
+   hack.h defines as macros. */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define B64_SIMD
+# include <immintrin.h>
+#endif
+
 #include "hack.h"
 #include "patchlevel.h"
 #include "iomodes.h"
@@ -23,7 +30,9 @@ static void log_reset(void);
 static void log_binary(const char *buf, int buflen);
 static long get_log_offset(void);
 static long get_log_last_newline(int);
-static char *lgetline_malloc(int);
+static char *lgetline(int);
+static void sync_log_file_pointer(int fd);
+static long log_seek(int fd, long offset, int whence);
 
 static enum nh_log_status read_log_header(
     int fd, struct nh_game_info *si, int *recovery_count, boolean do_locking);
@@ -31,6 +40,19 @@ static enum nh_log_status read_log_header(
 static void load_gamestate_from_binary_save(boolean maybe_old_version);
 static void log_replay_save_line(void);
 
+static long save_moves(struct memfile *mf);
+static long binary_save_moves(void);
+static void index_save_line(long offset, long moves, boolean backup);
+static void link_save_line(long offset, long next);
+static void log_save_line_record(long prev_backup, long last_line);
+static void index_save_line_record(long offset, const char *logline,
+                                   const char *record);
+static void truncate_save_line_index(long offset);
+static void free_save_line_index(void);
+static void checkpoint_save_line(long offset, long backup, struct memfile *mf);
+static void truncate_save_checkpoints(long offset);
+static void free_save_checkpoints(void);
+
 static boolean full_read(int fd, void *buffer, int len);
 static boolean full_write(int fd, const void *buffer, int len);
 
@@ -209,7 +231,7 @@ log_recover_core(long offset, boolean canreturn, const char *message,
        If it isn't, the recover will have to be done manually. */
 
     if (offset > 0) {
-        lseek(program_state.logfile, offset - 1, SEEK_SET);
+        log_seek(program_state.logfile, offset - 1, SEEK_SET);
         ok = full_read(program_state.logfile, newline_check, 1);
         if (ok && *newline_check != '\n')
             ok = FALSE;
@@ -224,7 +246,7 @@ log_recover_core(long offset, boolean canreturn, const char *message,
         terminate(ERR_IN_PROGRESS); /* cannot panic */
     }
 
-    if (offset * 9 < lseek(program_state.logfile, 0, SEEK_END)) {
+    if (offset * 9 < log_seek(program_state.logfile, 0, SEEK_END)) {
         log_reset();
         /* the location to recover to has probably been calculated incorrectly;
            force a manual recover rather than losing data */
@@ -250,8 +272,8 @@ log_recover_core(long offset, boolean canreturn, const char *message,
                      "However, the game can be recovered from a backup save.");
         buf = msgprintf("This will lose approximately %.4g%% of your progress.",
                         100.0 * (1.0 - ((float)offset /
-                                        lseek(program_state.logfile, 0,
-                                              SEEK_END))));
+                                        log_seek(program_state.logfile, 0,
+                                                  SEEK_END))));
         add_menutext(&menu, buf);
 
         if (canreturn) {
@@ -314,7 +336,7 @@ log_recover_core(long offset, boolean canreturn, const char *message,
                         program_state.expected_recovery_count,
                         VERSION_MAJOR, VERSION_MINOR, PATCHLEVEL);
 
-        lseek(program_state.logfile, 0, SEEK_SET);
+        log_seek(program_state.logfile, 0, SEEK_SET);
         if (!full_write(program_state.logfile, buf, strlen(buf))) {
             /* This is bad enough to panic, but we can't panic, so... */
             raw_printf("Could not write to save file to recover it!\n");
@@ -326,6 +348,8 @@ log_recover_core(long offset, boolean canreturn, const char *message,
             raw_printf("Could not truncate save file during recovery!\n");
             terminate(ERR_RESTORE_FAILED);
         }
+        discard_log_read_buffer(program_state.logfile);
+        truncate_save_line_index(offset);
 
         /* Relinquish the lock, and reload the file. */
         if (!change_fd_lock(program_state.logfile, TRUE, LT_MONITOR, 1)) {
@@ -378,14 +402,13 @@ log_maybe_undo_quit(void)
                     &program_state.expected_recovery_count, FALSE);
 
     lastline = get_log_last_newline(2);
-    lseek(program_state.logfile, lastline, SEEK_SET);
-    logline = lgetline_malloc(program_state.logfile);
+    log_seek(program_state.logfile, lastline, SEEK_SET);
+    logline = lgetline(program_state.logfile);
     if (!logline) /* perhaps someone else didn't lock correctly? */
         error_reading_save("penultimate newline was past EOF");
 
     if (strcmp(logline, "Q") == 0)
         log_recover_core(lastline, FALSE, NULL, __FILE__, __LINE__);
-    free(logline);
 
     if (!change_fd_lock(program_state.logfile, TRUE, LT_MONITOR, 2))
         panic("Could not downgrade to monitor lock on logfile");
@@ -394,7 +417,7 @@ log_maybe_undo_quit(void)
 /* The save file was in a correct format, but referred to something that
    couldn't possibly happen in the gamestate. This should only be called if
    there have been no logfile operations (except change_fd_lock) since an
-   lgetline_malloc() of the offending line; start_replaying_logfile() leaves the
+   lgetline() of the offending line; start_replaying_logfile() leaves the
    logfile in the right state. */
 static noreturn void
 log_desync(char found, char expected)
@@ -436,19 +459,16 @@ log_desync(char found, char expected)
         panic("Could not upgrade to read lock on logfile");
 
     /* Can we find some future save point to restore to? */
-    while ((logline = lgetline_malloc(program_state.logfile))) {
+    while ((logline = lgetline(program_state.logfile))) {
 
         if (*logline == '~' || *logline == '*') {
 
             /* Yes. */
             if (!change_fd_lock(program_state.logfile, TRUE, LT_MONITOR, 2))
                 panic("Could not downgrade to monitor lock on logfile");
-            free(logline);
             /* TODO: get this to restart at the log offset, somehow */
             terminate(RESTART_PLAY);
         }
-
-        free(logline);
     }
 
     /* No. */
@@ -474,24 +494,275 @@ static const char b64d[256] = {
     41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51
 };
 
-static int
+int
 base64size(int n)
 {
     return compressBound(n) * 4 / 3 + 4 + 12;   /* 12 for $4294967296$ */
 }
 
-static void
+/* Compressed data is held in this buffer on its way into or out of base 64; it
+   grows as needed, and is kept around between calls because save diffs and
+   backups are encoded and decoded very frequently. */
+static unsigned char *base64_zbuf = NULL;
+static unsigned long base64_zbuf_size = 0;
+
+static unsigned char *
+get_base64_zbuf(unsigned long size)
+{
+    if (size > base64_zbuf_size) {
+        free(base64_zbuf);
+        base64_zbuf = malloc(size);
+        if (!base64_zbuf)
+            panic("Out of memory allocating base 64 buffer");
+        base64_zbuf_size = size;
+    }
+    return base64_zbuf;
+}
+
+/* Vectorized encoding and decoding of base 64 data. These work on whole blocks
+   (12 or 24 bytes of binary data, 16 or 32 characters of base 64) at a time,
+   and return how many bytes of binary data they processed; anything they leave
+   over is handled by the scalar code in base64_encode_binary and base64_decode.
+   The algorithms are those of Wojciech Muła (http://0x80.pl/articles/), and
+   produce exactly the same output as the table-driven code.
+
+   The game is normally compiled for a generic target, so the kernels are
+   compiled for SSSE3 and AVX2 via function attributes, and the best one the
+   CPU supports is chosen at runtime. Each kernel is written once, as a macro
+   that's instantiated for both vector widths; with 256-bit vectors, each
+   128-bit lane is processed independently. */
+#ifdef B64_SIMD
+
+# define B64_OP_128(f) _mm_##f
+# define B64_OP_256(f) _mm256_##f
+# define B64_OP(w, f) B64_OP_##w(f)
+# define B64_SI(w, f) B64_OP(w, f##_si##w)
+# define B64_LUT_128(...) _mm_setr_epi8(__VA_ARGS__)
+# define B64_LUT_256(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+# define B64_LUT(w, ...) B64_LUT_##w(__VA_ARGS__)
+# define B64_VEC(w) __m##w##i
+# define B64_TARGET_128 __attribute__((target("ssse3")))
+# define B64_TARGET_256 __attribute__((target("avx2")))
+# define B64_TARGET(w) B64_TARGET_##w
+
+/* base64_encode_lanes_W converts 12 bytes of binary data (in bytes 0 to 11 of
+   each lane) to 16 base 64 characters: it splits each group of 3 bytes into 4
+   6-bit indexes, one per byte, then maps the indexes to characters by adding an
+   offset that depends on which range of the alphabet they're in. */
+# define B64_ENCODE_LANES(w)                                                \
+static inline B64_TARGET(w) B64_VEC(w)                                      \
+base64_encode_lanes_##w(B64_VEC(w) in)                                      \
+{                                                                           \
+    const B64_VEC(w) shuf = B64_LUT(w, 1, 0, 2, 1, 4, 3, 5, 4,              \
+                                    7, 6, 8, 7, 10, 9, 11, 10);             \
+    const B64_VEC(w) shift_lut = B64_LUT(w,                                 \
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,         \
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,         \
+        '/' - 63, 'A', 0, 0);                                               \
+    B64_VEC(w) t0, t1, t2, t3, idx, res;                                    \
+                                                                            \
+    in = B64_OP(w, shuffle_epi8)(in, shuf);                                 \
+    t0 = B64_SI(w, and)(in, B64_OP(w, set1_epi32)(0x0fc0fc00));             \
+    t1 = B64_OP(w, mulhi_epu16)(t0, B64_OP(w, set1_epi32)(0x04000040));     \
+    t2 = B64_SI(w, and)(in, B64_OP(w, set1_epi32)(0x003f03f0));             \
+    t3 = B64_OP(w, mullo_epi16)(t2, B64_OP(w, set1_epi32)(0x01000010));     \
+    idx = B64_SI(w, or)(t1, t3);                                            \
+                                                                            \
+    res = B64_OP(w, subs_epu8)(idx, B64_OP(w, set1_epi8)(51));              \
+    res = B64_SI(w, or)(                                                    \
+        res, B64_SI(w, and)(                                                \
+            B64_OP(w, cmpgt_epi8)(B64_OP(w, set1_epi8)(26), idx),           \
+            B64_OP(w, set1_epi8)(13)));                                     \
+    res = B64_OP(w, shuffle_epi8)(shift_lut, res);                          \
+    return B64_OP(w, add_epi8)(res, idx);                                   \
+}
+
+/* base64_decode_lanes_W converts 16 base 64 characters to 12 bytes of binary
+   data (in bytes 0 to 11 of each lane): it maps the characters to 6-bit values,
+   then packs 4 of those into 3 bytes. It sets *bad to TRUE if any of the
+   characters were outside the base 64 alphabet. */
+# define B64_DECODE_LANES(w)                                                \
+static inline B64_TARGET(w) B64_VEC(w)                                      \
+base64_decode_lanes_##w(B64_VEC(w) in, boolean *bad)                        \
+{                                                                           \
+    const B64_VEC(w) lut_lo = B64_LUT(w,                                    \
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,                     \
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);                    \
+    const B64_VEC(w) lut_hi = B64_LUT(w,                                    \
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,                     \
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);                    \
+    const B64_VEC(w) lut_roll = B64_LUT(w,                                  \
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);          \
+    const B64_VEC(w) shuf = B64_LUT(w, 2, 1, 0, 6, 5, 4, 10, 9,             \
+                                    8, 14, 13, 12, -1, -1, -1, -1);         \
+    B64_VEC(w) hi, lo, roll;                                                \
+                                                                            \
+    hi = B64_SI(w, and)(B64_OP(w, srli_epi32)(in, 4),                       \
+                        B64_OP(w, set1_epi8)(0x0f));                        \
+    lo = B64_SI(w, and)(in, B64_OP(w, set1_epi8)(0x0f));                    \
+    *bad = !!B64_OP(w, movemask_epi8)(B64_OP(w, cmpgt_epi8)(                \
+        B64_SI(w, and)(B64_OP(w, shuffle_epi8)(lut_lo, lo),                 \
+                       B64_OP(w, shuffle_epi8)(lut_hi, hi)),                \
+        B64_SI(w, setzero)()));                                             \
+                                                                            \
+    roll = B64_OP(w, shuffle_epi8)(                                         \
+        lut_roll, B64_OP(w, add_epi8)(                                      \
+            B64_OP(w, cmpeq_epi8)(in, B64_OP(w, set1_epi8)('/')), hi));     \
+    in = B64_OP(w, add_epi8)(in, roll);                                     \
+    in = B64_OP(w, maddubs_epi16)(in, B64_OP(w, set1_epi32)(0x01400140));   \
+    in = B64_OP(w, madd_epi16)(in, B64_OP(w, set1_epi32)(0x00011000));      \
+    return B64_OP(w, shuffle_epi8)(in, shuf);                               \
+}
+
+B64_ENCODE_LANES(128)
+B64_ENCODE_LANES(256)
+B64_DECODE_LANES(128)
+B64_DECODE_LANES(256)
+
+/* The block functions encode whole blocks of in to base 64, without reading
+   past the end of in; and decode whole blocks of base 64 from in, stopping at
+   anything that isn't in the base 64 alphabet (such as padding), and always
+   leaving at least one group of 4 characters for the scalar code to handle. The
+   decoded output is only written while there's room for a whole vector within
+   outlen. */
+static int B64_TARGET(128)
+base64_encode_blocks_128(const unsigned char *in, int len, char *out)
+{
+    int i;
+
+    for (i = 0; i + 16 <= len; i += 12)
+        _mm_storeu_si128((__m128i *)(out + i / 3 * 4), base64_encode_lanes_128(
+                             _mm_loadu_si128((const __m128i *)(in + i))));
+
+    return i;
+}
+
+static int B64_TARGET(256)
+base64_encode_blocks_256(const unsigned char *in, int len, char *out)
+{
+    int i;
+
+    for (i = 0; i + 28 <= len; i += 24) {
+        __m256i v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(
+                _mm_loadu_si128((const __m128i *)(in + i))),
+            _mm_loadu_si128((const __m128i *)(in + i + 12)), 1);
+
+        _mm256_storeu_si256((__m256i *)(out + i / 3 * 4),
+                            base64_encode_lanes_256(v));
+    }
+
+    return i;
+}
+
+static int B64_TARGET(128)
+base64_decode_blocks_128(const char *in, int len, unsigned char *out,
+                         int outlen)
+{
+    int i, o;
+    boolean bad;
+
+    for (i = 0, o = 0; i + 16 < len && o + 16 <= outlen; i += 16, o += 12) {
+        __m128i v = base64_decode_lanes_128(
+            _mm_loadu_si128((const __m128i *)(in + i)), &bad);
+
+        if (bad)
+            break;
+        _mm_storeu_si128((__m128i *)(out + o), v);
+    }
+
+    return o;
+}
+
+static int B64_TARGET(256)
+base64_decode_blocks_256(const char *in, int len, unsigned char *out,
+                         int outlen)
+{
+    int i, o;
+    boolean bad;
+
+    for (i = 0, o = 0; i + 32 < len && o + 28 <= outlen; i += 32, o += 24) {
+        __m256i v = base64_decode_lanes_256(
+            _mm256_loadu_si256((const __m256i *)(in + i)), &bad);
+
+        if (bad)
+            break;
+        _mm_storeu_si128((__m128i *)(out + o), _mm256_castsi256_si128(v));
+        _mm_storeu_si128((__m128i *)(out + o + 12),
+                         _mm256_extracti128_si256(v, 1));
+    }
+
+    return o;
+}
+
+#endif
+
+static int
+base64_encode_blocks_none(const unsigned char *in, int len, char *out)
+{
+    (void) in;
+    (void) len;
+    (void) out;
+    return 0;
+}
+
+static int
+base64_decode_blocks_none(const char *in, int len, unsigned char *out,
+                          int outlen)
+{
+    (void) in;
+    (void) len;
+    (void) out;
+    (void) outlen;
+    return 0;
+}
+
+static int (*base64_encode_blocks)(const unsigned char *, int, char *);
+static int (*base64_decode_blocks)(const char *, int, unsigned char *, int);
+
+/* Chooses the fastest base 64 kernels that the CPU supports, up to maxlevel
+   (0 for the scalar code only, 1 for SSSE3, 2 for AVX2). Returns the level
+   actually chosen. This is called automatically the first time base 64 data is
+   encoded or decoded; the unit tests call it to compare the kernels. */
+int
+select_base64_kernels(int maxlevel)
+{
+#ifdef B64_SIMD
+    __builtin_cpu_init();
+    if (maxlevel >= 2 && __builtin_cpu_supports("avx2")) {
+        base64_encode_blocks = base64_encode_blocks_256;
+        base64_decode_blocks = base64_decode_blocks_256;
+        return 2;
+    }
+    if (maxlevel >= 1 && __builtin_cpu_supports("ssse3")) {
+        base64_encode_blocks = base64_encode_blocks_128;
+        base64_decode_blocks = base64_decode_blocks_128;
+        return 1;
+    }
+#else
+    (void) maxlevel;
+#endif
+    base64_encode_blocks = base64_encode_blocks_none;
+    base64_decode_blocks = base64_decode_blocks_none;
+    return 0;
+}
+
+/* Returns the length of the output (not including the trailing NUL). */
+int
 base64_encode_binary(const unsigned char *in, char *out, int len)
 {
     int i, pos, rem;
     unsigned long olen = compressBound(len);
-    unsigned char *o = malloc(olen);
+    unsigned char *o = get_base64_zbuf(olen);
 
     if (compress2(o, &olen, in, len, Z_BEST_COMPRESSION) != Z_OK) {
         panic("Could not compress input data!");
     }
     MARK_INITIALIZED(o, olen);
 
+    if (!base64_encode_blocks)
+        select_base64_kernels(2);
+
     pos = sprintf(out, "$%d$", len);
 
     if (pos + olen >= len) {
@@ -500,7 +771,10 @@ base64_encode_binary(const unsigned char *in, char *out, int len)
     } else
         in = o;
 
-    for (i = 0; i < (olen / 3) * 3; i += 3) {
+    i = base64_encode_blocks(in, olen, out + pos);
+    pos += i / 3 * 4;
+
+    for (; i < (olen / 3) * 3; i += 3) {
         out[pos] = b64e[in[i] >> 2];
         out[pos + 1] = b64e[(in[i] & 0x03) << 4 | (in[i + 1] & 0xf0) >> 4];
         out[pos + 2] = b64e[(in[i + 1] & 0x0f) << 2 | (in[i + 2] & 0xc0) >> 6];
@@ -519,9 +793,8 @@ base64_encode_binary(const unsigned char *in, char *out, int len)
         pos += 4;
     }
 
-    free(o);
-
     out[pos] = '\0';
+    return pos;
 }
 
 
@@ -542,15 +815,18 @@ base64_strlen(const char *in)
 }
 
 /* TODO: This should be communicating the end position of the base 64 data. */
-static void
+void
 base64_decode(const char *in, char *out, int outlen)
 {
-    int i, len = strlen(in), pos = 0, olen;
+    int i, len = strlen(in), pos = 0, olen, done;
     char *o = out;
 
+    if (!base64_decode_blocks)
+        select_base64_kernels(2);
+
     olen = outlen;
     if (*in == '$') {
-        o = malloc(len);
+        o = (char *)get_base64_zbuf(len);
         olen = len;
     }
 
@@ -561,6 +837,18 @@ base64_decode(const char *in, char *out, int outlen)
         if (in[i] == '$')
             for (i += 2; in[i - 1] != '$' && in[i]; i++) {}
 
+        /* decode as much as we can a block at a time; this leaves padding and
+           the last group of characters to the code below, and we go round the
+           loop again afterwards so that the group after the decoded blocks gets
+           the same checks as any other */
+        done = base64_decode_blocks(in + i, len - i, (unsigned char *)o + pos,
+                                    olen - pos);
+        if (done) {
+            i += done / 3 * 4 - 4;
+            pos += done;
+            continue;
+        }
+
         /* decode blocks; padding '=' are converted to 0 in the decoding table
            */
         if (pos < olen)
@@ -588,14 +876,11 @@ base64_decode(const char *in, char *out, int outlen)
     if (*in == '$') {
 
         unsigned long blen = base64_strlen(in);
-        if (blen > outlen) {
-            free(o);
+        if (blen > outlen)
             error_reading_save("Compressed base64 data was too long at %ld\n");
-        }
         int errcode = uncompress((unsigned char *)out, &blen,
                                  (unsigned char *)o, pos);
 
-        free(o);
         if (errcode != Z_OK) {
             raw_printf("Decompressing save file failed at %ld: %s\n",
                        get_log_offset(),
@@ -622,7 +907,10 @@ static boolean
 full_read(int fd, void *buffer, int len)
 {
     int rv;
-    long o = lseek(fd, 0, SEEK_CUR);
+    long o;
+
+    sync_log_file_pointer(fd);
+    o = lseek(fd, 0, SEEK_CUR);
     errno = 0;
     rv = read(fd, buffer, len);
     if (rv < 0 && errno == EINTR) {
@@ -639,7 +927,10 @@ static boolean
 full_write(int fd, const void *buffer, int len)
 {
     int rv;
-    long o = lseek(fd, 0, SEEK_CUR);
+    long o;
+
+    discard_log_read_buffer(fd);
+    o = lseek(fd, 0, SEEK_CUR);
     errno = 0;
     rv = write(fd, buffer, len);
     if (rv < 0 && errno == EINTR) {
@@ -690,85 +981,212 @@ lprintf(const char *fmt, ...)
     return ret;
 }
 
+/* The encoded form of binary data being written to the log; like base64_zbuf,
+   this is kept around between calls. */
+static char *log_binary_buf = NULL;
+static int log_binary_bufsize = 0;
+
 static void
 log_binary(const char *buf, int buflen)
 {
     char *b64buf;
+    int b64len;
 
     if (program_state.logfile == -1)
         return;
 
-    b64buf = malloc(base64size(buflen));
-    base64_encode_binary((const unsigned char *)buf, b64buf, buflen);
+    if (base64size(buflen) > log_binary_bufsize) {
+        free(log_binary_buf);
+        log_binary_bufsize = base64size(buflen);
+        log_binary_buf = malloc(log_binary_bufsize);
+        if (!log_binary_buf)
+            panic("Out of memory allocating base 64 buffer");
+    }
+    b64buf = log_binary_buf;
+    b64len = base64_encode_binary((const unsigned char *)buf, b64buf, buflen);
 
     /* don't use lprintf, b64buf might be too big for the buffer used by
        lprintf */
-    if (!full_write(program_state.logfile, b64buf, strlen(b64buf)))
+    if (!full_write(program_state.logfile, b64buf, b64len))
         panic("Could not write binary content to the log.");
+}
+
+/* Lines are read from the log via a buffer, so that reading a long sequence of
+   lines (e.g. when catching up with a game in log_sync) doesn't need a sequence
+   of small reads plus a seek for every line. The buffer holds bytes start to
+   start + len - 1 of file descriptor fd (or nothing, if fd is -1).
 
-    free(b64buf);
+   The buffered data is only valid while it can't have been changed behind our
+   back, so it's discarded whenever we write to or truncate the file, and
+   whenever we take a read or write lock on it (which is the only way another
+   process's changes could become visible to us).
+
+   While the buffer is in use, lgetline() doesn't move fd's real file pointer;
+   instead, pos holds the logical file pointer (or -1 if the real file pointer
+   is correct). So all seeks on the file go through log_seek(), and anything
+   else that uses the file pointer calls sync_log_file_pointer() first.
+
+   lgetline() returns lines in place, replacing their newline with a NUL; nul is
+   the index in buf of that newline (or -1), so that it can be put back. */
+#define LOG_READ_BUFFER_MIN 16384
+static struct {
+    char *buf;
+    long size;
+    long start;
+    long len;
+    long pos;
+    long nul;
+    int fd;
+} log_read_buffer = {NULL, 0, 0, 0, -1, -1, -1};
+
+static void
+sync_log_file_pointer(int fd)
+{
+    if (fd == log_read_buffer.fd && log_read_buffer.pos >= 0) {
+        lseek(fd, log_read_buffer.pos, SEEK_SET);
+        log_read_buffer.pos = -1;
+    }
+}
+
+void
+discard_log_read_buffer(int fd)
+{
+    if (fd == -1 || fd == log_read_buffer.fd) {
+        sync_log_file_pointer(log_read_buffer.fd);
+        log_read_buffer.fd = -1;
+        log_read_buffer.len = 0;
+        /* the line lgetline() last returned stays NUL-terminated */
+        log_read_buffer.nul = -1;
+    }
+}
+
+static void
+free_log_read_buffer(void)
+{
+    discard_log_read_buffer(-1);
+    free(log_read_buffer.buf);
+    log_read_buffer.buf = NULL;
+    log_read_buffer.size = 0;
+}
+
+/* A replacement for lseek() that understands lgetline()'s logical file
+   pointer. Seeking to an absolute location within a file we're buffering
+   doesn't need a system call. */
+static long
+log_seek(int fd, long offset, int whence)
+{
+    if (fd == log_read_buffer.fd) {
+        if (whence == SEEK_CUR && log_read_buffer.pos >= 0) {
+            offset += log_read_buffer.pos;
+            whence = SEEK_SET;
+        }
+        if (whence == SEEK_SET && offset >= 0) {
+            log_read_buffer.pos = offset;
+            return offset;
+        }
+        log_read_buffer.pos = -1;
+    }
+    return lseek(fd, offset, whence);
 }
 
 /* Reads a line starting from the current file pointer. Returns NULL if the line
-   is incomplete or spos is past EOF, otherwise mallocs enough space for the
-   line and returns it. The file pointer is left at the newline, or in an
-   unpredictable location in case of error. */
+   is incomplete or spos is past EOF, otherwise returns the line (without its
+   newline). The line is returned in place in the read buffer, so it's only
+   valid until the next call to lgetline() or free_log_read_buffer(); callers
+   must copy anything they want to keep. The file pointer is left just after the
+   newline, or in an unpredictable location in case of error. */
 static char *
-lgetline_malloc(int fd)
+lgetline(int fd)
 {
-    char *inbuf = NULL;
-    long inbuflen = 0;  /* number of bytes read */
-    long fpos = 0;      /* file pointer, relative to its original location */
-    void *nlloc = NULL;
-    boolean at_eof = FALSE;
+    long pos;
+    long scanned;       /* file offset up to which we've looked for a newline */
+    long linelen;
+    char *nlloc = NULL;
+
+    if (log_read_buffer.nul >= 0) {
+        log_read_buffer.buf[log_read_buffer.nul] = '\x0a';
+        log_read_buffer.nul = -1;
+    }
 
-    do {
-        inbuflen += 4;
-        inbuflen *= 3;
-        inbuflen /= 2;
-        inbuf = realloc(inbuf, inbuflen);
-        if (!inbuf)
-            panic("Out of memory in lgetline_malloc");
+    if (log_read_buffer.fd != fd)
+        discard_log_read_buffer(-1);
+    pos = log_seek(fd, 0, SEEK_CUR);
+    if (pos < 0)
+        return NULL;
+
+    if (log_read_buffer.fd != fd || pos < log_read_buffer.start ||
+        pos > log_read_buffer.start + log_read_buffer.len) {
+        log_read_buffer.fd = fd;
+        log_read_buffer.start = pos;
+        log_read_buffer.len = 0;
+    }
+    log_read_buffer.pos = pos;
+
+    scanned = pos;
+    while (1) {
+        long bufend = log_read_buffer.start + log_read_buffer.len;
+        long readlen;
+
+        if (bufend > scanned)
+            nlloc = memchr(log_read_buffer.buf +
+                           (scanned - log_read_buffer.start),
+                           '\x0a', bufend - scanned);
+        if (nlloc)
+            break;
+        scanned = bufend;
+
+        /* We need more data. Drop the part of the buffer before the line we're
+           reading (it's most likely been read already), then expand the buffer
+           if that didn't free any space. */
+        if (pos > log_read_buffer.start) {
+            memmove(log_read_buffer.buf,
+                    log_read_buffer.buf + (pos - log_read_buffer.start),
+                    bufend - pos);
+            log_read_buffer.len = bufend - pos;
+            log_read_buffer.start = pos;
+        }
+        if (log_read_buffer.len == log_read_buffer.size) {
+            log_read_buffer.size = log_read_buffer.size ?
+                log_read_buffer.size * 2 : LOG_READ_BUFFER_MIN;
+            log_read_buffer.buf = realloc(log_read_buffer.buf,
+                                          log_read_buffer.size);
+            if (!log_read_buffer.buf)
+                panic("Out of memory in lgetline");
+        }
 
         /* Return values from read:
            negative return = error
            zero return = EOF
            positive return = success, even if it didn't return as many
-           bytes as expected (in which case we must rerun read) */
-        inbuflen = read(fd, inbuf + fpos, inbuflen - fpos) + fpos;
+           bytes as expected
 
-        /* Most errors are a problem. However, if the read is interrupted with
+           Most errors are a problem. However, if the read is interrupted with
            zero bytes read, then this is reported as an "error" EINTR rather
-           than a count of zero, so as to distinguish it from EOF. (This API
-           could have been better designed, really, but we're stuck with it
-           now.) */
-        at_eof = inbuflen == fpos;
-
-        if (inbuflen < fpos) {
-            if (errno != EINTR) {
-                free(inbuf);
-                return NULL;
-            }
-            inbuflen = fpos; /* we successfully read 0 bytes */
+           than a count of zero, so as to distinguish it from EOF; in that case,
+           we just try again. (This moves the real file pointer, but not the
+           logical one.) */
+        errno = 0;
+        lseek(fd, bufend, SEEK_SET);
+        readlen = read(fd, log_read_buffer.buf + log_read_buffer.len,
+                       log_read_buffer.size - log_read_buffer.len);
+        if (readlen < 0 && errno == EINTR)
+            continue;
+        if (readlen < 0) {
+            discard_log_read_buffer(fd);
+            return NULL;
         }
+        if (readlen == 0)
+            break;  /* at EOF */
 
-        /* We want to break out of the loop if we're at EOF (inbuflen ==
-           fpos) or if a newline was found. */
-        nlloc = memchr(inbuf, '\x0a', fpos);
-        if (at_eof)
-            break;
-
-        fpos = inbuflen;
-    } while (!nlloc);
+        log_read_buffer.len += readlen;
+    }
 
-    if (!nlloc && fpos > 0) {
+    if (!nlloc && scanned > pos) {
         /* The save file ends with a partial line, something that should never
            happen in normal operation (it indicates that a process crashed in
-           the middle of a write). Get rid of the partial line. */
+           the middle of a write). Get rid of the partial line.
 
-        free(inbuf);
-
-        /* Note: this assumes that fd is never 0 or -1. -1 is definitely a safe
+           Note: this assumes that fd is never 0 or -1. -1 is definitely a safe
            assumption, we wouldn't reach here if the fd were invalid. TODO: 0
            is possibly an unsafe assumption, if we're ever run from a client
            that has no open FDs of its own and which has closed all the
@@ -787,24 +1205,22 @@ lgetline_malloc(int fd)
                due to corruption in the first three lines of a file. The NULL
                return here treats this the same way as if one of the first three
                lines were missing, which is pretty much equivalent.) */
-            free(inbuf);
             return NULL;
         }
 
-    } else if (!nlloc && fpos == 0) {
+    } else if (!nlloc) {
         /* At EOF, which is at the start of the line. */
-        free(inbuf);
         return NULL;
     }
 
-    /* We could trim inbuf down to size, but there's not a lot of point,
-       especially as in most cases it's going to be free'd almost
-       immediately. We must, however, undo the excess read via seeking the
-       cursor backwards to just after the final newline. */
-    *(char *)nlloc = '\0';
-    lseek(fd, ((char *)nlloc - inbuf) + 1 - fpos, SEEK_CUR);
+    /* Terminate the line in place, and move the file pointer to just after the
+       newline, as though we'd read exactly that much. */
+    linelen = nlloc - (log_read_buffer.buf + (pos - log_read_buffer.start));
+    *nlloc = '\0';
+    log_read_buffer.nul = nlloc - log_read_buffer.buf;
+    log_read_buffer.pos = pos + linelen + 1;
 
-    return inbuf;
+    return nlloc - linelen;
 }
 
 
@@ -812,7 +1228,7 @@ lgetline_malloc(int fd)
 static long
 get_log_offset(void)
 {
-    return lseek(program_state.logfile, 0, SEEK_CUR);
+    return log_seek(program_state.logfile, 0, SEEK_CUR);
 }
 
 /* Returns the offset just past the end of the last valid line in the log.  This
@@ -831,7 +1247,7 @@ get_log_last_newline(int nth)
     if (!change_fd_lock(program_state.logfile, TRUE, LT_READ, 2))
         panic("Could not upgrade to read lock on logfile");
 
-    lseek(program_state.logfile, -1, SEEK_END);
+    log_seek(program_state.logfile, -1, SEEK_END);
 
     /* Run through the file backwards, reading one char at a time until we find
        a newline. (This is rather less efficient than reading blocks at a time
@@ -840,13 +1256,13 @@ get_log_last_newline(int nth)
        it's unlikely to be a performance bottleneck.) */
     while (full_read(program_state.logfile, inchar, 1) &&
            (*inchar != '\n' || --nth))
-        if (!lseek(program_state.logfile, -2, SEEK_CUR))
+        if (!log_seek(program_state.logfile, -2, SEEK_CUR))
             break;
 
     if (*inchar == '\n') {
         /* We found our newline. The file pointer is now just past it. */
         rv = get_log_offset();
-        lseek(program_state.logfile, o, SEEK_SET);
+        log_seek(program_state.logfile, o, SEEK_SET);
 
         if (!change_fd_lock(program_state.logfile, TRUE, LT_MONITOR, 2))
             panic("Could not downgrade to monitor lock on logfile");
@@ -882,26 +1298,24 @@ get_log_start_of_turn_offset(void)
     if (program_state.emergency_recover_location)
         loc = program_state.emergency_recover_location;
 
-    lseek(program_state.logfile, loc, SEEK_SET);
+    log_seek(program_state.logfile, loc, SEEK_SET);
 
     /* Move forwards one line. In the exceptional case that we have a binary save
        location without a matching binary save (which is probably impossible, but
        may as well handle it just in case it isn't), we treat it the same way as
        an incomplete line. */
 
-    save_diff_line = lgetline_malloc(program_state.logfile);
+    save_diff_line = lgetline(program_state.logfile);
 
     if (!save_diff_line)
         log_recover_noreturn(get_log_last_newline(1),
                              "No save diff in binary save location",
                              __FILE__, __LINE__);
 
-    free(save_diff_line);
-
     /* Now return the offset we found, taking care to restore the file
        pointer. */
     rv = get_log_offset();
-    lseek(program_state.logfile, o, SEEK_SET);
+    log_seek(program_state.logfile, o, SEEK_SET);
 
     if (!change_fd_lock(program_state.logfile, TRUE, LT_MONITOR, 2))
         panic("Could not downgrade to monitor lock on logfile");
@@ -955,13 +1369,13 @@ start_updating_logfile(boolean ok_not_at_end)
     if (lstatus == LS_DONE)
         terminate(GAME_ALREADY_OVER);
 
-    lseek(program_state.logfile,
-          program_state.end_of_gamestate_location, SEEK_SET);
+    log_seek(program_state.logfile,
+              program_state.end_of_gamestate_location, SEEK_SET);
 
     /* now the file pointer should be at EOF */
     o = get_log_offset();
 
-    if (o != lseek(program_state.logfile, 0, SEEK_END)) {
+    if (o != log_seek(program_state.logfile, 0, SEEK_END)) {
         if (!change_fd_lock(program_state.logfile, TRUE, LT_MONITOR, 1))
             panic("Could not downgrade to monitor lock on logfile");
 
@@ -983,7 +1397,7 @@ stop_updating_logfile(int lines_added)
             program_state.end_of_gamestate_location;
 
         program_state.end_of_gamestate_location =
-            lseek(program_state.logfile, 0, SEEK_END);
+            log_seek(program_state.logfile, 0, SEEK_END);
 
     } else if (lines_added > 1) {
         panic("logfile updates may add at most 1 line");
@@ -1046,8 +1460,8 @@ log_newgame(microseconds start_time)
 static void
 set_second_logline(const char *second_logline)
 {
-    lseek(program_state.logfile,
-          strlen("NHGAME  00000001 4.000.000\x0a") + STATUS_LEN, SEEK_SET);
+    log_seek(program_state.logfile,
+              strlen("NHGAME  00000001 4.000.000\x0a") + STATUS_LEN, SEEK_SET);
     lprintf("%" SECOND_LOGLINE_LEN_STR "." SECOND_LOGLINE_LEN_STR "s",
             second_logline);
 }
@@ -1056,8 +1470,8 @@ void
 log_game_over(const char *death)
 {
     start_updating_logfile(FALSE);
-    lseek(program_state.logfile,
-          strlen("NHGAME "), SEEK_SET);
+    log_seek(program_state.logfile,
+              strlen("NHGAME "), SEEK_SET);
     lprintf("%" STATUS_LEN_STR "." STATUS_LEN_STR "s", status_string(LS_DONE));
 
     set_second_logline(death);
@@ -1104,6 +1518,9 @@ log_backup_save(void)
         return;
     }
 
+    long last_line = program_state.binary_save_location;
+    long prev_backup = program_state.save_backup_location;
+
     program_state.binary_save_location = 0;
     if (program_state.binary_save_allocated)
         mfree(&program_state.binary_save);
@@ -1112,21 +1529,25 @@ log_backup_save(void)
     savegame(&program_state.binary_save);
 
     long o = get_log_offset();
-    boolean is_newgame = program_state.save_backup_location == 0;
-    lprintf("*%08lx ", program_state.save_backup_location);
+    boolean is_newgame = prev_backup == 0;
+    lprintf("*%08lx ", prev_backup);
     program_state.save_backup_location = o;
     program_state.binary_save_location = o;
+    index_save_line(o, moves, TRUE);
+    link_save_line(last_line, o);
     log_binary(program_state.binary_save.buf, program_state.binary_save.pos);
+    if (!is_newgame)
+        log_save_line_record(prev_backup, last_line);
     lprintf("\x0a");
 
     /* Once per backup save is about the right rate to refresh this. */
     log_game_state_inner();
 
     /* Record the location of this save backup in the appropriate place. */
-    lseek(program_state.logfile, is_newgame ? o + 1 :
-          program_state.last_save_backup_location_location, SEEK_SET);
+    log_seek(program_state.logfile, is_newgame ? o + 1 :
+              program_state.last_save_backup_location_location, SEEK_SET);
     lprintf("%08lx", o);
-    lseek(program_state.logfile, 0, SEEK_END);
+    log_seek(program_state.logfile, 0, SEEK_END);
 
     stop_updating_logfile(1);
 
@@ -1165,6 +1586,7 @@ log_neutral_turnstate(void)
 
         /* We're generating a save diff line. */
         struct memfile mf = program_state.binary_save;
+        long last_line = program_state.binary_save_location;
 
         /* start_updating_logfile can cause a turn restart, so place it
            outside the allocation of the new binary save */
@@ -1184,6 +1606,8 @@ log_neutral_turnstate(void)
         savegame(&program_state.binary_save);
 
         program_state.binary_save_location = get_log_offset();
+        index_save_line(program_state.binary_save_location, moves, FALSE);
+        link_save_line(last_line, program_state.binary_save_location);
 
         mdiffflush(&program_state.binary_save, 1);
 
@@ -1192,15 +1616,27 @@ log_neutral_turnstate(void)
                    program_state.binary_save.diffpos);
         lprintf("\x0a");
 
+        long end_of_line = get_log_offset();
+
+        boolean full_check = program_state.save_verification == SV_FULL ||
+            (program_state.save_verification == SV_PERIODIC &&
+             program_state.save_verification_interval > 0 &&
+             moves - program_state.last_save_verification >=
+             program_state.save_verification_interval);
+
         /* Verify that the diffing algorithm is working correctly; we don't
-           want to corrupt the save in a way that can't be recovered. */
+           want to corrupt the save in a way that can't be recovered. Applying
+           the diff checks it against the checksum at its end, which is
+           computed from the new save; comparing the whole file as well is
+           only done for full checks. */
         {
             struct memfile checkmf;
             mnew(&checkmf, NULL);
             mdiffapply(program_state.binary_save.diffbuf,
                        program_state.binary_save.diffpos, &mf,
                        &checkmf, diff_error_at_neutral_turnstate);
-            if (!mequal(&checkmf, &program_state.binary_save, NULL))
+            if (full_check &&
+                !mequal(&checkmf, &program_state.binary_save, NULL))
                 panic("Corrupted diff added to save file");
             mfree(&checkmf);
         }
@@ -1212,8 +1648,22 @@ log_neutral_turnstate(void)
 
         stop_updating_logfile(1);
 
-        /* Check the gamestate, for the same reason as in log_backup_save(). */
-        load_gamestate_from_binary_save(FALSE);
+        /* Check the gamestate, for the same reason as in log_backup_save().
+           If we aren't doing that this turn, the game state in memory is the
+           one we just saved, so we merely need to record where it is.
+
+           Skipping the reload does mean that any state which isn't saved (and
+           which the reload would have reset) now lives on until the next full
+           check, rather than being lost at the end of the turn; so a bug in
+           which such state affects the game shows up as a desync later than
+           it would with SV_FULL, if at all. */
+        if (full_check)
+            load_gamestate_from_binary_save(FALSE);
+        else {
+            program_state.gamestate_location =
+                program_state.binary_save_location;
+            program_state.end_of_gamestate_location = end_of_line;
+        }
 
         program_state.emergency_recover_location = 0;
     }
@@ -1460,10 +1910,10 @@ start_replaying_logfile(char firstchar)
     if (!change_fd_lock(program_state.logfile, TRUE, LT_READ, 2))
         panic("Could not upgrade to read lock on logfile");
 
-    lseek(program_state.logfile,
-          program_state.end_of_gamestate_location, SEEK_SET);
+    log_seek(program_state.logfile,
+              program_state.end_of_gamestate_location, SEEK_SET);
 
-    logline = lgetline_malloc(program_state.logfile);
+    logline = lgetline(program_state.logfile);
 
     if (!change_fd_lock(program_state.logfile, TRUE, LT_MONITOR, 2))
         panic("Could not downgrade to monitor lock on logfile");
@@ -1477,9 +1927,7 @@ start_replaying_logfile(char firstchar)
     if (logline && firstchar && firstchar != *logline) {
         /* Desync: the log contains one sort of input, but the engine is
            requesting another. */
-        char c = *logline;
-        free(logline);
-        log_desync(c, firstchar);
+        log_desync(*logline, firstchar);
     }
 
     return logline;
@@ -1491,11 +1939,8 @@ log_want_replay(char firstchar)
     if (program_state.in_zero_time_command)
         return FALSE;         /* can happen while replaying */
 
-    char *logline = start_replaying_logfile(firstchar);
-    if (logline) {
-        free(logline);
+    if (start_replaying_logfile(firstchar))
         return TRUE;
-    }
 
     if (program_state.followmode == FM_REPLAY) {
         /* We can't continue through the normal codepath. Let the client
@@ -1571,8 +2016,6 @@ log_replay_bones(struct memfile *mf)
 
     stop_replaying_logfile();
 
-    free(logline);
-
     return TRUE;
 }
 
@@ -1618,10 +2061,8 @@ log_replay_input(int count, const char *fmt, ...)
     /* Does the format line parse all the characters in logline? */
     actual_count = -1;
     sscanf(logline, fmtbuf, &actual_count);
-    if (strlen(logline) != actual_count) {
-        free(logline);
+    if (strlen(logline) != actual_count)
         return FALSE;
-    }
 
     /* OK, now make sure there's enough input in logline to assign to all
        the arguments. */
@@ -1629,8 +2070,6 @@ log_replay_input(int count, const char *fmt, ...)
     actual_count = vsscanf(logline, fmt, vargs);
     va_end(vargs);
 
-    free(logline);
-
     if (count != actual_count)
         return FALSE;
 
@@ -1653,8 +2092,6 @@ log_replay_line(const char **buf)
 
     stop_replaying_logfile();
 
-    free(logline);
-
     return TRUE;
 }
 
@@ -1699,19 +2136,15 @@ log_replay_menu(boolean isobjmenu, void *el)
 
         if (*lp == ',') {
 
-            if (!isobjmenu) {
-                free(logline);
+            if (!isobjmenu)
                 error_reading_save("non-obj menu has counts\n");
-            }
 
             lp++;
             count = parse_decimal_number(&lp);
         }
 
-        if (*lp != ':' && *lp) {
-            free(logline);
+        if (*lp != ':' && *lp)
             error_reading_save("bad number format in menu\n");
-        }
 
         if (isobjmenu) {
             orl = xrealloc(&turnstate.message_chain, orl,
@@ -1730,8 +2163,6 @@ log_replay_menu(boolean isobjmenu, void *el)
 
     stop_replaying_logfile();
 
-    free(logline);
-
     if (isobjmenu)
         *objresultlist = orl;
     else
@@ -1759,11 +2190,8 @@ log_replay_command(struct nh_cmd_and_arg *cmd)
                 return FALSE;
         }
 
-        if (*logline < 'a' || *logline > 'z') {
-            c = *logline;
-            free(logline);
-            log_desync(c, 'a');
-        }
+        if (*logline < 'a' || *logline > 'z')
+            log_desync(*logline, 'a');
     }
 
     program_state.eof_reached = FALSE;
@@ -1791,10 +2219,8 @@ log_replay_command(struct nh_cmd_and_arg *cmd)
         case 'P':
             cmd->arg.argtype |= CMD_ARG_POS;
             cmd->arg.pos.x = parse_decimal_number(&lp);
-            if (*(lp++) != ',') {
-                free(logline);
+            if (*(lp++) != ',')
                 error_reading_save("No comma in position argument\n");
-            }
             cmd->arg.pos.y = parse_decimal_number(&lp);
             break;
 
@@ -1831,15 +2257,12 @@ log_replay_command(struct nh_cmd_and_arg *cmd)
             break;
 
         default:
-            free(logline);
             error_reading_save("Unrecognised command argument\n");
         }
     }
 
     stop_replaying_logfile();
 
-    free(logline);
-
     return TRUE;
 }
 
@@ -1849,7 +2272,7 @@ log_replay_command(struct nh_cmd_and_arg *cmd)
 noreturn void
 log_replay_no_more_options(void)
 {
-    free(start_replaying_logfile(0));
+    start_replaying_logfile(0);
     log_desync('?', '?');
 }
 
@@ -1869,36 +2292,32 @@ read_log_header(int fd, struct nh_game_info *si,
     if (do_locking && !change_fd_lock(fd, FALSE, LT_READ, 1))
         return LS_IN_PROGRESS;
 
-    lseek(fd, 0, SEEK_SET);
-    logline = lgetline_malloc(fd);
+    log_seek(fd, 0, SEEK_SET);
+    logline = lgetline(fd);
     if (!logline)
         goto invalid_log;
 
     if (sscanf(logline, "NHGAME %" STATUS_LEN_STR "s %8x %d.%3d.%3d", statusbuf,
                recovery_count, &version_major, &version_minor,
                &version_patchlevel) != 5)
-        goto invalid_logline;
-
-    free(logline);
+        goto invalid_log;
 
     if ((result = status_from_string(statusbuf)) == LS_INVALID)
         goto invalid_log;
 
-    logline = lgetline_malloc(fd);
+    logline = lgetline(fd);
     if (!logline)
         goto invalid_log;
 
     if (strlen(logline) != SECOND_LOGLINE_LEN)
-        goto invalid_logline;
+        goto invalid_log;
 
     p = logline;
     while (*p == ' ')
         p++;
     strcpy(si->game_state, p);
 
-    free(logline);
-
-    logline = lgetline_malloc(fd);
+    logline = lgetline(fd);
     if (!logline)
         goto invalid_log;
 
@@ -1909,20 +2328,18 @@ read_log_header(int fd, struct nh_game_info *si,
     if (sscanf(logline, "%*x %*x %d %64s %6s %6s %6s %6s",
                &playmode, namebuf, si->plrole, si->plrace,
                si->plgend, si->plalign) != 6)
-        goto invalid_logline;
-
-    free(logline);
+        goto invalid_log;
 
     si->playmode = playmode;
     base64_decode(namebuf, si->name, sizeof (si->name));
 
+    discard_log_read_buffer(fd);
     if (do_locking)
         change_fd_lock(fd, FALSE, LT_NONE, 0);
     return result;
 
-invalid_logline:
-    free(logline);
 invalid_log:
+    discard_log_read_buffer(fd);
     if (do_locking)
         change_fd_lock(fd, FALSE, LT_NONE, 0);
     return LS_INVALID;
@@ -1960,9 +2377,9 @@ load_gamestate_from_binary_save(boolean maybe_old_version)
 
     /* Load the saved game. */
     program_state.gamestate_location = program_state.binary_save_location;
-    lseek(program_state.logfile, program_state.binary_save_location,
-          SEEK_SET);
-    free(lgetline_malloc(program_state.logfile));
+    log_seek(program_state.logfile, program_state.binary_save_location,
+              SEEK_SET);
+    lgetline(program_state.logfile);
     program_state.end_of_gamestate_location = get_log_offset();
 
     freedynamicdata();
@@ -1986,9 +2403,9 @@ load_gamestate_from_binary_save(boolean maybe_old_version)
         /* To recover from this, we need to go back to the binary save before
            the one we were trying to load. log_sync rounds down. */
         log_sync(program_state.binary_save_location - 1, TLU_BYTES, TRUE);
-        lseek(program_state.logfile, program_state.binary_save_location,
-              SEEK_SET);
-        free(lgetline_malloc(program_state.logfile));
+        log_seek(program_state.logfile, program_state.binary_save_location,
+                  SEEK_SET);
+        lgetline(program_state.logfile);
         log_recover_noreturn(get_log_offset(), mequal_message,
                              __FILE__, __LINE__);
     }
@@ -1997,6 +2414,7 @@ load_gamestate_from_binary_save(boolean maybe_old_version)
     mfree(&program_state.binary_save);
     program_state.binary_save = mf;
     program_state.ok_to_diff = TRUE;
+    program_state.last_save_verification = moves;
 }
 
 static noreturn void
@@ -2038,12 +2456,30 @@ apply_save_diff(char *s, struct memfile *diff_base)
     free(buf);
 }
 
+/* Splits a save backup line into the save and its save line index record (if
+   any), returning the record. The save itself never contains spaces, so the
+   first space after the header is the start of the record. */
+static const char *
+split_save_backup_line(char *s)
+{
+    char *record;
+
+    /* The header is '*', an 8 digit hex number, and ' ', = 10 bytes. */
+    record = strchr(s + 10, ' ');
+    if (!record)
+        return NULL;
+    *record = '\0';
+    return record + 1;
+}
+
 /* Decodes the given string into program_state.binary_save. The caller should
    check that the string actually is a representation of a save backup, and is
-   responsible for fixing the invariants on program_state. */
-static void
+   responsible for fixing the invariants on program_state. Returns the save
+   line index record from the end of the line, or NULL if it has none. */
+static const char *
 load_save_backup_from_string(char *s)
 {
+    const char *record;
     void *mp;
     long len;
 
@@ -2052,12 +2488,14 @@ load_save_backup_from_string(char *s)
     mnew(&program_state.binary_save, NULL);
     program_state.binary_save_allocated = TRUE;
 
-    /* The header is '*', an 8 digit hex number, and ' ', = 10 bytes. */
+    record = split_save_backup_line(s);
     s += 10;
     len = base64_strlen(s);
 
     mp = mmmap(&program_state.binary_save, len, 0);
     base64_decode(s, mp, len);
+
+    return record;
 }
 
 /* Sets the binary save and save backup locations from the argument (which
@@ -2069,18 +2507,21 @@ static void
 load_save_backup_from_offset(long offset)
 {
     char *logline;
+    const char *record;
 
     program_state.binary_save_location = offset;
     program_state.save_backup_location = offset;
 
-    lseek(program_state.logfile, offset, SEEK_SET);
-    logline = lgetline_malloc(program_state.logfile);
+    log_seek(program_state.logfile, offset, SEEK_SET);
+    logline = lgetline(program_state.logfile);
 
     if (!logline)
         error_reading_save("EOF when reading save backup\n");
 
-    load_save_backup_from_string(logline);
-    free(logline);
+    record = load_save_backup_from_string(logline);
+
+    index_save_line(offset, binary_save_moves(), TRUE);
+    index_save_line_record(offset, logline, record);
 }
 
 /* Checks to see if a save backup exists at a given file location. Returns -1 if
@@ -2098,7 +2539,7 @@ get_save_backup_offset(long offset)
     if (!change_fd_lock(program_state.logfile, TRUE, LT_READ, 2))
         panic("Could not upgrade to read lock on logfile");
 
-    if (lseek(program_state.logfile, offset, SEEK_SET) < 0)
+    if (log_seek(program_state.logfile, offset, SEEK_SET) < 0)
         goto cleanup;
 
     /* Read the save backup header. */
@@ -2121,7 +2562,7 @@ get_save_backup_offset(long offset)
         rv = sbloc;
 
 cleanup:
-    lseek(program_state.logfile, oldoffset, SEEK_SET);
+    log_seek(program_state.logfile, oldoffset, SEEK_SET);
 
     if (!change_fd_lock(program_state.logfile, TRUE, LT_MONITOR, 2))
         panic("Could not downgrade to monitor lock on logfile");
@@ -2129,6 +2570,29 @@ cleanup:
     return rv;
 }
 
+/* Returns the turn counter stored in a binary save, or -1 if the binary save is
+   from the wrong version. Leaves the memfile pointer in its original
+   location. */
+static long
+save_moves(struct memfile *mf)
+{
+    long temp_pos = mf->pos;
+    long rv = -1;
+
+    mf->pos = 0;
+    if (uptodate(mf, NULL))
+        rv = mread32(mf);
+    mf->pos = temp_pos;
+
+    return rv;
+}
+
+static long
+binary_save_moves(void)
+{
+    return save_moves(&program_state.binary_save);
+}
+
 /* Returns positive if the binary save is ahead of the target location, negative
    if the binary save is behind the target location, zero if they're the
    same. The argument is the binary save location; while the invariants hold,
@@ -2144,13 +2608,12 @@ cleanup:
 static long
 relative_to_target(long bsl, long targetpos, enum target_location_units tlu)
 {
-    long temp_pos = program_state.binary_save.pos;
     long curv;
 
     switch (tlu) {
 
     case TLU_EOF:
-        targetpos = lseek(program_state.logfile, 0, SEEK_END);
+        targetpos = log_seek(program_state.logfile, 0, SEEK_END);
         /* fall through */
     case TLU_BYTES:
         curv = bsl;
@@ -2158,13 +2621,10 @@ relative_to_target(long bsl, long targetpos, enum target_location_units tlu)
 
     case TLU_TURNS:
 
-        program_state.binary_save.pos = 0;
-        if (!uptodate(&program_state.binary_save, NULL))
+        curv = binary_save_moves();
+        if (curv < 0)
             error_reading_save(
                 "binary save is from the wrong version of NetHack\n");
-
-        curv = mread32(&program_state.binary_save);
-        program_state.binary_save.pos = temp_pos;
         break;
 
     default:
@@ -2174,6 +2634,583 @@ relative_to_target(long bsl, long targetpos, enum target_location_units tlu)
     return curv - targetpos;
 }
 
+/* Returns TRUE if log_sync() has to go back from the binary save to reach the
+   target. Several save lines can be from the same turn, and a target in turns
+   means the first of them, so being on the target turn isn't enough: moving
+   back and then forwards again finds the same line whichever line we started
+   from (and whether we start from a save backup or a checkpoint). */
+static boolean
+ahead_of_target(long bsl, long targetpos, enum target_location_units tlu)
+{
+    long rel = relative_to_target(bsl, targetpos, tlu);
+
+    return rel > 0 || (rel == 0 && tlu == TLU_TURNS);
+}
+
+/***** Save line index *****/
+
+/* log_sync() needs to find save backups and diffs in the log, and to know
+   which turn each save backup is from. Finding that out requires reading
+   through the log, and decoding the save backups. So we remember what we've
+   learned about each save line, allowing later calls to log_sync() to go
+   directly to the right save backup, and from each save line to the next.
+
+   The index is rebuilt lazily, by log_sync() and by the code that writes save
+   lines; it's only an optimization, and anything in it that doesn't match the
+   log is discarded. It's sorted by offset.
+
+   So that a process loading the game doesn't have to start from nothing, the
+   index is also kept in the log itself: each save backup apart from the first
+   ends with a record of the save lines since the previous save backup (see
+   doc/saves.txt). Records are read along with the save backups they're on,
+   and checked against the log before they're used; a record that's missing or
+   doesn't match is ignored, and that part of the index is rebuilt the slow
+   way. */
+struct save_line_info {
+    long offset;        /* location of the save line in the log */
+    long next;          /* location of the next save line, 0 if unknown */
+    long moves;         /* turn counter in the save, -1 if unknown */
+    boolean backup;     /* save backup rather than save diff */
+};
+static struct save_line_info *save_line_index = NULL;
+static int save_line_index_count = 0;
+static int save_line_index_size = 0;
+
+/* Returns the index of the first entry at or after offset. */
+static int
+save_line_index_search(long offset)
+{
+    int lo = 0, hi = save_line_index_count;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (save_line_index[mid].offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static struct save_line_info *
+find_save_line(long offset)
+{
+    int i = save_line_index_search(offset);
+
+    if (i < save_line_index_count && save_line_index[i].offset == offset)
+        return save_line_index + i;
+    return NULL;
+}
+
+static void
+index_save_line(long offset, long moves, boolean backup)
+{
+    struct save_line_info *sli = find_save_line(offset);
+    int i;
+
+    if (!sli) {
+        if (save_line_index_count == save_line_index_size) {
+            save_line_index_size = save_line_index_size ?
+                save_line_index_size * 2 : 256;
+            save_line_index = realloc(save_line_index, save_line_index_size *
+                                      sizeof (struct save_line_info));
+        }
+
+        /* Save lines are usually indexed in order, so this rarely moves
+           anything. */
+        i = save_line_index_search(offset);
+        memmove(save_line_index + i + 1, save_line_index + i,
+                (save_line_index_count - i) * sizeof (struct save_line_info));
+        save_line_index_count++;
+
+        sli = save_line_index + i;
+        sli->offset = offset;
+        sli->next = 0;
+
+        /* A newly found save line might be between a line and what we thought
+           was its next line. */
+        if (i > 0 && save_line_index[i - 1].next > offset)
+            save_line_index[i - 1].next = 0;
+    }
+    sli->moves = moves;
+    sli->backup = backup;
+}
+
+/* Records that the save line after the one at offset is at next. */
+static void
+link_save_line(long offset, long next)
+{
+    struct save_line_info *sli = find_save_line(offset);
+
+    if (sli)
+        sli->next = next;
+}
+
+/* Forgets everything about the log from offset onwards (because it was
+   truncated, or because the index turned out not to match it). */
+static void
+truncate_save_line_index(long offset)
+{
+    int i;
+
+    save_line_index_count = save_line_index_search(offset);
+    for (i = 0; i < save_line_index_count; i++)
+        if (save_line_index[i].next >= offset)
+            save_line_index[i].next = 0;
+
+    truncate_save_checkpoints(offset);
+}
+
+static void
+free_save_line_index(void)
+{
+    free(save_line_index);
+    save_line_index = NULL;
+    save_line_index_count = save_line_index_size = 0;
+
+    free_save_checkpoints();
+}
+
+/* Returns the last save backup in the index that's known not to be after the
+   target location, or NULL if there isn't one. The index is in log order, which
+   is also turn order, so we binary search for the first line past the target,
+   then step back to the nearest backup before it. (For a target in turns, a
+   line on the target turn counts as past it; see ahead_of_target().) */
+static const struct save_line_info *
+best_indexed_save_backup(long target_location, enum target_location_units tlu)
+{
+    int i, lo, hi;
+
+    if (tlu == TLU_EOF || target_location == LONG_MAX)
+        i = save_line_index_count;
+    else if (tlu == TLU_BYTES)
+        i = save_line_index_search(target_location + 1);
+    else {
+        lo = 0;
+        hi = save_line_index_count;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+
+            if (save_line_index[mid].moves < target_location)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        i = lo;
+    }
+
+    while (i-- > 0) {
+        const struct save_line_info *sli = save_line_index + i;
+
+        if (sli->backup && (tlu != TLU_TURNS ||
+                            (sli->moves >= 0 && sli->moves < target_location)))
+            return sli;
+    }
+    return NULL;
+}
+
+/* Writes the index record for the save backup being written: the save lines
+   from prev_backup up to last_line, which is the save line just before the
+   save backup. The record is only written if the index knows about every one of
+   those lines; otherwise, it's left out, and readers rebuild that part of the
+   index from the log. */
+static void
+log_save_line_record(long prev_backup, long last_line)
+{
+    const struct save_line_info *sli = find_save_line(prev_backup);
+    long prev_offset, prev_moves;
+    char *record;
+    int count = 0, len;
+
+    if (!sli || !sli->backup)
+        return;
+
+    while (sli->offset != last_line) {
+        if (sli->moves < 0 || !sli->next)
+            return;
+        sli = find_save_line(sli->next);
+        if (!sli || sli->backup)
+            return;
+        count++;
+    }
+    if (sli->moves < 0)
+        return;
+
+    /* Each line takes at most two 16-digit numbers, and two separators. */
+    record = malloc(count * 34 + 20);
+    if (!record)
+        panic("Out of memory writing save line index record");
+
+    sli = find_save_line(prev_backup);
+    len = sprintf(record, " #%lx", sli->moves);
+    prev_offset = sli->offset;
+    prev_moves = sli->moves;
+    while (sli->offset != last_line) {
+        sli = find_save_line(sli->next);
+        if (sli->moves < prev_moves) {
+            free(record);
+            return;
+        }
+        len += sprintf(record + len, ":%lx,%lx", sli->offset - prev_offset,
+                       sli->moves - prev_moves);
+        prev_offset = sli->offset;
+        prev_moves = sli->moves;
+    }
+
+    if (!full_write(program_state.logfile, record, len))
+        panic("Could not write save line index record to the log.");
+    free(record);
+}
+
+/* Parses the index record from the save backup at offset (logline is the line
+   itself, for its header). Returns the number of save lines in it, with the
+   lines themselves in *lines (to be freed by the caller), or 0 if the record is
+   missing or malformed. */
+static int
+parse_save_line_record(long offset, const char *logline, const char *record,
+                       struct save_line_info **lines)
+{
+    struct save_line_info *l;
+    const char *p;
+    char *end;
+    long prev_backup, o, m, d, dm;
+    int count, size;
+
+    if (!record || *record != '#')
+        return 0;
+
+    /* The record starts from the previous save backup, which the header of
+       this one points to. (The first save backup's header has something else
+       there, but it's after the save backup, so it gets rejected here.) */
+    prev_backup = strtol(logline + 1, &end, 16);
+    if (end != logline + 9 || prev_backup <= 0 || prev_backup >= offset)
+        return 0;
+    m = strtol(record + 1, &end, 16);
+    if (end == record + 1 || m < 0)
+        return 0;
+
+    size = 64;
+    l = malloc(size * sizeof (struct save_line_info));
+    if (!l)
+        panic("Out of memory reading save line index record");
+    l[0].offset = o = prev_backup;
+    l[0].moves = m;
+    l[0].backup = TRUE;
+    count = 1;
+
+    while (*end == ':') {
+        p = end + 1;
+        d = strtol(p, &end, 16);
+        if (end == p || *end != ',' || d <= 0)
+            goto malformed;
+        p = end + 1;
+        dm = strtol(p, &end, 16);
+        if (end == p || dm < 0 || d >= offset - o || dm > LONG_MAX - m)
+            goto malformed;
+
+        o += d;
+        m += dm;
+
+        if (count == size) {
+            size *= 2;
+            l = realloc(l, size * sizeof (struct save_line_info));
+            if (!l)
+                panic("Out of memory reading save line index record");
+        }
+        l[count].offset = o;
+        l[count].moves = m;
+        l[count].backup = FALSE;
+        l[count - 1].next = o;
+        count++;
+    }
+    if (*end)
+        goto malformed;
+    l[count - 1].next = offset;
+
+    *lines = l;
+    return count;
+
+malformed:
+    free(l);
+    return 0;
+}
+
+/* Checks that the log has a save line of the given type ('*' or '~') starting
+   at offset. */
+static boolean
+is_save_line_at(long offset, char type)
+{
+    char buf[2];
+
+    if (log_seek(program_state.logfile, offset - 1, SEEK_SET) < 0)
+        return FALSE;
+    return full_read(program_state.logfile, buf, 2) &&
+        buf[0] == '\x0a' && buf[1] == type;
+}
+
+/* Adds the save lines from the index record of the save backup at offset to
+   the index, as long as the record matches both the log and what the index
+   already knows. The caller must hold a read lock on the log; the log file
+   pointer is left where it was. */
+static void
+index_save_line_record(long offset, const char *logline, const char *record)
+{
+    struct save_line_info *lines;
+    const struct save_line_info *sli;
+    long oldoffset;
+    int count, i;
+    boolean ok = TRUE;
+
+    count = parse_save_line_record(offset, logline, record, &lines);
+    if (!count)
+        return;
+
+    oldoffset = get_log_offset();
+
+    for (i = 0; i < count && ok; i++) {
+        sli = find_save_line(lines[i].offset);
+        if (sli)
+            ok = sli->backup == lines[i].backup &&
+                (sli->moves < 0 || sli->moves == lines[i].moves);
+        else
+            ok = is_save_line_at(lines[i].offset,
+                                 lines[i].backup ? '*' : '~');
+    }
+
+    log_seek(program_state.logfile, oldoffset, SEEK_SET);
+
+    if (ok)
+        for (i = 0; i < count; i++) {
+            index_save_line(lines[i].offset, lines[i].moves, lines[i].backup);
+            link_save_line(lines[i].offset, lines[i].next);
+        }
+    free(lines);
+}
+
+/* Returns TRUE if the save line is known to be after the target location. */
+static boolean
+save_line_past_target(const struct save_line_info *sli, long target_location,
+                      enum target_location_units tlu)
+{
+    if (tlu == TLU_BYTES)
+        return sli->offset > target_location;
+    if (tlu == TLU_TURNS)
+        return sli->moves >= target_location;
+    return FALSE;
+}
+
+/* Extends the index backwards until it reaches the target location, using the
+   index records on save backups. This only needs to read the save backups, not
+   decode them, so it's much faster than going back through them one by one in
+   log_sync(). It stops early if it finds a save backup without a usable
+   record; log_sync() will then have to do things the slow way. */
+static void
+extend_save_line_index(long target_location, enum target_location_units tlu)
+{
+    long first;
+    char *logline;
+
+    while (save_line_index_count && save_line_index[0].backup &&
+           save_line_past_target(save_line_index, target_location, tlu)) {
+        first = save_line_index[0].offset;
+
+        log_seek(program_state.logfile, first, SEEK_SET);
+        logline = lgetline(program_state.logfile);
+        if (!logline || *logline != '*')
+            break;
+        index_save_line_record(first, logline,
+                               split_save_backup_line(logline));
+
+        if (save_line_index[0].offset == first)
+            break;
+    }
+}
+
+/* For the unit tests: forgets the save line index, as though the log had just
+   been opened by a new process. */
+void
+log_forget_save_line_index(void)
+{
+    free_save_line_index();
+    discard_log_read_buffer(-1);
+}
+
+/* For the unit tests: looks up the save line at offset in the index, returning
+   FALSE if it isn't there. */
+boolean
+log_save_line_indexed(long offset, long *moves, long *next)
+{
+    const struct save_line_info *sli = find_save_line(offset);
+
+    if (!sli)
+        return FALSE;
+    *moves = sli->moves;
+    *next = sli->next;
+    return TRUE;
+}
+
+/***** Save checkpoints *****/
+
+/* When replaying a game, moving backwards means going back to a save backup and
+   applying save diffs from there, so stepping back one turn at a time would
+   take time proportional to the distance from the last save backup, for each
+   step. To avoid this, in replay mode, we hold on to some of the binary saves
+   we decode (rather than freeing them), and log_sync() can start from one of
+   those rather than a save backup.
+
+   The amount of memory used for this is limited to NH4REPLAYCACHE megabytes
+   (default 32, 0 to disable; a "k" suffix gives the size in kilobytes
+   instead), with the least recently used checkpoints being discarded first.
+   Like the save line index, this is invalidated from any point where the log
+   gets truncated. */
+struct save_checkpoint {
+    long offset;        /* location of the save line in the log */
+    long backup;        /* save backup location that goes with it */
+    long moves;         /* turn counter in the save */
+    unsigned long last_used;
+    struct memfile save;
+};
+static struct save_checkpoint *save_checkpoints = NULL;
+static int save_checkpoint_count = 0;
+static int save_checkpoint_size = 0;
+static long save_checkpoint_memory = 0;
+static long save_checkpoint_memory_limit = 0;
+static unsigned long save_checkpoint_clock = 0;
+
+static void
+log_init_save_checkpoints(void)
+{
+    const char *rc = nh_getenv("NH4REPLAYCACHE");
+    char *unit = NULL;
+
+    save_checkpoint_memory_limit = 32;
+    if (rc && *rc)
+        save_checkpoint_memory_limit = strtol(rc, &unit, 10);
+    if (save_checkpoint_memory_limit < 0)
+        save_checkpoint_memory_limit = 0;
+    save_checkpoint_memory_limit *= 1024L;
+    if (!unit || (*unit != 'k' && *unit != 'K'))
+        save_checkpoint_memory_limit *= 1024L;
+}
+
+static void
+remove_save_checkpoint(int i)
+{
+    save_checkpoint_memory -= save_checkpoints[i].save.len;
+    mfree(&save_checkpoints[i].save);
+    save_checkpoints[i] = save_checkpoints[--save_checkpoint_count];
+}
+
+/* Takes ownership of mf, the decoded binary save for the save line at offset,
+   either keeping it as a checkpoint or freeing it. */
+static void
+checkpoint_save_line(long offset, long backup, struct memfile *mf)
+{
+    struct save_checkpoint *cp;
+    int i, lru;
+
+    if (program_state.followmode != FM_REPLAY ||
+        mf->len > save_checkpoint_memory_limit) {
+        mfree(mf);
+        return;
+    }
+
+    for (i = 0; i < save_checkpoint_count; i++) {
+        if (save_checkpoints[i].offset == offset) {
+            save_checkpoints[i].last_used = ++save_checkpoint_clock;
+            mfree(mf);
+            return;
+        }
+    }
+
+    while (save_checkpoint_memory + mf->len > save_checkpoint_memory_limit) {
+        lru = 0;
+        for (i = 1; i < save_checkpoint_count; i++)
+            if (save_checkpoints[i].last_used < save_checkpoints[lru].last_used)
+                lru = i;
+        remove_save_checkpoint(lru);
+    }
+
+    if (save_checkpoint_count == save_checkpoint_size) {
+        save_checkpoint_size = save_checkpoint_size ?
+            save_checkpoint_size * 2 : 16;
+        save_checkpoints = realloc(save_checkpoints, save_checkpoint_size *
+                                   sizeof (struct save_checkpoint));
+    }
+
+    cp = save_checkpoints + save_checkpoint_count++;
+    cp->offset = offset;
+    cp->backup = backup;
+    cp->moves = save_moves(mf);
+    cp->last_used = ++save_checkpoint_clock;
+    cp->save = *mf;
+    mtrim(&cp->save);
+    save_checkpoint_memory += cp->save.len;
+}
+
+/* Returns the last checkpoint that's not after the target location, or NULL if
+   there isn't one. As with the index, a checkpoint on the target turn is after
+   a target in turns. */
+static struct save_checkpoint *
+best_save_checkpoint(long target_location, enum target_location_units tlu)
+{
+    struct save_checkpoint *best = NULL;
+    int i;
+
+    if (tlu == TLU_EOF)
+        target_location = LONG_MAX;
+
+    for (i = 0; i < save_checkpoint_count; i++) {
+        struct save_checkpoint *cp = save_checkpoints + i;
+
+        if (tlu == TLU_TURNS ? cp->moves < 0 || cp->moves >= target_location
+            : cp->offset > target_location)
+            continue;
+        if (!best || cp->offset > best->offset)
+            best = cp;
+    }
+    return best;
+}
+
+/* Sets the binary save, and its location and save backup location, from a
+   checkpoint. Like load_save_backup_from_offset, this doesn't touch the
+   gamestate. */
+static void
+restore_save_checkpoint(struct save_checkpoint *cp)
+{
+    if (program_state.binary_save_allocated)
+        mfree(&program_state.binary_save);
+    mclone(&program_state.binary_save, &cp->save);
+    program_state.binary_save_allocated = TRUE;
+
+    program_state.binary_save_location = cp->offset;
+    program_state.save_backup_location = cp->backup;
+    cp->last_used = ++save_checkpoint_clock;
+}
+
+static void
+truncate_save_checkpoints(long offset)
+{
+    int i = 0;
+
+    while (i < save_checkpoint_count) {
+        if (save_checkpoints[i].offset >= offset)
+            remove_save_checkpoint(i);
+        else
+            i++;
+    }
+}
+
+static void
+free_save_checkpoints(void)
+{
+    while (save_checkpoint_count)
+        remove_save_checkpoint(save_checkpoint_count - 1);
+    free(save_checkpoints);
+    save_checkpoints = NULL;
+    save_checkpoint_size = 0;
+}
+
 /*
  * Fastforwards/rewinds the gamestate to the target location.
  *
@@ -2275,12 +3312,42 @@ log_sync(long target_location, enum target_location_units tlu,
 
     }
 
+    /* If we have to go back, see how far back the records in the log let us
+       extend the index first. */
+    if (ahead_of_target(program_state.binary_save_location,
+                        target_location, tlu))
+        extend_save_line_index(target_location, tlu);
+
+    /* If the index knows of a save backup that's at or before the target, and
+       either we're ahead of the target or it's closer to the target than we
+       are, go straight there. */
+    const struct save_line_info *best =
+        best_indexed_save_backup(target_location, tlu);
+    if (best && best->offset != program_state.binary_save_location &&
+        (best->offset > program_state.binary_save_location ||
+         ahead_of_target(program_state.binary_save_location,
+                         target_location, tlu))) {
+        if (get_save_backup_offset(best->offset) >= 0)
+            load_save_backup_from_offset(best->offset);
+        else
+            truncate_save_line_index(best->offset);
+    }
+
+    /* Likewise for checkpoints, which can be much closer to the target than
+       the nearest save backup. */
+    struct save_checkpoint *cp = best_save_checkpoint(target_location, tlu);
+    if (cp && cp->offset != program_state.binary_save_location &&
+        (cp->offset > program_state.binary_save_location ||
+         ahead_of_target(program_state.binary_save_location,
+                         target_location, tlu)))
+        restore_save_checkpoint(cp);
+
     /* If we're ahead of the target, move back to the last save backup (because
        we can't run save diffs backwards, our only choice is to move forwards
        from the save backup location). */
     if (program_state.binary_save_location != program_state.save_backup_location
-        && relative_to_target(program_state.binary_save_location,
-                              target_location, tlu) > 0) {
+        && ahead_of_target(program_state.binary_save_location,
+                           target_location, tlu)) {
 
         load_save_backup_from_offset(program_state.save_backup_location);
     }
@@ -2288,8 +3355,8 @@ log_sync(long target_location, enum target_location_units tlu,
     /* While we're still ahead of the target, try progressively earlier
        backups. */
     last_sloc = -1;
-    while (relative_to_target(program_state.binary_save_location,
-                              target_location, tlu) > 0 &&
+    while (ahead_of_target(program_state.binary_save_location,
+                           target_location, tlu) &&
            program_state.save_backup_location >
            program_state.last_save_backup_location_location) {
 
@@ -2301,12 +3368,9 @@ log_sync(long target_location, enum target_location_units tlu,
     }
 
     /* If we're behind the target, move forwards until we're at or ahead of the
-       target, via adding together diffs.
-
-       TODO: We could increase the loading speed via caching the end location of
-       the save diff / backup, rather than skipping it each time round the
-       loop. That isn't implemented yet in order to start off by getting the
-       simplest possible version of the code working. */
+       target, via adding together diffs. The save line index remembers where
+       each save line is followed by the next, so that we only have to search
+       for it the first time. */
     sloc = program_state.binary_save_location;
     long loadamt;
     long orig_loadamt = 0;
@@ -2322,18 +3386,33 @@ log_sync(long target_location, enum target_location_units tlu,
             last_load_progress_time = now;
         }
 
-        lseek(program_state.logfile, sloc, SEEK_SET);
-        /* Skip the save diff or backup itself. */
-        free(lgetline_malloc(program_state.logfile));
-
-        /* Look for the next save diff or backup line. */
-        for ((loglineloc = get_log_offset()),
-                 (logline = lgetline_malloc(program_state.logfile));
-             logline;
-             free(logline), (loglineloc = get_log_offset()),
-                 (logline = lgetline_malloc(program_state.logfile))) {
-            if (*logline == '*' || *logline == '~')
-                break;
+        /* If we know where the next save line is, go straight there. */
+        const struct save_line_info *sli = find_save_line(sloc);
+        logline = NULL;
+        if (sli && sli->next) {
+            loglineloc = sli->next;
+            log_seek(program_state.logfile, loglineloc, SEEK_SET);
+            logline = lgetline(program_state.logfile);
+            if (!logline || (*logline != '*' && *logline != '~')) {
+                logline = NULL;
+                truncate_save_line_index(sloc + 1);
+            }
+        }
+
+        if (!logline) {
+            log_seek(program_state.logfile, sloc, SEEK_SET);
+            /* Skip the save diff or backup itself. */
+            lgetline(program_state.logfile);
+
+            /* Look for the next save diff or backup line. */
+            for ((loglineloc = get_log_offset()),
+                     (logline = lgetline(program_state.logfile));
+                 logline;
+                 (loglineloc = get_log_offset()),
+                     (logline = lgetline(program_state.logfile))) {
+                if (*logline == '*' || *logline == '~')
+                    break;
+            }
         }
 
         if (!logline) {
@@ -2353,14 +3432,22 @@ log_sync(long target_location, enum target_location_units tlu,
         bsave = program_state.binary_save;
         program_state.binary_save_allocated = FALSE;
 
-        if (*logline == '*') {
+        const char *record = NULL;
+        boolean backup = *logline == '*';
+
+        if (backup) {
             /* This is a save backup. */
-            load_save_backup_from_string(logline);
+            record = load_save_backup_from_string(logline);
         } else if (*logline == '~') {
             /* This is a save diff. */
             apply_save_diff(logline, &bsave);
         }
 
+        index_save_line(loglineloc, binary_save_moves(), backup);
+        link_save_line(sloc, loglineloc);
+        if (backup)
+            index_save_line_record(loglineloc, logline, record);
+
         if (relative_to_target(loglineloc, target_location, tlu) > 0) {
 
             /* We overshot. */
@@ -2369,8 +3456,9 @@ log_sync(long target_location, enum target_location_units tlu,
             if (!program_state.binary_save_allocated) /* should never happen */
                 panic("overshoot in log_sync but no binary save present");
 
-            free(logline);
-            mfree(&program_state.binary_save);
+            checkpoint_save_line(loglineloc, backup ? loglineloc :
+                                 program_state.save_backup_location,
+                                 &program_state.binary_save);
             program_state.binary_save = bsave;
 
             if (!inconsistent)
@@ -2381,15 +3469,14 @@ log_sync(long target_location, enum target_location_units tlu,
 
         } else {
 
-            /* We didn't overshoot: set the locations to match this new save. */
+            /* We didn't overshoot: set the locations to match this new
+               save. */
+            checkpoint_save_line(sloc, program_state.save_backup_location,
+                                 &bsave);
             sloc = program_state.binary_save_location = loglineloc;
-            if (*logline == '*')
+            if (backup)
                 program_state.save_backup_location = loglineloc;
-
-            mfree(&bsave);
         }
-
-        free(logline);
     }
 
     /* Fix the invariant on the gamestate. */
@@ -2425,10 +3512,10 @@ log_replay_save_line(void)
         if (!change_fd_lock(program_state.logfile, TRUE, LT_READ, 2))
             panic("Could not upgrade to read lock on logfile");
 
-        lseek(program_state.logfile,
-              program_state.end_of_gamestate_location, SEEK_SET);
+        log_seek(program_state.logfile,
+                  program_state.end_of_gamestate_location, SEEK_SET);
 
-        logline = lgetline_malloc(program_state.logfile);
+        logline = lgetline(program_state.logfile);
 
         if (!change_fd_lock(program_state.logfile, TRUE, LT_MONITOR, 2))
             panic("Could not downgrade to monitor lock on logfile");
@@ -2453,13 +3540,20 @@ log_replay_save_line(void)
         bsave = program_state.binary_save;
         program_state.binary_save_allocated = FALSE;
         apply_save_diff(logline, &bsave);
-        mfree(&bsave);
+        checkpoint_save_line(program_state.binary_save_location,
+                             program_state.save_backup_location, &bsave);
         program_state.binary_save_location =
             program_state.end_of_gamestate_location;
         load_gamestate_from_binary_save(TRUE);
 
     } else if (*logline == '*') {
 
+        if (program_state.binary_save_allocated) {
+            bsave = program_state.binary_save;
+            program_state.binary_save_allocated = FALSE;
+            checkpoint_save_line(program_state.binary_save_location,
+                                 program_state.save_backup_location, &bsave);
+        }
         load_save_backup_from_string(logline);
         program_state.binary_save_location =
             program_state.save_backup_location =
@@ -2472,8 +3566,6 @@ log_replay_save_line(void)
 
     }
 
-    free(logline);
-
     /* otherwise do nothing */
 }
 
@@ -2495,14 +3587,40 @@ log_reset(void)
     program_state.last_save_backup_location_location = 0;
     program_state.emergency_recover_location = 0;
     program_state.eof_reached = FALSE;
+
+    free_save_line_index();
+    discard_log_read_buffer(-1);
+}
+
+/* NH4SAVEVERIFY can be "full" (the default), "crc", "periodic" (check fully
+   only on save backups) or "periodic:N" (also check fully every N turns). */
+static void
+log_init_save_verification(void)
+{
+    const char *sv = nh_getenv("NH4SAVEVERIFY");
+
+    program_state.save_verification = SV_FULL;
+    program_state.save_verification_interval = 0;
+    program_state.last_save_verification = 0;
+
+    if (!sv)
+        return;
+
+    if (!strcmp(sv, "crc"))
+        program_state.save_verification = SV_CRC;
+    else if (!strncmp(sv, "periodic", 8) && (!sv[8] || sv[8] == ':')) {
+        program_state.save_verification = SV_PERIODIC;
+        if (sv[8] == ':' && atoi(sv + 9) > 0)
+            program_state.save_verification_interval = atoi(sv + 9);
+    }
 }
 
 void
 log_init(int logfd)
 {
     program_state.logfile = logfd;
-    program_state.logfile_watchers = NULL;
-    program_state.logfile_watcher_count = 0;
+    log_init_save_verification();
+    log_init_save_checkpoints();
 
     if (!change_fd_lock(logfd, TRUE, LT_MONITOR, 2)) {
         program_state.logfile = -1;
@@ -2518,10 +3636,6 @@ log_uninit(void)
     if (program_state.logfile > -1)
         change_fd_lock(program_state.logfile, TRUE, LT_NONE, 0);
 
-#ifdef AIMAKE_BUILDOS_linux
-    flush_logfile_watchers();
-#endif
-
     program_state.logfile = -1;
 
     /* We need to do this so that init_data doesn't leak memory when it's told
@@ -2533,6 +3647,16 @@ log_uninit(void)
         program_state.binary_save_allocated = 0;
     }
 
+    free_save_line_index();
+    free_log_read_buffer();
+
+    free(base64_zbuf);
+    base64_zbuf = NULL;
+    base64_zbuf_size = 0;
+    free(log_binary_buf);
+    log_binary_buf = NULL;
+    log_binary_bufsize = 0;
+
     /* just in case we have a badly-timed panic */
     program_state.emergency_recover_location = 0;
 }
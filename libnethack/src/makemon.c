@@ -74,6 +74,15 @@ newmonst(int extyp, int namelen)
     return mon;
 }
 
+/* Deallocates a monster. All monsters allocated with newmonst() should be
+   deallocated here. */
+void
+dealloc_monst(struct monst *mon)
+{
+    unindex_mid(mon);
+    free(mon);
+}
+
 
 boolean
 is_home_elemental(const struct d_level * dlev, const struct permonst * ptr)
@@ -3,6 +3,13 @@
 /* Copyright (c) Daniel Thaler, 2011.                             */
 /* NetHack may be freely redistributed.  See license for details. */
 
+/* The intrinsics headers must come before hack.h, as they use identifiers that
+   hack.h defines as macros. */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define MDIFF_SIMD
+# include <immintrin.h>
+#endif
+
 #include "hack.h"
 #define __STDC_FORMAT_MACROS
 #include <stdint.h>
@@ -117,17 +124,17 @@ mnew(struct memfile *mf, struct memfile *relativeto)
 
     mdiffwrite(mf, diffheader, 2);
 
-    for (i = 0; i < MEMFILE_HASHTABLE_SIZE; i++)
-        mf->tags[i] = 0;
-    mf->last_tag = 0;
+    /* the tag arrays are allocated on first use */
+    mf->tags = NULL;
+    mf->tagindex = NULL;
+    mf->tagcount = mf->tagsize = mf->tagindexsize = 0;
+    mf->last_tag = -1;
 }
 
 /* Allocates to as a deep copy of from. */
 void
 mclone(struct memfile *to, const struct memfile *from)
 {
-    int i;
-
     *to = *from;
 
     if (from->buf) {
@@ -139,42 +146,56 @@ mclone(struct memfile *to, const struct memfile *from)
         memcpy(to->diffbuf, from->diffbuf, from->difflen);
     }
 
-    for (i = 0; i < MEMFILE_HASHTABLE_SIZE; i++) {
-        struct memfile_tag *fromtag, **totag;
-
-        fromtag = from->tags[i];
-        totag = &(to->tags[i]);
-
-        while (fromtag) {
-            *totag = malloc(sizeof (struct memfile_tag));
-            **totag = *fromtag;
-            fromtag = fromtag->next;
-            totag = &((*totag)->next);
-        }
-
-        *totag = 0;
+    if (from->tags) {
+        to->tags = malloc(from->tagsize * sizeof (struct memfile_tag));
+        memcpy(to->tags, from->tags,
+               from->tagcount * sizeof (struct memfile_tag));
+    }
+    if (from->tagindex) {
+        to->tagindex = malloc(from->tagindexsize * sizeof (int));
+        memcpy(to->tagindex, from->tagindex,
+               from->tagindexsize * sizeof (int));
     }
 }
 
 void
 mfree(struct memfile *mf)
 {
-    int i;
-
     free(mf->buf);
     mf->buf = 0;
     free(mf->diffbuf);
     mf->diffbuf = 0;
-    for (i = 0; i < MEMFILE_HASHTABLE_SIZE; i++) {
-        struct memfile_tag *tag, *otag;
+    free(mf->tags);
+    mf->tags = 0;
+    free(mf->tagindex);
+    mf->tagindex = 0;
+    mf->tagcount = mf->tagsize = mf->tagindexsize = 0;
+    mf->last_tag = -1;
+}
 
-        for ((tag = mf->tags[i]), (otag = NULL); tag; tag = tag->next) {
-            free(otag);
-            otag = tag;
-        }
-        free(otag);
-        mf->tags[i] = 0;
-    }
+/* Frees everything a memfile holds apart from its contents, for when only the
+   contents will be needed from now on. */
+void
+mtrim(struct memfile *mf)
+{
+    free(mf->diffbuf);
+    mf->diffbuf = 0;
+    mf->difflen = mf->diffpos = 0;
+    free(mf->tags);
+    mf->tags = 0;
+    free(mf->tagindex);
+    mf->tagindex = 0;
+    mf->tagcount = mf->tagsize = mf->tagindexsize = 0;
+    mf->last_tag = -1;
+}
+
+/* The memory used by a memfile's tags (the tags themselves, and the index used
+   to look them up), for memory usage statistics. */
+long
+mtag_memory_usage(const struct memfile *mf)
+{
+    return (long)mf->tagsize * sizeof (struct memfile_tag) +
+        (long)mf->tagindexsize * sizeof (int);
 }
 
 /* Functions for writing to a memory file.
@@ -211,6 +232,131 @@ mmmap(struct memfile *mf, long len, long off)
     return mf->buf + off;
 }
 
+/* Finding the runs of equal and different bytes in mwrite() is where save
+   diffing spends most of its time, so where possible, we compare many bytes at
+   once, and find the end of the run from a bitmask. Each kernel looks at whole
+   blocks of p1 and p2 (the first len bytes), and returns either the length of
+   the run of bytes that are equal to each other (if equal is TRUE) or different
+   from each other (if equal is FALSE), or the offset of the first block it
+   didn't look at; the scalar code in mdiff_run_length finishes the job.
+
+   As with the base 64 kernels in log.c, the game is normally compiled for a
+   generic target, so the SSE2 and AVX2 kernels are compiled via function
+   attributes, and the best one the CPU supports is chosen at runtime. */
+static unsigned int
+mdiff_blocks_none(const char *p1, const char *p2, unsigned int len,
+                  boolean equal)
+{
+    unsigned int i = 0;
+
+#if defined(__GNUC__) && !defined(IS_BIG_ENDIAN)
+    /* Runs of different bytes are typically short, so this only speeds up
+       runs of equal bytes. */
+    if (equal) {
+        for (; i + 8 <= len; i += 8) {
+            uint64_t w1, w2;
+
+            memcpy(&w1, p1 + i, 8);
+            memcpy(&w2, p2 + i, 8);
+            if (w1 != w2)
+                return i + __builtin_ctzll(w1 ^ w2) / 8;
+        }
+    }
+#else
+    (void) p1;
+    (void) p2;
+    (void) len;
+    (void) equal;
+#endif
+    return i;
+}
+
+#ifdef MDIFF_SIMD
+static __attribute__((target("sse2"))) unsigned int
+mdiff_blocks_128(const char *p1, const char *p2, unsigned int len,
+                 boolean equal)
+{
+    unsigned int i;
+
+    for (i = 0; i + 16 <= len; i += 16) {
+        __m128i v1 = _mm_loadu_si128((const __m128i *)(p1 + i));
+        __m128i v2 = _mm_loadu_si128((const __m128i *)(p2 + i));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v1, v2));
+
+        if (equal)
+            mask = ~mask & 0xFFFFu;
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    return i;
+}
+
+static __attribute__((target("avx2"))) unsigned int
+mdiff_blocks_256(const char *p1, const char *p2, unsigned int len,
+                 boolean equal)
+{
+    unsigned int i;
+
+    for (i = 0; i + 32 <= len; i += 32) {
+        __m256i v1 = _mm256_loadu_si256((const __m256i *)(p1 + i));
+        __m256i v2 = _mm256_loadu_si256((const __m256i *)(p2 + i));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(v1, v2));
+
+        if (equal)
+            mask = ~mask;
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    return i + mdiff_blocks_128(p1 + i, p2 + i, len - i, equal);
+}
+#endif
+
+static unsigned int (*mdiff_blocks)(const char *, const char *, unsigned int,
+                                    boolean);
+
+/* Chooses the fastest diffing kernel that the CPU supports, up to maxlevel (0
+   for the scalar code only, 1 for SSE2, 2 for AVX2). Returns the level actually
+   chosen. This is called automatically the first time a save is diffed; the
+   unit tests call it to compare the kernels. */
+int
+select_mdiff_kernel(int maxlevel)
+{
+#ifdef MDIFF_SIMD
+    __builtin_cpu_init();
+    if (maxlevel >= 2 && __builtin_cpu_supports("avx2")) {
+        mdiff_blocks = mdiff_blocks_256;
+        return 2;
+    }
+    if (maxlevel >= 1 && __builtin_cpu_supports("sse2")) {
+        mdiff_blocks = mdiff_blocks_128;
+        return 1;
+    }
+#else
+    (void) maxlevel;
+#endif
+    mdiff_blocks = mdiff_blocks_none;
+    return 0;
+}
+
+/* Returns the length of the run of bytes at the start of p1 and p2 that are
+   equal to each other (if equal is TRUE) or different from each other (if
+   equal is FALSE), up to a maximum of len. */
+static unsigned int
+mdiff_run_length(const char *p1, const char *p2, unsigned int len,
+                 boolean equal)
+{
+    unsigned int i;
+
+    if (!mdiff_blocks)
+        select_mdiff_kernel(2);
+
+    for (i = mdiff_blocks(p1, p2, len, equal); i < len; i++)
+        if ((p1[i] == p2[i]) != !!equal)
+            break;
+    return i;
+}
+
 void
 mwrite(struct memfile *mf, const void *buf, unsigned int num)
 {
@@ -220,28 +366,48 @@ mwrite(struct memfile *mf, const void *buf, unsigned int num)
     if (!mf->relativeto) {
         mf->pos += num;
     } else {
-        /* calculate and record the diff as well */
-        while (num--) {
-            if (mf->relativepos < mf->relativeto->pos &&
-                mf->buf[mf->pos] == mf->relativeto->buf[mf->relativepos]) {
+        /* Calculate and record the diff as well. We handle entire runs of
+           copied or edited bytes at once, but the effect is the same as
+           handling the bytes one at a time: a copied byte flushes pending
+           seeks and edits, and an edited byte flushes pending seeks. */
+        while (num) {
+            unsigned int avail = 0, run;
+
+            if (mf->relativepos < mf->relativeto->pos)
+                avail = min(num, (unsigned int)(mf->relativeto->pos -
+                                                mf->relativepos));
+
+            run = mdiff_run_length(mf->buf + mf->pos,
+                                   mf->relativeto->buf + mf->relativepos,
+                                   avail, TRUE);
+            if (run) {
 
                 if (mf->pending_seeks || mf->pending_edits)
                     mdiffflush(mf, 0);
 
-                mf->pending_copies++;
+                mf->pending_copies += run;
 
             } else {
 
                 /* Note that mdiffflush is responsible for writing the actual
                    data that was edited, once we have a complete run of it. So
-                   there's no need to record the data anywhere but in buf. */
+                   there's no need to record the data anywhere but in buf.
+
+                   Anything past the end of relativeto is an edit. */
+                run = num;
+                if (avail)
+                    run = mdiff_run_length(
+                        mf->buf + mf->pos,
+                        mf->relativeto->buf + mf->relativepos, avail, FALSE);
+
                 if (mf->pending_seeks)
                     mdiffflush(mf, 0);
 
-                mf->pending_edits++;
+                mf->pending_edits += run;
             }
-            mf->pos++;
-            mf->relativepos++;
+            mf->pos += run;
+            mf->relativepos += run;
+            num -= run;
         }
     }
 }
@@ -719,10 +885,10 @@ mdiffflush(struct memfile *mf, boolean eof)
            this point will be edited or seeked away) */
         fprintf(debuglog, "] pos %d, last copy %d:%08lx%+d anchor %d\n> ",
                 mf->pos,
-                mf->last_tag ? mf->last_tag->tagtype : -1,
-                mf->last_tag ? mf->last_tag->tagdata : 0,
+                mf->last_tag >= 0 ? (int)mf->tags[mf->last_tag].tagtype : -1,
+                mf->last_tag >= 0 ? mf->tags[mf->last_tag].tagdata : 0,
                 mf->pos - (int)mf->pending_edits -
-                (mf->last_tag ? mf->last_tag->pos : 0),
+                (mf->last_tag >= 0 ? mf->tags[mf->last_tag].pos : 0),
                 mf->coord_relative_to);
     }
 
@@ -1185,26 +1351,99 @@ mdiffapply(char *diff, long difflen, struct memfile *diff_base,
    and the file location. For a diff memfile, it also sets relativepos
    to the pos of the tag in relativeto, if it exists, and adds a seek
    command to the diff, unless it would be redundant. */
+static unsigned int
+mtag_hash(long tagdata, enum memfile_tagtype tagtype)
+{
+    /* 619 is chosen here because it's a prime number; the multiplication by
+       a large odd constant then spreads the bits out, so that we can use the
+       bottom bits of the result as an index. */
+    unsigned int h = (unsigned int)(tagdata * 619 + (int)tagtype);
+
+    h *= 0x9E3779B1u;
+    return h ^ (h >> 16);
+}
+
+/* Places the tag with the given index into the tag index, replacing any older
+   tag with the same tagdata and tagtype. */
+static void
+mtag_index(struct memfile *mf, int tagnum)
+{
+    const struct memfile_tag *tag = mf->tags + tagnum;
+    unsigned int mask = mf->tagindexsize - 1;
+    unsigned int i = mtag_hash(tag->tagdata, tag->tagtype) & mask;
+
+    while (mf->tagindex[i]) {
+        const struct memfile_tag *other = mf->tags + mf->tagindex[i] - 1;
+
+        if (other->tagdata == tag->tagdata && other->tagtype == tag->tagtype)
+            break;
+        i = (i + 1) & mask;
+    }
+    mf->tagindex[i] = tagnum + 1;
+}
+
+/* Returns the most recently placed tag with the given tagdata and tagtype, or
+   NULL if there is no such tag. */
+static const struct memfile_tag *
+mtag_find(const struct memfile *mf, long tagdata, enum memfile_tagtype tagtype)
+{
+    unsigned int mask = mf->tagindexsize - 1;
+    unsigned int i;
+
+    if (!mf->tagindexsize)
+        return NULL;
+
+    for (i = mtag_hash(tagdata, tagtype) & mask; mf->tagindex[i];
+         i = (i + 1) & mask) {
+        const struct memfile_tag *tag = mf->tags + mf->tagindex[i] - 1;
+
+        if (tag->tagdata == tagdata && tag->tagtype == tagtype)
+            return tag;
+    }
+    return NULL;
+}
+
+/* Records a tag at the given position, without affecting the diff. Tags must
+   be added in order of position. */
+static void
+mtag_add(struct memfile *mf, long tagdata, enum memfile_tagtype tagtype,
+         int pos)
+{
+    int i;
+
+    if (mf->tagcount == mf->tagsize) {
+        mf->tagsize = mf->tagsize ? mf->tagsize * 2 :
+            MEMFILE_TAGS_INITIAL_SIZE;
+        mf->tags = realloc(mf->tags, mf->tagsize * sizeof (struct memfile_tag));
+    }
+    mf->tags[mf->tagcount] = (struct memfile_tag)
+        {.tagdata = tagdata, .tagtype = tagtype, .pos = pos};
+    mf->last_tag = mf->tagcount;
+    mf->tagcount++;
+
+    /* Keep the index at most half full; when it grows, rebuild it from
+       scratch, going through the tags in order so that newer tags replace
+       older ones. */
+    if (mf->tagcount * 2 > mf->tagindexsize) {
+        mf->tagindexsize = mf->tagindexsize ? mf->tagindexsize * 2 :
+            MEMFILE_TAGS_INITIAL_SIZE * 2;
+        free(mf->tagindex);
+        mf->tagindex = calloc(mf->tagindexsize, sizeof (int));
+        for (i = 0; i < mf->tagcount; i++)
+            mtag_index(mf, i);
+    } else
+        mtag_index(mf, mf->tagcount - 1);
+}
+
 void
 mtag(struct memfile *mf, long tagdata, enum memfile_tagtype tagtype)
 {
-    /* 619 is chosen here because it's a prime number, and it's approximately
-       in the golden ratio with MEMFILE_HASHTABLE_SIZE. */
-    int bucket = (tagdata * 619 + (int)tagtype) % MEMFILE_HASHTABLE_SIZE;
-    struct memfile_tag *tag = malloc(sizeof (struct memfile_tag));
-
-    tag->next = mf->tags[bucket];
-    tag->tagdata = tagdata;
-    tag->tagtype = tagtype;
-    tag->pos = mf->pos;
-    mf->tags[bucket] = tag;
-    mf->last_tag = tag;
+    const struct memfile_tag *tag;
+
+    mtag_add(mf, tagdata, tagtype, mf->pos);
 
     if (mf->relativeto) {
-        for (tag = mf->relativeto->tags[bucket]; tag; tag = tag->next) {
-            if (tag->tagtype == tagtype && tag->tagdata == tagdata)
-                break;
-        }
+        tag = mtag_find(mf->relativeto, tagdata, tagtype);
         if (tag && mf->relativepos != tag->pos) {
             int offset = mf->relativepos - tag->pos;
 
@@ -1217,6 +1456,97 @@ mtag(struct memfile *mf, long tagdata, enum memfile_tagtype tagtype)
     }
 }
 
+/* Memfile sections. msection_save copies everything written to mf since
+   position start (both data and tags) into ms, reusing ms's buffers if it
+   already holds an older section; msection_write appends a saved section to
+   another memfile, producing the same file as if the data and tags had been
+   written to it directly. */
+
+void
+msection_save(struct memfile_section *ms, struct memfile *mf, int start)
+{
+    int i, first;
+
+    ms->len = mf->pos - start;
+    if (ms->bufsize < ms->len) {
+        ms->bufsize = ms->len;
+        ms->buf = realloc(ms->buf, ms->bufsize);
+    }
+    memcpy(ms->buf, mf->buf + start, ms->len);
+
+    /* Tags are stored in order of position, so the tags we want are at the
+       end of the array. */
+    for (first = mf->tagcount; first > 0; first--)
+        if (mf->tags[first - 1].pos < start)
+            break;
+
+    ms->tagcount = mf->tagcount - first;
+    if (ms->tagsize < ms->tagcount) {
+        ms->tagsize = ms->tagcount;
+        ms->tags = realloc(ms->tags, ms->tagsize * sizeof (struct memfile_tag));
+    }
+    memcpy(ms->tags, mf->tags + first,
+           ms->tagcount * sizeof (struct memfile_tag));
+    for (i = 0; i < ms->tagcount; i++)
+        ms->tags[i].pos -= start;
+}
+
+void
+msection_write(struct memfile *mf, const struct memfile_section *ms)
+{
+    int i, start = mf->pos;
+
+    if (mf->relativeto && mf->relativepos >= 0 &&
+        mf->relativepos + ms->len <= mf->relativeto->pos &&
+        memcmp(mf->relativeto->buf + mf->relativepos, ms->buf, ms->len) == 0) {
+
+        /* The common case: this section was also written, unchanged, to the
+           file we're diffing against. So it's all one big copy, and there's
+           no need to compare it byte by byte. */
+        expand_memfile(mf, mf->pos + ms->len);
+        memcpy(mf->buf + mf->pos, ms->buf, ms->len);
+        if (ms->len) {
+            if (mf->pending_seeks || mf->pending_edits)
+                mdiffflush(mf, 0);
+            mf->pending_copies += ms->len;
+        }
+        mf->pos += ms->len;
+        mf->relativepos += ms->len;
+
+    } else if (mf->relativeto) {
+
+        /* Replay the writes and tags in order, so that the tags can seek in
+           the file we're diffing against as normal. */
+        int written = 0;
+
+        for (i = 0; i < ms->tagcount; i++) {
+            mwrite(mf, ms->buf + written, ms->tags[i].pos - written);
+            written = ms->tags[i].pos;
+            mtag(mf, ms->tags[i].tagdata, ms->tags[i].tagtype);
+        }
+        mwrite(mf, ms->buf + written, ms->len - written);
+        return;
+
+    } else {
+
+        mwrite(mf, ms->buf, ms->len);
+    }
+
+    for (i = 0; i < ms->tagcount; i++)
+        mtag_add(mf, ms->tags[i].tagdata, ms->tags[i].tagtype,
+                 start + ms->tags[i].pos);
+}
+
+void
+msection_free(struct memfile_section *ms)
+{
+    free(ms->buf);
+    free(ms->tags);
+    ms->buf = NULL;
+    ms->tags = NULL;
+    ms->len = ms->bufsize = ms->tagcount = ms->tagsize = 0;
+}
+
 void
 mread(struct memfile *mf, void *buf, unsigned int len)
 {
@@ -1312,7 +1642,6 @@ mequal(struct memfile *mf1, struct memfile *mf2, const char **difference_reason)
 {
     char *p1, *p2;
     long len, off;
-    int bin;
 
     /* Compare the save files. If they're different lengths, we compare only the
        portion that fits into both files. */
@@ -1334,12 +1663,19 @@ mequal(struct memfile *mf1, struct memfile *mf2, const char **difference_reason)
         /* Determine where the desyncs are. */
         for (off = 0; off < len; off++) {
             if (p1[off] != p2[off]) {
-                struct memfile_tag *tag = NULL, *titer;
-                for (bin = 0; bin < MEMFILE_HASHTABLE_SIZE; bin++)
-                    for (titer = mf2->tags[bin]; titer; titer = titer->next)
-                        if (titer->pos <= off)
-                            if (!tag || tag->pos < titer->pos)
-                                tag = titer;
+                /* Find the last tag at or before off; tags are sorted by
+                   position, so we can binary search for it. */
+                const struct memfile_tag *tag = NULL;
+                int lo = 0, hi = mf2->tagcount;
+                while (lo < hi) {
+                    int mid = lo + (hi - lo) / 2;
+                    if (mf2->tags[mid].pos <= off)
+                        lo = mid + 1;
+                    else
+                        hi = mid;
+                }
+                if (lo > 0)
+                    tag = mf2->tags + lo - 1;
 
                 if (!tag) {
 
@@ -534,6 +534,7 @@ alloc_level(d_level *levnum)
     lev->rooms[0].hx = -1;
     lev->subrooms[0].hx = -1;
     lev->flags.hero_memory = 1;
+    mark_terrain_changed();
 
     lev->updest.lx = lev->updest.hx = lev->updest.nlx = lev->updest.nhx =
         lev->dndest.lx = lev->dndest.hx = lev->dndest.nlx = lev->dndest.nhx =
@@ -1563,6 +1564,8 @@ mkinvpos(xchar x, xchar y, int dist)
         break;
     }
 
+    mark_terrain_changed();
+
     /* display new value of position; could have a monster/object on it */
     newsym(x, y);
 }
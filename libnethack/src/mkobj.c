@@ -12,6 +12,7 @@ static void mkbox_cnts(struct obj *, enum rng rng);
 static struct obj *mksobj_basic(struct level *lev, int otyp);
 static void obj_timer_checks(struct obj *, xchar, xchar, int);
 static void container_weight(struct obj *);
+static void mark_obj_level_dirty(struct obj *);
 static struct obj *save_mtraits(struct obj *, struct monst *);
 static void extract_nexthere(struct obj *, struct obj **);
 
@@ -1235,6 +1236,7 @@ place_object(struct obj *otmp, struct level *lev, int x, int y)
         panic("placing object at bad position");
 
     obj_no_longer_held(otmp);
+    mark_level_dirty(lev);
     if (otmp->otyp == BOULDER && lev == level)
         block_point(x, y);      /* vision */
 
@@ -1374,6 +1376,7 @@ remove_object(struct obj *otmp)
 
     if (otmp->where != OBJ_FLOOR)
         panic("remove_object: obj not on floor");
+    mark_level_dirty(otmp->olev);
     extract_nexthere(otmp, &otmp->olev->objects[x][y]);
     extract_nobj(otmp, &otmp->olev->objlist,
                  &turnstate.floating_objects, OBJ_FREE);
@@ -1427,6 +1430,7 @@ obj_extract_self(struct obj *obj)
         remove_object(obj);
         break;
     case OBJ_CONTAINED:
+        mark_obj_level_dirty(obj);
         extract_nobj(obj, &obj->ocontainer->cobj,
                      &turnstate.floating_objects, OBJ_FREE);
         container_weight(obj->ocontainer);
@@ -1435,14 +1439,17 @@ obj_extract_self(struct obj *obj)
         freeinv(obj);
         break;
     case OBJ_MINVENT:
+        mark_obj_level_dirty(obj);
         extract_nobj(obj, &obj->ocarry->minvent,
                      &turnstate.floating_objects, OBJ_FREE);
         break;
     case OBJ_BURIED:
+        mark_level_dirty(obj->olev);
         extract_nobj(obj, &obj->olev->buriedobjlist,
                      &turnstate.floating_objects, OBJ_FREE);
         break;
     case OBJ_ONBILL:
+        mark_level_dirty(obj->olev);
         extract_nobj(obj, &obj->olev->billobjs,
                      &turnstate.floating_objects, OBJ_FREE);
         break;
@@ -1532,6 +1539,7 @@ add_to_minv(struct monst *mon, struct obj *obj)
     /* else insert; don't bother forcing it to end of chain */
     extract_nobj(obj, &turnstate.floating_objects, &mon->minvent, OBJ_MINVENT);
     obj->ocarry = mon;
+    mark_obj_level_dirty(obj);
 
     return 0;   /* obj on mon's inventory chain */
 }
@@ -1559,6 +1567,7 @@ add_to_container(struct obj *container, struct obj *obj)
     extract_nobj(obj, &turnstate.floating_objects,
                  &container->cobj, OBJ_CONTAINED);
     obj->ocontainer = container;
+    mark_obj_level_dirty(obj);
     return obj;
 }
 
@@ -1569,11 +1578,36 @@ add_to_buried(struct obj *obj)
     if (obj->where != OBJ_FREE)
         panic("add_to_buried: obj not free");
 
+    mark_level_dirty(obj->olev);
     extract_nobj(obj, &turnstate.floating_objects,
                  &obj->olev->buriedobjlist, OBJ_BURIED);
 }
 
 
+/* Mark the level whose save data includes obj as dirty (see
+   mark_level_dirty()). Objects in containers are saved along with the
+   outermost container; monster inventories are saved with the monster. */
+static void
+mark_obj_level_dirty(struct obj *obj)
+{
+    while (obj->where == OBJ_CONTAINED)
+        obj = obj->ocontainer;
+
+    switch (obj->where) {
+    case OBJ_FLOOR:
+    case OBJ_BURIED:
+    case OBJ_ONBILL:
+        mark_level_dirty(obj->olev);
+        break;
+    case OBJ_MINVENT:
+        if (obj->ocarry->dlevel)
+            mark_level_dirty(obj->ocarry->dlevel);
+        break;
+    default:
+        break;
+    }
+}
+
 /* Recalculate the weight of this container and all of _its_ containers. */
 static void
 container_weight(struct obj *container)
@@ -1627,6 +1661,7 @@ dealloc_obj(struct obj *obj)
         thrownobj = NULL;
 
     extract_nobj(obj, &turnstate.floating_objects, NULL, 0);
+    unindex_oid(obj);
 
     free(obj);
 }
@@ -1558,6 +1558,7 @@ relmon(struct monst *mon)
     if (mon->dlevel->monlist == NULL)
         panic("relmon: no level->monlist available.");
 
+    mark_level_dirty(mon->dlevel);
     mon->dlevel->monsters[mon->mx][mon->my] = NULL;
 
     if (mon == mon->dlevel->monlist)
@@ -890,14 +890,12 @@ not_special:
         int ndist, nidist;
         coord poss[9];
 
-        struct distmap_state ds;
-
-        distmap_init(&ds, gx, gy, mtmp);
+        struct distmap_state *ds = distmap_init(gx, gy, mtmp);
 
         cnt = mfndpos(mtmp, poss, info, flag);
         chcnt = 0;
         chi = -1;
-        nidist = distmap(&ds, omx, omy);
+        nidist = distmap(ds, omx, omy);
 
         if (is_unicorn(ptr) && level->flags.noteleport) {
             /* on noteleport levels, perhaps we cannot avoid hero */
@@ -912,7 +910,7 @@ not_special:
             nx = poss[i].x;
             ny = poss[i].y;
 
-            nearer = ((ndist = distmap(&ds, nx, ny)) < nidist);
+            nearer = ((ndist = distmap(ds, nx, ny)) < nidist);
             distance_tie = (ndist == nidist);
 
             if ((appr == 1 && nearer) ||
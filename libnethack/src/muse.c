@@ -754,6 +754,7 @@ use_defensive(struct monst *mtmp, struct musable *m)
                   t->ttyp == TRAPDOOR ? "trap door" : "hole");
             if (level->locations[trapx][trapy].typ == SCORR) {
                 level->locations[trapx][trapy].typ = CORR;
+                mark_terrain_changed();
                 unblock_point(trapx, trapy);
             }
             seetrap(t_at(level, trapx, trapy));
@@ -843,6 +844,7 @@ use_defensive(struct monst *mtmp, struct musable *m)
                   makeplural(locomotion(mtmp->data, "jump")));
             if (level->locations[trapx][trapy].typ == SCORR) {
                 level->locations[trapx][trapy].typ = CORR;
+                mark_terrain_changed();
                 unblock_point(trapx, trapy);
             }
             seetrap(t_at(level, trapx, trapy));
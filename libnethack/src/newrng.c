@@ -204,6 +204,147 @@ sha256_done(struct sha256_state *ss)
     return ss->state;
 }
 
+/* The RNG only ever hashes 12-byte messages, and usually hashes several
+   consecutive seeds in a row; so where we can, we hash several seeds at once,
+   one per lane of a vector, using the GCC vector extensions (which compile to
+   whatever SIMD instructions are available). Because a 12-byte message fits in
+   a single block, we can construct the padded block directly.
+
+   The kernel is written once, as a macro that's instantiated for 4 and 8
+   lanes. As with the base 64 kernels in log.c, the game is normally compiled
+   for a generic target, so on x86 the 8-lane kernel is compiled for AVX2 via a
+   function attribute, and used if the CPU supports it; otherwise, the seeds
+   are hashed 4 at a time. */
+#define SHA256_MAX_LANES 8
+
+#ifdef __GNUC__
+# if defined(__x86_64__) || defined(__i386__)
+#  define SHA256_AVX2
+#  define SHA256_TARGET_8 __attribute__((target("avx2")))
+# else
+#  define SHA256_TARGET_8
+# endif
+# define SHA256_TARGET_4
+# define SHA256_TARGET(n) SHA256_TARGET_##n
+
+typedef uint32_t sha256_vec_4 __attribute__((vector_size(16)));
+typedef uint32_t sha256_vec_8 __attribute__((vector_size(32)));
+
+# define SHA256_SEEDS_LANES(n)                                              \
+static SHA256_TARGET(n) void                                                \
+sha256_seeds_##n(const unsigned char seeds[][RNG_SEED_SIZE_BYTES],          \
+                 uint32_t out[][8])                                         \
+{                                                                           \
+    static const uint32_t initial_state[8] = {                              \
+        0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,             \
+        0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL              \
+    };                                                                      \
+    const sha256_vec_##n zero = {0};                                        \
+    sha256_vec_##n S[8], W[64];                                             \
+    int i, j;                                                               \
+                                                                            \
+    /* the seed, then a '1' bit, then padding, then the length in bits */   \
+    for (i = 0; i < RNG_SEED_SIZE_BYTES / 4; i++)                           \
+        for (j = 0; j < n; j++)                                             \
+            W[i][j] = (uint32_t)seeds[j][i * 4 + 0] << 24 |                 \
+                (uint32_t)seeds[j][i * 4 + 1] << 16 |                       \
+                (uint32_t)seeds[j][i * 4 + 2] <<  8 |                       \
+                (uint32_t)seeds[j][i * 4 + 3] <<  0;                        \
+    W[i++] = zero + 0x80000000UL;                                           \
+    for (; i < 15; i++)                                                     \
+        W[i] = zero;                                                        \
+    W[15] = zero + RNG_SEED_SIZE_BYTES * 8;                                 \
+                                                                            \
+    for (i = 16; i < 64; i++) {                                             \
+        W[i] = Gamma1(W[i - 2]) + W[i - 7] + Gamma0(W[i - 15]) +            \
+            W[i - 16];                                                      \
+    }                                                                       \
+                                                                            \
+    for (i = 0; i < 8; i++)                                                 \
+        S[i] = zero + initial_state[i];                                     \
+                                                                            \
+    for (i = 0; i < 64; ++i) {                                              \
+        sha256_vec_##n t, t0, t1;                                           \
+                                                                            \
+        t0 = S[7] + Sigma1(S[4]) + Ch(S[4], S[5], S[6]) + K[i] + W[i];      \
+        t1 = Sigma0(S[0]) + Maj(S[0], S[1], S[2]);                          \
+        S[3] += t0;                                                         \
+        S[7] = t0 + t1;                                                     \
+                                                                            \
+        t = S[7]; S[7] = S[6]; S[6] = S[5]; S[5] = S[4];                    \
+        S[4] = S[3]; S[3] = S[2]; S[2] = S[1]; S[1] = S[0]; S[0] = t;       \
+    }                                                                       \
+                                                                            \
+    for (i = 0; i < 8; i++)                                                 \
+        for (j = 0; j < n; j++)                                             \
+            out[j][i] = S[i][j] + initial_state[i];                         \
+}
+
+SHA256_SEEDS_LANES(4)
+# ifdef SHA256_AVX2
+SHA256_SEEDS_LANES(8)
+# endif
+#endif
+
+static void
+sha256_seeds_1(const unsigned char seeds[][RNG_SEED_SIZE_BYTES],
+               uint32_t out[][8])
+{
+    struct sha256_state ss;
+
+    sha256_init(&ss);
+    sha256_process(&ss, seeds[0], RNG_SEED_SIZE_BYTES);
+    memcpy(out[0], sha256_done(&ss), 8 * sizeof (uint32_t));
+}
+
+static void (*sha256_seeds_kernel)(const unsigned char [][RNG_SEED_SIZE_BYTES],
+                                   uint32_t [][8]);
+static int sha256_lanes;
+
+/* Chooses the widest SHA-256 kernel that the CPU supports, up to maxlevel (0
+   for one seed at a time, 1 for 4 lanes, 2 for 8 lanes with AVX2). Returns the
+   level actually chosen. This is called automatically the first time seeds are
+   hashed in bulk; the unit tests call it to compare the kernels. */
+int
+select_sha256_kernel(int maxlevel)
+{
+#ifdef __GNUC__
+# ifdef SHA256_AVX2
+    __builtin_cpu_init();
+    if (maxlevel >= 2 && __builtin_cpu_supports("avx2")) {
+        sha256_seeds_kernel = sha256_seeds_8;
+        sha256_lanes = 8;
+        return 2;
+    }
+# endif
+    if (maxlevel >= 1) {
+        sha256_seeds_kernel = sha256_seeds_4;
+        sha256_lanes = 4;
+        return 1;
+    }
+#else
+    (void) maxlevel;
+#endif
+    sha256_seeds_kernel = sha256_seeds_1;
+    sha256_lanes = 1;
+    return 0;
+}
+
+/* Hashes SHA256_MAX_LANES consecutive seeds, as many at a time as the chosen
+   kernel can. */
+static void
+sha256_seeds(const unsigned char seeds[][RNG_SEED_SIZE_BYTES],
+             uint32_t out[][8])
+{
+    int i;
+
+    if (!sha256_seeds_kernel)
+        select_sha256_kernel(2);
+
+    for (i = 0; i < SHA256_MAX_LANES; i += sha256_lanes)
+        sha256_seeds_kernel(seeds + i, out + i);
+}
+
 /* End of SHA-256 code. Start of entropy collectors (based on AdeonRNG by Mikko
    Juola, modified for NetHack 4). */
 
@@ -429,30 +570,85 @@ get_initial_rng_seed(char out[static RNG_SEED_SIZE_BASE64])
 
 /* Generation. */
 
+/* Increases a seed by 1. We treat it as one big little-endian number. */
+static void
+increment_seed(unsigned char seed[static RNG_SEED_SIZE_BYTES])
+{
+    int s;
+
+    for (s = 0; s < RNG_SEED_SIZE_BYTES; s++) {
+        seed[s]++;
+        if (seed[s])
+            break;
+    }
+}
+
+/* Each RNG has a cache of the hashes of the next few values its seed will take,
+   which are calculated all at once by sha256_seeds(). An entry can be used if
+   its seed matches the RNG's current seed; this means that the cache never
+   needs to be invalidated when the seeds change for any other reason (e.g. a
+   save file being loaded), because it'll just stop matching. */
+#define RNG_LOOKAHEAD SHA256_MAX_LANES
+struct rng_lookahead {
+    unsigned char seeds[RNG_LOOKAHEAD][RNG_SEED_SIZE_BYTES];
+    uint32_t out[RNG_LOOKAHEAD][8];
+    int next;   /* the entry that should be used next */
+    int count;  /* the number of valid entries */
+};
+static struct rng_lookahead
+rng_lookahead[RNG_SEEDSPACE / RNG_SEED_SIZE_BYTES + 1];
+
+static const uint32_t *
+rng_hash_seed(const unsigned char seed[static RNG_SEED_SIZE_BYTES],
+              struct rng_lookahead *la)
+{
+    int i;
+
+    if (la->next >= la->count ||
+        memcmp(la->seeds[la->next], seed, RNG_SEED_SIZE_BYTES) != 0) {
+
+        memcpy(la->seeds[0], seed, RNG_SEED_SIZE_BYTES);
+        for (i = 1; i < RNG_LOOKAHEAD; i++) {
+            memcpy(la->seeds[i], la->seeds[i - 1], RNG_SEED_SIZE_BYTES);
+            increment_seed(la->seeds[i]);
+        }
+        sha256_seeds((const unsigned char (*)[RNG_SEED_SIZE_BYTES])la->seeds,
+                     la->out);
+        la->next = 0;
+        la->count = RNG_LOOKAHEAD;
+    }
+
+    return la->out[la->next++];
+}
+
+/* la is the look-ahead cache to use, or NULL to hash the seed directly. */
 static uint32_t
 rn2_from_seedarray(uint32_t maxplus1,
-                   unsigned char seedarray[static RNG_SEED_SIZE_BYTES])
+                   unsigned char seedarray[static RNG_SEED_SIZE_BYTES],
+                   struct rng_lookahead *la)
 {
     struct sha256_state ss;
+    const uint32_t *out;
+    int s;
 
     if (maxplus1 == 0) {
         impossible("Impossible range 0 <= x < 0 for a random number");
         maxplus1 = 1;
     }
 
-    /* Calculate the SHA-256 of the current seed. */
-    sha256_init(&ss);
-    sha256_process(&ss, seedarray, RNG_SEED_SIZE_BYTES);
-    uint32_t *out = sha256_done(&ss);
-
-    /* Increase the seed. We treat it as one big little-endian number. */
-    int s;
-    for (s = 0; s < RNG_SEED_SIZE_BYTES; s++) {
-        seedarray[s]++;
-        if (seedarray[s])
-            break;
+    /* Calculate the SHA-256 of the current seed (or, more likely, find that
+       we've already calculated it). */
+    if (la)
+        out = rng_hash_seed(seedarray, la);
+    else {
+        sha256_init(&ss);
+        sha256_process(&ss, seedarray, RNG_SEED_SIZE_BYTES);
+        out = sha256_done(&ss);
     }
 
+    /* Increase the seed. */
+    increment_seed(seedarray);
+
     /* Produce output in the range 0..maxplus1-1. We look through the 32-bit
        numbers that the SHA-256 algorithm calculated, trying each one in turn to
        see if it produces a result that can be used without modulo bias. If it
@@ -480,7 +676,7 @@ rn2_from_seedarray(uint32_t maxplus1,
             return out[s] / (unbiased_maximum / maxplus1);
     }
 
-    return rn2_from_seedarray(maxplus1, seedarray);
+    return rn2_from_seedarray(maxplus1, seedarray, la);
 }
 
 int
@@ -501,7 +697,9 @@ rn2_on_rng(int maxplus1, enum rng rng)
            for the sequence to be particularly secure, so we can start at 0. */
         static unsigned char display_rng_seed[RNG_SEED_SIZE_BYTES] = {0};
 
-        return (int)rn2_from_seedarray(maxplus1, display_rng_seed);
+        return (int)rn2_from_seedarray(
+            maxplus1, display_rng_seed,
+            rng_lookahead + RNG_SEEDSPACE / RNG_SEED_SIZE_BYTES);
 
     } else if (rng == rng_initialseed) {
 
@@ -514,7 +712,7 @@ rn2_on_rng(int maxplus1, enum rng rng)
             impossible("Zero-time command used main RNG");
 
         return (int)rn2_from_seedarray(maxplus1,
-            flags.rngstate + rng * RNG_SEED_SIZE_BYTES);
+            flags.rngstate + rng * RNG_SEED_SIZE_BYTES, rng_lookahead + rng);
 
     } else {
 
@@ -523,6 +721,59 @@ rn2_on_rng(int maxplus1, enum rng rng)
     }
 }
 
+/* Generates a random number from a seed given directly, which it advances,
+   hashing the seed without using a look-ahead cache. This gives the same
+   results as rn2_on_rng would on an RNG with that seed; the unit tests use it
+   to check the cache. */
+int
+rn2_on_seed_uncached(int maxplus1,
+                     unsigned char seed[static RNG_SEED_SIZE_BYTES])
+{
+    return (int)rn2_from_seedarray(maxplus1, seed, NULL);
+}
+
+/* Measures the speed of the RNG, for the #rngbench debug command. Returns the
+   number of random numbers generated per second, and sets *unbuffered to the
+   number per second we'd get if we hashed each seed individually (without the
+   look-ahead cache). This uses a seed of its own, so doesn't affect the
+   gamestate or the display RNG. */
+long
+rng_benchmark(long *unbuffered)
+{
+    unsigned char seed[RNG_SEED_SIZE_BYTES] = {0};
+    struct rng_lookahead la = {.next = 0, .count = 0};
+    struct timeval start, now;
+    double elapsed;
+    long calls, rv;
+    int i;
+
+    calls = 0;
+    gettimeofday(&start, NULL);
+    do {
+        for (i = 0; i < 10000; i++)
+            rn2_from_seedarray(1000, seed, &la);
+        calls += 10000;
+        gettimeofday(&now, NULL);
+        elapsed = (now.tv_sec - start.tv_sec) +
+            (now.tv_usec - start.tv_usec) / 1000000.0;
+    } while (elapsed < 0.5);
+    rv = calls / elapsed;
+
+    calls = 0;
+    gettimeofday(&start, NULL);
+    do {
+        for (i = 0; i < 10000; i++)
+            rn2_from_seedarray(1000, seed, NULL);
+        calls += 10000;
+        gettimeofday(&now, NULL);
+        elapsed = (now.tv_sec - start.tv_sec) +
+            (now.tv_usec - start.tv_usec) / 1000000.0;
+    } while (elapsed < 0.5);
+    *unbuffered = calls / elapsed;
+
+    return rv;
+}
+
 /* Wrapper for functions that take an RNG as an argument. */
 int
 rn2_on_display_rng(int x)
@@ -11,6 +11,7 @@
 
 #include "hack.h"
 #include "dlb.h"
+#include "dataidx.h"
 
 static boolean append_str(const char **buf, const char *new_str,
                           int is_plur, int is_in);
@@ -19,6 +20,16 @@ static void describe_bg(int x, int y, int bg, char *buf);
 static int describe_object(int x, int y, int votyp, char *buf, int known_embed,
                            boolean *feature_described);
 static void describe_mon(int x, int y, int monnum, char *buf);
+static void free_data_index(void);
+static boolean load_data_index(dlb *fp);
+static int exact_data_key(const char *str);
+static unsigned int wild_anchor_hash(const char *text, int len,
+                                     boolean prefix);
+static void bucket_wild_data_keys(void);
+static int find_wild_candidates(const char *str, int *cand, int ncand);
+static int next_wild_data_key(const int *cand, int ncand, int *c,
+                              const char *str, const char *alt);
+static int find_data_group(const char *str, const char *alt);
 static void checkfile(const char *inp, struct permonst *, boolean, boolean);
 static int do_look(boolean, const struct nh_cmd_arg *);
 
@@ -441,6 +452,353 @@ nh_describe_pos(int x, int y, struct nh_desc_buf *bufs, int *is_in)
     API_EXIT();
 }
 
+/*
+ * The index of the "data" file (see dataidx.h). It's loaded the first time
+ * it's needed, and then kept, because the file never changes.
+ *
+ * The keys with wildcards are bucketed when it's loaded, by their "anchor":
+ * the literal text before their first wildcard or after their last, whichever
+ * is longer. A string can only match a key if it starts or ends with the
+ * key's anchor, so a lookup hashes the start and end of the string at each
+ * length some anchor has, and tests only the keys found there, plus the few
+ * that have wildcards at both ends.
+ */
+struct wild_anchor {
+    int len;            /* length of the anchor; 0 if the key has none */
+    boolean prefix;     /* the anchor is at the start rather than the end */
+    int next;           /* next wildcard key in the same bucket, or -1 */
+};
+
+static struct {
+    boolean loaded;
+    long txt_offset;
+    int ngroups, nkeys, nslots, nbuckets, nwild;
+    long *group_offset;
+    int *group_count;
+    struct data_key *keys;
+    unsigned int *seeds;
+    int *slots;
+    int *wild;
+    struct wild_anchor *anchors;        /* one per entry in wild */
+    int nwildbuckets;
+    int *wild_buckets;  /* first entry in wild with each anchor hash, or -1 */
+    int nplens, nslens, nunanchored;
+    int *plens, *slens; /* the distinct lengths of prefix and suffix anchors */
+    int *unanchored;    /* entries in wild with no anchor, in order */
+} dataidx;
+
+static void
+free_data_index(void)
+{
+    int i;
+
+    if (dataidx.keys)
+        for (i = 0; i < dataidx.nkeys; i++)
+            free(dataidx.keys[i].text);
+    free(dataidx.group_offset);
+    free(dataidx.group_count);
+    free(dataidx.keys);
+    free(dataidx.seeds);
+    free(dataidx.slots);
+    free(dataidx.wild);
+    free(dataidx.anchors);
+    free(dataidx.wild_buckets);
+    free(dataidx.plens);
+    free(dataidx.slens);
+    free(dataidx.unanchored);
+    memset(&dataidx, 0, sizeof dataidx);
+}
+
+static unsigned int
+wild_anchor_hash(const char *text, int len, boolean prefix)
+{
+    unsigned int h = prefix ? 2166136261u : 84696351u;
+
+    while (len--) {
+        h ^= (unsigned char)*text++;
+        h *= 16777619u;
+    }
+    return h ^ (h >> 16);
+}
+
+/* Works out the anchor of each key with wildcards, and puts the keys in
+   buckets by their anchors' hashes. */
+static void
+bucket_wild_data_keys(void)
+{
+    const char *text, *p;
+    struct wild_anchor *a;
+    int i, j, len, plen, slen, *lens, *nlens;
+    unsigned int b;
+
+    dataidx.nwildbuckets = 1;
+    while (dataidx.nwildbuckets < 2 * dataidx.nwild)
+        dataidx.nwildbuckets *= 2;
+    dataidx.anchors = malloc(dataidx.nwild * sizeof (struct wild_anchor) + 1);
+    dataidx.wild_buckets = malloc(dataidx.nwildbuckets * sizeof (int));
+    dataidx.plens = malloc(dataidx.nwild * sizeof (int) + 1);
+    dataidx.slens = malloc(dataidx.nwild * sizeof (int) + 1);
+    dataidx.unanchored = malloc(dataidx.nwild * sizeof (int) + 1);
+    for (b = 0; b < dataidx.nwildbuckets; b++)
+        dataidx.wild_buckets[b] = -1;
+
+    /* go backwards, so that each bucket ends up in order */
+    for (i = dataidx.nwild - 1; i >= 0; i--) {
+        text = dataidx.keys[dataidx.wild[i]].text;
+        len = strlen(text);
+        plen = strcspn(text, "*?");
+        for (p = text + len; p > text && p[-1] != '*' && p[-1] != '?'; p--)
+            ;
+        slen = text + len - p;
+
+        a = &dataidx.anchors[i];
+        a->prefix = plen > slen;
+        a->len = a->prefix ? plen : slen;
+        a->next = -1;
+        if (!a->len)
+            continue;
+
+        b = wild_anchor_hash(a->prefix ? text : p, a->len, a->prefix) &
+            (dataidx.nwildbuckets - 1);
+        a->next = dataidx.wild_buckets[b];
+        dataidx.wild_buckets[b] = i;
+
+        lens = a->prefix ? dataidx.plens : dataidx.slens;
+        nlens = a->prefix ? &dataidx.nplens : &dataidx.nslens;
+        for (j = 0; j < *nlens && lens[j] != a->len; j++)
+            ;
+        if (j == *nlens)
+            lens[(*nlens)++] = a->len;
+    }
+
+    for (i = 0; i < dataidx.nwild; i++)
+        if (!dataidx.anchors[i].len)
+            dataidx.unanchored[dataidx.nunanchored++] = i;
+}
+
+/* Reads the index from the start of the "data" file, if it isn't loaded
+   already. Returns FALSE if the file is in the wrong format. */
+static boolean
+load_data_index(dlb *fp)
+{
+    char buf[BUFSZ], *ep;
+    int i, n, neg;
+    struct data_key *key;
+
+    if (dataidx.loaded)
+        return TRUE;
+
+    /* skip first record; read second, then the sizes */
+    if (!dlb_fgets(buf, BUFSZ, fp) || !dlb_fgets(buf, BUFSZ, fp) ||
+        sscanf(buf, "%8lx\n", &dataidx.txt_offset) < 1 ||
+        dataidx.txt_offset <= 0 || !dlb_fgets(buf, BUFSZ, fp) ||
+        sscanf(buf, "%d %d %d %d %d", &dataidx.ngroups, &dataidx.nkeys,
+               &dataidx.nslots, &dataidx.nbuckets, &dataidx.nwild) < 5 ||
+        dataidx.ngroups < 0 || dataidx.nkeys < 0 || dataidx.nslots <= 0 ||
+        dataidx.nbuckets <= 0 || dataidx.nwild < 0 ||
+        dataidx.nwild > dataidx.nkeys)
+        goto bad;
+
+    dataidx.group_offset = malloc(dataidx.ngroups * sizeof (long) + 1);
+    dataidx.group_count = malloc(dataidx.ngroups * sizeof (int) + 1);
+    dataidx.keys = malloc(dataidx.nkeys * sizeof (struct data_key) + 1);
+    dataidx.seeds = malloc(dataidx.nbuckets * sizeof (unsigned int));
+    dataidx.slots = malloc(dataidx.nslots * sizeof (int));
+    dataidx.wild = malloc(dataidx.nwild * sizeof (int) + 1);
+    for (i = 0; i < dataidx.nkeys; i++)
+        dataidx.keys[i].text = NULL;
+
+    for (i = 0; i < dataidx.ngroups; i++)
+        if (!dlb_fgets(buf, BUFSZ, fp) ||
+            sscanf(buf, "%ld,%d", &dataidx.group_offset[i],
+                   &dataidx.group_count[i]) < 2)
+            goto bad;
+
+    for (i = 0; i < dataidx.nkeys; i++) {
+        key = &dataidx.keys[i];
+        if (!dlb_fgets(buf, BUFSZ, fp) || !(ep = strchr(buf, '\n')))
+            goto bad;
+        *ep = '\0';
+        if (sscanf(buf, "%d %d %d%n", &key->group, &neg, &key->next, &n) < 3 ||
+            buf[n] != ' ' || key->group < 0 || key->group >= dataidx.ngroups ||
+            key->next < -1 || key->next >= dataidx.nkeys)
+            goto bad;
+        key->neg = !!neg;
+        key->text = malloc(strlen(buf + n + 1) + 1);
+        strcpy(key->text, buf + n + 1);
+    }
+
+    for (i = 0; i < dataidx.nbuckets; i++)
+        if (!dlb_fgets(buf, BUFSZ, fp) ||
+            sscanf(buf, "%u", &dataidx.seeds[i]) < 1)
+            goto bad;
+
+    for (i = 0; i < dataidx.nslots; i++)
+        if (!dlb_fgets(buf, BUFSZ, fp) ||
+            sscanf(buf, "%d", &dataidx.slots[i]) < 1 ||
+            dataidx.slots[i] < -1 || dataidx.slots[i] >= dataidx.nkeys)
+            goto bad;
+
+    for (i = 0; i < dataidx.nwild; i++)
+        if (!dlb_fgets(buf, BUFSZ, fp) ||
+            sscanf(buf, "%d", &dataidx.wild[i]) < 1 ||
+            dataidx.wild[i] < 0 || dataidx.wild[i] >= dataidx.nkeys)
+            goto bad;
+
+    bucket_wild_data_keys();
+
+    dataidx.loaded = TRUE;
+    return TRUE;
+
+bad:
+    free_data_index();
+    return FALSE;
+}
+
+/* Returns the first key without wildcards whose text is str, or -1. */
+static int
+exact_data_key(const char *str)
+{
+    unsigned int seed =
+        dataidx.seeds[data_key_hash(str, 0) % dataidx.nbuckets];
+    int k = dataidx.slots[data_key_hash(str, seed) % dataidx.nslots];
+
+    if (k < 0 || strcmp(dataidx.keys[k].text, str))
+        return -1;
+    return k;
+}
+
+/* Adds to cand, which has ncand entries so far, the entries in wild for the
+   keys whose anchors str starts or ends with. Returns the new number of
+   entries. Each key is added at most once, because its anchor is at a fixed
+   place in str. */
+static int
+find_wild_candidates(const char *str, int *cand, int ncand)
+{
+    const char *text;
+    int i, j, len, prefix, slen = strlen(str);
+    const struct wild_anchor *a;
+
+    for (prefix = 0; prefix < 2; prefix++) {
+        for (i = 0; i < (prefix ? dataidx.nplens : dataidx.nslens); i++) {
+            len = prefix ? dataidx.plens[i] : dataidx.slens[i];
+            if (len > slen)
+                continue;
+            text = prefix ? str : str + slen - len;
+            for (j = dataidx.wild_buckets[wild_anchor_hash(text, len, prefix) &
+                                          (dataidx.nwildbuckets - 1)];
+                 j >= 0; j = a->next) {
+                a = &dataidx.anchors[j];
+                if (a->len == len && a->prefix == prefix)
+                    cand[ncand++] = j;
+            }
+        }
+    }
+    return ncand;
+}
+
+static int
+int_cmp(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+/* Returns the next key with wildcards, starting from the *c'th entry in cand
+   (a sorted list of entries in wild), that matches str or alt; or -1 if there
+   are no more. */
+static int
+next_wild_data_key(const int *cand, int ncand, int *c, const char *str,
+                   const char *alt)
+{
+    int k;
+
+    while (*c < ncand) {
+        k = dataidx.wild[cand[(*c)++]];
+        if (pmatch(dataidx.keys[k].text, str) ||
+            (alt && pmatch(dataidx.keys[k].text, alt)))
+            return k;
+    }
+    return -1;
+}
+
+/*
+ * Returns the group of keys in the "data" file that describes str (or alt),
+ * or -1 if there isn't one.  This is the first group in which the first key
+ * that matches is not a "~" key.
+ *
+ * The keys that can match are those with the exact text (in a chain from the
+ * hash table), and those with wildcards whose anchors fit; they're visited in
+ * the order they appear in the file by merging the three lists, which are each
+ * in order.
+ */
+static int
+find_data_group(const char *str, const char *alt)
+{
+    int ks = exact_data_key(str);
+    int ka = alt ? exact_data_key(alt) : -1;
+    int cand[3 * dataidx.nwild + 1];
+    int i, j, ncand, c = 0, kw;
+    int k, skipgroup = -1;
+
+    /* the wildcard keys that could match, in order, without duplicates */
+    memcpy(cand, dataidx.unanchored, dataidx.nunanchored * sizeof (int));
+    ncand = find_wild_candidates(str, cand, dataidx.nunanchored);
+    if (alt)
+        ncand = find_wild_candidates(alt, cand, ncand);
+    qsort(cand, ncand, sizeof (int), int_cmp);
+    for (i = j = 0; i < ncand; i++)
+        if (!j || cand[i] != cand[j - 1])
+            cand[j++] = cand[i];
+    ncand = j;
+
+    kw = next_wild_data_key(cand, ncand, &c, str, alt);
+
+    for (;;) {
+        k = ks;
+        if (k < 0 || (ka >= 0 && ka < k))
+            k = ka;
+        if (k < 0 || (kw >= 0 && kw < k))
+            k = kw;
+        if (k < 0)
+            return -1;
+
+        if (k == ks)
+            ks = dataidx.keys[ks].next;
+        if (k == ka)
+            ka = dataidx.keys[ka].next;
+        if (k == kw)
+            kw = next_wild_data_key(cand, ncand, &c, str, alt);
+
+        if (dataidx.keys[k].group == skipgroup)
+            continue;
+        /* if we match a key that begins with "~", skip this entry */
+        if (dataidx.keys[k].neg)
+            skipgroup = dataidx.keys[k].group;
+        else
+            return dataidx.keys[k].group;
+    }
+}
+
+/* Finds the entry in the 'data' file for str, or for its alternate form alt
+   (which may be NULL). Returns the number of lines in the entry, with *pos set
+   to where it starts in fp; 0 if there's no entry; or -1 if the file is in the
+   wrong format. */
+int
+find_data_entry(dlb *fp, const char *str, const char *alt, long *pos)
+{
+    int group;
+
+    if (!load_data_index(fp))
+        return -1;
+
+    group = find_data_group(str, alt);
+    if (group < 0)
+        return 0;
+
+    *pos = dataidx.txt_offset + dataidx.group_offset[group];
+    return dataidx.group_count[group];
+}
+
 /*
  * Look in the "data" file for more info.  Called if the user typed in the
  * whole name (user_typed_name == TRUE), or we've found a possible match
@@ -453,9 +811,8 @@ checkfile(const char *inp, struct permonst *pm, boolean user_typed_name,
     dlb *fp;
     char buf[BUFSZ], newstr[BUFSZ];
     char *ep, *dbase_str;
-    long txt_offset = 0;
-    int chk_skip;
-    boolean found_in_file = FALSE, skipping_entry = FALSE;
+    long pos;
+    int nlines = 0;
 
     fp = dlb_fopen(DATAFILE, "r");
     if (!fp) {
@@ -524,64 +881,19 @@ checkfile(const char *inp, struct permonst *pm, boolean user_typed_name,
         else if (user_typed_name)
             alt = msglowercase(alt);
 
-        /* skip first record; read second */
-        txt_offset = 0L;
-        if (!dlb_fgets(buf, BUFSZ, fp) || !dlb_fgets(buf, BUFSZ, fp)) {
-            impossible("can't read 'data' file");
-            dlb_fclose(fp);
-            return;
-        } else if (sscanf(buf, "%8lx\n", &txt_offset) < 1 || txt_offset <= 0)
-            goto bad_data_file;
-
         /* look for the appropriate entry */
-        while (dlb_fgets(buf, BUFSZ, fp)) {
-            if (*buf == '.')
-                break;  /* we passed last entry without success */
-
-            if (digit(*buf)) {
-                /* a number indicates the end of current entry */
-                skipping_entry = FALSE;
-            } else if (!skipping_entry) {
-                if (!(ep = strchr(buf, '\n')))
-                    goto bad_data_file;
-                *ep = 0;
-                /* if we match a key that begins with "~", skip this entry */
-                chk_skip = (*buf == '~') ? 1 : 0;
-                if (pmatch(&buf[chk_skip], dbase_str) ||
-                    (alt && pmatch(&buf[chk_skip], alt))) {
-                    if (chk_skip) {
-                        skipping_entry = TRUE;
-                        continue;
-                    } else {
-                        found_in_file = TRUE;
-                        break;
-                    }
-                }
-            }
-        }
+        nlines = find_data_entry(fp, dbase_str, alt, &pos);
+        if (nlines < 0)
+            goto bad_data_file;
     }
 
-    if (found_in_file) {
-        long entry_offset;
-        int entry_count;
+    if (nlines > 0) {
         int i;
 
-        /* skip over other possible matches for the info */
-        do {
-            if (!dlb_fgets(buf, BUFSZ, fp))
-                goto bad_data_file;
-        } while (!digit(*buf));
-
-        if (sscanf(buf, "%ld,%d\n", &entry_offset, &entry_count) < 2) {
-        bad_data_file:impossible("'data' file in wrong format");
-            dlb_fclose(fp);
-            return;
-        }
-
         if (user_typed_name || without_asking || yn("More info?") == 'y') {
             struct nh_menulist menu;
 
-            if (dlb_fseek(fp, txt_offset + entry_offset, SEEK_SET) < 0) {
+            if (dlb_fseek(fp, pos, SEEK_SET) < 0) {
                 pline(msgc_saveload, "? Seek error on 'data' file!");
                 dlb_fclose(fp);
                 return;
@@ -589,7 +901,7 @@ checkfile(const char *inp, struct permonst *pm, boolean user_typed_name,
 
             init_menulist(&menu);
 
-            for (i = 0; i < entry_count; i++) {
+            for (i = 0; i < nlines; i++) {
                 if (!dlb_fgets(buf, BUFSZ, fp))
                     goto bad_data_file;
                 if ((ep = strchr(buf, '\n')) != 0)
@@ -606,6 +918,11 @@ checkfile(const char *inp, struct permonst *pm, boolean user_typed_name,
         pline(msgc_info, "I don't have any information on those things.");
 
     dlb_fclose(fp);
+    return;
+
+bad_data_file:
+    impossible("'data' file in wrong format");
+    dlb_fclose(fp);
 }
 
 
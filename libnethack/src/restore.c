@@ -232,6 +232,7 @@ restobjchn(struct memfile *mf, struct level *lev, boolean ghostly,
         /* we might need to produce an index, for speed in relinking IDs */
         if (table)
             trietable_add(table, otmp->o_id, otmp);
+        index_oid(otmp);
 
         /* get contents of a container or statue */
         if (Has_contents(otmp)) {
@@ -279,6 +280,7 @@ restmonchn(struct memfile *mf, struct level *lev, boolean ghostly)
                 mtmp->mhpmax = DEFUNCT_MONSTER;
             }
         }
+        index_mid(mtmp);
 
         if (mtmp->minvent) {
             restobjchn(mf, lev, ghostly, FALSE, &(mtmp->minvent), NULL);
@@ -889,8 +891,12 @@ dorecover(struct memfile *mf)
     /* restore levels */
     count = mread32(mf);
     for (; count; count--) {
+        int start;
+
         ltmp = mread8(mf);
+        start = mf->pos;
         getlev(mf, ltmp, FALSE);
+        level_save_cache_restored(ltmp, mf, start);
     }
 
     restgamestate(mf);
@@ -85,13 +85,58 @@ GEN_SAVE_DECODE(8, 0xFF)
 GEN_SAVE_DECODE(16, 0xFFFF)
 GEN_SAVE_DECODE(32, 0xFFFFFFFF)
 
+/* The save data of levels other than the current level usually doesn't change
+   from one turn to the next, so savegame() caches it, and writes out the
+   cached copy rather than regenerating it. Anything that changes a level other
+   than the current level must therefore call mark_level_dirty(). (This is only
+   safe with the levelrel save encoding; with other encodings, the save data
+   of a level can depend on the turn counter.) */
+static struct memfile_section level_save_cache[MAXLINFO];
+
+void
+mark_level_dirty(struct level *lev)
+{
+    lev->save_cached = FALSE;
+}
+
+/* Called by dorecover() once it has restored level levnum from the data
+   between start and the current position of mf. The cache is freshly cleared
+   when the level structure is reallocated, which happens every turn (the game
+   state is reloaded from the binary save), so without this it would never be
+   used. If the data read back is identical to what we cached, the cache still
+   describes the level, and can be reused. */
+void
+level_save_cache_restored(xchar levnum, struct memfile *mf, int start)
+{
+    const struct memfile_section *ms = level_save_cache + levnum;
+
+    if (flags.save_encoding == saveenc_levelrel && ms->buf &&
+        ms->len == mf->pos - start &&
+        memcmp(ms->buf, mf->buf + start, ms->len) == 0)
+        levels[levnum]->save_cached = TRUE;
+}
+
+void
+free_level_save_cache(void)
+{
+    int i;
+
+    for (i = 0; i < MAXLINFO; i++) {
+        msection_free(level_save_cache + i);
+        if (levels[i])
+            levels[i]->save_cached = FALSE;
+    }
+}
+
 /* The save code itself. */
 
 void
 savegame(struct memfile *mf)
 {
-    int count = 0;
+    int count = 0, start;
     xchar ltmp;
+    struct level *lev;
+    boolean use_cache = flags.save_encoding == saveenc_levelrel;
 
     /* no tag useful here as store_version adds one */
     store_version(mf);
@@ -119,9 +164,23 @@ savegame(struct memfile *mf)
     for (ltmp = 1; ltmp <= maxledgerno(); ltmp++) {
         if (!levels[ltmp])
             continue;
+        lev = levels[ltmp];
         mtag(mf, ltmp, MTAG_LEVELS);
         mwrite8(mf, ltmp);      /* level number */
+
+        /* The current level changes too often to be worth caching. */
+        if (use_cache && lev != level && lev->save_cached &&
+            !lev->flags.purge_monsters) {
+            msection_write(mf, level_save_cache + ltmp);
+            continue;
+        }
+
+        start = mf->pos;
         savelev(mf, ltmp);      /* actual level */
+        if (use_cache && lev != level) {
+            msection_save(level_save_cache + ltmp, mf, start);
+            lev->save_cached = TRUE;
+        }
     }
     savegamestate(mf);
 
@@ -1006,6 +1065,10 @@ freedynamicdata(void)
     free_dungeon();
     free_history();
 
+    /* everything in these should have been deallocated by now */
+    clear_oid_index();
+    clear_mid_index();
+
     if (flags.last_str_buf) {
         free(flags.last_str_buf);
         flags.last_str_buf = NULL;
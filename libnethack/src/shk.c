@@ -5,6 +5,7 @@
 
 #include "hack.h"
 #include "eshk.h"
+#include "trietable.h"
 
 /*#define DEBUG*/
 
@@ -58,6 +59,7 @@ static void add_to_billobjs(struct obj *);
 static void bill_box_content(struct obj *, boolean, boolean, struct monst *);
 static boolean rob_shop(struct monst *);
 static struct obj *find_oid_lev(struct level *lev, unsigned id);
+static struct obj *find_oid_slow(unsigned id);
 
 /*
     invariants: obj->unpaid iff onbill(obj) [unless bp->useup]
@@ -168,6 +170,7 @@ shkgone(struct monst *mtmp)
     char *p;
     int sx, sy;
 
+    mark_level_dirty(shoplev);
     remove_damage(mtmp, TRUE);
     sroom->resident = NULL;
 
@@ -1751,6 +1754,45 @@ find_oid_lev(struct level *lev, unsigned id)
     return NULL;
 }
 
+/*
+ * An index from object IDs to objects, to save find_oid() from searching every
+ * object chain in the game. Like the monster ID index in light.c, it's filled
+ * in as objects are restored and whenever a search finds one, and objects are
+ * removed as they're deallocated; but an entry is only a hint, because objects
+ * are moved between chains without updating it.
+ */
+static struct trietable *oid_index = NULL;
+
+void
+index_oid(struct obj *obj)
+{
+    trietable_add(&oid_index, obj->o_id, obj);
+}
+
+void
+unindex_oid(struct obj *obj)
+{
+    if (trietable_find(&oid_index, obj->o_id) == obj)
+        trietable_remove(&oid_index, obj->o_id);
+}
+
+void
+clear_oid_index(void)
+{
+    trietable_empty(&oid_index);
+}
+
+/* Is obj somewhere that find_oid() searches? */
+static boolean
+obj_findable(const struct obj *obj)
+{
+    while (obj->where == OBJ_CONTAINED)
+        obj = obj->ocontainer;
+
+    return obj->where == OBJ_FLOOR || obj->where == OBJ_BURIED ||
+        obj->where == OBJ_INVENT || obj->where == OBJ_MINVENT;
+}
+
 /*
  * Look for o_id on all lists but billobj.  Return obj or NULL if not found.
  * It's OK for restore_timers() to call this function, there should not
@@ -1758,6 +1800,21 @@ find_oid_lev(struct level *lev, unsigned id)
  */
 struct obj *
 find_oid(unsigned id)
+{
+    struct obj *obj;
+
+    obj = trietable_find(&oid_index, id);
+    if (obj && obj->o_id == id && obj_findable(obj))
+        return obj;
+
+    obj = find_oid_slow(id);
+    if (obj)
+        index_oid(obj);
+    return obj;
+}
+
+static struct obj *
+find_oid_slow(unsigned id)
 {
     struct obj *obj;
     struct monst *mon;
@@ -2945,6 +3002,7 @@ remove_damage(struct monst *shkp, boolean croaked)
     uchar saw_walls = 0;
     struct level *lev = levels[ledger_no(&ESHK(shkp)->shoplevel)];
 
+    mark_level_dirty(lev);
     tmp_dam = lev->damagelist;
     tmp2_dam = 0;
     while (tmp_dam) {
@@ -3068,6 +3126,7 @@ repair_damage(struct level *lev, struct monst *shkp, struct damage *tmp_dam,
             block_point(x, y);
         } else if (IS_WALL(tmp_dam->typ)) {
             lev->locations[x][y].typ = tmp_dam->typ;
+            mark_terrain_changed();
             block_point(x, y);
         }
         if (lev == level)
@@ -3083,6 +3142,7 @@ repair_damage(struct level *lev, struct monst *shkp, struct damage *tmp_dam,
         /* No messages if player already replaced shop door */
         return 1;
     lev->locations[x][y].typ = tmp_dam->typ;
+    mark_terrain_changed();
     memset(litter, 0, sizeof (litter));
     if ((otmp = lev->objects[x][y]) != 0) {
         /* Scatter objects haphazardly into the shop */
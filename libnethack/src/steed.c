@@ -648,6 +648,7 @@ place_monster(struct monst *mon, int x, int y)
     }
     mon->mx = x;
     mon->my = y;
+    mark_level_dirty(mon->dlevel);
     if (isok(x, y))
         mon->dlevel->monsters[x][y] = mon;
     else
@@ -1158,7 +1158,7 @@ do_storms(void)
  *         Start a timer of kind 'kind' that will expire at time
  *         moves+'timeout'.  Call the function at 'func_index'
  *         in the timeout table using argument 'arg'.  Return TRUE if
- *         a timer was started.  This places the timer on a list ordered
+ *         a timer was started.  This places the timer on a queue ordered
  *         "sooner" to "later".  If an object, increment the object's
  *         timer count.
  *
@@ -1206,15 +1206,27 @@ do_storms(void)
  */
 
 static const char *kind_name(short);
-static void print_queue(struct nh_menulist *menu, timer_element *);
+static void print_queue(struct nh_menulist *menu, struct level *lev);
+static boolean timer_before(const timer_element *, const timer_element *);
+static int timer_cmp(const void *, const void *);
+static void heap_set(struct timer_queue *, int, timer_element *);
+static void heap_sift_up(struct timer_queue *, int);
+static void heap_sift_down(struct timer_queue *, int);
+static unsigned timer_hash(short, const void *);
+static void index_timer(struct timer_queue *, timer_element *);
+static void unindex_timer(struct timer_queue *, timer_element *);
+static void resize_index(struct timer_queue *, int);
 static void insert_timer(struct level *lev, timer_element * gnu);
-static timer_element *remove_timer(timer_element **, short, void *);
-static timer_element *peek_timer(timer_element **, short, const void *);
+static void unlink_timer(struct level *lev, timer_element *);
+static timer_element *remove_timer(struct level *, short, void *);
+static timer_element *peek_timer(struct level *, short, const void *);
+static timer_element **obj_timers(struct obj *, int *);
+static timer_element **sorted_timers(struct level *);
 static void write_timer(struct memfile *mf, timer_element *);
 static boolean mon_is_local(struct monst *);
 static boolean timer_is_local(timer_element *);
-static int maybe_write_timer(struct memfile *mf, struct level *lev, int range,
-                             boolean write_it);
+static int maybe_write_timer(struct memfile *mf, timer_element **timers,
+                             int count, int range, boolean write_it);
 
 typedef struct {
     timeout_proc f, cleanup;
@@ -1250,20 +1262,24 @@ kind_name(short kind)
 }
 
 static void
-print_queue(struct nh_menulist *menu, timer_element * base)
+print_queue(struct nh_menulist *menu, struct level *lev)
 {
-    timer_element *curr;
+    timer_element **timers, *curr;
+    int i;
 
-    if (!base) {
+    if (!lev->lev_timers.count) {
         add_menutext(menu, "<empty>");
     } else {
+        timers = sorted_timers(lev);
         add_menutext(menu, "timeout\tid\tkind\tcall");
-        for (curr = base; curr; curr = curr->next) {
+        for (i = 0; i < lev->lev_timers.count; i++) {
+            curr = timers[i];
             add_menutext(menu, msgprintf(
                              " %4u\t%4u\t%-6s #%d\t%s(%p)", curr->timeout,
                              curr->tid, kind_name(curr->kind), curr->func_index,
                              timeout_funcs[curr->func_index].name, curr->arg));
         }
+        free(timers);
     }
 }
 
@@ -1280,7 +1296,7 @@ wiz_timeout_queue(const struct nh_cmd_arg *arg)
     add_menutext(&menu, "");
     add_menutext(&menu, "Active timeout queue:");
     add_menutext(&menu, "");
-    print_queue(&menu, level->lev_timers);
+    print_queue(&menu, level);
 
     display_menu(&menu, NULL, PICK_NONE, PLHINT_ANYWHERE, NULL);
 
@@ -1299,12 +1315,13 @@ run_timers(void)
 
     /*
      * Always use the first element.  Elements may be added or deleted at
-     * any time.  The list is ordered, we are done when the first element
+     * any time.  The queue is ordered, we are done when the first element
      * is in the future.
      */
-    while (level->lev_timers && level->lev_timers->timeout <= moves) {
-        curr = level->lev_timers;
-        level->lev_timers = curr->next;
+    while (level->lev_timers.count &&
+           level->lev_timers.heap[0]->timeout <= moves) {
+        curr = level->lev_timers.heap[0];
+        unlink_timer(level, curr);
 
         if (curr->kind == TIMER_OBJECT)
             ((struct obj *)(curr->arg))->timed--;
@@ -1346,8 +1363,8 @@ start_timer(struct level *lev, long when, short kind, short func_index,
 
 
 /*
- * Remove the timer from the current list and free it up.  Return the time
- * it would have gone off, 0 if not found.
+ * Remove the timer from the queue and free it up.  Return the time it would
+ * have gone off, 0 if not found.
  */
 long
 stop_timer(struct level *lev, short func_index, void *arg)
@@ -1355,7 +1372,7 @@ stop_timer(struct level *lev, short func_index, void *arg)
     timer_element *doomed;
     long timeout;
 
-    doomed = remove_timer(&lev->lev_timers, func_index, arg);
+    doomed = remove_timer(lev, func_index, arg);
 
     if (doomed) {
         timeout = doomed->timeout;
@@ -1370,7 +1387,7 @@ stop_timer(struct level *lev, short func_index, void *arg)
 }
 
 /*
- * Look at the timer list for a timer.  Return the time it was
+ * Look at the timer queue for a timer.  Return the time it was
  * scheduled to go off, 0 if not found.
  */
 long
@@ -1378,7 +1395,7 @@ report_timer(struct level *lev, short func_index, const void *arg)
 {
     timer_element *checking;
 
-    checking = peek_timer(&lev->lev_timers, func_index, arg);
+    checking = peek_timer(lev, func_index, arg);
 
     if (checking) {
         return checking->timeout;
@@ -1393,15 +1410,20 @@ report_timer(struct level *lev, short func_index, const void *arg)
 void
 obj_move_timers(struct obj *src, struct obj *dest)
 {
-    int count;
-    timer_element *curr;
+    struct timer_queue *q = &src->olev->lev_timers;
+    timer_element **timers;
+    int i, count;
+
+    timers = obj_timers(src, &count);
+    for (i = 0; i < count; i++) {
+        /* the index is keyed on arg, so rehash the timer */
+        unindex_timer(q, timers[i]);
+        timers[i]->arg = dest;
+        index_timer(q, timers[i]);
+        dest->timed++;
+    }
+    free(timers);
 
-    for (count = 0, curr = src->olev->lev_timers; curr; curr = curr->next)
-        if (curr->kind == TIMER_OBJECT && curr->arg == src) {
-            curr->arg = dest;
-            dest->timed++;
-            count++;
-        }
     if (count != src->timed)
         panic("obj_move_timers");
     src->timed = 0;
@@ -1414,15 +1436,14 @@ obj_move_timers(struct obj *src, struct obj *dest)
 void
 obj_split_timers(struct obj *src, struct obj *dest)
 {
-    timer_element *curr, *next_timer = 0;
+    timer_element **timers;
+    int i, count;
 
-    for (curr = src->olev->lev_timers; curr; curr = next_timer) {
-        next_timer = curr->next;        /* things may be inserted */
-        if (curr->kind == TIMER_OBJECT && curr->arg == src) {
-            start_timer(dest->olev, curr->timeout - moves, TIMER_OBJECT,
-                        curr->func_index, dest);
-        }
-    }
+    timers = obj_timers(src, &count);
+    for (i = 0; i < count; i++)
+        start_timer(dest->olev, timers[i]->timeout - moves, TIMER_OBJECT,
+                    timers[i]->func_index, dest);
+    free(timers);
 }
 
 
@@ -1433,81 +1454,283 @@ obj_split_timers(struct obj *src, struct obj *dest)
 void
 obj_stop_timers(struct obj *obj)
 {
-    timer_element *curr, *prev, *next_timer = 0;
-
-    for (prev = 0, curr = obj->olev->lev_timers; curr; curr = next_timer) {
-        next_timer = curr->next;
-        if (curr->kind == TIMER_OBJECT && curr->arg == obj) {
-            if (prev)
-                prev->next = curr->next;
-            else
-                obj->olev->lev_timers = curr->next;
-            if (timeout_funcs[curr->func_index].cleanup)
-                (*timeout_funcs[curr->func_index].cleanup)(
-                    curr->arg, curr->timeout);
-            free(curr);
-        } else {
-            prev = curr;
-        }
+    timer_element **timers, *curr;
+    int i, count;
+
+    timers = obj_timers(obj, &count);
+    for (i = 0; i < count; i++) {
+        curr = timers[i];
+        unlink_timer(obj->olev, curr);
+        if (timeout_funcs[curr->func_index].cleanup)
+            (*timeout_funcs[curr->func_index].cleanup)(
+                curr->arg, curr->timeout);
+        free(curr);
     }
+    free(timers);
     obj->timed = 0;
 }
 
 
-/* Insert timer into the global queue */
+/*
+ * The timer queue.
+ *
+ * The timers on a level are kept in a binary heap, so that finding the next
+ * one to go off, adding one and removing one all take logarithmic time, and
+ * each timer remembers its position in the heap so that it can be removed from
+ * the middle. Timers are looked up by (func_index, arg) via a hash table whose
+ * chains are linked through the timers themselves.
+ *
+ * The heap isn't ordered by timeout alone: timers with the same timeout go off
+ * in the reverse of the order in which they were inserted (each timer gets a
+ * sequence number as it's inserted, for this purpose). The order of timers is
+ * visible in the save file, so must not depend on the heap's layout; anything
+ * that looks at timers in order sorts them first.
+ */
+
+/* Does a go off before b? */
+static boolean
+timer_before(const timer_element *a, const timer_element *b)
+{
+    if (a->timeout != b->timeout)
+        return a->timeout < b->timeout;
+    return a->seq > b->seq;
+}
+
+/* qsort comparator for arrays of timer_element pointers */
+static int
+timer_cmp(const void *a, const void *b)
+{
+    const timer_element *ta = *(timer_element *const *)a;
+    const timer_element *tb = *(timer_element *const *)b;
+
+    if (timer_before(ta, tb))
+        return -1;
+    if (timer_before(tb, ta))
+        return 1;
+    return 0;
+}
+
 static void
-insert_timer(struct level *lev, timer_element * gnu)
+heap_set(struct timer_queue *q, int pos, timer_element *timer)
 {
-    timer_element *curr, *prev;
-
-    for (prev = 0, curr = lev->lev_timers; curr; prev = curr, curr = curr->next)
-        /* For most purposes, > vs. >= has little effect. Using >=, however,
-           ensures that we load timers in the same order as when they were saved
-           to a file, which avoids desyncing the save. (We used to use > for
-           the same reason, but timers are now loaded in reverse order in order
-           to avoid a performance bottleneck.) */
-        if (curr->timeout >= gnu->timeout)
+    q->heap[pos] = timer;
+    timer->heappos = pos;
+}
+
+static void
+heap_sift_up(struct timer_queue *q, int pos)
+{
+    timer_element *timer = q->heap[pos];
+    int parent;
+
+    while (pos > 0) {
+        parent = (pos - 1) / 2;
+        if (!timer_before(timer, q->heap[parent]))
             break;
+        heap_set(q, pos, q->heap[parent]);
+        pos = parent;
+    }
+    heap_set(q, pos, timer);
+}
 
-    gnu->next = curr;
-    if (prev)
-        prev->next = gnu;
-    else
-        lev->lev_timers = gnu;
+static void
+heap_sift_down(struct timer_queue *q, int pos)
+{
+    timer_element *timer = q->heap[pos];
+    int child;
+
+    while ((child = 2 * pos + 1) < q->count) {
+        if (child + 1 < q->count &&
+            timer_before(q->heap[child + 1], q->heap[child]))
+            child++;
+        if (!timer_before(q->heap[child], timer))
+            break;
+        heap_set(q, pos, q->heap[child]);
+        pos = child;
+    }
+    heap_set(q, pos, timer);
 }
 
+static unsigned
+timer_hash(short func_index, const void *arg)
+{
+    uintptr_t a = (uintptr_t) arg;
+    unsigned h;
+
+    /* Object pointers are aligned, and integer args are small; mix all the
+       bits, because the table only looks at the bottom few. (The double shift
+       avoids a warning when uintptr_t is 32 bits wide.) */
+    h = (unsigned)a ^ (unsigned)(a >> 16 >> 16) ^ func_index * 0x9e3779b9u;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
 
-static timer_element *
-remove_timer(timer_element ** base, short func_index, void *arg)
+static void
+index_timer(struct timer_queue *q, timer_element *timer)
 {
-    timer_element *prev, *curr;
+    timer_element **chain =
+        &q->index[timer_hash(timer->func_index, timer->arg) &
+                  (q->indexsize - 1)];
 
-    for (prev = 0, curr = *base; curr; prev = curr, curr = curr->next)
-        if (curr->func_index == func_index && curr->arg == arg)
-            break;
+    timer->next = *chain;
+    *chain = timer;
+}
 
-    if (curr) {
-        if (prev)
-            prev->next = curr->next;
-        else
-            *base = curr->next;
+static void
+unindex_timer(struct timer_queue *q, timer_element *timer)
+{
+    timer_element **chain =
+        &q->index[timer_hash(timer->func_index, timer->arg) &
+                  (q->indexsize - 1)];
+
+    while (*chain != timer) {
+        if (!*chain)
+            panic("unindex_timer: timer not in index");
+        chain = &(*chain)->next;
+    }
+    *chain = timer->next;
+    timer->next = NULL;
+}
+
+static void
+resize_index(struct timer_queue *q, int size)
+{
+    int i;
+
+    free(q->index);
+    q->index = malloc(size * sizeof (timer_element *));
+    memset(q->index, 0, size * sizeof (timer_element *));
+    q->indexsize = size;
+
+    for (i = 0; i < q->count; i++)
+        index_timer(q, q->heap[i]);
+}
+
+/* Insert timer into the level's queue */
+static void
+insert_timer(struct level *lev, timer_element * gnu)
+{
+    struct timer_queue *q = &lev->lev_timers;
+
+    if (q->count == q->heapsize) {
+        q->heapsize = q->heapsize ? q->heapsize * 2 : 16;
+        q->heap = realloc(q->heap, q->heapsize * sizeof (timer_element *));
     }
+    if (q->count >= q->indexsize)
+        resize_index(q, q->indexsize ? q->indexsize * 2 : 16);
+
+    /* For most purposes, the order of timers with the same timeout has little
+       effect. Making the newest one go off first, however, ensures that we
+       load timers in the same order as when they were saved to a file (they're
+       loaded in reverse order), which avoids desyncing the save. */
+    gnu->seq = q->seq++;
+
+    index_timer(q, gnu);
+    heap_set(q, q->count++, gnu);
+    heap_sift_up(q, gnu->heappos);
+}
 
-    return curr;
+/* Take timer out of the level's queue, without freeing it */
+static void
+unlink_timer(struct level *lev, timer_element *timer)
+{
+    struct timer_queue *q = &lev->lev_timers;
+    timer_element *last;
+    int pos = timer->heappos;
+
+    if (pos < 0 || pos >= q->count || q->heap[pos] != timer)
+        panic("unlink_timer: timer not in queue");
+
+    unindex_timer(q, timer);
+
+    last = q->heap[--q->count];
+    if (last != timer) {
+        heap_set(q, pos, last);
+        heap_sift_up(q, pos);
+        heap_sift_down(q, last->heappos);
+    }
 }
 
 static timer_element *
-peek_timer(timer_element ** base, short func_index, const void *arg)
+remove_timer(struct level *lev, short func_index, void *arg)
 {
     timer_element *curr;
 
-    for (curr = *base; curr; curr = curr->next)
-        if (curr->func_index == func_index && curr->arg == arg)
-            break;
+    curr = peek_timer(lev, func_index, arg);
+    if (curr)
+        unlink_timer(lev, curr);
 
     return curr;
 }
 
+/* If there are several matching timers, finds the one that goes off first. */
+static timer_element *
+peek_timer(struct level *lev, short func_index, const void *arg)
+{
+    struct timer_queue *q = &lev->lev_timers;
+    timer_element *curr, *found = NULL;
+
+    if (!q->indexsize)
+        return NULL;
+
+    for (curr = q->index[timer_hash(func_index, arg) & (q->indexsize - 1)];
+         curr; curr = curr->next)
+        if (curr->func_index == func_index && curr->arg == arg &&
+            (!found || timer_before(curr, found)))
+            found = curr;
+
+    return found;
+}
+
+/* Returns the timers attached to obj, in the order that they'll go off, in an
+   array allocated with malloc() (or NULL if there are none); its length is
+   stored in *count. */
+static timer_element **
+obj_timers(struct obj *obj, int *count)
+{
+    struct timer_queue *q = &obj->olev->lev_timers;
+    timer_element **timers = NULL, *curr;
+    int f, n = 0, size = 0;
+
+    for (f = 0; q->indexsize && f < NUM_TIME_FUNCS; f++)
+        for (curr = q->index[timer_hash(f, obj) & (q->indexsize - 1)];
+             curr; curr = curr->next)
+            if (curr->kind == TIMER_OBJECT && curr->func_index == f &&
+                curr->arg == obj) {
+                if (n == size) {
+                    size = size ? size * 2 : 4;
+                    timers = realloc(timers, size * sizeof (timer_element *));
+                }
+                timers[n++] = curr;
+            }
+
+    if (n > 1)
+        qsort(timers, n, sizeof (timer_element *), timer_cmp);
+    *count = n;
+    return timers;
+}
+
+/* Returns all the timers on lev, in the order that they'll go off, in an array
+   allocated with malloc() (or NULL if there are none). */
+static timer_element **
+sorted_timers(struct level *lev)
+{
+    struct timer_queue *q = &lev->lev_timers;
+    timer_element **timers;
+
+    if (!q->count)
+        return NULL;
+
+    timers = malloc(q->count * sizeof (timer_element *));
+    memcpy(timers, q->heap, q->count * sizeof (timer_element *));
+    qsort(timers, q->count, sizeof (timer_element *), timer_cmp);
+    return timers;
+}
+
 static void
 write_timer(struct memfile *mf, timer_element * timer)
 {
@@ -1614,18 +1837,19 @@ timer_is_local(timer_element * timer)
  * be written.  If write_it is true, actually write the timer.
  */
 static int
-maybe_write_timer(struct memfile *mf, struct level *lev, int range,
-                  boolean write_it)
+maybe_write_timer(struct memfile *mf, timer_element **timers, int count,
+                  int range, boolean write_it)
 {
-    int count = 0;
+    int i, written = 0;
     timer_element *curr;
 
-    for (curr = lev->lev_timers; curr; curr = curr->next) {
+    for (i = 0; i < count; i++) {
+        curr = timers[i];
         if (range == RANGE_GLOBAL) {
             /* global timers */
 
             if (!timer_is_local(curr)) {
-                count++;
+                written++;
                 if (write_it)
                     write_timer(mf, curr);
             }
@@ -1634,7 +1858,7 @@ maybe_write_timer(struct memfile *mf, struct level *lev, int range,
             /* local timers */
 
             if (timer_is_local(curr)) {
-                count++;
+                written++;
                 if (write_it)
                     write_timer(mf, curr);
             }
@@ -1642,7 +1866,7 @@ maybe_write_timer(struct memfile *mf, struct level *lev, int range,
         }
     }
 
-    return count;
+    return written;
 }
 
 
@@ -1650,29 +1874,33 @@ void
 transfer_timers(struct level *oldlev, struct level *newlev,
                 unsigned int obj_id)
 {
-    timer_element *curr, *prev = NULL, *next_timer = NULL;
+    struct timer_queue *q = &oldlev->lev_timers;
+    timer_element **moving, *curr;
+    int i, count = 0;
 
-    if (newlev == oldlev)
+    if (newlev == oldlev || !q->count)
         return;
 
-    for (curr = oldlev->lev_timers; curr; curr = next_timer) {
-        next_timer = curr->next;        /* in case curr is removed */
+    moving = malloc(q->count * sizeof (timer_element *));
+    for (i = 0; i < q->count; i++) {
+        curr = q->heap[i];
 
 	/* transfer global timers or timers of requested object */
 	if ((!obj_id && !timer_is_local(curr)) ||
 	    (obj_id && curr->kind == TIMER_OBJECT &&
-	     ((struct obj *)curr->arg)->o_id == obj_id)) {
-            if (prev)
-                prev->next = curr->next;
-            else
-                oldlev->lev_timers = curr->next;
+	     ((struct obj *)curr->arg)->o_id == obj_id))
+            moving[count++] = curr;
+    }
 
-            insert_timer(newlev, curr);
-            /* prev stays the same */
-        } else {
-            prev = curr;
-        }
+    /* move them in the order they'll go off, so that timers with the same
+       timeout end up in a consistent order */
+    if (count > 1)
+        qsort(moving, count, sizeof (timer_element *), timer_cmp);
+    for (i = 0; i < count; i++) {
+        unlink_timer(oldlev, moving[i]);
+        insert_timer(newlev, moving[i]);
     }
+    free(moving);
 }
 
 
@@ -1692,28 +1920,33 @@ transfer_timers(struct level *oldlev, struct level *newlev,
 void
 save_timers(struct memfile *mf, struct level *lev, int range)
 {
+    timer_element **timers;
     int count;
 
     mtag(mf, 2 * (int)ledger_no(&lev->z) + range, MTAG_TIMERS);
     if (range == RANGE_GLOBAL)
         mwrite32(mf, timer_id);
 
-    count = maybe_write_timer(mf, lev, range, FALSE);
+    /* timers are saved in the order they'll go off */
+    timers = sorted_timers(lev);
+    count = maybe_write_timer(mf, timers, lev->lev_timers.count, range, FALSE);
     mwrite32(mf, count);
-    maybe_write_timer(mf, lev, range, TRUE);
+    maybe_write_timer(mf, timers, lev->lev_timers.count, range, TRUE);
+    free(timers);
 }
 
 
 void
 free_timers(struct level *lev)
 {
-    timer_element *curr, *next = NULL;
+    struct timer_queue *q = &lev->lev_timers;
+    int i;
 
-    for (curr = lev->lev_timers; curr; curr = next) {
-        next = curr->next;
-        free(curr);
-    }
-    lev->lev_timers = NULL;
+    for (i = 0; i < q->count; i++)
+        free(q->heap[i]);
+    free(q->heap);
+    free(q->index);
+    memset(q, 0, sizeof (struct timer_queue));
 }
 
 
@@ -1743,6 +1976,7 @@ restore_timers(struct memfile *mf, struct level *lev, int range,
 
     while (i-- > 0) {
         curr = malloc(sizeof (timer_element));
+        memset(curr, 0, sizeof (timer_element));
 
         curr->tid = mread32(mf);
         curr->timeout = mread32(mf);
@@ -1755,16 +1989,10 @@ restore_timers(struct memfile *mf, struct level *lev, int range,
         if (ghostly)
             curr->timeout += adjust;
 
-        /* The code here previously did `insert_timer(lev, curr);`. This is
-           correct in terms of code effect. However, because the timer list
-           is a linked list, and it's output front to back, and because the
-           list of timers must be maintained in order, that had quadratic
-           performance. Worse, during pudding farming, a /lot/ of timers are
-           generated (one for each pudding corpse).
-
-           Instead, we store the timers into an array temporarily, then add them
-           in the opposite order, making the performance linear rather than
-           quadratic. */
+        /* The timers were saved in the order they go off. Among timers with
+           the same timeout, the one inserted last goes off first, so we insert
+           them in the opposite order to the one they were saved in; that way,
+           they'll be saved in the same order again. */
         temp_timers[i] = curr;
     }
     for (i = 0; i < count; i++)
@@ -1776,10 +2004,13 @@ restore_timers(struct memfile *mf, struct level *lev, int range,
 void
 relink_timers(boolean ghostly, struct level *lev, struct trietable **table)
 {
+    struct timer_queue *q = &lev->lev_timers;
     timer_element *curr;
     unsigned nid;
+    int i;
 
-    for (curr = lev->lev_timers; curr; curr = curr->next) {
+    for (i = 0; i < q->count; i++) {
+        curr = q->heap[i];
         if (curr->needs_fixup) {
             if (curr->kind == TIMER_OBJECT) {
                 if (ghostly) {
@@ -1788,6 +2019,9 @@ relink_timers(boolean ghostly, struct level *lev, struct trietable **table)
                 } else
                     nid = (intptr_t) curr->arg;
 
+                /* the index is keyed on arg, which is about to change */
+                unindex_timer(q, curr);
+
                 /* If necessary, we'll find the object in question using
                    find_oid. However, if we happened to cache its location in
                    a trietable, we can use that instead and save some time.
@@ -1810,6 +2044,8 @@ relink_timers(boolean ghostly, struct level *lev, struct trietable **table)
                 if (!curr->arg)
                     panic("cant find o_id %d", nid);
                 curr->needs_fixup = 0;
+
+                index_timer(q, curr);
             } else
                 panic("relink_timers 2");
         }
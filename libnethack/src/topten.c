@@ -10,6 +10,7 @@
 
 #include <fcntl.h>
 #include <inttypes.h>
+#include <sys/stat.h>
 
 /* 10000 highscore entries should be enough for _anybody_
  * <500 bytes per entry * 10000 ~= 5MB max file size. Seems reasonable. */
@@ -42,15 +43,88 @@ struct toptenentry {
 
 #define validentry(x) ((x).points > 0 || (x).deathlev)
 
-static void writeentry(int fd, const struct toptenentry *tt);
-static void write_topten(int fd, const struct toptenentry *ttlist);
+/*
+ * The record file is a text file in rank order, which external tools rely on;
+ * but reading it means parsing every line. RECORD_INDEX holds the same list in
+ * a binary form that can be read piecemeal:
+ *
+ * - a struct ttindex_header;
+ * - hdr.count struct toptenentry, in rank order, exactly as read_topten() would
+ *   read them from the record;
+ * - hdr.count + 1 byte offsets of the lines of the record (the last one being
+ *   the end of the list);
+ * - hdr.count struct ttindex_name, sorted by name and then by rank.
+ *
+ * The index is only used if the size and modification time (to the nanosecond,
+ * where the OS records that) of the record match the ones in its header; if
+ * anything else changes the record, we go back to parsing it, and the next
+ * update_topten() rebuilds the index. Both files are write-locked while
+ * update_topten() changes them, and the index is read-locked while being read.
+ */
+#define TTINDEX_MAGIC "NH4TTIX"
+
+struct ttindex_header {
+    char magic[8];
+    int entrysize;      /* sizeof (struct toptenentry) */
+    int count;
+    int_least64_t record_size;
+    int_least64_t record_mtime;
+    int_least64_t record_mtime_nsec;
+};
+
+struct ttindex_name {
+    char name[NAMSZ + 1];
+    int rank;
+};
+
+#define TTINDEX_ENTRIES ((int_least64_t)sizeof (struct ttindex_header))
+#define TTINDEX_OFFSETS(count) \
+    (TTINDEX_ENTRIES + (int_least64_t)(count) * sizeof (struct toptenentry))
+#define TTINDEX_NAMES(count) \
+    (TTINDEX_OFFSETS(count) + ((int_least64_t)(count) + 1) * \
+     sizeof (int_least64_t))
+#define TTINDEX_SIZE(count) \
+    (TTINDEX_NAMES(count) + (int_least64_t)(count) * \
+     sizeof (struct ttindex_name))
+
+/* Where score entries are read from: the index, or if that's unusable, the
+   whole list parsed from the record. */
+struct toptensource {
+    int fd;                     /* the index, or -1 */
+    struct toptenentry *ttlist; /* if fd == -1 */
+    int count;
+};
+
+static int format_entry(char *buf, int bufsize, const struct toptenentry *tt);
+static int writeentry(int fd, const struct toptenentry *tt);
+static void write_topten(int fd, struct toptenentry *ttlist, int from,
+                         int_least64_t *offsets);
 static void update_log(const struct toptenentry *newtt);
 static boolean readentry(char *line, struct toptenentry *tt);
-static struct toptenentry *read_topten(int fd, int limit);
+static void normalize_entry(struct toptenentry *tt);
+static struct toptenentry *read_topten(int fd, int limit,
+                                       int_least64_t *offsets);
+static boolean read_at(int fd, int_least64_t offset, void *buf, int len);
+static boolean write_at(int fd, int_least64_t offset, const void *buf,
+                        int len);
+static int open_topten_index(int recfd, int oflags, int locktype,
+                             struct ttindex_header *hdr);
+static void write_topten_index(int ifd, int recfd,
+                               const struct toptenentry *ttlist, int count,
+                               const int_least64_t *offsets);
+static void open_topten_source(struct toptensource *ts, int recfd);
+static void close_topten_source(struct toptensource *ts);
+static boolean get_topten_entries(struct toptensource *ts, int first, int n,
+                                  struct toptenentry *out);
+static int find_topten_entry(struct toptensource *ts,
+                             const struct toptenentry *tt);
+static int *find_player_entries(struct toptensource *ts, const char *name,
+                                int *n);
 static void fill_topten_entry(struct toptenentry *newtt, int how,
                               const char *killer);
-static boolean toptenlist_insert(struct toptenentry *ttlist,
-                                 struct toptenentry *newtt);
+static int toptenlist_insert(struct toptenentry *ttlist,
+                             struct toptenentry *newtt);
+static void add_to_record(int fd, struct toptenentry *newtt);
 static int classmon(char *plch, boolean fem);
 static void topten_death_description(struct toptenentry *in, char *outbuf);
 static void fill_nh_score_entry(struct toptenentry *in,
@@ -288,40 +362,51 @@ write_xlentry(FILE * rfile, const struct toptenentry *tt,
 #undef SEP
 #undef SEPC
 
-static void
+/* Formats tt as a line of the record; returns its length. */
+static int
+format_entry(char *buf, int bufsize, const struct toptenentry *tt)
+{
+    snprintf(buf, bufsize, "%d.%d.%d %d %d %d %d %d %d %d %d %d %d "
+             "%d %d %s %s %s %s %s,%s\n",
+             tt->ver_major, tt->ver_minor, tt->patchlevel, tt->points,
+             tt->deathdnum, tt->deathlev, tt->maxlvl, tt->hp, tt->maxhp,
+             tt->deaths, tt->deathdate, tt->birthdate, tt->uid,
+             tt->moves, tt->how, tt->plrole, tt->plrace, tt->plgend,
+             tt->plalign, onlyspace(tt->name) ? "_" : tt->name, tt->death);
+    return strlen(buf);
+}
+
+static int
 writeentry(int fd, const struct toptenentry *tt)
 {
     char buf[1024];
     int len;
 
-    snprintf(buf, 1024, "%d.%d.%d %d %d %d %d %d %d %d %d %d %d ",
-             tt->ver_major, tt->ver_minor, tt->patchlevel, tt->points,
-             tt->deathdnum, tt->deathlev, tt->maxlvl, tt->hp, tt->maxhp,
-             tt->deaths, tt->deathdate, tt->birthdate, tt->uid);
-    len = strlen(buf);
+    len = format_entry(buf, sizeof buf, tt);
     if (write(fd, buf, len) != len)
         panic("Failed to write topten. Out of disk?");
 
-    snprintf(buf, 1024, "%d %d %s %s %s %s %s,%s\n", tt->moves, tt->how,
-             tt->plrole, tt->plrace, tt->plgend, tt->plalign,
-             onlyspace(tt->name) ? "_" : tt->name, tt->death);
-    len = strlen(buf);
-    if (write(fd, buf, len) != len)
-        panic("Failed to write topten. Out of disk?");
+    return len;
 }
 
 
+/* Rewrites the record from entry from onwards (the earlier entries being
+   unchanged), updating offsets to match. */
 static void
-write_topten(int fd, const struct toptenentry *ttlist)
+write_topten(int fd, struct toptenentry *ttlist, int from,
+             int_least64_t *offsets)
 {
+    int_least64_t pos = offsets[from];
     int i;
 
-    lseek(fd, 0, SEEK_SET);
-    if (ftruncate(fd, 0) >= 0)
-        for (i = 0; i < TTLISTLEN && validentry(ttlist[i]); i++)
-            writeentry(fd, &ttlist[i]);
-    else
+    if (lseek(fd, pos, SEEK_SET) != pos || ftruncate(fd, pos) < 0)
         panic("Failed to write topten. Is the record file writable?");
+
+    for (i = from; i < TTLISTLEN && validentry(ttlist[i]); i++) {
+        offsets[i] = pos;
+        pos += writeentry(fd, &ttlist[i]);
+    }
+    offsets[i] = pos;
 }
 
 
@@ -383,13 +468,31 @@ readentry(char *line, struct toptenentry *tt)
 }
 
 
+/* Gives tt the value it would have after a round trip through the record. */
+static void
+normalize_entry(struct toptenentry *tt)
+{
+    char buf[1024];
+
+    format_entry(buf, sizeof buf, tt);
+    memset(tt, 0, sizeof (struct toptenentry));
+    readentry(buf, tt);
+}
+
+
+/* If offsets is not NULL, it must have room for limit + 1 values; the offset
+   of each entry's line is stored there, followed by the offset of the end of
+   the list. */
 static struct toptenentry *
-read_topten(int fd, int limit)
+read_topten(int fd, int limit, int_least64_t *offsets)
 {
     int i, size;
     struct toptenentry *ttlist;
     char *data, *line;
 
+    if (offsets)
+        offsets[0] = 0;
+
     lseek(fd, 0, SEEK_SET);
     data = loadfile(fd, &size);
     if (!data)
@@ -405,6 +508,8 @@ read_topten(int fd, int limit)
         if (!readentry(line, &ttlist[i]))
             break;
         line = strchr(line, '\n') + 1;
+        if (offsets)
+            offsets[i + 1] = line - data;
     }
 
     free(data);
@@ -412,6 +517,294 @@ read_topten(int fd, int limit)
 }
 
 
+static boolean
+read_at(int fd, int_least64_t offset, void *buf, int len)
+{
+    char *p = buf;
+    int ret;
+
+    if (lseek(fd, offset, SEEK_SET) != offset)
+        return FALSE;
+
+    while (len > 0) {
+        ret = read(fd, p, len);
+        if (ret <= 0)
+            return FALSE;
+        p += ret;
+        len -= ret;
+    }
+    return TRUE;
+}
+
+
+static boolean
+write_at(int fd, int_least64_t offset, const void *buf, int len)
+{
+    const char *p = buf;
+    int ret;
+
+    if (lseek(fd, offset, SEEK_SET) != offset)
+        return FALSE;
+
+    while (len > 0) {
+        ret = write(fd, p, len);
+        if (ret <= 0)
+            return FALSE;
+        p += ret;
+        len -= ret;
+    }
+    return TRUE;
+}
+
+
+/* The nanoseconds part of a file's modification time, or 0 if we don't know
+   how to find it on this OS. Without it, a record rewritten with the same size
+   within a second of the index being written would look unchanged. */
+static int_least64_t
+mtime_nsec(const struct stat *st)
+{
+#if defined(AIMAKE_BUILDOS_linux) || defined(AIMAKE_BUILDOS_freebsd)
+    return st->st_mtim.tv_nsec;
+#elif defined(AIMAKE_BUILDOS_darwin)
+    return st->st_mtimespec.tv_nsec;
+#else
+    (void) st;
+    return 0;
+#endif
+}
+
+
+/* Opens and locks the index, and checks that it describes the record open on
+   recfd. Returns -1 if there's no usable index; otherwise, the file descriptor
+   (with hdr filled in). If oflags include O_CREAT, a stale or missing index
+   is not an error, and hdr->count is set to -1 to indicate that it needs to be
+   rebuilt. */
+static int
+open_topten_index(int recfd, int oflags, int locktype,
+                  struct ttindex_header *hdr)
+{
+    struct stat st;
+    int fd;
+
+    fd = open_datafile(RECORD_INDEX, oflags, SCOREPREFIX);
+    if (fd < 0)
+        return -1;
+
+    /* The record must be checked after we have the lock, so that we don't see
+       a record and index from different updates. */
+    if (!change_fd_lock(fd, FALSE, locktype, 10) || fstat(recfd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    if (!read_at(fd, 0, hdr, sizeof (struct ttindex_header)) ||
+        memcmp(hdr->magic, TTINDEX_MAGIC, sizeof hdr->magic) ||
+        hdr->entrysize != (int)sizeof (struct toptenentry) ||
+        hdr->count < 0 || hdr->count > TTLISTLEN ||
+        hdr->record_size != (int_least64_t)st.st_size ||
+        hdr->record_mtime != (int_least64_t)st.st_mtime ||
+        hdr->record_mtime_nsec != mtime_nsec(&st) ||
+        lseek(fd, 0, SEEK_END) != TTINDEX_SIZE(hdr->count)) {
+        if (oflags & O_CREAT) {
+            hdr->count = -1;
+            return fd;
+        }
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+static int
+ttindex_name_cmp(const void *a, const void *b)
+{
+    const struct ttindex_name *na = a, *nb = b;
+    int c = strcmp(na->name, nb->name);
+
+    return c ? c : na->rank - nb->rank;
+}
+
+/* Rewrites the index to match the record open on recfd. The header is written
+   last, so that an interrupted write leaves an index that doesn't match. */
+static void
+write_topten_index(int ifd, int recfd, const struct toptenentry *ttlist,
+                   int count, const int_least64_t *offsets)
+{
+    struct ttindex_header hdr;
+    struct ttindex_name *names;
+    struct stat st;
+    boolean ok;
+    int i;
+
+    if (fstat(recfd, &st) < 0 || ftruncate(ifd, 0) < 0)
+        return;
+
+    names = calloc(count ? count : 1, sizeof (struct ttindex_name));
+    for (i = 0; i < count; i++) {
+        strcpy(names[i].name, ttlist[i].name);
+        names[i].rank = i;
+    }
+    qsort(names, count, sizeof (struct ttindex_name), ttindex_name_cmp);
+
+    memset(&hdr, 0, sizeof hdr);
+    memcpy(hdr.magic, TTINDEX_MAGIC, sizeof hdr.magic);
+    hdr.entrysize = sizeof (struct toptenentry);
+    hdr.count = count;
+    hdr.record_size = st.st_size;
+    hdr.record_mtime = st.st_mtime;
+    hdr.record_mtime_nsec = mtime_nsec(&st);
+
+    ok = write_at(ifd, TTINDEX_ENTRIES, ttlist,
+                  count * sizeof (struct toptenentry)) &&
+        write_at(ifd, TTINDEX_OFFSETS(count), offsets,
+                 (count + 1) * sizeof (int_least64_t)) &&
+        write_at(ifd, TTINDEX_NAMES(count), names,
+                 count * sizeof (struct ttindex_name)) &&
+        write_at(ifd, 0, &hdr, sizeof hdr);
+
+    /* The record is what matters; if the index can't be written, it'll just
+       be ignored. */
+    if (!ok && ftruncate(ifd, 0) < 0)
+        impossible("Failed to write or remove the score index.");
+
+    free(names);
+}
+
+
+static void
+open_topten_source(struct toptensource *ts, int recfd)
+{
+    struct ttindex_header hdr;
+
+    ts->ttlist = NULL;
+    ts->fd = open_topten_index(recfd, O_RDONLY, LT_READ, &hdr);
+    if (ts->fd >= 0) {
+        ts->count = hdr.count;
+        return;
+    }
+
+    ts->ttlist = read_topten(recfd, TTLISTLEN, NULL);
+    for (ts->count = 0;
+         ts->count < TTLISTLEN && validentry(ts->ttlist[ts->count]);
+         ts->count++)
+        ;
+}
+
+static void
+close_topten_source(struct toptensource *ts)
+{
+    if (ts->fd >= 0) {
+        change_fd_lock(ts->fd, FALSE, LT_NONE, 0);
+        close(ts->fd);
+    }
+    free(ts->ttlist);
+}
+
+/* Reads the n entries starting at rank first (counting from 0). */
+static boolean
+get_topten_entries(struct toptensource *ts, int first, int n,
+                   struct toptenentry *out)
+{
+    if (first < 0 || n < 0 || first + n > ts->count)
+        return FALSE;
+
+    if (ts->fd < 0) {
+        memcpy(out, ts->ttlist + first, n * sizeof (struct toptenentry));
+        return TRUE;
+    }
+
+    return read_at(ts->fd, TTINDEX_ENTRIES + (int_least64_t)first *
+                   sizeof (struct toptenentry), out,
+                   n * sizeof (struct toptenentry));
+}
+
+/* Returns the rank of the last entry identical to tt, or -1. Entries are in
+   descending order of points, so we can binary search for tt's points. */
+static int
+find_topten_entry(struct toptensource *ts, const struct toptenentry *tt)
+{
+    struct toptenentry e;
+    int lo = 0, hi = ts->count, mid, rank = -1;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (!get_topten_entries(ts, mid, 1, &e))
+            return -1;
+        if (e.points > tt->points)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for (; get_topten_entries(ts, lo, 1, &e) && e.points == tt->points; lo++)
+        if (!memcmp(&e, tt, sizeof (struct toptenentry)))
+            rank = lo;
+
+    return rank;
+}
+
+/* Returns the ranks of name's entries, in increasing order, in an array
+   allocated with malloc(); *n is set to their number. */
+static int *
+find_player_entries(struct toptensource *ts, const char *name, int *n)
+{
+    struct ttindex_name *names, probe;
+    int *ranks, lo, hi, mid, first, i;
+
+    *n = 0;
+    ranks = malloc((ts->count ? ts->count : 1) * sizeof (int));
+
+    if (ts->fd < 0) {
+        for (i = 0; i < ts->count; i++)
+            if (!strcmp(name, ts->ttlist[i].name))
+                ranks[(*n)++] = i;
+        return ranks;
+    }
+
+    /* The by-name table is sorted; find the first and last entries with this
+       name, then read everything in between. */
+    for (lo = 0, hi = ts->count; lo < hi;) {
+        mid = lo + (hi - lo) / 2;
+        if (!read_at(ts->fd, TTINDEX_NAMES(ts->count) +
+                     (int_least64_t)mid * sizeof probe, &probe, sizeof probe))
+            return ranks;
+        probe.name[NAMSZ] = '\0';
+        if (strcmp(probe.name, name) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    first = lo;
+
+    for (hi = ts->count; lo < hi;) {
+        mid = lo + (hi - lo) / 2;
+        if (!read_at(ts->fd, TTINDEX_NAMES(ts->count) +
+                     (int_least64_t)mid * sizeof probe, &probe, sizeof probe))
+            return ranks;
+        probe.name[NAMSZ] = '\0';
+        if (strcmp(probe.name, name) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == first)
+        return ranks;
+
+    names = malloc((lo - first) * sizeof (struct ttindex_name));
+    if (read_at(ts->fd, TTINDEX_NAMES(ts->count) +
+                (int_least64_t)first * sizeof (struct ttindex_name), names,
+                (lo - first) * sizeof (struct ttindex_name)))
+        for (i = 0; i < lo - first; i++)
+            ranks[(*n)++] = names[i].rank;
+    free(names);
+
+    return ranks;
+}
+
+
 static void
 fill_topten_entry(struct toptenentry *newtt, int how, const char *killer)
 {
@@ -457,7 +850,8 @@ fill_topten_entry(struct toptenentry *newtt, int how, const char *killer)
 }
 
 
-static boolean
+/* Returns the rank at which newtt was inserted, or -1 if it wasn't. */
+static int
 toptenlist_insert(struct toptenentry *ttlist, struct toptenentry *newtt)
 {
     int i, ins, del, occ_cnt;
@@ -474,7 +868,7 @@ toptenlist_insert(struct toptenentry *ttlist, struct toptenentry *newtt)
 
     if (occ_cnt >= PLAYERMAX || ins == TTLISTLEN)
         /* this game doesn't get onto the list */
-        return FALSE;
+        return -1;
 
     /* If the player already has PLAYERMAX entries in the list, find the last
        one. Otherwise del is either the first empty entry or TTLISTLEN if the
@@ -496,7 +890,57 @@ toptenlist_insert(struct toptenentry *ttlist, struct toptenentry *newtt)
 
     ttlist[ins] = *newtt;
 
-    return TRUE;
+    return ins;
+}
+
+/* Adds newtt to the record open (and write-locked) on fd, if it belongs there,
+   and brings the index up to date. */
+static void
+add_to_record(int fd, struct toptenentry *newtt)
+{
+    struct toptenentry *toptenlist;
+    struct ttindex_header hdr;
+    int_least64_t *offsets;
+    int ifd, ins, count;
+
+    /* Load the list from the index if we can, because that doesn't involve
+       parsing it. */
+    offsets = calloc(TTLISTLEN + 1, sizeof (int_least64_t));
+    ifd = open_topten_index(fd, O_RDWR | O_CREAT, LT_WRITE, &hdr);
+    if (ifd >= 0 && hdr.count >= 0) {
+        toptenlist = calloc(TTLISTLEN + 1, sizeof (struct toptenentry));
+        if (!read_at(ifd, TTINDEX_ENTRIES, toptenlist,
+                     hdr.count * sizeof (struct toptenentry)) ||
+            !read_at(ifd, TTINDEX_OFFSETS(hdr.count), offsets,
+                     (hdr.count + 1) * sizeof (int_least64_t))) {
+            free(toptenlist);
+            hdr.count = -1;
+        }
+    }
+    if (ifd < 0 || hdr.count < 0)
+        toptenlist = read_topten(fd, TTLISTLEN, offsets);
+
+    /* possibly rearrange the score list to include the new entry; the entry
+       is stored as it will be read back from the record, so that the index
+       matches it */
+    normalize_entry(newtt);
+    ins = toptenlist_insert(toptenlist, newtt);
+    if (ins >= 0)
+        write_topten(fd, toptenlist, ins, offsets);
+
+    if (ifd >= 0) {
+        if (ins >= 0 || hdr.count < 0) {
+            for (count = 0; count < TTLISTLEN && validentry(toptenlist[count]);
+                 count++)
+                ;
+            write_topten_index(ifd, fd, toptenlist, count, offsets);
+        }
+        change_fd_lock(ifd, FALSE, LT_NONE, 0);
+        close(ifd);
+    }
+
+    free(toptenlist);
+    free(offsets);
 }
 
 /*
@@ -506,8 +950,7 @@ void
 update_topten(int how, const char *killer, unsigned long carried,
               const char *dumpname)
 {
-    struct toptenentry *toptenlist, newtt;
-    boolean need_rewrite;
+    struct toptenentry newtt;
     int fd;
 
     if (program_state.panicking)
@@ -535,16 +978,10 @@ update_topten(int how, const char *killer, unsigned long carried,
         return;
     }
 
-    toptenlist = read_topten(fd, TTLISTLEN);
-
-    /* possibly rearrange the score list to include the new entry */
-    need_rewrite = toptenlist_insert(toptenlist, &newtt);
-    if (need_rewrite)
-        write_topten(fd, toptenlist);
+    add_to_record(fd, &newtt);
 
     change_fd_lock(fd, FALSE, LT_NONE, 0);
     close(fd);
-    free(toptenlist);
 }
 
 
@@ -578,6 +1015,7 @@ tt_oname(struct obj *otmp)
 {
     int rank, fd;
     struct toptenentry *toptenlist, *tt;
+    struct toptensource ts;
 
     if (!otmp)
         return NULL;
@@ -586,7 +1024,12 @@ tt_oname(struct obj *otmp)
     if (fd < 0)
         return NULL;   /* the topten list is missing */
 
-    toptenlist = read_topten(fd, 100);  /* load the top 100 scores */
+    /* load the top 100 scores */
+    toptenlist = calloc(100 + 1, sizeof (struct toptenentry));
+    open_topten_source(&ts, fd);
+    if (!get_topten_entries(&ts, 0, min(ts.count, 100), toptenlist))
+        memset(toptenlist, 0, 100 * sizeof (struct toptenentry));
+    close_topten_source(&ts);
     close(fd);
 
     /* try to find a valid entry, reducing the value range for rank each time */
@@ -756,17 +1199,25 @@ fill_nh_score_entry(struct toptenentry *in, struct nh_topten_entry *out,
 }
 
 
+static int
+int_cmp(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+
 struct nh_topten_entry *
 nh_get_topten(int *out_len, char *statusbuf, const char *volatile player,
               int top, int around, boolean own)
 {
     struct toptenentry *ttlist, newtt;
     struct nh_topten_entry *score_list;
+    struct toptensource ts;
     boolean game_inited = (wiz1_level.dlevel != 0);
     boolean game_complete = game_inited && moves && program_state.gameover;
     int rank = -1;      /* index of the completed game in the topten list */
-    int fd, i, j, sel_count;
-    boolean *selected;
+    int fd, i, j, sel_count, own_count, *selected, *own_ranks;
+    int ntop, naround;
     volatile boolean off_list = FALSE;
 
     statusbuf[0] = '\0';
@@ -791,27 +1242,22 @@ nh_get_topten(int *out_len, char *statusbuf, const char *volatile player,
     }
 
     fd = open_datafile(RECORD, O_RDONLY, SCOREPREFIX);
-    if (fd >= 0) {
-        ttlist = read_topten(fd, TTLISTLEN);
-        close(fd);
-    } else
-        ttlist = NULL;
-
-    if (!ttlist) {
+    if (fd < 0) {
         strcpy(statusbuf, "Cannot open record file!");
 
         API_EXIT();
         return NULL;
     }
 
+    open_topten_source(&ts, fd);
+
     /* find the rank of a completed game in the score list */
     if (game_complete && !strcmp(player, u.uplname)) {
         fill_topten_entry(&newtt, end_how, end_killer);
+        normalize_entry(&newtt);
 
         /* find this entry in the list */
-        for (i = 0; i < TTLISTLEN && validentry(ttlist[i]); i++)
-            if (!memcmp(&ttlist[i], &newtt, sizeof (struct toptenentry)))
-                rank = i;
+        rank = find_topten_entry(&ts, &newtt);
 
         /* TODO: Perhaps we could have a different top ten list for play on a
            particular set seed (seed of the week, as it were). But there's too
@@ -830,28 +1276,56 @@ nh_get_topten(int *out_len, char *statusbuf, const char *volatile player,
                     rank + 1, ordin(rank + 1));
     }
 
-    /* select scores for display */
+    /* select scores for display: the ranks of the top scores, the player's
+       own scores, and the scores around the completed game, then sorted with
+       duplicates removed (top and around are copied rather than modified,
+       because they're live across the API checkpoint's setjmp); both come
+       from the client, so they're clamped to the list before being used in
+       any arithmetic, and any negative top means the whole list */
+    ntop = (top < 0 || top > ts.count) ? ts.count : top;
+    naround = around < 0 ? 0 : around > ts.count ? ts.count : around;
+
+    own_ranks = own ? find_player_entries(&ts, player, &own_count) : NULL;
+    if (!own)
+        own_count = 0;
+
+    selected = malloc((ntop + own_count + min(2 * naround + 1, ts.count) + 1) *
+                      sizeof (int));
     sel_count = 0;
-    selected = calloc(TTLISTLEN, sizeof (boolean));
-
-    for (i = 0; i < TTLISTLEN && validentry(ttlist[i]); i++) {
-        if (top == -1 || i < top)
-            selected[i] = TRUE;
-
-        if (own && !strcmp(player, ttlist[i].name))
-            selected[i] = TRUE;
-
-        if (rank != -1 && rank - around <= i && i <= rank + around)
-            selected[i] = TRUE;
-
-        if (selected[i])
-            sel_count++;
+    for (i = 0; i < ntop; i++)
+        selected[sel_count++] = i;
+    for (i = 0; i < own_count; i++)
+        if (own_ranks[i] >= ntop && own_ranks[i] < ts.count)
+            selected[sel_count++] = own_ranks[i];
+    if (rank != -1)
+        for (i = max(rank - naround, ntop);
+             i <= rank + naround && i < ts.count; i++)
+            selected[sel_count++] = i;
+    free(own_ranks);
+
+    qsort(selected, sel_count, sizeof (int), int_cmp);
+    for (i = j = 0; i < sel_count; i++)
+        if (!j || selected[i] != selected[j - 1])
+            selected[j++] = selected[i];
+    sel_count = j;
+
+    /* read the selected entries, a run of consecutive ranks at a time */
+    ttlist = calloc(sel_count ? sel_count : 1, sizeof (struct toptenentry));
+    for (i = 0; i < sel_count; i = j) {
+        for (j = i + 1; j < sel_count && selected[j] == selected[j - 1] + 1;
+             j++)
+            ;
+        if (!get_topten_entries(&ts, selected[i], j - i, ttlist + i))
+            break;
     }
+    sel_count = i;
+    close_topten_source(&ts);
+    close(fd);
 
     if (game_complete && sel_count == 0) {
         /* didn't make it onto the list and nothing else is selected */
         ttlist[0] = newtt;
-        selected[0] = TRUE;
+        selected[0] = 0;
         sel_count++;
         off_list = TRUE;
     }
@@ -861,11 +1335,9 @@ nh_get_topten(int *out_len, char *statusbuf, const char *volatile player,
                          sel_count * sizeof (struct nh_topten_entry));
     memset(score_list, 0, sel_count * sizeof (struct nh_topten_entry));
     *out_len = sel_count;
-    j = 0;
-    for (i = 0; i < TTLISTLEN && validentry(ttlist[i]); i++) {
-        if (selected[i])
-            fill_nh_score_entry(&ttlist[i], &score_list[j++], i + 1, i == rank);
-    }
+    for (i = 0; i < sel_count; i++)
+        fill_nh_score_entry(&ttlist[i], &score_list[i], selected[i] + 1,
+                            selected[i] == rank);
 
     if (off_list) {
         score_list[0].rank = -1;
@@ -359,6 +359,7 @@ maketrap(struct level *lev, int x, int y, int typ, enum rng rng)
             loc->typ =
                 lev->flags.is_maze_lev ? ROOM : lev->
                 flags.is_cavernous_lev ? CORR : DOOR;
+        mark_terrain_changed();
 
         unearth_objs(lev, x, y);
         break;
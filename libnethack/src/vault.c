@@ -52,6 +52,7 @@ clear_fcorr(struct monst *grd, boolean forceshow)
         }
         oldtyp = level->locations[fcx][fcy].typ;
         level->locations[fcx][fcy].typ = EGD(grd)->fakecorr[fcbeg].ftyp;
+        mark_terrain_changed();
         if (!ACCESSIBLE(level->locations[fcx][fcy].typ) && ACCESSIBLE(oldtyp)) {
             struct trap *t = t_at(level, fcx, fcy);
 
@@ -395,6 +396,7 @@ invault(void)
         }
         level->locations[x][y].typ = DOOR;
         level->locations[x][y].doormask = D_NODOOR;
+        mark_terrain_changed();
         unblock_point(x, y);    /* doesn't block light */
         EGD(guard)->fcend = 1;
         EGD(guard)->warncnt = 1;
@@ -457,6 +459,7 @@ wallify_vault(struct monst *grd)
                     typ = HWALL;
                 level->locations[x][y].typ = typ;
                 level->locations[x][y].doormask = 0;
+                mark_terrain_changed();
                 /* 
                  * hack: player knows walls are restored because of the
                  * message, below, so show this on the screen.
@@ -544,6 +547,7 @@ gd_move(struct monst *grd)
                 verbalize(msgc_npcanger, "You've been warned, knave!");
                 mnexto(grd);
                 level->locations[m][n].typ = egrd->fakecorr[0].ftyp;
+                mark_terrain_changed();
                 newsym(m, n);
                 msethostility(grd, TRUE, FALSE);
                 return -1;
@@ -560,6 +564,7 @@ gd_move(struct monst *grd)
                 n = grd->my;
                 rloc(grd, FALSE, level);
                 level->locations[m][n].typ = egrd->fakecorr[0].ftyp;
+                mark_terrain_changed();
                 newsym(m, n);
                 msethostility(grd, TRUE, FALSE);
             letknow:
@@ -743,6 +748,7 @@ nextpos:
     }
     crm->typ = CORR;
 proceed:
+    mark_terrain_changed();
     unblock_point(nx, ny);      /* doesn't block light */
     if (cansee(nx, ny))
         newsym(nx, ny);
@@ -86,6 +86,7 @@ static char cs_rmin1[ROWNO], cs_rmax1[ROWNO];
 
 static char viz_clear[ROWNO][COLNO];    /* vision clear/blocked map */
 static char *viz_clear_rows[ROWNO];
+static unsigned long viz_clear_epoch = 1;  /* bumped when viz_clear changes */
 
 static char left_ptrs[ROWNO][COLNO];    /* LOS algorithm helpers */
 static char right_ptrs[ROWNO][COLNO];
@@ -97,6 +98,8 @@ static void view_from(int, int, char **, char *, char *, int,
                       void (*)(int, int, void *), void *);
 static void get_unused_cs(char ***, char **, char **);
 static void rogue_vision(char **, char *, char *);
+static void los_cache_reset(void);
+static void los_cache_discard(boolean);
 
 /* Macro definitions that I can't find anywhere. */
 #define sign(z) ((z) < 0 ? -1 : ((z) ? 1 : 0 ))
@@ -128,6 +131,7 @@ vision_init(void)
     viz_rmax = cs_rmax0;
 
     memset(could_see, 0, sizeof (could_see));
+    los_cache_reset();
 }
 
 /*
@@ -188,6 +192,8 @@ vision_reset(void)
 
     /* Reset the pointers and clear so that we have a "full" dungeon. */
     memset(viz_clear, 0, sizeof (viz_clear));
+    los_cache_reset();
+    viz_clear_epoch++;
 
     /* Dig the level */
     for (y = 0; y < ROWNO; y++) {
@@ -812,6 +818,19 @@ unblock_point(int x, int y)
         turnstate.vision_full_recalc = TRUE;
 }
 
+/*
+ * vision_clear_epoch()
+ *
+ * Returns a number that changes whenever a location becomes opaque or
+ * transparent to light, or the level is reset; anything computed from the
+ * clear/blocked map can be reused for as long as this stays the same.
+ */
+unsigned long
+vision_clear_epoch(void)
+{
+    return viz_clear_epoch;
+}
+
 
 /*===========================================================================*\
  |                                                                           |
@@ -870,6 +889,8 @@ dig_point(int row, int col)
         return; /* already done */
 
     viz_clear[row][col] = 1;
+    los_cache_discard(FALSE);
+    viz_clear_epoch++;
 
     /* 
      * Boundary cases first.
@@ -955,6 +976,8 @@ fill_point(int row, int col)
         return;
 
     viz_clear[row][col] = 0;
+    los_cache_discard(TRUE);
+    viz_clear_epoch++;
 
     if (col == 0) {
         if (viz_clear[row][1]) {        /* adjacent is clear */
@@ -1277,6 +1300,109 @@ q3_path(int srow, int scol, int y2, int x2)
 }
 
 
+/*
+ * Line of sight cache.
+ *
+ * clear_path() tends to be asked the same questions over and over: each light
+ * source checks every square in its radius whenever vision is recalculated,
+ * and monsters repeatedly check whether they can see the same things. So the
+ * results of the path functions above are cached, per starting square, as a
+ * bitset of the destinations whose result is known and a bitset of the results
+ * themselves. los_cache_slot maps a starting square to 1 + its entry in
+ * los_cache, or 0 if it has none.
+ *
+ * The results only depend on viz_clear. When a point becomes blocked, the only
+ * cached results that can change are clear ones, and when a point becomes
+ * clear, only blocked ones; so those are all that fill_point() and dig_point()
+ * need to discard.
+ */
+#define LOS_CACHE_SIZE  64
+#define LOS_BITS        (CHAR_BIT * sizeof (unsigned long))
+#define LOS_WORDS       ((COLNO * ROWNO + LOS_BITS - 1) / LOS_BITS)
+
+struct los_cache_entry {
+    int col, row;
+    unsigned long last_used;
+    unsigned long known[LOS_WORDS];
+    unsigned long clear[LOS_WORDS];
+};
+
+static struct los_cache_entry los_cache[LOS_CACHE_SIZE];
+static unsigned char los_cache_slot[ROWNO][COLNO];
+static int los_cache_used;
+static unsigned long los_cache_clock;
+
+static void
+los_cache_reset(void)
+{
+    memset(los_cache_slot, 0, sizeof los_cache_slot);
+    los_cache_used = 0;
+}
+
+static void
+los_cache_discard(boolean now_blocked)
+{
+    int i, w;
+
+    for (i = 0; i < los_cache_used; i++) {
+        struct los_cache_entry *e = los_cache + i;
+
+        for (w = 0; w < LOS_WORDS; w++)
+            e->known[w] &= now_blocked ? ~e->clear[w] : e->clear[w];
+    }
+}
+
+/* Returns the cache entry for paths starting at (col,row), creating one (and
+   evicting the least recently used one) if necessary. */
+static struct los_cache_entry *
+los_cache_entry(int col, int row)
+{
+    struct los_cache_entry *e;
+    int i;
+
+    if (los_cache_slot[row][col]) {
+        e = los_cache + los_cache_slot[row][col] - 1;
+    } else {
+        if (los_cache_used < LOS_CACHE_SIZE) {
+            e = los_cache + los_cache_used++;
+        } else {
+            e = los_cache;
+            for (i = 1; i < LOS_CACHE_SIZE; i++)
+                if (los_cache[i].last_used < e->last_used)
+                    e = los_cache + i;
+            los_cache_slot[e->row][e->col] = 0;
+        }
+        e->col = col;
+        e->row = row;
+        memset(e->known, 0, sizeof e->known);
+        los_cache_slot[row][col] = e - los_cache + 1;
+    }
+
+    e->last_used = ++los_cache_clock;
+    return e;
+}
+
+
+/* Runs whichever of the path functions above is appropriate for the direction
+   from (col1,row1) to (col2,row2). */
+static int
+quadrant_path(int col1, int row1, int col2, int row2)
+{
+    if (col1 < col2) {
+        if (row1 > row2)
+            return q1_path(row1, col1, row2, col2);
+        else
+            return q4_path(row1, col1, row2, col2);
+    } else {
+        if (row1 > row2)
+            return q2_path(row1, col1, row2, col2);
+        else if (row1 == row2 && col1 == col2)
+            return 1;
+        else
+            return q3_path(row1, col1, row2, col2);
+    }
+}
+
 /*
  * Use vision tables to determine if there is a clear path from
  * (col1,row1) to (col2,row2).  This is used by:
@@ -1299,7 +1425,9 @@ q3_path(int srow, int scol, int y2, int x2)
 boolean
 clear_path(int col1, int row1, int col2, int row2, char **couldsee_data)
 {
-    int result;
+    struct los_cache_entry *e;
+    unsigned long bit;
+    int result, index;
 
     if (!isok(col1, row1))
         return FALSE;
@@ -1313,24 +1441,33 @@ clear_path(int col1, int row1, int col2, int row2, char **couldsee_data)
     else if (col2 == u.ux && row2 == u.uy && couldsee_data)
         return !!(couldsee_data[row1][col1] & COULD_SEE);
 
-    if (col1 < col2) {
-        if (row1 > row2) {
-            result = q1_path(row1, col1, row2, col2);
-        } else {
-            result = q4_path(row1, col1, row2, col2);
-        }
-    } else {
-        if (row1 > row2) {
-            result = q2_path(row1, col1, row2, col2);
-        } else if (row1 == row2 && col1 == col2) {
-            result = 1;
-        } else {
-            result = q3_path(row1, col1, row2, col2);
-        }
-    }
+    e = los_cache_entry(col1, row1);
+    index = col2 * ROWNO + row2;
+    bit = 1UL << (index % LOS_BITS);
+    if (e->known[index / LOS_BITS] & bit)
+        return !!(e->clear[index / LOS_BITS] & bit);
+
+    result = quadrant_path(col1, row1, col2, row2);
+
+    e->known[index / LOS_BITS] |= bit;
+    if (result)
+        e->clear[index / LOS_BITS] |= bit;
+    else
+        e->clear[index / LOS_BITS] &= ~bit;
+
     return (boolean) result;
 }
 
+/* clear_path() with a NULL couldsee_data, bypassing the line of sight cache;
+   the unit tests compare the two. */
+boolean
+clear_path_uncached(int col1, int row1, int col2, int row2)
+{
+    if (!isok(col1, row1) || !isok(col2, row2))
+        return FALSE;
+    return (boolean) quadrant_path(col1, row1, col2, row2);
+}
+
 
 /*===========================================================================*\
                             GENERAL LINE OF SIGHT
@@ -464,8 +464,7 @@ strategy(struct monst *mtmp, boolean magical_target)
          mtmp->mx == STRAT_GOALX(mtmp->mstrategy) &&
          mtmp->my == STRAT_GOALY(mtmp->mstrategy))) {
 
-        struct distmap_state ds;
-        distmap_init(&ds, mtmp->mx, mtmp->my, mtmp);
+        struct distmap_state *ds = distmap_init(mtmp->mx, mtmp->my, mtmp);
         
         /* Check to see if there are any items around that the monster might
            want. (This code was moved from monmove.c, and slightly edited;
@@ -491,7 +490,7 @@ strategy(struct monst *mtmp, boolean magical_target)
                        item */
                     if (otmp->otyp == ROCK)
                         continue;
-                    if (distmap(&ds, otmp->ox, otmp->oy) <= minr) {
+                    if (distmap(ds, otmp->ox, otmp->oy) <= minr) {
                         /* don't get stuck circling around an object that's
                            underneath an immobile or hidden monster; paralysis
                            victims excluded */
@@ -506,7 +505,7 @@ strategy(struct monst *mtmp, boolean magical_target)
                             (throws_rocks(mtmp->data) ||
                              !sobj_at(BOULDER, level, otmp->ox, otmp->oy)) &&
                             !(onscary(otmp->ox, otmp->oy, mtmp))) {
-                            minr = distmap(&ds, otmp->ox, otmp->oy) - 1;
+                            minr = distmap(ds, otmp->ox, otmp->oy) - 1;
                             gx = otmp->ox;
                             gy = otmp->oy;
                         }
@@ -529,7 +528,7 @@ strategy(struct monst *mtmp, boolean magical_target)
             int x = rn2(COLNO);
             int y = rn2(ROWNO);
             if (goodpos(mtmp->dlevel, x, y, mtmp, 0)) {
-                int distm = distmap(&ds, x, y);
+                int distm = distmap(ds, x, y);
                 if (distm > dist && distm < COLNO * ROWNO) {
                     dist = distm;
                     strat = STRAT(STRAT_GROUND, x, y, 0);
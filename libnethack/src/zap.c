@@ -3670,6 +3670,7 @@ melt_ice(struct level *lev, xchar x, xchar y)
         loc->typ = (loc->icedpool == ICED_POOL ? POOL : MOAT);
         loc->icedpool = 0;
     }
+    mark_terrain_changed();
     obj_ice_effects(lev, x, y, FALSE);
     unearth_objs(lev, x, y);
 
@@ -3732,6 +3733,7 @@ zap_over_floor(xchar x, xchar y, int type, boolean * shopdamage)
 
                 rangemod -= 3;
                 loc->typ = ROOM;
+                mark_terrain_changed();
                 ttmp = maketrap(level, x, y, PIT, rng_main);
                 if (ttmp)
                     ttmp->tseen = 1;
@@ -3769,6 +3771,7 @@ zap_over_floor(xchar x, xchar y, int type, boolean * shopdamage)
                     loc->icedpool = (loc->typ == POOL ? ICED_POOL : ICED_MOAT);
                 loc->typ = (lava ? ROOM : ICE);
             }
+            mark_terrain_changed();
             bury_objs(level, x, y);
             if (cansee(x, y)) {
                 if (moat)
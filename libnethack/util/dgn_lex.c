@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <regex.h>
+
+/* Last modified by Sean Hunt, 2014-10-17 */
+/*	Copyright (c) 1989 by Jean-Christophe Collet */
+/*	Copyright (c) 1990 by M. Stephenson	     */
+/* NetHack may be freely redistributed.  See license for details. */
+
+#define DGN_COMP
+
+#include "config.h"
+#include "dgn_comp.h"
+#include "dgn_file.h"
+#include "dgn_compiler.h"
+
+#ifdef FLEX_SCANNER
+#define YY_MALLOC_DECL \
+	       void * malloc(size_t); \
+	       void * realloc(void *,size_t);
+#define YY_NO_INPUT
+#endif
+
+/* this doesn't always get put in dgn_comp.h
+ * (esp. when using older versions of bison)
+ */
+
+extern YYSTYPE yylval;
+
+int line_number = 1;
+
+#ifdef __clang__
+/* We can't control the generated code, so we have to disable the warning
+ * instead. Otherwise, it will complain about yy_fatal_error and various
+ * shadowed variables. */
+# pragma clang diagnostic ignored "-Wmissing-noreturn"
+# pragma clang diagnostic ignored "-Wshadow"
+# pragma clang diagnostic ignored "-Wmissing-variable-declarations"
+#endif
+
+
+FILE *yyin, *yyout;
+char *yytext; int yyleng;
+static int yy_start;
+#define INITIAL 0
+#define BEGIN(x) (yy_start = (x))
+#define yyterminate() return 0
+static const char *yy_pats[] = {"^(DUNGEON)", "^(up)", "^(down)", "^(ENTRY)", "^(stair)", "^(no_up)", "^(no_down)", "^(portal)", "^(PROTOFILE)", "^(DESCRIPTION)", "^(LEVELDESC)", "^(ALIGNMENT)", "^(LEVALIGN)", "^(town)", "^(hellish)", "^(mazelike)", "^(roguelike)", "^(unaligned)", "^(noalign)", "^(lawful)", "^(neutral)", "^(chaotic)", "^(BRANCH)", "^(CHAINBRANCH)", "^(LEVEL)", "^(RNDLEVEL)", "^(CHAINLEVEL)", "^(RNDCHLEVEL)", "^([0-9-]+)", "^(\"[^\"]*\")", "^(#.*\n)", "^(\r?\n)", "^([ \t]+)", "^(.)"};
+static const int yy_bol[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0};
+static const int yy_cond[] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+#define YY_NRULES 34
+
+static regex_t yy_re[YY_NRULES];
+static char *yy_buf; static long yy_len, yy_pos; static int yy_inited;
+static char yy_hold_char; static long yy_hold_pos = -1;
+void yyrestart(FILE *f) { yyin = f; free(yy_buf); yy_buf = NULL; }
+static void yy_load(void) {
+    long cap = 4096; yy_buf = malloc(cap); yy_len = 0; size_t n;
+    while ((n = fread(yy_buf + yy_len, 1, cap - yy_len - 1, yyin)) > 0) {
+        yy_len += n; if (cap - yy_len < 2048) yy_buf = realloc(yy_buf, cap *= 2);
+    }
+    yy_buf[yy_len] = 0; yy_pos = 0;
+}
+int yylex(void) {
+    int i;
+    if (!yy_inited) {
+        for (i = 0; i < YY_NRULES; i++)
+            if (regcomp(&yy_re[i], yy_pats[i], REG_EXTENDED | REG_NEWLINE)) {
+                fprintf(stderr, "bad pattern %s\n", yy_pats[i]); exit(1); }
+        yy_inited = 1;
+    }
+    if (!yyin) yyin = stdin;
+    if (!yy_buf) yy_load();
+    for (;;) {
+        if (yy_hold_pos >= 0) { yy_buf[yy_hold_pos] = yy_hold_char; yy_hold_pos = -1; }
+        if (yy_pos >= yy_len) return 0;
+        int best = -1; long bestlen = 0;
+        int atbol = yy_pos == 0 || yy_buf[yy_pos - 1] == '\n';
+        for (i = 0; i < YY_NRULES; i++) {
+            regmatch_t m[1];
+            if (yy_cond[i] != -1 && yy_cond[i] != yy_start) continue;
+            if (yy_bol[i] && !atbol) continue;
+            if (regexec(&yy_re[i], yy_buf + yy_pos, 1, m, 0) || m[0].rm_so != 0) continue;
+            if (m[0].rm_eo > bestlen) { best = i; bestlen = m[0].rm_eo; }
+        }
+        if (best < 0) { /* newline etc. unmatched: echo */ yy_pos++; continue; }
+        yytext = yy_buf + yy_pos; yyleng = bestlen;
+        yy_pos += bestlen;
+        yy_hold_pos = yy_pos; yy_hold_char = yy_buf[yy_pos]; yy_buf[yy_pos] = 0;
+        switch (best) {
+        case 0: return A_DUNGEON;
+            break;
+        case 1: { yylval.i=1; return UP_OR_DOWN; }
+            break;
+        case 2: { yylval.i=0; return UP_OR_DOWN; }
+            break;
+        case 3: return ENTRY;
+            break;
+        case 4: return STAIR;
+            break;
+        case 5: return NO_UP;
+            break;
+        case 6: return NO_DOWN;
+            break;
+        case 7: return PORTAL;
+            break;
+        case 8: return PROTOFILE;
+            break;
+        case 9: return DESCRIPTION;
+            break;
+        case 10: return LEVELDESC;
+            break;
+        case 11: return ALIGNMENT;
+            break;
+        case 12: return LEVALIGN;
+            break;
+        case 13: { yylval.i=TOWN ; return DESCRIPTOR; }
+            break;
+        case 14: { yylval.i=HELLISH ; return DESCRIPTOR; }
+            break;
+        case 15: { yylval.i=MAZELIKE ; return DESCRIPTOR; }
+            break;
+        case 16: { yylval.i=ROGUELIKE ; return DESCRIPTOR; }
+            break;
+        case 17: { yylval.i=D_ALIGN_NONE ; return DESCRIPTOR; }
+            break;
+        case 18: { yylval.i=D_ALIGN_NONE ; return DESCRIPTOR; }
+            break;
+        case 19: { yylval.i=D_ALIGN_LAWFUL ; return DESCRIPTOR; }
+            break;
+        case 20: { yylval.i=D_ALIGN_NEUTRAL ; return DESCRIPTOR; }
+            break;
+        case 21: { yylval.i=D_ALIGN_CHAOTIC ; return DESCRIPTOR; }
+            break;
+        case 22: return BRANCH;
+            break;
+        case 23: return CHBRANCH;
+            break;
+        case 24: return LEVEL;
+            break;
+        case 25: return RNDLEVEL;
+            break;
+        case 26: return CHLEVEL;
+            break;
+        case 27: return RNDCHLEVEL;
+            break;
+        case 28: { yylval.i=atoi(yytext); return INTEGER; }
+            break;
+        case 29: { yytext[yyleng-1] = 0; /* Discard the trailing \" */
+		  yylval.str = malloc(strlen(yytext+1)+1);
+		  strcpy(yylval.str, yytext+1); /* Discard the first \" */
+		  return STRING; }
+            break;
+        case 30: { line_number++; }
+            break;
+        case 31: { line_number++; }
+            break;
+        case 32: ;	/* skip trailing tabs & spaces */
+            break;
+        case 33: { return yytext[0]; }
+            break;
+        }
+    }
+}
+
+/* routine to switch to another input file; needed for flex */
+void init_yyin( FILE *input_f )
+{
+#if defined(FLEX_SCANNER) || defined(FLEXHACK_SCANNER)
+	if (yyin)
+	    yyrestart(input_f);
+	else
+#endif
+	    yyin = input_f;
+}
+/* analogous routine (for completeness) */
+void init_yyout( FILE *output_f )
+{
+	yyout = output_f;
+}
+
+/*dgn_comp.l*/
+
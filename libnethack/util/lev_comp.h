@@ -0,0 +1,159 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_LIBNETHACK_UTIL_LEV_COMP_H_INCLUDED
+# define YY_YY_LIBNETHACK_UTIL_LEV_COMP_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    CHAR = 258,                    /* CHAR  */
+    INTEGER = 259,                 /* INTEGER  */
+    BOOLEAN = 260,                 /* BOOLEAN  */
+    PERCENT = 261,                 /* PERCENT  */
+    MESSAGE_ID = 262,              /* MESSAGE_ID  */
+    HALLUMSG_ID = 263,             /* HALLUMSG_ID  */
+    MAZE_ID = 264,                 /* MAZE_ID  */
+    LEVEL_ID = 265,                /* LEVEL_ID  */
+    LEV_INIT_ID = 266,             /* LEV_INIT_ID  */
+    GEOMETRY_ID = 267,             /* GEOMETRY_ID  */
+    NOMAP_ID = 268,                /* NOMAP_ID  */
+    OBJECT_ID = 269,               /* OBJECT_ID  */
+    COBJECT_ID = 270,              /* COBJECT_ID  */
+    MONSTER_ID = 271,              /* MONSTER_ID  */
+    TRAP_ID = 272,                 /* TRAP_ID  */
+    DOOR_ID = 273,                 /* DOOR_ID  */
+    DRAWBRIDGE_ID = 274,           /* DRAWBRIDGE_ID  */
+    MAZEWALK_ID = 275,             /* MAZEWALK_ID  */
+    WALLIFY_ID = 276,              /* WALLIFY_ID  */
+    REGION_ID = 277,               /* REGION_ID  */
+    FILLING = 278,                 /* FILLING  */
+    RANDOM_OBJECTS_ID = 279,       /* RANDOM_OBJECTS_ID  */
+    RANDOM_MONSTERS_ID = 280,      /* RANDOM_MONSTERS_ID  */
+    RANDOM_PLACES_ID = 281,        /* RANDOM_PLACES_ID  */
+    ALTAR_ID = 282,                /* ALTAR_ID  */
+    LADDER_ID = 283,               /* LADDER_ID  */
+    STAIR_ID = 284,                /* STAIR_ID  */
+    NON_DIGGABLE_ID = 285,         /* NON_DIGGABLE_ID  */
+    NON_PASSWALL_ID = 286,         /* NON_PASSWALL_ID  */
+    ROOM_ID = 287,                 /* ROOM_ID  */
+    PORTAL_ID = 288,               /* PORTAL_ID  */
+    TELEPRT_ID = 289,              /* TELEPRT_ID  */
+    BRANCH_ID = 290,               /* BRANCH_ID  */
+    LEV = 291,                     /* LEV  */
+    CHANCE_ID = 292,               /* CHANCE_ID  */
+    CORRIDOR_ID = 293,             /* CORRIDOR_ID  */
+    GOLD_ID = 294,                 /* GOLD_ID  */
+    ENGRAVING_ID = 295,            /* ENGRAVING_ID  */
+    FOUNTAIN_ID = 296,             /* FOUNTAIN_ID  */
+    POOL_ID = 297,                 /* POOL_ID  */
+    SINK_ID = 298,                 /* SINK_ID  */
+    NONE = 299,                    /* NONE  */
+    RAND_CORRIDOR_ID = 300,        /* RAND_CORRIDOR_ID  */
+    DOOR_STATE = 301,              /* DOOR_STATE  */
+    LIGHT_STATE = 302,             /* LIGHT_STATE  */
+    CURSE_TYPE = 303,              /* CURSE_TYPE  */
+    ENGRAVING_TYPE = 304,          /* ENGRAVING_TYPE  */
+    DIRECTION = 305,               /* DIRECTION  */
+    RANDOM_TYPE = 306,             /* RANDOM_TYPE  */
+    O_REGISTER = 307,              /* O_REGISTER  */
+    M_REGISTER = 308,              /* M_REGISTER  */
+    P_REGISTER = 309,              /* P_REGISTER  */
+    A_REGISTER = 310,              /* A_REGISTER  */
+    ALIGNMENT = 311,               /* ALIGNMENT  */
+    LEFT_OR_RIGHT = 312,           /* LEFT_OR_RIGHT  */
+    CENTER = 313,                  /* CENTER  */
+    TOP_OR_BOT = 314,              /* TOP_OR_BOT  */
+    ALTAR_TYPE = 315,              /* ALTAR_TYPE  */
+    UP_OR_DOWN = 316,              /* UP_OR_DOWN  */
+    SUBROOM_ID = 317,              /* SUBROOM_ID  */
+    NAME_ID = 318,                 /* NAME_ID  */
+    FLAGS_ID = 319,                /* FLAGS_ID  */
+    FLAG_TYPE = 320,               /* FLAG_TYPE  */
+    MON_ATTITUDE = 321,            /* MON_ATTITUDE  */
+    MON_ALERTNESS = 322,           /* MON_ALERTNESS  */
+    MON_APPEARANCE = 323,          /* MON_APPEARANCE  */
+    CONTAINED = 324,               /* CONTAINED  */
+    STRING = 325,                  /* STRING  */
+    MAP_ID = 326                   /* MAP_ID  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 98 "libnethack/util/lev_comp.y"
+
+	int	i;
+	char*	map;
+	struct {
+		signed char room;
+		signed char wall;
+		signed char door;
+	} corpos;
+
+#line 145 "libnethack/util/lev_comp.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_LIBNETHACK_UTIL_LEV_COMP_H_INCLUDED  */
@@ -0,0 +1,358 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <regex.h>
+
+/* Last modified by Sean Hunt, 2014-10-17 */
+/*	Copyright (c) 1989 by Jean-Christophe Collet */
+/* NetHack may be freely redistributed.  See license for details. */
+
+#define LEV_LEX_C
+
+#include "hack.h"
+#include "lev_comp.h"
+#include "sp_lev.h"
+#include "lev_compiler.h"
+
+#ifdef FLEX_SCANNER
+#define YY_MALLOC_DECL \
+	      void * malloc(size_t); \
+	      void * realloc(void *,size_t);
+#define YY_NO_INPUT
+#endif
+
+/*
+ * This doesn't always get put in lev_comp.h
+ * (esp. when using older versions of bison).
+ */
+extern YYSTYPE yylval;
+
+int line_number = 1, colon_line_number = 1;
+static char map[4096];
+static int map_cnt = 0;
+
+#ifdef __clang__
+/* We can't control the generated code, so we have to disable the warning
+ * instead. Otherwise, it will complain about yy_fatal_error and various
+ * shadowed variables. */
+# pragma clang diagnostic ignored "-Wmissing-noreturn"
+# pragma clang diagnostic ignored "-Wshadow"
+# pragma clang diagnostic ignored "-Wmissing-variable-declarations"
+#endif
+
+
+FILE *yyin, *yyout;
+char *yytext; int yyleng;
+static int yy_start;
+#define INITIAL 0
+#define MAPC 1
+#define BEGIN(x) (yy_start = (x))
+#define yyterminate() return 0
+static const char *yy_pats[] = {"^(ENDMAP)", "^([|}{+ABCISHKPLWTF\\#. 0123456789-]*\r?\n)", "^(#.*\n)", "^(:)", "^(MESSAGE)", "^(HALLUMSG)", "^(MAZE)", "^(NOMAP)", "^(LEVEL)", "^(INIT_MAP)", "^(FLAGS)", "^(GEOMETRY)", "^(MAP\r?\n)", "^(OBJECT)", "^(CONTAINER)", "^(MONSTER)", "^(TRAP)", "^(DOOR)", "^(DRAWBRIDGE)", "^(MAZEWALK)", "^(WALLIFY)", "^(REGION)", "^(RANDOM_OBJECTS)", "^(RANDOM_MONSTERS)", "^(RANDOM_PLACES)", "^(ALTAR)", "^(LADDER)", "^(STAIR)", "^(PORTAL)", "^(TELEPORT_REGION)", "^(BRANCH)", "^(FOUNTAIN)", "^(SINK)", "^(POOL)", "^(NON_DIGGABLE)", "^(NON_PASSWALL)", "^(ROOM)", "^(SUBROOM)", "^(RANDOM_CORRIDORS)", "^(CORRIDOR)", "^(GOLD)", "^(ENGRAVING)", "^(NAME)", "^(CHANCE)", "^(levregion)", "^(open)", "^(closed)", "^(locked)", "^(nodoor)", "^(broken)", "^(north)", "^(east)", "^(south)", "^(west)", "^(random)", "^(none)", "^(object)", "^(monster)", "^(place)", "^(align)", "^(left)", "^(half-left)", "^(center)", "^(half-right)", "^(right)", "^(top)", "^(bottom)", "^(lit)", "^(unlit)", "^(filled)", "^(unfilled)", "^(noalign)", "^(law)", "^(neutral)", "^(chaos)", "^(coaligned)", "^(noncoaligned)", "^(peaceful)", "^(hostile)", "^(asleep)", "^(awake)", "^(m_feature)", "^(m_monster)", "^(m_object)", "^(sanctum)", "^(shrine)", "^(altar)", "^(up)", "^(down)", "^(false)", "^(true)", "^(dust)", "^(engrave)", "^(burn)", "^(mark)", "^(blessed)", "^(uncursed)", "^(cursed)", "^(contained)", "^(noteleport)", "^(hardfloor)", "^(nommap)", "^(arboreal)", "^(shortsighted)", "^(\\[ *[0-9]+% *\\])", "^([+-]?[0-9]+)", "^(\"[^\"]*\")", "^(\r?\n)", "^([ \t]+)", "^('\\\\.')", "^('.')", "^(.)"};
+static const int yy_bol[] = {0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+static const int yy_cond[] = {MAPC, MAPC, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+#define YY_NRULES 112
+
+static regex_t yy_re[YY_NRULES];
+static char *yy_buf; static long yy_len, yy_pos; static int yy_inited;
+static char yy_hold_char; static long yy_hold_pos = -1;
+void yyrestart(FILE *f) { yyin = f; free(yy_buf); yy_buf = NULL; }
+static void yy_load(void) {
+    long cap = 4096; yy_buf = malloc(cap); yy_len = 0; size_t n;
+    while ((n = fread(yy_buf + yy_len, 1, cap - yy_len - 1, yyin)) > 0) {
+        yy_len += n; if (cap - yy_len < 2048) yy_buf = realloc(yy_buf, cap *= 2);
+    }
+    yy_buf[yy_len] = 0; yy_pos = 0;
+}
+int yylex(void) {
+    int i;
+    if (!yy_inited) {
+        for (i = 0; i < YY_NRULES; i++)
+            if (regcomp(&yy_re[i], yy_pats[i], REG_EXTENDED | REG_NEWLINE)) {
+                fprintf(stderr, "bad pattern %s\n", yy_pats[i]); exit(1); }
+        yy_inited = 1;
+    }
+    if (!yyin) yyin = stdin;
+    if (!yy_buf) yy_load();
+    for (;;) {
+        if (yy_hold_pos >= 0) { yy_buf[yy_hold_pos] = yy_hold_char; yy_hold_pos = -1; }
+        if (yy_pos >= yy_len) return 0;
+        int best = -1; long bestlen = 0;
+        int atbol = yy_pos == 0 || yy_buf[yy_pos - 1] == '\n';
+        for (i = 0; i < YY_NRULES; i++) {
+            regmatch_t m[1];
+            if (yy_cond[i] != -1 && yy_cond[i] != yy_start) continue;
+            if (yy_bol[i] && !atbol) continue;
+            if (regexec(&yy_re[i], yy_buf + yy_pos, 1, m, 0) || m[0].rm_so != 0) continue;
+            if (m[0].rm_eo > bestlen) { best = i; bestlen = m[0].rm_eo; }
+        }
+        if (best < 0) { /* newline etc. unmatched: echo */ yy_pos++; continue; }
+        yytext = yy_buf + yy_pos; yyleng = bestlen;
+        yy_pos += bestlen;
+        yy_hold_pos = yy_pos; yy_hold_char = yy_buf[yy_pos]; yy_buf[yy_pos] = 0;
+        switch (best) {
+        case 0: {
+		  BEGIN(INITIAL);
+		  yylval.map = malloc(map_cnt + 1);
+		  strncpy(yylval.map, map, map_cnt);
+		  yylval.map[map_cnt] = 0;
+		  map_cnt = 0;
+		  return MAP_ID;
+		}
+            break;
+        case 1: {
+		  int len = yyleng;
+		  /* convert \r\n to \n */
+		  if (len >= 2 && yytext[len - 2] == '\r') len -= 1;
+		  line_number++;
+		  strncpy(map + map_cnt, yytext, len);
+		  map_cnt += len;
+		  map[map_cnt - 1] = '\n';
+		  map[map_cnt] = '\0';
+		}
+            break;
+        case 2: { line_number++; }
+            break;
+        case 3: { colon_line_number = line_number; return ':'; }
+            break;
+        case 4: return MESSAGE_ID;
+            break;
+        case 5: return HALLUMSG_ID;
+            break;
+        case 6: return MAZE_ID;
+            break;
+        case 7: return NOMAP_ID;
+            break;
+        case 8: return LEVEL_ID;
+            break;
+        case 9: return LEV_INIT_ID;
+            break;
+        case 10: return FLAGS_ID;
+            break;
+        case 11: return GEOMETRY_ID;
+            break;
+        case 12: { BEGIN(MAPC); line_number++; }
+            break;
+        case 13: return OBJECT_ID;
+            break;
+        case 14: return COBJECT_ID;
+            break;
+        case 15: return MONSTER_ID;
+            break;
+        case 16: return TRAP_ID;
+            break;
+        case 17: return DOOR_ID;
+            break;
+        case 18: return DRAWBRIDGE_ID;
+            break;
+        case 19: return MAZEWALK_ID;
+            break;
+        case 20: return WALLIFY_ID;
+            break;
+        case 21: return REGION_ID;
+            break;
+        case 22: return RANDOM_OBJECTS_ID;
+            break;
+        case 23: return RANDOM_MONSTERS_ID;
+            break;
+        case 24: return RANDOM_PLACES_ID;
+            break;
+        case 25: return ALTAR_ID;
+            break;
+        case 26: return LADDER_ID;
+            break;
+        case 27: return STAIR_ID;
+            break;
+        case 28: return PORTAL_ID;
+            break;
+        case 29: return TELEPRT_ID;
+            break;
+        case 30: return BRANCH_ID;
+            break;
+        case 31: return FOUNTAIN_ID;
+            break;
+        case 32: return SINK_ID;
+            break;
+        case 33: return POOL_ID;
+            break;
+        case 34: return NON_DIGGABLE_ID;
+            break;
+        case 35: return NON_PASSWALL_ID;
+            break;
+        case 36: return ROOM_ID;
+            break;
+        case 37: return SUBROOM_ID;
+            break;
+        case 38: return RAND_CORRIDOR_ID;
+            break;
+        case 39: return CORRIDOR_ID;
+            break;
+        case 40: return GOLD_ID;
+            break;
+        case 41: return ENGRAVING_ID;
+            break;
+        case 42: return NAME_ID;
+            break;
+        case 43: return CHANCE_ID;
+            break;
+        case 44: return LEV;
+            break;
+        case 45: { yylval.i=D_ISOPEN; return DOOR_STATE; }
+            break;
+        case 46: { yylval.i=D_CLOSED; return DOOR_STATE; }
+            break;
+        case 47: { yylval.i=D_LOCKED; return DOOR_STATE; }
+            break;
+        case 48: { yylval.i=D_NODOOR; return DOOR_STATE; }
+            break;
+        case 49: { yylval.i=D_BROKEN; return DOOR_STATE; }
+            break;
+        case 50: { yylval.i=W_NORTH; return DIRECTION; }
+            break;
+        case 51: { yylval.i=W_EAST; return DIRECTION; }
+            break;
+        case 52: { yylval.i=W_SOUTH; return DIRECTION; }
+            break;
+        case 53: { yylval.i=W_WEST; return DIRECTION; }
+            break;
+        case 54: { yylval.i = -1; return RANDOM_TYPE; }
+            break;
+        case 55: { yylval.i = -2; return NONE; }
+            break;
+        case 56: return O_REGISTER;
+            break;
+        case 57: return M_REGISTER;
+            break;
+        case 58: return P_REGISTER;
+            break;
+        case 59: return A_REGISTER;
+            break;
+        case 60: { yylval.i=1; return LEFT_OR_RIGHT; }
+            break;
+        case 61: { yylval.i=2; return LEFT_OR_RIGHT; }
+            break;
+        case 62: { yylval.i=3; return CENTER; }
+            break;
+        case 63: { yylval.i=4; return LEFT_OR_RIGHT; }
+            break;
+        case 64: { yylval.i=5; return LEFT_OR_RIGHT; }
+            break;
+        case 65: { yylval.i=1; return TOP_OR_BOT; }
+            break;
+        case 66: { yylval.i=5; return TOP_OR_BOT; }
+            break;
+        case 67: { yylval.i=1; return LIGHT_STATE; }
+            break;
+        case 68: { yylval.i=0; return LIGHT_STATE; }
+            break;
+        case 69: { yylval.i=0; return FILLING; }
+            break;
+        case 70: { yylval.i=1; return FILLING; }
+            break;
+        case 71: { yylval.i= AM_NONE; return ALIGNMENT; }
+            break;
+        case 72: { yylval.i= AM_LAWFUL; return ALIGNMENT; }
+            break;
+        case 73: { yylval.i= AM_NEUTRAL; return ALIGNMENT; }
+            break;
+        case 74: { yylval.i= AM_CHAOTIC; return ALIGNMENT; }
+            break;
+        case 75: { yylval.i= AM_SPLEV_CO; return ALIGNMENT; }
+            break;
+        case 76: { yylval.i= AM_SPLEV_NONCO; return ALIGNMENT; }
+            break;
+        case 77: { yylval.i=1; return MON_ATTITUDE; }
+            break;
+        case 78: { yylval.i=0; return MON_ATTITUDE; }
+            break;
+        case 79: { yylval.i=1; return MON_ALERTNESS; }
+            break;
+        case 80: { yylval.i=0; return MON_ALERTNESS; }
+            break;
+        case 81: { yylval.i= M_AP_FURNITURE; return MON_APPEARANCE; }
+            break;
+        case 82: { yylval.i= M_AP_MONSTER;   return MON_APPEARANCE; }
+            break;
+        case 83: { yylval.i= M_AP_OBJECT;    return MON_APPEARANCE; }
+            break;
+        case 84: { yylval.i=2; return ALTAR_TYPE; }
+            break;
+        case 85: { yylval.i=1; return ALTAR_TYPE; }
+            break;
+        case 86: { yylval.i=0; return ALTAR_TYPE; }
+            break;
+        case 87: { yylval.i=1; return UP_OR_DOWN; }
+            break;
+        case 88: { yylval.i=0; return UP_OR_DOWN; }
+            break;
+        case 89: { yylval.i=0; return BOOLEAN; }
+            break;
+        case 90: { yylval.i=1; return BOOLEAN; }
+            break;
+        case 91: { yylval.i=DUST; return ENGRAVING_TYPE; }
+            break;
+        case 92: { yylval.i=ENGRAVE; return ENGRAVING_TYPE; }
+            break;
+        case 93: { yylval.i=BURN; return ENGRAVING_TYPE; }
+            break;
+        case 94: { yylval.i=MARK; return ENGRAVING_TYPE; }
+            break;
+        case 95: { yylval.i=1; return CURSE_TYPE; }
+            break;
+        case 96: { yylval.i=2; return CURSE_TYPE; }
+            break;
+        case 97: { yylval.i=3; return CURSE_TYPE; }
+            break;
+        case 98: { return CONTAINED; }
+            break;
+        case 99: { yylval.i=NOTELEPORT; return FLAG_TYPE; }
+            break;
+        case 100: { yylval.i=HARDFLOOR; return FLAG_TYPE; }
+            break;
+        case 101: { yylval.i=NOMMAP; return FLAG_TYPE; }
+            break;
+        case 102: { yylval.i=ARBOREAL; return FLAG_TYPE; }	/* KMH */
+            break;
+        case 103: { yylval.i=SHORTSIGHTED; return FLAG_TYPE; }
+            break;
+        case 104: { yylval.i = atoi(yytext + 1); return PERCENT; }
+            break;
+        case 105: { yylval.i=atoi(yytext); return INTEGER; }
+            break;
+        case 106: { yytext[yyleng-1] = 0; /* Discard the trailing \" */
+		  yylval.map = malloc(strlen(yytext+1)+1);
+		  strcpy(yylval.map, yytext+1); /* Discard the first \" */
+		  return STRING; }
+            break;
+        case 107: { line_number++; }
+            break;
+        case 108: 
+            break;
+        case 109: { yylval.i = yytext[2]; return CHAR; }
+            break;
+        case 110: { yylval.i = yytext[1]; return CHAR; }
+            break;
+        case 111: { return yytext[0]; }
+            break;
+        }
+    }
+}
+
+/* routine to switch to another input file; needed for flex */
+void init_yyin( FILE *input_f )
+{
+#if defined(FLEX_SCANNER) || defined(FLEXHACK_SCANNER)
+	if (yyin)
+	    yyrestart(input_f);
+	else
+#endif
+	    yyin = input_f;
+}
+/* analogous routine (for completeness) */
+void init_yyout( FILE *output_f )
+{
+	yyout = output_f;
+}
+
+/*lev_comp.l*/
+
@@ -0,0 +1,3617 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "libnethack/util/lev_comp.y"
+
+/* Last modified by Sean Hunt, 2014-10-17 */
+/*	Copyright (c) 1989 by Jean-Christophe Collet */
+/* NetHack may be freely redistributed.  See license for details. */
+#include "hack.h"
+#include "sp_lev.h"
+#include "lev_compiler.h"
+
+/*
+ * This file contains the Level Compiler code
+ * It may handle special mazes & special room-levels
+ */
+
+#define MAX_REGISTERS	10
+#define ERR		(-1)
+/* many types of things are put in chars for transference to NetHack.
+ * since some systems will use signed chars, limit everybody to the
+ * same number for portability.
+ */
+#define MAX_OF_TYPE	128
+
+#define New(type)		\
+	(type *) memset(malloc(sizeof(type)), 0, sizeof(type))
+#define NewTab(type, size)	malloc(sizeof(type *) * size)
+#define Free(ptr)		free(ptr)
+
+static struct reg {
+	int x1, y1;
+	int x2, y2;
+}		current_region;
+
+static struct coord {
+	int x;
+	int y;
+}		current_coord, current_align;
+
+static struct size {
+	int height;
+	int width;
+}		current_size;
+
+char tmpmessage[256];
+char tmphallumsg[256];
+digpos *tmppass[32];
+char *tmpmap[ROWNO];
+
+digpos *tmpdig[MAX_OF_TYPE];
+region *tmpreg[MAX_OF_TYPE];
+lev_region *tmplreg[MAX_OF_TYPE];
+door *tmpdoor[MAX_OF_TYPE];
+drawbridge *tmpdb[MAX_OF_TYPE];
+walk *tmpwalk[MAX_OF_TYPE];
+
+room_door *tmprdoor[MAX_OF_TYPE];
+trap *tmptrap[MAX_OF_TYPE];
+monster *tmpmonst[MAX_OF_TYPE];
+object *tmpobj[MAX_OF_TYPE];
+altar *tmpaltar[MAX_OF_TYPE];
+lad *tmplad[MAX_OF_TYPE];
+stair *tmpstair[MAX_OF_TYPE];
+gold *tmpgold[MAX_OF_TYPE];
+engraving *tmpengraving[MAX_OF_TYPE];
+fountain *tmpfountain[MAX_OF_TYPE];
+sink *tmpsink[MAX_OF_TYPE];
+pool *tmppool[MAX_OF_TYPE];
+
+mazepart *tmppart[10];
+room *tmproom[MAXNROFROOMS*2];
+static corridor *tmpcor[MAX_OF_TYPE];
+
+static specialmaze maze;
+static splev special_lev;
+static lev_init init_lev;
+
+static char olist[MAX_REGISTERS], mlist[MAX_REGISTERS];
+static struct coord plist[MAX_REGISTERS];
+
+int n_olist = 0, n_mlist = 0, n_plist = 0;
+
+unsigned int nlreg = 0, nreg = 0, ndoor = 0, ntrap = 0, nmons = 0, nobj = 0;
+unsigned int ndb = 0, nwalk = 0, npart = 0, ndig = 0, nlad = 0, nstair = 0;
+unsigned int naltar = 0, ncorridor = 0, nrooms = 0, ngold = 0, nengraving = 0;
+unsigned int nfountain = 0, npool = 0, nsink = 0, npass = 0;
+
+static int lev_flags = 0;
+
+unsigned int max_x_map, max_y_map;
+
+static xchar in_room;
+
+#ifdef __clang__
+# pragma clang diagnostic ignored "-Wmissing-variable-declarations"
+#endif
+
+
+#line 167 "libnethack/util/lev_yacc.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "lev_comp.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_CHAR = 3,                       /* CHAR  */
+  YYSYMBOL_INTEGER = 4,                    /* INTEGER  */
+  YYSYMBOL_BOOLEAN = 5,                    /* BOOLEAN  */
+  YYSYMBOL_PERCENT = 6,                    /* PERCENT  */
+  YYSYMBOL_MESSAGE_ID = 7,                 /* MESSAGE_ID  */
+  YYSYMBOL_HALLUMSG_ID = 8,                /* HALLUMSG_ID  */
+  YYSYMBOL_MAZE_ID = 9,                    /* MAZE_ID  */
+  YYSYMBOL_LEVEL_ID = 10,                  /* LEVEL_ID  */
+  YYSYMBOL_LEV_INIT_ID = 11,               /* LEV_INIT_ID  */
+  YYSYMBOL_GEOMETRY_ID = 12,               /* GEOMETRY_ID  */
+  YYSYMBOL_NOMAP_ID = 13,                  /* NOMAP_ID  */
+  YYSYMBOL_OBJECT_ID = 14,                 /* OBJECT_ID  */
+  YYSYMBOL_COBJECT_ID = 15,                /* COBJECT_ID  */
+  YYSYMBOL_MONSTER_ID = 16,                /* MONSTER_ID  */
+  YYSYMBOL_TRAP_ID = 17,                   /* TRAP_ID  */
+  YYSYMBOL_DOOR_ID = 18,                   /* DOOR_ID  */
+  YYSYMBOL_DRAWBRIDGE_ID = 19,             /* DRAWBRIDGE_ID  */
+  YYSYMBOL_MAZEWALK_ID = 20,               /* MAZEWALK_ID  */
+  YYSYMBOL_WALLIFY_ID = 21,                /* WALLIFY_ID  */
+  YYSYMBOL_REGION_ID = 22,                 /* REGION_ID  */
+  YYSYMBOL_FILLING = 23,                   /* FILLING  */
+  YYSYMBOL_RANDOM_OBJECTS_ID = 24,         /* RANDOM_OBJECTS_ID  */
+  YYSYMBOL_RANDOM_MONSTERS_ID = 25,        /* RANDOM_MONSTERS_ID  */
+  YYSYMBOL_RANDOM_PLACES_ID = 26,          /* RANDOM_PLACES_ID  */
+  YYSYMBOL_ALTAR_ID = 27,                  /* ALTAR_ID  */
+  YYSYMBOL_LADDER_ID = 28,                 /* LADDER_ID  */
+  YYSYMBOL_STAIR_ID = 29,                  /* STAIR_ID  */
+  YYSYMBOL_NON_DIGGABLE_ID = 30,           /* NON_DIGGABLE_ID  */
+  YYSYMBOL_NON_PASSWALL_ID = 31,           /* NON_PASSWALL_ID  */
+  YYSYMBOL_ROOM_ID = 32,                   /* ROOM_ID  */
+  YYSYMBOL_PORTAL_ID = 33,                 /* PORTAL_ID  */
+  YYSYMBOL_TELEPRT_ID = 34,                /* TELEPRT_ID  */
+  YYSYMBOL_BRANCH_ID = 35,                 /* BRANCH_ID  */
+  YYSYMBOL_LEV = 36,                       /* LEV  */
+  YYSYMBOL_CHANCE_ID = 37,                 /* CHANCE_ID  */
+  YYSYMBOL_CORRIDOR_ID = 38,               /* CORRIDOR_ID  */
+  YYSYMBOL_GOLD_ID = 39,                   /* GOLD_ID  */
+  YYSYMBOL_ENGRAVING_ID = 40,              /* ENGRAVING_ID  */
+  YYSYMBOL_FOUNTAIN_ID = 41,               /* FOUNTAIN_ID  */
+  YYSYMBOL_POOL_ID = 42,                   /* POOL_ID  */
+  YYSYMBOL_SINK_ID = 43,                   /* SINK_ID  */
+  YYSYMBOL_NONE = 44,                      /* NONE  */
+  YYSYMBOL_RAND_CORRIDOR_ID = 45,          /* RAND_CORRIDOR_ID  */
+  YYSYMBOL_DOOR_STATE = 46,                /* DOOR_STATE  */
+  YYSYMBOL_LIGHT_STATE = 47,               /* LIGHT_STATE  */
+  YYSYMBOL_CURSE_TYPE = 48,                /* CURSE_TYPE  */
+  YYSYMBOL_ENGRAVING_TYPE = 49,            /* ENGRAVING_TYPE  */
+  YYSYMBOL_DIRECTION = 50,                 /* DIRECTION  */
+  YYSYMBOL_RANDOM_TYPE = 51,               /* RANDOM_TYPE  */
+  YYSYMBOL_O_REGISTER = 52,                /* O_REGISTER  */
+  YYSYMBOL_M_REGISTER = 53,                /* M_REGISTER  */
+  YYSYMBOL_P_REGISTER = 54,                /* P_REGISTER  */
+  YYSYMBOL_A_REGISTER = 55,                /* A_REGISTER  */
+  YYSYMBOL_ALIGNMENT = 56,                 /* ALIGNMENT  */
+  YYSYMBOL_LEFT_OR_RIGHT = 57,             /* LEFT_OR_RIGHT  */
+  YYSYMBOL_CENTER = 58,                    /* CENTER  */
+  YYSYMBOL_TOP_OR_BOT = 59,                /* TOP_OR_BOT  */
+  YYSYMBOL_ALTAR_TYPE = 60,                /* ALTAR_TYPE  */
+  YYSYMBOL_UP_OR_DOWN = 61,                /* UP_OR_DOWN  */
+  YYSYMBOL_SUBROOM_ID = 62,                /* SUBROOM_ID  */
+  YYSYMBOL_NAME_ID = 63,                   /* NAME_ID  */
+  YYSYMBOL_FLAGS_ID = 64,                  /* FLAGS_ID  */
+  YYSYMBOL_FLAG_TYPE = 65,                 /* FLAG_TYPE  */
+  YYSYMBOL_MON_ATTITUDE = 66,              /* MON_ATTITUDE  */
+  YYSYMBOL_MON_ALERTNESS = 67,             /* MON_ALERTNESS  */
+  YYSYMBOL_MON_APPEARANCE = 68,            /* MON_APPEARANCE  */
+  YYSYMBOL_CONTAINED = 69,                 /* CONTAINED  */
+  YYSYMBOL_70_ = 70,                       /* ','  */
+  YYSYMBOL_71_ = 71,                       /* ':'  */
+  YYSYMBOL_72_ = 72,                       /* '('  */
+  YYSYMBOL_73_ = 73,                       /* ')'  */
+  YYSYMBOL_74_ = 74,                       /* '['  */
+  YYSYMBOL_75_ = 75,                       /* ']'  */
+  YYSYMBOL_STRING = 76,                    /* STRING  */
+  YYSYMBOL_MAP_ID = 77,                    /* MAP_ID  */
+  YYSYMBOL_YYACCEPT = 78,                  /* $accept  */
+  YYSYMBOL_file = 79,                      /* file  */
+  YYSYMBOL_levels = 80,                    /* levels  */
+  YYSYMBOL_level = 81,                     /* level  */
+  YYSYMBOL_maze_level = 82,                /* maze_level  */
+  YYSYMBOL_room_level = 83,                /* room_level  */
+  YYSYMBOL_level_def = 84,                 /* level_def  */
+  YYSYMBOL_lev_init = 85,                  /* lev_init  */
+  YYSYMBOL_walled = 86,                    /* walled  */
+  YYSYMBOL_flags = 87,                     /* flags  */
+  YYSYMBOL_flag_list = 88,                 /* flag_list  */
+  YYSYMBOL_messages = 89,                  /* messages  */
+  YYSYMBOL_message = 90,                   /* message  */
+  YYSYMBOL_hallumsgs = 91,                 /* hallumsgs  */
+  YYSYMBOL_hallumsg = 92,                  /* hallumsg  */
+  YYSYMBOL_rreg_init = 93,                 /* rreg_init  */
+  YYSYMBOL_init_rreg = 94,                 /* init_rreg  */
+  YYSYMBOL_rooms = 95,                     /* rooms  */
+  YYSYMBOL_roomlist = 96,                  /* roomlist  */
+  YYSYMBOL_corridors_def = 97,             /* corridors_def  */
+  YYSYMBOL_random_corridors = 98,          /* random_corridors  */
+  YYSYMBOL_corridors = 99,                 /* corridors  */
+  YYSYMBOL_corridor = 100,                 /* corridor  */
+  YYSYMBOL_corr_spec = 101,                /* corr_spec  */
+  YYSYMBOL_aroom = 102,                    /* aroom  */
+  YYSYMBOL_subroom_def = 103,              /* subroom_def  */
+  YYSYMBOL_room_def = 104,                 /* room_def  */
+  YYSYMBOL_roomfill = 105,                 /* roomfill  */
+  YYSYMBOL_room_pos = 106,                 /* room_pos  */
+  YYSYMBOL_subroom_pos = 107,              /* subroom_pos  */
+  YYSYMBOL_room_align = 108,               /* room_align  */
+  YYSYMBOL_room_size = 109,                /* room_size  */
+  YYSYMBOL_room_details = 110,             /* room_details  */
+  YYSYMBOL_room_detail = 111,              /* room_detail  */
+  YYSYMBOL_room_name = 112,                /* room_name  */
+  YYSYMBOL_room_chance = 113,              /* room_chance  */
+  YYSYMBOL_room_door = 114,                /* room_door  */
+  YYSYMBOL_secret = 115,                   /* secret  */
+  YYSYMBOL_door_wall = 116,                /* door_wall  */
+  YYSYMBOL_door_pos = 117,                 /* door_pos  */
+  YYSYMBOL_maze_def = 118,                 /* maze_def  */
+  YYSYMBOL_filling = 119,                  /* filling  */
+  YYSYMBOL_regions = 120,                  /* regions  */
+  YYSYMBOL_aregion = 121,                  /* aregion  */
+  YYSYMBOL_map_definition = 122,           /* map_definition  */
+  YYSYMBOL_map_geometry = 123,             /* map_geometry  */
+  YYSYMBOL_h_justif = 124,                 /* h_justif  */
+  YYSYMBOL_v_justif = 125,                 /* v_justif  */
+  YYSYMBOL_reg_init = 126,                 /* reg_init  */
+  YYSYMBOL_init_reg = 127,                 /* init_reg  */
+  YYSYMBOL_object_list = 128,              /* object_list  */
+  YYSYMBOL_monster_list = 129,             /* monster_list  */
+  YYSYMBOL_place_list = 130,               /* place_list  */
+  YYSYMBOL_131_1 = 131,                    /* $@1  */
+  YYSYMBOL_map_details = 132,              /* map_details  */
+  YYSYMBOL_map_detail = 133,               /* map_detail  */
+  YYSYMBOL_monster_detail = 134,           /* monster_detail  */
+  YYSYMBOL_135_2 = 135,                    /* $@2  */
+  YYSYMBOL_monster_infos = 136,            /* monster_infos  */
+  YYSYMBOL_monster_info = 137,             /* monster_info  */
+  YYSYMBOL_object_detail = 138,            /* object_detail  */
+  YYSYMBOL_object_desc = 139,              /* object_desc  */
+  YYSYMBOL_140_3 = 140,                    /* $@3  */
+  YYSYMBOL_object_where = 141,             /* object_where  */
+  YYSYMBOL_object_infos = 142,             /* object_infos  */
+  YYSYMBOL_curse_state = 143,              /* curse_state  */
+  YYSYMBOL_monster_id = 144,               /* monster_id  */
+  YYSYMBOL_enchantment = 145,              /* enchantment  */
+  YYSYMBOL_optional_name = 146,            /* optional_name  */
+  YYSYMBOL_door_detail = 147,              /* door_detail  */
+  YYSYMBOL_trap_detail = 148,              /* trap_detail  */
+  YYSYMBOL_drawbridge_detail = 149,        /* drawbridge_detail  */
+  YYSYMBOL_mazewalk_detail = 150,          /* mazewalk_detail  */
+  YYSYMBOL_wallify_detail = 151,           /* wallify_detail  */
+  YYSYMBOL_ladder_detail = 152,            /* ladder_detail  */
+  YYSYMBOL_stair_detail = 153,             /* stair_detail  */
+  YYSYMBOL_stair_region = 154,             /* stair_region  */
+  YYSYMBOL_155_4 = 155,                    /* $@4  */
+  YYSYMBOL_portal_region = 156,            /* portal_region  */
+  YYSYMBOL_157_5 = 157,                    /* $@5  */
+  YYSYMBOL_teleprt_region = 158,           /* teleprt_region  */
+  YYSYMBOL_159_6 = 159,                    /* $@6  */
+  YYSYMBOL_160_7 = 160,                    /* $@7  */
+  YYSYMBOL_branch_region = 161,            /* branch_region  */
+  YYSYMBOL_162_8 = 162,                    /* $@8  */
+  YYSYMBOL_teleprt_detail = 163,           /* teleprt_detail  */
+  YYSYMBOL_lev_region = 164,               /* lev_region  */
+  YYSYMBOL_fountain_detail = 165,          /* fountain_detail  */
+  YYSYMBOL_sink_detail = 166,              /* sink_detail  */
+  YYSYMBOL_pool_detail = 167,              /* pool_detail  */
+  YYSYMBOL_diggable_detail = 168,          /* diggable_detail  */
+  YYSYMBOL_passwall_detail = 169,          /* passwall_detail  */
+  YYSYMBOL_region_detail = 170,            /* region_detail  */
+  YYSYMBOL_altar_detail = 171,             /* altar_detail  */
+  YYSYMBOL_gold_detail = 172,              /* gold_detail  */
+  YYSYMBOL_engraving_detail = 173,         /* engraving_detail  */
+  YYSYMBOL_monster_c = 174,                /* monster_c  */
+  YYSYMBOL_object_c = 175,                 /* object_c  */
+  YYSYMBOL_m_name = 176,                   /* m_name  */
+  YYSYMBOL_o_name = 177,                   /* o_name  */
+  YYSYMBOL_trap_name = 178,                /* trap_name  */
+  YYSYMBOL_room_type = 179,                /* room_type  */
+  YYSYMBOL_prefilled = 180,                /* prefilled  */
+  YYSYMBOL_coordinate = 181,               /* coordinate  */
+  YYSYMBOL_door_state = 182,               /* door_state  */
+  YYSYMBOL_light_state = 183,              /* light_state  */
+  YYSYMBOL_alignment = 184,                /* alignment  */
+  YYSYMBOL_altar_type = 185,               /* altar_type  */
+  YYSYMBOL_p_register = 186,               /* p_register  */
+  YYSYMBOL_o_register = 187,               /* o_register  */
+  YYSYMBOL_m_register = 188,               /* m_register  */
+  YYSYMBOL_a_register = 189,               /* a_register  */
+  YYSYMBOL_place = 190,                    /* place  */
+  YYSYMBOL_monster = 191,                  /* monster  */
+  YYSYMBOL_object = 192,                   /* object  */
+  YYSYMBOL_string = 193,                   /* string  */
+  YYSYMBOL_amount = 194,                   /* amount  */
+  YYSYMBOL_chance = 195,                   /* chance  */
+  YYSYMBOL_engraving_type = 196,           /* engraving_type  */
+  YYSYMBOL_coord = 197,                    /* coord  */
+  YYSYMBOL_region = 198                    /* region  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int16 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  12
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   452
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  78
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  121
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  227
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  483
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   326
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+      72,    73,     2,     2,    70,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    71,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,    74,     2,    75,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    76,    77
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,   136,   136,   137,   140,   141,   144,   145,   148,   175,
+     212,   225,   233,   253,   254,   258,   261,   268,   272,   278,
+     279,   282,   299,   300,   303,   321,   322,   325,   336,   350,
+     364,   367,   368,   371,   372,   375,   383,   384,   387,   402,
+     418,   428,   432,   438,   456,   475,   478,   484,   494,   500,
+     509,   515,   520,   526,   531,   537,   538,   541,   542,   543,
+     544,   545,   546,   547,   548,   549,   550,   551,   552,   553,
+     556,   565,   578,   598,   599,   602,   603,   606,   607,   610,
+     623,   627,   633,   634,   637,   643,   659,   672,   678,   679,
+     682,   683,   686,   687,   690,   701,   716,   729,   736,   745,
+     752,   761,   769,   768,   778,   779,   782,   783,   784,   785,
+     786,   787,   788,   789,   790,   791,   792,   793,   794,   795,
+     796,   797,   798,   799,   800,   801,   805,   804,   840,   841,
+     844,   848,   852,   856,   860,   867,   870,   880,   879,   907,
+     916,   926,   935,   938,   941,   946,   950,   956,   967,   971,
+     977,   978,   981,   987,  1005,  1022,  1064,  1078,  1084,  1101,
+    1119,  1118,  1148,  1147,  1174,  1183,  1173,  1207,  1206,  1233,
+    1236,  1242,  1246,  1264,  1272,  1288,  1301,  1314,  1329,  1344,
+    1410,  1428,  1445,  1463,  1464,  1468,  1471,  1472,  1476,  1479,
+    1480,  1486,  1487,  1493,  1501,  1504,  1514,  1518,  1521,  1525,
+    1531,  1532,  1533,  1539,  1540,  1543,  1544,  1547,  1548,  1549,
+    1555,  1556,  1559,  1568,  1577,  1586,  1595,  1598,  1609,  1621,
+    1624,  1625,  1629,  1632,  1640,  1641,  1644,  1655
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "CHAR", "INTEGER",
+  "BOOLEAN", "PERCENT", "MESSAGE_ID", "HALLUMSG_ID", "MAZE_ID", "LEVEL_ID",
+  "LEV_INIT_ID", "GEOMETRY_ID", "NOMAP_ID", "OBJECT_ID", "COBJECT_ID",
+  "MONSTER_ID", "TRAP_ID", "DOOR_ID", "DRAWBRIDGE_ID", "MAZEWALK_ID",
+  "WALLIFY_ID", "REGION_ID", "FILLING", "RANDOM_OBJECTS_ID",
+  "RANDOM_MONSTERS_ID", "RANDOM_PLACES_ID", "ALTAR_ID", "LADDER_ID",
+  "STAIR_ID", "NON_DIGGABLE_ID", "NON_PASSWALL_ID", "ROOM_ID", "PORTAL_ID",
+  "TELEPRT_ID", "BRANCH_ID", "LEV", "CHANCE_ID", "CORRIDOR_ID", "GOLD_ID",
+  "ENGRAVING_ID", "FOUNTAIN_ID", "POOL_ID", "SINK_ID", "NONE",
+  "RAND_CORRIDOR_ID", "DOOR_STATE", "LIGHT_STATE", "CURSE_TYPE",
+  "ENGRAVING_TYPE", "DIRECTION", "RANDOM_TYPE", "O_REGISTER", "M_REGISTER",
+  "P_REGISTER", "A_REGISTER", "ALIGNMENT", "LEFT_OR_RIGHT", "CENTER",
+  "TOP_OR_BOT", "ALTAR_TYPE", "UP_OR_DOWN", "SUBROOM_ID", "NAME_ID",
+  "FLAGS_ID", "FLAG_TYPE", "MON_ATTITUDE", "MON_ALERTNESS",
+  "MON_APPEARANCE", "CONTAINED", "','", "':'", "'('", "')'", "'['", "']'",
+  "STRING", "MAP_ID", "$accept", "file", "levels", "level", "maze_level",
+  "room_level", "level_def", "lev_init", "walled", "flags", "flag_list",
+  "messages", "message", "hallumsgs", "hallumsg", "rreg_init", "init_rreg",
+  "rooms", "roomlist", "corridors_def", "random_corridors", "corridors",
+  "corridor", "corr_spec", "aroom", "subroom_def", "room_def", "roomfill",
+  "room_pos", "subroom_pos", "room_align", "room_size", "room_details",
+  "room_detail", "room_name", "room_chance", "room_door", "secret",
+  "door_wall", "door_pos", "maze_def", "filling", "regions", "aregion",
+  "map_definition", "map_geometry", "h_justif", "v_justif", "reg_init",
+  "init_reg", "object_list", "monster_list", "place_list", "$@1",
+  "map_details", "map_detail", "monster_detail", "$@2", "monster_infos",
+  "monster_info", "object_detail", "object_desc", "$@3", "object_where",
+  "object_infos", "curse_state", "monster_id", "enchantment",
+  "optional_name", "door_detail", "trap_detail", "drawbridge_detail",
+  "mazewalk_detail", "wallify_detail", "ladder_detail", "stair_detail",
+  "stair_region", "$@4", "portal_region", "$@5", "teleprt_region", "$@6",
+  "$@7", "branch_region", "$@8", "teleprt_detail", "lev_region",
+  "fountain_detail", "sink_detail", "pool_detail", "diggable_detail",
+  "passwall_detail", "region_detail", "altar_detail", "gold_detail",
+  "engraving_detail", "monster_c", "object_c", "m_name", "o_name",
+  "trap_name", "room_type", "prefilled", "coordinate", "door_state",
+  "light_state", "alignment", "altar_type", "p_register", "o_register",
+  "m_register", "a_register", "place", "monster", "object", "string",
+  "amount", "chance", "engraving_type", "coord", "region", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-430)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-103)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+     134,   -30,    41,   101,  -430,   134,  -430,  -430,    57,    57,
+      52,    52,  -430,  -430,    66,   139,   139,  -430,    85,  -430,
+      94,    99,   172,   172,    15,   113,  -430,   181,   118,  -430,
+     172,   183,  -430,  -430,  -430,    94,   123,   116,    29,  -430,
+     124,    39,   183,  -430,   191,  -430,   125,   126,   127,   128,
+    -430,   155,  -430,    -6,  -430,  -430,   129,   130,  -430,  -430,
+      39,  -430,   131,  -430,   132,   200,   201,     4,     4,  -430,
+    -430,  -430,   168,  -430,     5,     5,  -430,    30,  -430,   122,
+    -430,   202,  -430,  -430,   140,  -430,  -430,   141,  -430,   142,
+    -430,   143,   138,  -430,   208,   208,   208,   208,   144,   145,
+     146,   148,   149,   150,   151,   152,   153,   154,  -430,  -430,
+    -430,  -430,  -430,  -430,  -430,  -430,  -430,  -430,  -430,  -430,
+    -430,  -430,  -430,  -430,   156,   157,   158,   159,  -430,   147,
+     162,   200,   201,    89,    89,   161,  -430,  -430,   163,  -430,
+     164,   165,    20,   -15,   -15,   214,    23,   -15,   -15,   -15,
+     -15,    52,    95,   200,   201,   166,   169,   170,   171,  -430,
+     173,   174,   175,   176,   177,   178,   179,   180,  -430,  -430,
+    -430,  -430,  -430,  -430,  -430,  -430,  -430,  -430,  -430,  -430,
+    -430,  -430,  -430,  -430,  -430,  -430,  -430,  -430,  -430,   222,
+    -430,  -430,  -430,  -430,   167,   182,   235,   184,    21,    14,
+       9,  -430,  -430,   185,  -430,   186,   239,   187,  -430,  -430,
+     188,  -430,  -430,  -430,   189,   193,  -430,  -430,  -430,  -430,
+    -430,  -430,  -430,  -430,  -430,  -430,   194,  -430,    78,   -15,
+     -15,   195,   -15,    28,   195,   195,    -3,    -3,    -3,   196,
+      35,    51,   198,    12,  -430,   197,   199,  -430,  -430,  -430,
+     203,   204,  -430,  -430,  -430,   205,  -430,    78,   249,   206,
+      64,   209,   -15,   100,   210,  -430,  -430,   211,   212,   216,
+     252,   217,   218,   207,   257,  -430,  -430,  -430,  -430,  -430,
+    -430,  -430,    89,  -430,   261,   219,  -430,   268,   220,   223,
+    -430,  -430,   274,    19,   280,    27,   -15,   221,   224,   288,
+    -430,   226,  -430,   225,  -430,  -430,  -430,  -430,  -430,   227,
+     166,   -15,   243,   244,   228,    89,   240,     8,   232,   233,
+     234,   236,   237,   238,   241,    53,   242,    54,   245,   230,
+    -430,  -430,  -430,   246,  -430,   248,  -430,  -430,   107,  -430,
+     247,   292,   -11,    52,  -430,  -430,   253,  -430,   305,   254,
+    -430,   255,  -430,   306,    -3,    -3,    -3,    -3,    26,   309,
+    -430,    30,   256,   310,  -430,   312,   258,    24,  -430,   259,
+    -430,   -15,  -430,  -430,   260,  -430,   262,  -430,  -430,  -430,
+    -430,    78,   264,     4,   315,    72,   265,   266,  -430,  -430,
+    -430,  -430,  -430,   267,   269,    54,   270,   271,    52,  -430,
+    -430,   272,    45,  -430,    24,  -430,  -430,   318,   276,   277,
+     281,    52,   278,  -430,    95,   279,  -430,   323,   279,  -430,
+    -430,   282,  -430,  -430,  -430,   283,   308,  -430,   328,  -430,
+    -430,   289,  -430,   284,   333,  -430,   285,  -430,   -13,  -430,
+     286,   340,   290,   291,  -430,  -430,  -430,  -430,  -430,  -430,
+    -430,   293,   294,    42,  -430,   295,   346,   350,     7,    25,
+    -430,  -430,    52,  -430,  -430,  -430,  -430,   296,  -430,  -430,
+     297,   300,   300,  -430,  -430,    25,   -14,  -430,  -430,   300,
+    -430,  -430,  -430
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_uint8 yydefact[] =
+{
+       2,     0,     0,     0,     3,     4,     6,     7,    15,    15,
+       0,     0,     1,     5,     0,    11,    11,   219,     0,    10,
+       0,     0,    19,    19,     0,    18,    16,     0,     0,    25,
+      19,    22,    80,    81,    79,     0,     0,     0,    29,    20,
+       0,     0,    22,    17,     0,    21,     0,     0,     0,     0,
+      26,    36,    30,    31,    55,    55,     0,     0,    85,     8,
+      82,    92,     0,    23,     0,     0,     0,     0,     0,    35,
+       9,    33,    34,    32,    42,    41,    24,     0,    83,   104,
+      86,     0,   218,    27,    97,   217,    28,    99,   196,     0,
+     195,     0,     0,    37,   222,   222,   222,   222,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    56,    57,
+      58,    59,    60,    61,    62,    69,    64,    65,    66,    63,
+      67,    68,    88,    89,     0,     0,     0,     0,    93,    84,
+       0,     0,     0,     0,     0,     0,   223,   135,     0,   136,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,   157,
+       0,     0,     0,     0,     0,     0,     0,     0,   105,   106,
+     107,   108,   109,   110,   118,   119,   120,   121,   112,   113,
+     114,   115,   117,   124,   125,   111,   116,   122,   123,     0,
+      98,   100,   205,   206,     0,     0,     0,     0,     0,     0,
+       0,    73,    74,     0,   202,     0,     0,     0,   201,   200,
+       0,    71,   220,   221,     0,     0,   174,   176,   175,    70,
+      91,    90,    87,    94,    96,    95,   101,   216,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,   187,     0,     0,   188,   186,   184,
+       0,     0,   185,   183,   194,     0,   193,     0,     0,     0,
+       0,     0,     0,     0,     0,   203,   204,     0,     0,     0,
+       0,     0,     0,     0,     0,   160,   171,   177,   178,   162,
+     164,   167,     0,    48,     0,     0,    50,     0,     0,     0,
+      39,    38,     0,     0,     0,     0,     0,     0,     0,     0,
+     209,     0,   207,     0,   208,   159,   181,   224,   225,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+     192,   137,   191,     0,   190,     0,   189,   154,     0,   212,
+       0,     0,     0,     0,   103,   153,     0,   156,     0,     0,
+     158,     0,   173,     0,     0,     0,     0,     0,     0,     0,
+      52,     0,     0,     0,    54,     0,     0,     0,   213,     0,
+     214,     0,    75,    76,     0,   226,     0,   211,   210,   180,
+     182,     0,     0,     0,     0,     0,     0,     0,   165,   168,
+      13,    14,    12,     0,     0,     0,     0,     0,     0,    77,
+      78,     0,     0,   126,     0,   215,   155,     0,   197,     0,
+       0,     0,   169,    47,     0,    45,    49,     0,    45,    40,
+     140,   141,   139,   128,    72,     0,     0,   179,     0,   161,
+     163,     0,   166,     0,     0,    44,     0,    43,     0,   138,
+     127,     0,   198,     0,   170,    51,    46,    53,   146,   145,
+     147,     0,     0,     0,   129,     0,     0,     0,     0,     0,
+     131,   132,     0,   133,   130,   227,   199,     0,   149,   148,
+       0,   150,   150,   134,   172,     0,     0,   143,   144,   150,
+     151,   152,   142
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -430,  -430,   354,  -430,  -430,  -430,  -430,   339,  -430,   353,
+     330,    83,  -430,   324,  -430,  -430,  -430,  -430,   319,  -430,
+    -430,  -430,  -430,   133,  -430,  -430,  -430,   -47,  -430,  -430,
+    -430,   -22,   320,  -430,  -430,  -430,  -430,  -430,  -430,   -27,
+    -430,  -430,   314,  -430,  -430,  -430,    17,   -35,  -430,  -430,
+     -94,   -38,    70,  -430,  -430,  -430,   263,  -430,  -430,  -430,
+     273,   287,  -430,  -430,  -430,  -430,   -77,  -348,  -429,  -430,
+     275,  -430,  -430,  -430,  -430,   298,  -430,  -430,  -430,  -430,
+    -430,  -430,  -430,  -430,  -430,  -430,  -223,   299,  -430,  -430,
+    -430,  -430,  -430,   301,   302,   303,  -430,  -430,  -430,  -430,
+    -430,   -66,  -430,  -140,  -251,  -130,   -70,  -430,  -430,  -430,
+    -430,  -430,  -430,   190,   192,   -10,  -430,    76,  -430,  -150,
+     -96
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int16 yydefgoto[] =
+{
+       0,     3,     4,     5,     6,     7,     8,    22,   392,    15,
+      26,    29,    30,    41,    42,    38,    50,    51,    52,    70,
+      71,    72,    93,   197,    53,    54,    55,   435,   285,   288,
+     362,   366,    74,   108,   109,   110,   111,   203,   374,   401,
+       9,    34,    59,    60,    61,    62,   124,   222,    79,   128,
+      83,    86,   225,   264,   129,   168,   112,   423,   440,   454,
+     113,   137,   369,   421,   439,   451,   452,   471,   477,   171,
+     114,   173,   174,   175,   176,   115,   178,   319,   179,   320,
+     180,   321,   412,   181,   322,   432,   275,   116,   117,   118,
+     183,   184,   185,   119,   120,   121,   251,   246,   335,   331,
+     255,    89,   427,   210,   267,   194,   303,   379,   208,   247,
+     252,   304,   226,    87,    84,    90,   214,   138,   309,   209,
+     276
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+      18,    19,    91,   207,   195,   227,   297,   215,   216,   217,
+     218,   468,   351,   279,   280,   281,   290,    85,    32,    94,
+      95,    96,    97,    98,    82,   201,    48,   212,   399,   468,
+     480,   390,    99,   273,   100,   448,   204,   190,   449,   205,
+     377,    10,   101,   478,   102,   103,   104,   105,   106,   378,
+     482,    57,    58,    46,    47,    88,    49,   206,   469,   223,
+     254,    48,   481,   450,   273,   249,    33,   250,   107,   270,
+     330,   202,   244,   245,   213,   400,   469,   391,   334,   204,
+      17,   352,   205,   450,   196,    17,   283,   122,   123,   268,
+     269,    49,   272,   300,   191,    17,   204,   301,   302,   205,
+     274,    12,   286,    17,   360,   364,    31,   284,   460,   461,
+     462,   472,    11,    39,   420,   300,   224,   206,    17,   301,
+     302,    14,   306,   287,   265,   361,   365,   479,    17,   266,
+     406,   386,   387,   388,   389,   271,   192,    20,   277,   278,
+     193,   219,   407,     1,     2,   375,   125,   126,   127,   307,
+      21,   308,   323,   220,   221,    24,   337,   372,   373,    25,
+     227,    94,    95,    96,    97,   156,   157,   158,   159,   160,
+      27,   345,   140,   141,    99,   161,   162,   163,   164,    28,
+     165,   166,   167,    35,    36,   349,   102,   103,   104,    37,
+     256,    40,    45,    44,    64,    56,    65,    66,    67,    68,
+      69,    77,    81,    82,    85,    76,    92,   130,    80,   135,
+     131,   132,   133,   134,   136,   142,   143,   144,   211,   145,
+     146,   147,   148,   149,   150,   151,   152,   239,   153,   154,
+     155,   403,   189,   196,   198,   199,   200,   240,   206,   242,
+     228,   229,   230,   259,   231,   232,   233,   234,   235,   236,
+     237,   238,   241,   298,   243,   257,   314,   260,   261,   262,
+     258,   318,   422,   263,  -102,   324,   282,   270,   289,   293,
+     305,   292,   326,   328,   295,   296,   299,   294,   329,   317,
+     310,   311,   312,   332,   333,   336,   313,   315,   316,   325,
+     327,   338,   340,   346,   347,   342,   376,   343,   348,   339,
+     341,   350,   353,   354,   355,   368,   356,   357,   358,   382,
+     385,   359,   363,   393,   396,   367,   397,   408,   371,   409,
+     375,   370,   425,   381,   383,   384,   395,   436,   398,   402,
+     404,   442,   443,   380,   407,   410,   411,   405,   446,   414,
+     413,   417,   429,   416,   455,   419,   426,   428,   431,   434,
+     444,   466,   438,   441,   467,    23,   453,   445,   447,    13,
+     456,   457,    16,   458,   459,    43,    63,   475,   465,   474,
+     476,   437,    73,   415,    78,    75,   291,   424,   394,   433,
+     344,   470,   139,   463,     0,     0,     0,     0,   418,   253,
+     248,     0,   169,     0,     0,     0,     0,     0,     0,     0,
+       0,   430,   170,     0,   172,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,   177,   182,     0,
+     186,   187,   188,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,   464,     0,     0,     0,     0,     0,     0,
+       0,     0,   473
+};
+
+static const yytype_int16 yycheck[] =
+{
+      10,    11,    68,   143,   134,   155,   257,   147,   148,   149,
+     150,     4,     4,   236,   237,   238,     4,     3,     3,    14,
+      15,    16,    17,    18,     3,     5,    32,     4,     4,     4,
+      44,     5,    27,    36,    29,    48,    51,   131,    51,    54,
+      51,    71,    37,   472,    39,    40,    41,    42,    43,    60,
+     479,    12,    13,    24,    25,    51,    62,    72,    51,   153,
+      51,    32,    76,    76,    36,    51,    51,    53,    63,    72,
+      51,    51,    51,    52,    51,    51,    51,    51,    51,    51,
+      76,    73,    54,    76,    72,    76,    51,    57,    58,   229,
+     230,    62,   232,    51,   132,    76,    51,    55,    56,    54,
+      72,     0,    51,    76,    51,    51,    23,    72,    66,    67,
+      68,   459,    71,    30,    69,    51,   154,    72,    76,    55,
+      56,    64,   262,    72,    46,    72,    72,   475,    76,    51,
+     381,   354,   355,   356,   357,   231,    47,    71,   234,   235,
+      51,   151,    70,     9,    10,    73,    24,    25,    26,    49,
+      11,    51,   282,    58,    59,    70,   296,    50,    51,    65,
+     310,    14,    15,    16,    17,    18,    19,    20,    21,    22,
+      71,   311,    96,    97,    27,    28,    29,    30,    31,     7,
+      33,    34,    35,    70,     3,   315,    39,    40,    41,    71,
+     200,     8,    76,    70,     3,    71,    71,    71,    71,    71,
+      45,    71,    70,     3,     3,    76,    38,     5,    77,    71,
+      70,    70,    70,    70,     6,    71,    71,    71,     4,    71,
+      71,    71,    71,    71,    71,    71,    70,     5,    71,    71,
+      71,   371,    70,    72,    71,    71,    71,    70,    72,     4,
+      71,    71,    71,     4,    71,    71,    71,    71,    71,    71,
+      71,    71,    70,     4,    70,    70,     4,    70,    70,    70,
+      74,     4,   402,    70,    70,     4,    70,    72,    70,    70,
+      61,    74,     4,    50,    70,    70,    70,    74,     4,    72,
+      70,    70,    70,   293,     4,   295,    70,    70,    70,    70,
+      70,    70,     4,    50,    50,    70,     4,    70,    70,    75,
+      74,    61,    70,    70,    70,    75,    70,    70,    70,     4,
+       4,    70,    70,     4,     4,    70,     4,   383,    70,     4,
+      73,    75,     4,    70,    70,    70,    70,     4,    70,    70,
+      70,    23,     4,   343,    70,    70,    70,    75,     5,    70,
+      73,    70,    61,    73,     4,    73,    70,    70,    70,    70,
+      61,     5,    70,    70,     4,    16,    70,    73,    73,     5,
+      70,    70,     9,    70,    70,    35,    42,    70,    73,    73,
+      70,   418,    53,   395,    60,    55,   243,   404,   361,   414,
+     310,   458,    95,   453,    -1,    -1,    -1,    -1,   398,   199,
+     198,    -1,   129,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,   411,   129,    -1,   129,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,   129,   129,    -1,
+     129,   129,   129,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,   453,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,   462
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_uint8 yystos[] =
+{
+       0,     9,    10,    79,    80,    81,    82,    83,    84,   118,
+      71,    71,     0,    80,    64,    87,    87,    76,   193,   193,
+      71,    11,    85,    85,    70,    65,    88,    71,     7,    89,
+      90,    89,     3,    51,   119,    70,     3,    71,    93,    89,
+       8,    91,    92,    88,    70,    76,    24,    25,    32,    62,
+      94,    95,    96,   102,   103,   104,    71,    12,    13,   120,
+     121,   122,   123,    91,     3,    71,    71,    71,    71,    45,
+      97,    98,    99,    96,   110,   110,    76,    71,   120,   126,
+      77,    70,     3,   128,   192,     3,   129,   191,    51,   179,
+     193,   179,    38,   100,    14,    15,    16,    17,    18,    27,
+      29,    37,    39,    40,    41,    42,    43,    63,   111,   112,
+     113,   114,   134,   138,   148,   153,   165,   166,   167,   171,
+     172,   173,    57,    58,   124,    24,    25,    26,   127,   132,
+       5,    70,    70,    70,    70,    71,     6,   139,   195,   139,
+     195,   195,    71,    71,    71,    71,    71,    71,    71,    71,
+      71,    71,    70,    71,    71,    71,    18,    19,    20,    21,
+      22,    28,    29,    30,    31,    33,    34,    35,   133,   134,
+     138,   147,   148,   149,   150,   151,   152,   153,   154,   156,
+     158,   161,   165,   168,   169,   170,   171,   172,   173,    70,
+     128,   129,    47,    51,   183,   183,    72,   101,    71,    71,
+      71,     5,    51,   115,    51,    54,    72,   181,   186,   197,
+     181,     4,     4,    51,   194,   181,   181,   181,   181,   193,
+      58,    59,   125,   128,   129,   130,   190,   197,    71,    71,
+      71,    71,    71,    71,    71,    71,    71,    71,    71,     5,
+      70,    70,     4,    70,    51,    52,   175,   187,   192,    51,
+      53,   174,   188,   191,    51,   178,   193,    70,    74,     4,
+      70,    70,    70,    70,   131,    46,    51,   182,   181,   181,
+      72,   198,   181,    36,    72,   164,   198,   198,   198,   164,
+     164,   164,    70,    51,    72,   106,    51,    72,   107,    70,
+       4,   101,    74,    70,    74,    70,    70,   182,     4,    70,
+      51,    55,    56,   184,   189,    61,   181,    49,    51,   196,
+      70,    70,    70,    70,     4,    70,    70,    72,     4,   155,
+     157,   159,   162,   183,     4,    70,     4,    70,    50,     4,
+      51,   177,   193,     4,    51,   176,   193,   181,    70,    75,
+       4,    74,    70,    70,   130,   181,    50,    50,    70,   183,
+      61,     4,    73,    70,    70,    70,    70,    70,    70,    70,
+      51,    72,   108,    70,    51,    72,   109,    70,    75,   140,
+      75,    70,    50,    51,   116,    73,     4,    51,    60,   185,
+     193,    70,     4,    70,    70,     4,   164,   164,   164,   164,
+       5,    51,    86,     4,   124,    70,     4,     4,    70,     4,
+      51,   117,    70,   181,    70,    75,   182,    70,   179,     4,
+      70,    70,   160,    73,    70,   109,    73,    70,   193,    73,
+      69,   141,   181,   135,   117,     4,    70,   180,    70,    61,
+     193,    70,   163,   125,    70,   105,     4,   105,    70,   142,
+     136,    70,    23,     4,    61,    73,     5,    73,    48,    51,
+      76,   143,   144,    70,   137,     4,    70,    70,    70,    70,
+      66,    67,    68,   184,   193,    73,     5,     4,     4,    51,
+     144,   145,   145,   193,    73,    70,    70,   146,   146,   145,
+      44,    76,   146
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_uint8 yyr1[] =
+{
+       0,    78,    79,    79,    80,    80,    81,    81,    82,    83,
+      84,    85,    85,    86,    86,    87,    87,    88,    88,    89,
+      89,    90,    91,    91,    92,    93,    93,    94,    94,    95,
+      95,    96,    96,    97,    97,    98,    99,    99,   100,   100,
+     101,   102,   102,   103,   104,   105,   105,   106,   106,   107,
+     107,   108,   108,   109,   109,   110,   110,   111,   111,   111,
+     111,   111,   111,   111,   111,   111,   111,   111,   111,   111,
+     112,   113,   114,   115,   115,   116,   116,   117,   117,   118,
+     119,   119,   120,   120,   121,   122,   122,   123,   124,   124,
+     125,   125,   126,   126,   127,   127,   127,   128,   128,   129,
+     129,   130,   131,   130,   132,   132,   133,   133,   133,   133,
+     133,   133,   133,   133,   133,   133,   133,   133,   133,   133,
+     133,   133,   133,   133,   133,   133,   135,   134,   136,   136,
+     137,   137,   137,   137,   137,   138,   138,   140,   139,   141,
+     141,   142,   142,   142,   142,   143,   143,   144,   145,   145,
+     146,   146,   146,   147,   148,   149,   150,   151,   152,   153,
+     155,   154,   157,   156,   159,   160,   158,   162,   161,   163,
+     163,   164,   164,   164,   165,   166,   167,   168,   169,   170,
+     171,   172,   173,   174,   174,   174,   175,   175,   175,   176,
+     176,   177,   177,   178,   178,   179,   179,   180,   180,   180,
+     181,   181,   181,   182,   182,   183,   183,   184,   184,   184,
+     185,   185,   186,   187,   188,   189,   190,   191,   192,   193,
+     194,   194,   195,   195,   196,   196,   197,   198
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     0,     1,     1,     2,     1,     1,     6,     7,
+       3,     0,    13,     1,     1,     0,     3,     3,     1,     0,
+       2,     3,     0,     2,     3,     0,     2,     3,     3,     0,
+       1,     1,     2,     1,     1,     1,     0,     2,     5,     5,
+       7,     2,     2,    12,    12,     0,     2,     5,     1,     5,
+       1,     5,     1,     5,     1,     0,     2,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       3,     3,     9,     1,     1,     1,     1,     1,     1,     5,
+       1,     1,     1,     2,     3,     1,     2,     5,     1,     1,
+       1,     1,     0,     2,     3,     3,     3,     1,     3,     1,
+       3,     1,     0,     4,     0,     2,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     0,    10,     0,     2,
+       2,     2,     2,     2,     3,     2,     2,     0,     9,     1,
+       1,     0,     7,     5,     5,     1,     1,     1,     1,     1,
+       0,     2,     2,     5,     6,     7,     5,     1,     5,     5,
+       0,     8,     0,     8,     0,     0,     8,     0,     6,     0,
+       2,     1,    10,     3,     3,     3,     3,     3,     3,     8,
+       7,     5,     7,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     0,     2,     4,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     4,     4,     4,     4,     1,     1,     1,     1,
+       1,     1,     0,     1,     1,     1,     5,     9
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+{
+  YY_USE (yyvaluep);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 8: /* maze_level: maze_def flags lev_init messages hallumsgs regions  */
+#line 149 "libnethack/util/lev_comp.y"
+                  {
+			unsigned i;
+
+			if (fatal_error > 0) {
+				(void) fprintf(stderr,
+				"%s : %d errors detected. No output created!\n",
+					fname, fatal_error);
+			} else {
+				maze.flags = (yyvsp[-4].i);
+				(void) memcpy(&(maze.init_lev),
+						&(init_lev),
+						sizeof(lev_init));
+				maze.numpart = npart;
+				maze.parts = NewTab(mazepart, npart);
+				for(i=0;i<npart;i++)
+				    maze.parts[i] = tmppart[i];
+				if (!write_level_file((yyvsp[-5].map), NULL, &maze)) {
+					yyerror("Can't write output file!!");
+					exit(EXIT_FAILURE);
+				}
+				npart = 0;
+			}
+			Free((yyvsp[-5].map));
+		  }
+#line 1729 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 9: /* room_level: level_def flags lev_init messages rreg_init rooms corridors_def  */
+#line 176 "libnethack/util/lev_comp.y"
+                  {
+			unsigned i;
+
+			if (fatal_error > 0) {
+			    (void) fprintf(stderr,
+			      "%s : %d errors detected. No output created!\n",
+					fname, fatal_error);
+			} else {
+				special_lev.flags = (long) (yyvsp[-5].i);
+				(void) memcpy(
+					&(special_lev.init_lev),
+					&(init_lev),
+					sizeof(lev_init));
+				special_lev.nroom = nrooms;
+				special_lev.rooms = NewTab(room, nrooms);
+				for(i=0; i<nrooms; i++)
+				    special_lev.rooms[i] = tmproom[i];
+				special_lev.ncorr = ncorridor;
+				special_lev.corrs = NewTab(corridor, ncorridor);
+				for(i=0; i<ncorridor; i++)
+				    special_lev.corrs[i] = tmpcor[i];
+				if (check_subrooms()) {
+				    if (!write_level_file((yyvsp[-6].map), &special_lev,
+							  NULL)) {
+					yyerror("Can't write output file!!");
+					exit(EXIT_FAILURE);
+				    }
+				}
+				free_rooms(&special_lev);
+				nrooms = 0;
+				ncorridor = 0;
+			}
+			Free((yyvsp[-6].map));
+		  }
+#line 1768 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 10: /* level_def: LEVEL_ID ':' string  */
+#line 213 "libnethack/util/lev_comp.y"
+                  {
+			if (strchr((yyvsp[0].map), '.'))
+			    yyerror("Invalid dot ('.') in level name.");
+			if ((int) strlen((yyvsp[0].map)) > 8)
+			    yyerror("Level names limited to 8 characters.");
+			(yyval.map) = (yyvsp[0].map);
+			special_lev.nrmonst = special_lev.nrobjects = 0;
+			n_mlist = n_olist = 0;
+		  }
+#line 1782 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 11: /* lev_init: %empty  */
+#line 225 "libnethack/util/lev_comp.y"
+                  {
+			/* in case we're processing multiple files,
+			   explicitly clear any stale settings */
+			(void) memset(&init_lev, 0,
+					sizeof init_lev);
+			init_lev.init_present = FALSE;
+			(yyval.i) = 0;
+		  }
+#line 1795 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 12: /* lev_init: LEV_INIT_ID ':' CHAR ',' CHAR ',' BOOLEAN ',' BOOLEAN ',' light_state ',' walled  */
+#line 234 "libnethack/util/lev_comp.y"
+                  {
+			init_lev.init_present = TRUE;
+			init_lev.fg = what_map_char((char) (yyvsp[-10].i));
+			if (init_lev.fg == INVALID_TYPE)
+			    yyerror("Invalid foreground type.");
+			init_lev.bg = what_map_char((char) (yyvsp[-8].i));
+			if (init_lev.bg == INVALID_TYPE)
+			    yyerror("Invalid background type.");
+			init_lev.smoothed = (yyvsp[-6].i);
+			init_lev.joined = (yyvsp[-4].i);
+			if (init_lev.joined &&
+			    init_lev.fg != CORR && init_lev.fg != ROOM)
+			    yyerror("Invalid foreground type for joined map.");
+			init_lev.lit = (yyvsp[-2].i);
+			init_lev.walled = (yyvsp[0].i);
+			(yyval.i) = 1;
+		  }
+#line 1817 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 15: /* flags: %empty  */
+#line 258 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = 0;
+		  }
+#line 1825 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 16: /* flags: FLAGS_ID ':' flag_list  */
+#line 262 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = lev_flags;
+			lev_flags = 0;	/* clear for next user */
+		  }
+#line 1834 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 17: /* flag_list: FLAG_TYPE ',' flag_list  */
+#line 269 "libnethack/util/lev_comp.y"
+                  {
+			lev_flags |= (yyvsp[-2].i);
+		  }
+#line 1842 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 18: /* flag_list: FLAG_TYPE  */
+#line 273 "libnethack/util/lev_comp.y"
+                  {
+			lev_flags |= (yyvsp[0].i);
+		  }
+#line 1850 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 21: /* message: MESSAGE_ID ':' STRING  */
+#line 283 "libnethack/util/lev_comp.y"
+                  {
+			int i, j;
+
+			i = (int) strlen((yyvsp[0].map)) + 1;
+			j = (int) strlen(tmpmessage);
+			if (i + j > 255) {
+			   yyerror("Message string too long (>256 characters)");
+			} else {
+			    if (j) tmpmessage[j++] = '\n';
+			    (void) strncpy(tmpmessage+j, (yyvsp[0].map), i - 1);
+			    tmpmessage[j + i - 1] = 0;
+			}
+			Free((yyvsp[0].map));
+		  }
+#line 1869 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 24: /* hallumsg: HALLUMSG_ID ':' STRING  */
+#line 304 "libnethack/util/lev_comp.y"
+                  {
+			int i, j;
+
+			i = (int) strlen((yyvsp[0].map)) + 1;
+			j = (int) strlen(tmphallumsg);
+			if (i + j > 255) {
+			   yyerror("Message string too long (>256 characters)");
+			} else {
+			    if (j) tmphallumsg[j++] = '\n';
+			    (void) strncpy(tmphallumsg+j, (yyvsp[0].map), i - 1);
+			    tmphallumsg[j + i - 1] = 0;
+			}
+			Free((yyvsp[0].map));
+		  }
+#line 1888 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 27: /* init_rreg: RANDOM_OBJECTS_ID ':' object_list  */
+#line 326 "libnethack/util/lev_comp.y"
+                  {
+			if(special_lev.nrobjects) {
+			    yyerror("Object registers already initialized!");
+			} else {
+			    special_lev.nrobjects = n_olist;
+			    special_lev.robjects = malloc(n_olist);
+			    (void) memcpy(special_lev.robjects,
+					  olist, n_olist);
+			}
+		  }
+#line 1903 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 28: /* init_rreg: RANDOM_MONSTERS_ID ':' monster_list  */
+#line 337 "libnethack/util/lev_comp.y"
+                  {
+			if(special_lev.nrmonst) {
+			    yyerror("Monster registers already initialized!");
+			} else {
+			    special_lev.nrmonst = n_mlist;
+			    special_lev.rmonst = malloc(n_mlist);
+			    (void) memcpy(special_lev.rmonst,
+					  mlist, n_mlist);
+			  }
+		  }
+#line 1918 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 29: /* rooms: %empty  */
+#line 350 "libnethack/util/lev_comp.y"
+                  {
+			tmproom[nrooms] = New(room);
+			tmproom[nrooms]->name = NULL;
+			tmproom[nrooms]->parent = NULL;
+			tmproom[nrooms]->rtype = 0;
+			tmproom[nrooms]->rlit = 0;
+			tmproom[nrooms]->xalign = ERR;
+			tmproom[nrooms]->yalign = ERR;
+			tmproom[nrooms]->x = 0;
+			tmproom[nrooms]->y = 0;
+			tmproom[nrooms]->w = 2;
+			tmproom[nrooms]->h = 2;
+			in_room = 1;
+		  }
+#line 1937 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 35: /* random_corridors: RAND_CORRIDOR_ID  */
+#line 376 "libnethack/util/lev_comp.y"
+                  {
+			tmpcor[0] = New(corridor);
+			tmpcor[0]->src.room = -1;
+			ncorridor = 1;
+		  }
+#line 1947 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 38: /* corridor: CORRIDOR_ID ':' corr_spec ',' corr_spec  */
+#line 388 "libnethack/util/lev_comp.y"
+                  {
+			tmpcor[ncorridor] = New(corridor);
+			tmpcor[ncorridor]->src.room = (yyvsp[-2].corpos).room;
+			tmpcor[ncorridor]->src.wall = (yyvsp[-2].corpos).wall;
+			tmpcor[ncorridor]->src.door = (yyvsp[-2].corpos).door;
+			tmpcor[ncorridor]->dest.room = (yyvsp[0].corpos).room;
+			tmpcor[ncorridor]->dest.wall = (yyvsp[0].corpos).wall;
+			tmpcor[ncorridor]->dest.door = (yyvsp[0].corpos).door;
+			ncorridor++;
+			if (ncorridor >= MAX_OF_TYPE) {
+				yyerror("Too many corridors in level!");
+				ncorridor--;
+			}
+		  }
+#line 1966 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 39: /* corridor: CORRIDOR_ID ':' corr_spec ',' INTEGER  */
+#line 403 "libnethack/util/lev_comp.y"
+                  {
+			tmpcor[ncorridor] = New(corridor);
+			tmpcor[ncorridor]->src.room = (yyvsp[-2].corpos).room;
+			tmpcor[ncorridor]->src.wall = (yyvsp[-2].corpos).wall;
+			tmpcor[ncorridor]->src.door = (yyvsp[-2].corpos).door;
+			tmpcor[ncorridor]->dest.room = -1;
+			tmpcor[ncorridor]->dest.wall = (yyvsp[0].i);
+			ncorridor++;
+			if (ncorridor >= MAX_OF_TYPE) {
+				yyerror("Too many corridors in level!");
+				ncorridor--;
+			}
+		  }
+#line 1984 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 40: /* corr_spec: '(' INTEGER ',' DIRECTION ',' door_pos ')'  */
+#line 419 "libnethack/util/lev_comp.y"
+                  {
+			if ((unsigned) (yyvsp[-5].i) >= nrooms)
+			    yyerror("Wrong room number!");
+			(yyval.corpos).room = (yyvsp[-5].i);
+			(yyval.corpos).wall = (yyvsp[-3].i);
+			(yyval.corpos).door = (yyvsp[-1].i);
+		  }
+#line 1996 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 41: /* aroom: room_def room_details  */
+#line 429 "libnethack/util/lev_comp.y"
+                  {
+			store_room();
+		  }
+#line 2004 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 42: /* aroom: subroom_def room_details  */
+#line 433 "libnethack/util/lev_comp.y"
+                  {
+			store_room();
+		  }
+#line 2012 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 43: /* subroom_def: SUBROOM_ID ':' room_type ',' light_state ',' subroom_pos ',' room_size ',' string roomfill  */
+#line 439 "libnethack/util/lev_comp.y"
+                  {
+			tmproom[nrooms] = New(room);
+			tmproom[nrooms]->parent = (yyvsp[-1].map);
+			tmproom[nrooms]->name = NULL;
+			tmproom[nrooms]->rtype = (yyvsp[-9].i);
+			tmproom[nrooms]->rlit = (yyvsp[-7].i);
+			tmproom[nrooms]->filled = (yyvsp[0].i);
+			tmproom[nrooms]->xalign = ERR;
+			tmproom[nrooms]->yalign = ERR;
+			tmproom[nrooms]->x = current_coord.x;
+			tmproom[nrooms]->y = current_coord.y;
+			tmproom[nrooms]->w = current_size.width;
+			tmproom[nrooms]->h = current_size.height;
+			in_room = 1;
+		  }
+#line 2032 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 44: /* room_def: ROOM_ID ':' room_type ',' light_state ',' room_pos ',' room_align ',' room_size roomfill  */
+#line 457 "libnethack/util/lev_comp.y"
+                  {
+			tmproom[nrooms] = New(room);
+			tmproom[nrooms]->name = NULL;
+			tmproom[nrooms]->parent = NULL;
+			tmproom[nrooms]->rtype = (yyvsp[-9].i);
+			tmproom[nrooms]->rlit = (yyvsp[-7].i);
+			tmproom[nrooms]->filled = (yyvsp[0].i);
+			tmproom[nrooms]->xalign = current_align.x;
+			tmproom[nrooms]->yalign = current_align.y;
+			tmproom[nrooms]->x = current_coord.x;
+			tmproom[nrooms]->y = current_coord.y;
+			tmproom[nrooms]->w = current_size.width;
+			tmproom[nrooms]->h = current_size.height;
+			in_room = 1;
+		  }
+#line 2052 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 45: /* roomfill: %empty  */
+#line 475 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = 1;
+		  }
+#line 2060 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 46: /* roomfill: ',' BOOLEAN  */
+#line 479 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = (yyvsp[0].i);
+		  }
+#line 2068 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 47: /* room_pos: '(' INTEGER ',' INTEGER ')'  */
+#line 485 "libnethack/util/lev_comp.y"
+                  {
+			if ( (yyvsp[-3].i) < 1 || (yyvsp[-3].i) > 5 ||
+			    (yyvsp[-1].i) < 1 || (yyvsp[-1].i) > 5 ) {
+			    yyerror("Room position should be between 1 & 5!");
+			} else {
+			    current_coord.x = (yyvsp[-3].i);
+			    current_coord.y = (yyvsp[-1].i);
+			}
+		  }
+#line 2082 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 48: /* room_pos: RANDOM_TYPE  */
+#line 495 "libnethack/util/lev_comp.y"
+                  {
+			current_coord.x = current_coord.y = ERR;
+		  }
+#line 2090 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 49: /* subroom_pos: '(' INTEGER ',' INTEGER ')'  */
+#line 501 "libnethack/util/lev_comp.y"
+                  {
+			if ( (yyvsp[-3].i) < 0 || (yyvsp[-1].i) < 0) {
+			    yyerror("Invalid subroom position !");
+			} else {
+			    current_coord.x = (yyvsp[-3].i);
+			    current_coord.y = (yyvsp[-1].i);
+			}
+		  }
+#line 2103 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 50: /* subroom_pos: RANDOM_TYPE  */
+#line 510 "libnethack/util/lev_comp.y"
+                  {
+			current_coord.x = current_coord.y = ERR;
+		  }
+#line 2111 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 51: /* room_align: '(' h_justif ',' v_justif ')'  */
+#line 516 "libnethack/util/lev_comp.y"
+                  {
+			current_align.x = (yyvsp[-3].i);
+			current_align.y = (yyvsp[-1].i);
+		  }
+#line 2120 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 52: /* room_align: RANDOM_TYPE  */
+#line 521 "libnethack/util/lev_comp.y"
+                  {
+			current_align.x = current_align.y = ERR;
+		  }
+#line 2128 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 53: /* room_size: '(' INTEGER ',' INTEGER ')'  */
+#line 527 "libnethack/util/lev_comp.y"
+                  {
+			current_size.width = (yyvsp[-3].i);
+			current_size.height = (yyvsp[-1].i);
+		  }
+#line 2137 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 54: /* room_size: RANDOM_TYPE  */
+#line 532 "libnethack/util/lev_comp.y"
+                  {
+			current_size.height = current_size.width = ERR;
+		  }
+#line 2145 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 70: /* room_name: NAME_ID ':' string  */
+#line 557 "libnethack/util/lev_comp.y"
+                  {
+			if (tmproom[nrooms]->name)
+			    yyerror("This room already has a name!");
+			else
+			    tmproom[nrooms]->name = (yyvsp[0].map);
+		  }
+#line 2156 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 71: /* room_chance: CHANCE_ID ':' INTEGER  */
+#line 566 "libnethack/util/lev_comp.y"
+                   {
+			if (tmproom[nrooms]->chance)
+			    yyerror("This room already assigned a chance!");
+			else if (tmproom[nrooms]->rtype == OROOM)
+			    yyerror("Only typed rooms can have a chance!");
+			else if ((yyvsp[0].i) < 1 || (yyvsp[0].i) > 99)
+			    yyerror("The chance is supposed to be percentile.");
+			else
+			    tmproom[nrooms]->chance = (yyvsp[0].i);
+		   }
+#line 2171 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 72: /* room_door: DOOR_ID ':' secret ',' door_state ',' door_wall ',' door_pos  */
+#line 579 "libnethack/util/lev_comp.y"
+                  {
+			/* ERR means random here */
+			if ((yyvsp[-2].i) == ERR && (yyvsp[0].i) != ERR) {
+		     yyerror("If the door wall is random, so must be its pos!");
+			} else {
+			    tmprdoor[ndoor] = New(room_door);
+			    tmprdoor[ndoor]->secret = (yyvsp[-6].i);
+			    tmprdoor[ndoor]->mask = (yyvsp[-4].i);
+			    tmprdoor[ndoor]->wall = (yyvsp[-2].i);
+			    tmprdoor[ndoor]->pos = (yyvsp[0].i);
+			    ndoor++;
+			    if (ndoor >= MAX_OF_TYPE) {
+				    yyerror("Too many doors in room!");
+				    ndoor--;
+			    }
+			}
+		  }
+#line 2193 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 79: /* maze_def: MAZE_ID ':' string ',' filling  */
+#line 611 "libnethack/util/lev_comp.y"
+                  {
+			maze.filling = (schar) (yyvsp[0].i);
+			if (strchr((yyvsp[-2].map), '.'))
+			    yyerror("Invalid dot ('.') in level name.");
+			if ((int) strlen((yyvsp[-2].map)) > 8)
+			    yyerror("Level names limited to 8 characters.");
+			(yyval.map) = (yyvsp[-2].map);
+			in_room = 0;
+			n_plist = n_mlist = n_olist = 0;
+		  }
+#line 2208 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 80: /* filling: CHAR  */
+#line 624 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = get_floor_type((char)(yyvsp[0].i));
+		  }
+#line 2216 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 81: /* filling: RANDOM_TYPE  */
+#line 628 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = -1;
+		  }
+#line 2224 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 84: /* aregion: map_definition reg_init map_details  */
+#line 638 "libnethack/util/lev_comp.y"
+                  {
+			store_part();
+		  }
+#line 2232 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 85: /* map_definition: NOMAP_ID  */
+#line 644 "libnethack/util/lev_comp.y"
+                  {
+			tmppart[npart] = New(mazepart);
+			tmppart[npart]->halign = 1;
+			tmppart[npart]->valign = 1;
+			tmppart[npart]->nrobjects = 0;
+			tmppart[npart]->nloc = 0;
+			tmppart[npart]->nrmonst = 0;
+			tmppart[npart]->xsize = 1;
+			tmppart[npart]->ysize = 1;
+			tmppart[npart]->map = malloc(sizeof(char *));
+			tmppart[npart]->map[0] = malloc(1);
+			tmppart[npart]->map[0][0] = STONE;
+			max_x_map = COLNO-1;
+			max_y_map = ROWNO;
+		  }
+#line 2252 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 86: /* map_definition: map_geometry MAP_ID  */
+#line 660 "libnethack/util/lev_comp.y"
+                  {
+			tmppart[npart] = New(mazepart);
+			tmppart[npart]->halign = (yyvsp[-1].i) % 10;
+			tmppart[npart]->valign = (yyvsp[-1].i) / 10;
+			tmppart[npart]->nrobjects = 0;
+			tmppart[npart]->nloc = 0;
+			tmppart[npart]->nrmonst = 0;
+			scan_map((yyvsp[0].map));
+			Free((yyvsp[0].map));
+		  }
+#line 2267 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 87: /* map_geometry: GEOMETRY_ID ':' h_justif ',' v_justif  */
+#line 673 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = (yyvsp[-2].i) + ((yyvsp[0].i) * 10);
+		  }
+#line 2275 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 94: /* init_reg: RANDOM_OBJECTS_ID ':' object_list  */
+#line 691 "libnethack/util/lev_comp.y"
+                  {
+			if (tmppart[npart]->nrobjects) {
+			    yyerror("Object registers already initialized!");
+			} else {
+			    tmppart[npart]->robjects = malloc(n_olist);
+			    (void) memcpy(tmppart[npart]->robjects,
+					  olist, n_olist);
+			    tmppart[npart]->nrobjects = n_olist;
+			}
+		  }
+#line 2290 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 95: /* init_reg: RANDOM_PLACES_ID ':' place_list  */
+#line 702 "libnethack/util/lev_comp.y"
+                  {
+			if (tmppart[npart]->nloc) {
+			    yyerror("Location registers already initialized!");
+			} else {
+			    int i;
+			    tmppart[npart]->rloc_x = malloc(n_plist);
+			    tmppart[npart]->rloc_y = malloc(n_plist);
+			    for(i=0;i<n_plist;i++) {
+				tmppart[npart]->rloc_x[i] = plist[i].x;
+				tmppart[npart]->rloc_y[i] = plist[i].y;
+			    }
+			    tmppart[npart]->nloc = n_plist;
+			}
+		  }
+#line 2309 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 96: /* init_reg: RANDOM_MONSTERS_ID ':' monster_list  */
+#line 717 "libnethack/util/lev_comp.y"
+                  {
+			if (tmppart[npart]->nrmonst) {
+			    yyerror("Monster registers already initialized!");
+			} else {
+			    tmppart[npart]->rmonst = malloc(n_mlist);
+			    (void) memcpy(tmppart[npart]->rmonst,
+					  mlist, n_mlist);
+			    tmppart[npart]->nrmonst = n_mlist;
+			}
+		  }
+#line 2324 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 97: /* object_list: object  */
+#line 730 "libnethack/util/lev_comp.y"
+                  {
+			if (n_olist < MAX_REGISTERS)
+			    olist[n_olist++] = (yyvsp[0].i);
+			else
+			    yyerror("Object list too long!");
+		  }
+#line 2335 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 98: /* object_list: object ',' object_list  */
+#line 737 "libnethack/util/lev_comp.y"
+                  {
+			if (n_olist < MAX_REGISTERS)
+			    olist[n_olist++] = (yyvsp[-2].i);
+			else
+			    yyerror("Object list too long!");
+		  }
+#line 2346 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 99: /* monster_list: monster  */
+#line 746 "libnethack/util/lev_comp.y"
+                  {
+			if (n_mlist < MAX_REGISTERS)
+			    mlist[n_mlist++] = (yyvsp[0].i);
+			else
+			    yyerror("Monster list too long!");
+		  }
+#line 2357 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 100: /* monster_list: monster ',' monster_list  */
+#line 753 "libnethack/util/lev_comp.y"
+                  {
+			if (n_mlist < MAX_REGISTERS)
+			    mlist[n_mlist++] = (yyvsp[-2].i);
+			else
+			    yyerror("Monster list too long!");
+		  }
+#line 2368 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 101: /* place_list: place  */
+#line 762 "libnethack/util/lev_comp.y"
+                  {
+			if (n_plist < MAX_REGISTERS)
+			    plist[n_plist++] = current_coord;
+			else
+			    yyerror("Location list too long!");
+		  }
+#line 2379 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 102: /* $@1: %empty  */
+#line 769 "libnethack/util/lev_comp.y"
+                  {
+			if (n_plist < MAX_REGISTERS)
+			    plist[n_plist++] = current_coord;
+			else
+			    yyerror("Location list too long!");
+		  }
+#line 2390 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 126: /* $@2: %empty  */
+#line 805 "libnethack/util/lev_comp.y"
+                  {
+			tmpmonst[nmons] = New(monster);
+			tmpmonst[nmons]->x = current_coord.x;
+			tmpmonst[nmons]->y = current_coord.y;
+			tmpmonst[nmons]->class = (yyvsp[-4].i);
+			tmpmonst[nmons]->peaceful = -1; /* no override */
+			tmpmonst[nmons]->asleep = -1;
+			tmpmonst[nmons]->align = - MAX_REGISTERS - 2;
+			tmpmonst[nmons]->name.str = 0;
+			tmpmonst[nmons]->appear = 0;
+			tmpmonst[nmons]->appear_as.str = 0;
+			tmpmonst[nmons]->chance = (yyvsp[-6].i);
+			tmpmonst[nmons]->id = NON_PM;
+			if (!in_room)
+			    check_coord(current_coord.x, current_coord.y,
+					"Monster");
+			if ((yyvsp[-2].map)) {
+			    int token = get_monster_id((yyvsp[-2].map), (char) (yyvsp[-4].i));
+			    if (token == ERR)
+				yywarning(
+			      "Invalid monster name!  Making random monster.");
+			    else
+				tmpmonst[nmons]->id = token;
+			    Free((yyvsp[-2].map));
+			}
+		  }
+#line 2421 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 127: /* monster_detail: MONSTER_ID chance ':' monster_c ',' m_name ',' coordinate $@2 monster_infos  */
+#line 832 "libnethack/util/lev_comp.y"
+                  {
+			if (++nmons >= MAX_OF_TYPE) {
+			    yyerror("Too many monsters in room or mazepart!");
+			    nmons--;
+			}
+		  }
+#line 2432 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 130: /* monster_info: ',' string  */
+#line 845 "libnethack/util/lev_comp.y"
+                  {
+			tmpmonst[nmons]->name.str = (yyvsp[0].map);
+		  }
+#line 2440 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 131: /* monster_info: ',' MON_ATTITUDE  */
+#line 849 "libnethack/util/lev_comp.y"
+                  {
+			tmpmonst[nmons]->peaceful = (yyvsp[0].i);
+		  }
+#line 2448 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 132: /* monster_info: ',' MON_ALERTNESS  */
+#line 853 "libnethack/util/lev_comp.y"
+                  {
+			tmpmonst[nmons]->asleep = (yyvsp[0].i);
+		  }
+#line 2456 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 133: /* monster_info: ',' alignment  */
+#line 857 "libnethack/util/lev_comp.y"
+                  {
+			tmpmonst[nmons]->align = (yyvsp[0].i);
+		  }
+#line 2464 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 134: /* monster_info: ',' MON_APPEARANCE string  */
+#line 861 "libnethack/util/lev_comp.y"
+                  {
+			tmpmonst[nmons]->appear = (yyvsp[-1].i);
+			tmpmonst[nmons]->appear_as.str = (yyvsp[0].map);
+		  }
+#line 2473 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 135: /* object_detail: OBJECT_ID object_desc  */
+#line 868 "libnethack/util/lev_comp.y"
+                  {
+		  }
+#line 2480 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 136: /* object_detail: COBJECT_ID object_desc  */
+#line 871 "libnethack/util/lev_comp.y"
+                  {
+			/* 1: is contents of preceeding object with 2 */
+			/* 2: is a container */
+			/* 0: neither */
+			tmpobj[nobj-1]->containment = 2;
+		  }
+#line 2491 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 137: /* $@3: %empty  */
+#line 880 "libnethack/util/lev_comp.y"
+                  {
+			tmpobj[nobj] = New(object);
+			tmpobj[nobj]->class = (yyvsp[-2].i);
+			tmpobj[nobj]->corpsenm = NON_PM;
+			tmpobj[nobj]->curse_state = -1;
+			tmpobj[nobj]->name.str = 0;
+			tmpobj[nobj]->chance = (yyvsp[-4].i);
+			tmpobj[nobj]->id = -1;
+			if ((yyvsp[0].map)) {
+			    int token = get_object_id((yyvsp[0].map), (yyvsp[-2].i));
+			    if (token == ERR)
+				yywarning(
+				"Illegal object name!  Making random object.");
+			     else
+				tmpobj[nobj]->id = token;
+			    Free((yyvsp[0].map));
+			}
+		  }
+#line 2514 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 138: /* object_desc: chance ':' object_c ',' o_name $@3 ',' object_where object_infos  */
+#line 899 "libnethack/util/lev_comp.y"
+                  {
+			if (++nobj >= MAX_OF_TYPE) {
+			    yyerror("Too many objects in room or mazepart!");
+			    nobj--;
+			}
+		  }
+#line 2525 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 139: /* object_where: coordinate  */
+#line 908 "libnethack/util/lev_comp.y"
+                  {
+			tmpobj[nobj]->containment = 0;
+			tmpobj[nobj]->x = current_coord.x;
+			tmpobj[nobj]->y = current_coord.y;
+			if (!in_room)
+			    check_coord(current_coord.x, current_coord.y,
+					"Object");
+		  }
+#line 2538 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 140: /* object_where: CONTAINED  */
+#line 917 "libnethack/util/lev_comp.y"
+                  {
+			tmpobj[nobj]->containment = 1;
+			/* random coordinate, will be overridden anyway */
+			tmpobj[nobj]->x = -MAX_REGISTERS-1;
+			tmpobj[nobj]->y = -MAX_REGISTERS-1;
+		  }
+#line 2549 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 141: /* object_infos: %empty  */
+#line 926 "libnethack/util/lev_comp.y"
+                  {
+			tmpobj[nobj]->spe = -127;
+	/* Note below: we're trying to make as many of these optional as
+	 * possible.  We clearly can't make curse_state, enchantment, and
+	 * monster_id _all_ optional, since ",random" would be ambiguous.
+	 * We can't even just make enchantment mandatory, since if we do that
+	 * alone, ",random" requires too much lookahead to parse.
+	 */
+		  }
+#line 2563 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 142: /* object_infos: ',' curse_state ',' monster_id ',' enchantment optional_name  */
+#line 936 "libnethack/util/lev_comp.y"
+                  {
+		  }
+#line 2570 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 143: /* object_infos: ',' curse_state ',' enchantment optional_name  */
+#line 939 "libnethack/util/lev_comp.y"
+                  {
+		  }
+#line 2577 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 144: /* object_infos: ',' monster_id ',' enchantment optional_name  */
+#line 942 "libnethack/util/lev_comp.y"
+                  {
+		  }
+#line 2584 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 145: /* curse_state: RANDOM_TYPE  */
+#line 947 "libnethack/util/lev_comp.y"
+                  {
+			tmpobj[nobj]->curse_state = -1;
+		  }
+#line 2592 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 146: /* curse_state: CURSE_TYPE  */
+#line 951 "libnethack/util/lev_comp.y"
+                  {
+			tmpobj[nobj]->curse_state = (yyvsp[0].i);
+		  }
+#line 2600 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 147: /* monster_id: STRING  */
+#line 957 "libnethack/util/lev_comp.y"
+                  {
+			int token = get_monster_id((yyvsp[0].map), (char)0);
+			if (token == ERR)	/* "random" */
+			    tmpobj[nobj]->corpsenm = NON_PM - 1;
+			else
+			    tmpobj[nobj]->corpsenm = token;
+			Free((yyvsp[0].map));
+		  }
+#line 2613 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 148: /* enchantment: RANDOM_TYPE  */
+#line 968 "libnethack/util/lev_comp.y"
+                  {
+			tmpobj[nobj]->spe = -127;
+		  }
+#line 2621 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 149: /* enchantment: INTEGER  */
+#line 972 "libnethack/util/lev_comp.y"
+                  {
+			tmpobj[nobj]->spe = (yyvsp[0].i);
+		  }
+#line 2629 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 151: /* optional_name: ',' NONE  */
+#line 979 "libnethack/util/lev_comp.y"
+                  {
+		  }
+#line 2636 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 152: /* optional_name: ',' STRING  */
+#line 982 "libnethack/util/lev_comp.y"
+                  {
+			tmpobj[nobj]->name.str = (yyvsp[0].map);
+		  }
+#line 2644 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 153: /* door_detail: DOOR_ID ':' door_state ',' coordinate  */
+#line 988 "libnethack/util/lev_comp.y"
+                  {
+			tmpdoor[ndoor] = New(door);
+			tmpdoor[ndoor]->x = current_coord.x;
+			tmpdoor[ndoor]->y = current_coord.y;
+			tmpdoor[ndoor]->mask = (yyvsp[-2].i);
+			if(current_coord.x >= 0 && current_coord.y >= 0 &&
+			   tmpmap[current_coord.y][current_coord.x] != DOOR &&
+			   tmpmap[current_coord.y][current_coord.x] != SDOOR)
+			    yyerror("Door decl doesn't match the map");
+			ndoor++;
+			if (ndoor >= MAX_OF_TYPE) {
+				yyerror("Too many doors in mazepart!");
+				ndoor--;
+			}
+		  }
+#line 2664 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 154: /* trap_detail: TRAP_ID chance ':' trap_name ',' coordinate  */
+#line 1006 "libnethack/util/lev_comp.y"
+                  {
+			tmptrap[ntrap] = New(trap);
+			tmptrap[ntrap]->x = current_coord.x;
+			tmptrap[ntrap]->y = current_coord.y;
+			tmptrap[ntrap]->type = (yyvsp[-2].i);
+			tmptrap[ntrap]->chance = (yyvsp[-4].i);
+			if (!in_room)
+			    check_coord(current_coord.x, current_coord.y,
+					"Trap");
+			if (++ntrap >= MAX_OF_TYPE) {
+				yyerror("Too many traps in room or mazepart!");
+				ntrap--;
+			}
+		  }
+#line 2683 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 155: /* drawbridge_detail: DRAWBRIDGE_ID ':' coordinate ',' DIRECTION ',' door_state  */
+#line 1023 "libnethack/util/lev_comp.y"
+                   {
+		        int x, y, dir;
+
+			tmpdb[ndb] = New(drawbridge);
+			x = tmpdb[ndb]->x = current_coord.x;
+			y = tmpdb[ndb]->y = current_coord.y;
+			/* convert dir from a DIRECTION to a DB_DIR */
+			dir = (yyvsp[-2].i);
+			switch(dir) {
+			case W_NORTH: dir = DB_NORTH; y--; break;
+			case W_SOUTH: dir = DB_SOUTH; y++; break;
+			case W_EAST:  dir = DB_EAST;  x++; break;
+			case W_WEST:  dir = DB_WEST;  x--; break;
+			default:
+			    yyerror("Invalid drawbridge direction");
+			    break;
+			}
+			tmpdb[ndb]->dir = dir;
+			if (current_coord.x >= 0 && current_coord.y >= 0 &&
+			    !IS_WALL(tmpmap[y][x])) {
+			    char ebuf[60];
+			    snprintf(ebuf, SIZE(ebuf),
+				    "Wall needed for drawbridge (%02d, %02d)",
+				    current_coord.x, current_coord.y);
+			    yyerror(ebuf);
+			}
+
+			if ( (yyvsp[0].i) == D_ISOPEN )
+			    tmpdb[ndb]->db_open = 1;
+			else if ( (yyvsp[0].i) == D_CLOSED )
+			    tmpdb[ndb]->db_open = 0;
+			else
+			    yyerror("A drawbridge can only be open or closed!");
+			ndb++;
+			if (ndb >= MAX_OF_TYPE) {
+				yyerror("Too many drawbridges in mazepart!");
+				ndb--;
+			}
+		   }
+#line 2727 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 156: /* mazewalk_detail: MAZEWALK_ID ':' coordinate ',' DIRECTION  */
+#line 1065 "libnethack/util/lev_comp.y"
+                  {
+			tmpwalk[nwalk] = New(walk);
+			tmpwalk[nwalk]->x = current_coord.x;
+			tmpwalk[nwalk]->y = current_coord.y;
+			tmpwalk[nwalk]->dir = (yyvsp[0].i);
+			nwalk++;
+			if (nwalk >= MAX_OF_TYPE) {
+				yyerror("Too many mazewalks in mazepart!");
+				nwalk--;
+			}
+		  }
+#line 2743 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 157: /* wallify_detail: WALLIFY_ID  */
+#line 1079 "libnethack/util/lev_comp.y"
+                  {
+			wallify_map();
+		  }
+#line 2751 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 158: /* ladder_detail: LADDER_ID ':' coordinate ',' UP_OR_DOWN  */
+#line 1085 "libnethack/util/lev_comp.y"
+                  {
+			tmplad[nlad] = New(lad);
+			tmplad[nlad]->x = current_coord.x;
+			tmplad[nlad]->y = current_coord.y;
+			tmplad[nlad]->up = (yyvsp[0].i);
+			if (!in_room)
+			    check_coord(current_coord.x, current_coord.y,
+					"Ladder");
+			nlad++;
+			if (nlad >= MAX_OF_TYPE) {
+				yyerror("Too many ladders in mazepart!");
+				nlad--;
+			}
+		  }
+#line 2770 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 159: /* stair_detail: STAIR_ID ':' coordinate ',' UP_OR_DOWN  */
+#line 1102 "libnethack/util/lev_comp.y"
+                  {
+			tmpstair[nstair] = New(stair);
+			tmpstair[nstair]->x = current_coord.x;
+			tmpstair[nstair]->y = current_coord.y;
+			tmpstair[nstair]->up = (yyvsp[0].i);
+			if (!in_room)
+			    check_coord(current_coord.x, current_coord.y,
+					"Stairway");
+			nstair++;
+			if (nstair >= MAX_OF_TYPE) {
+				yyerror("Too many stairs in room or mazepart!");
+				nstair--;
+			}
+		  }
+#line 2789 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 160: /* $@4: %empty  */
+#line 1119 "libnethack/util/lev_comp.y"
+                  {
+			tmplreg[nlreg] = New(lev_region);
+			tmplreg[nlreg]->in_islev = (yyvsp[0].i);
+			tmplreg[nlreg]->inarea.x1 = current_region.x1;
+			tmplreg[nlreg]->inarea.y1 = current_region.y1;
+			tmplreg[nlreg]->inarea.x2 = current_region.x2;
+			tmplreg[nlreg]->inarea.y2 = current_region.y2;
+		  }
+#line 2802 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 161: /* stair_region: STAIR_ID ':' lev_region $@4 ',' lev_region ',' UP_OR_DOWN  */
+#line 1128 "libnethack/util/lev_comp.y"
+                  {
+			tmplreg[nlreg]->del_islev = (yyvsp[-2].i);
+			tmplreg[nlreg]->delarea.x1 = current_region.x1;
+			tmplreg[nlreg]->delarea.y1 = current_region.y1;
+			tmplreg[nlreg]->delarea.x2 = current_region.x2;
+			tmplreg[nlreg]->delarea.y2 = current_region.y2;
+			if((yyvsp[0].i))
+			    tmplreg[nlreg]->rtype = LR_UPSTAIR;
+			else
+			    tmplreg[nlreg]->rtype = LR_DOWNSTAIR;
+			tmplreg[nlreg]->rname.str = 0;
+			nlreg++;
+			if (nlreg >= MAX_OF_TYPE) {
+				yyerror("Too many levregions in mazepart!");
+				nlreg--;
+			}
+		  }
+#line 2824 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 162: /* $@5: %empty  */
+#line 1148 "libnethack/util/lev_comp.y"
+                  {
+			tmplreg[nlreg] = New(lev_region);
+			tmplreg[nlreg]->in_islev = (yyvsp[0].i);
+			tmplreg[nlreg]->inarea.x1 = current_region.x1;
+			tmplreg[nlreg]->inarea.y1 = current_region.y1;
+			tmplreg[nlreg]->inarea.x2 = current_region.x2;
+			tmplreg[nlreg]->inarea.y2 = current_region.y2;
+		  }
+#line 2837 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 163: /* portal_region: PORTAL_ID ':' lev_region $@5 ',' lev_region ',' string  */
+#line 1157 "libnethack/util/lev_comp.y"
+                  {
+			tmplreg[nlreg]->del_islev = (yyvsp[-2].i);
+			tmplreg[nlreg]->delarea.x1 = current_region.x1;
+			tmplreg[nlreg]->delarea.y1 = current_region.y1;
+			tmplreg[nlreg]->delarea.x2 = current_region.x2;
+			tmplreg[nlreg]->delarea.y2 = current_region.y2;
+			tmplreg[nlreg]->rtype = LR_PORTAL;
+			tmplreg[nlreg]->rname.str = (yyvsp[0].map);
+			nlreg++;
+			if (nlreg >= MAX_OF_TYPE) {
+				yyerror("Too many levregions in mazepart!");
+				nlreg--;
+			}
+		  }
+#line 2856 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 164: /* $@6: %empty  */
+#line 1174 "libnethack/util/lev_comp.y"
+                  {
+			tmplreg[nlreg] = New(lev_region);
+			tmplreg[nlreg]->in_islev = (yyvsp[0].i);
+			tmplreg[nlreg]->inarea.x1 = current_region.x1;
+			tmplreg[nlreg]->inarea.y1 = current_region.y1;
+			tmplreg[nlreg]->inarea.x2 = current_region.x2;
+			tmplreg[nlreg]->inarea.y2 = current_region.y2;
+		  }
+#line 2869 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 165: /* $@7: %empty  */
+#line 1183 "libnethack/util/lev_comp.y"
+                  {
+			tmplreg[nlreg]->del_islev = (yyvsp[0].i);
+			tmplreg[nlreg]->delarea.x1 = current_region.x1;
+			tmplreg[nlreg]->delarea.y1 = current_region.y1;
+			tmplreg[nlreg]->delarea.x2 = current_region.x2;
+			tmplreg[nlreg]->delarea.y2 = current_region.y2;
+		  }
+#line 2881 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 166: /* teleprt_region: TELEPRT_ID ':' lev_region $@6 ',' lev_region $@7 teleprt_detail  */
+#line 1191 "libnethack/util/lev_comp.y"
+                  {
+			switch((yyvsp[0].i)) {
+			case -1: tmplreg[nlreg]->rtype = LR_TELE; break;
+			case 0: tmplreg[nlreg]->rtype = LR_DOWNTELE; break;
+			case 1: tmplreg[nlreg]->rtype = LR_UPTELE; break;
+			}
+			tmplreg[nlreg]->rname.str = 0;
+			nlreg++;
+			if (nlreg >= MAX_OF_TYPE) {
+				yyerror("Too many levregions in mazepart!");
+				nlreg--;
+			}
+		  }
+#line 2899 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 167: /* $@8: %empty  */
+#line 1207 "libnethack/util/lev_comp.y"
+                  {
+			tmplreg[nlreg] = New(lev_region);
+			tmplreg[nlreg]->in_islev = (yyvsp[0].i);
+			tmplreg[nlreg]->inarea.x1 = current_region.x1;
+			tmplreg[nlreg]->inarea.y1 = current_region.y1;
+			tmplreg[nlreg]->inarea.x2 = current_region.x2;
+			tmplreg[nlreg]->inarea.y2 = current_region.y2;
+		  }
+#line 2912 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 168: /* branch_region: BRANCH_ID ':' lev_region $@8 ',' lev_region  */
+#line 1216 "libnethack/util/lev_comp.y"
+                  {
+			tmplreg[nlreg]->del_islev = (yyvsp[0].i);
+			tmplreg[nlreg]->delarea.x1 = current_region.x1;
+			tmplreg[nlreg]->delarea.y1 = current_region.y1;
+			tmplreg[nlreg]->delarea.x2 = current_region.x2;
+			tmplreg[nlreg]->delarea.y2 = current_region.y2;
+			tmplreg[nlreg]->rtype = LR_BRANCH;
+			tmplreg[nlreg]->rname.str = 0;
+			nlreg++;
+			if (nlreg >= MAX_OF_TYPE) {
+				yyerror("Too many levregions in mazepart!");
+				nlreg--;
+			}
+		  }
+#line 2931 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 169: /* teleprt_detail: %empty  */
+#line 1233 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = -1;
+		  }
+#line 2939 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 170: /* teleprt_detail: ',' UP_OR_DOWN  */
+#line 1237 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = (yyvsp[0].i);
+		  }
+#line 2947 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 171: /* lev_region: region  */
+#line 1243 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = 0;
+		  }
+#line 2955 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 172: /* lev_region: LEV '(' INTEGER ',' INTEGER ',' INTEGER ',' INTEGER ')'  */
+#line 1247 "libnethack/util/lev_comp.y"
+                  {
+/* This series of if statements is a hack for MSC 5.1.  It seems that its
+   tiny little brain cannot compile if these are all one big if statement. */
+			if ((yyvsp[-7].i) < 0 || (yyvsp[-7].i) >= COLNO)
+				yyerror("Region out of level range!");
+			else if ((yyvsp[-5].i) < 0 || (yyvsp[-5].i) >= ROWNO)
+				yyerror("Region out of level range!");
+			else if ((yyvsp[-3].i) < 0 || (yyvsp[-3].i) >= COLNO)
+				yyerror("Region out of level range!");
+			else if ((yyvsp[-1].i) < 0 || (yyvsp[-1].i) >= ROWNO)
+				yyerror("Region out of level range!");
+			current_region.x1 = (yyvsp[-7].i);
+			current_region.y1 = (yyvsp[-5].i);
+			current_region.x2 = (yyvsp[-3].i);
+			current_region.y2 = (yyvsp[-1].i);
+			(yyval.i) = 1;
+		  }
+#line 2977 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 173: /* lev_region: LEV '(' ')'  */
+#line 1265 "libnethack/util/lev_comp.y"
+          {
+            current_region.x1 = current_region.x2 = COLNO;
+            current_region.y1 = current_region.y2 = ROWNO;
+            (yyval.i) = 1;
+          }
+#line 2987 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 174: /* fountain_detail: FOUNTAIN_ID ':' coordinate  */
+#line 1273 "libnethack/util/lev_comp.y"
+                  {
+			tmpfountain[nfountain] = New(fountain);
+			tmpfountain[nfountain]->x = current_coord.x;
+			tmpfountain[nfountain]->y = current_coord.y;
+			if (!in_room)
+			    check_coord(current_coord.x, current_coord.y,
+					"Fountain");
+			nfountain++;
+			if (nfountain >= MAX_OF_TYPE) {
+			    yyerror("Too many fountains in room or mazepart!");
+			    nfountain--;
+			}
+		  }
+#line 3005 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 175: /* sink_detail: SINK_ID ':' coordinate  */
+#line 1289 "libnethack/util/lev_comp.y"
+                  {
+			tmpsink[nsink] = New(sink);
+			tmpsink[nsink]->x = current_coord.x;
+			tmpsink[nsink]->y = current_coord.y;
+			nsink++;
+			if (nsink >= MAX_OF_TYPE) {
+				yyerror("Too many sinks in room!");
+				nsink--;
+			}
+		  }
+#line 3020 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 176: /* pool_detail: POOL_ID ':' coordinate  */
+#line 1302 "libnethack/util/lev_comp.y"
+                  {
+			tmppool[npool] = New(pool);
+			tmppool[npool]->x = current_coord.x;
+			tmppool[npool]->y = current_coord.y;
+			npool++;
+			if (npool >= MAX_OF_TYPE) {
+				yyerror("Too many pools in room!");
+				npool--;
+			}
+		  }
+#line 3035 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 177: /* diggable_detail: NON_DIGGABLE_ID ':' region  */
+#line 1315 "libnethack/util/lev_comp.y"
+                  {
+			tmpdig[ndig] = New(digpos);
+			tmpdig[ndig]->x1 = current_region.x1;
+			tmpdig[ndig]->y1 = current_region.y1;
+			tmpdig[ndig]->x2 = current_region.x2;
+			tmpdig[ndig]->y2 = current_region.y2;
+			ndig++;
+			if (ndig >= MAX_OF_TYPE) {
+				yyerror("Too many diggables in mazepart!");
+				ndig--;
+			}
+		  }
+#line 3052 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 178: /* passwall_detail: NON_PASSWALL_ID ':' region  */
+#line 1330 "libnethack/util/lev_comp.y"
+                  {
+			tmppass[npass] = New(digpos);
+			tmppass[npass]->x1 = current_region.x1;
+			tmppass[npass]->y1 = current_region.y1;
+			tmppass[npass]->x2 = current_region.x2;
+			tmppass[npass]->y2 = current_region.y2;
+			npass++;
+			if (npass >= 32) {
+				yyerror("Too many passwalls in mazepart!");
+				npass--;
+			}
+		  }
+#line 3069 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 179: /* region_detail: REGION_ID ':' region ',' light_state ',' room_type prefilled  */
+#line 1345 "libnethack/util/lev_comp.y"
+                  {
+			tmpreg[nreg] = New(region);
+			tmpreg[nreg]->x1 = current_region.x1;
+			tmpreg[nreg]->y1 = current_region.y1;
+			tmpreg[nreg]->x2 = current_region.x2;
+			tmpreg[nreg]->y2 = current_region.y2;
+			tmpreg[nreg]->rlit = (yyvsp[-3].i);
+			tmpreg[nreg]->rtype = (yyvsp[-1].i);
+			if((yyvsp[0].i) & 1) tmpreg[nreg]->rtype += MAXRTYPE+1;
+			tmpreg[nreg]->rirreg = (((yyvsp[0].i) & 2) != 0);
+			if(current_region.x1 > current_region.x2 ||
+			   current_region.y1 > current_region.y2)
+			   yyerror("Region start > end!");
+			if(tmpreg[nreg]->rtype == VAULT &&
+			   (tmpreg[nreg]->rirreg ||
+			    (tmpreg[nreg]->x2 - tmpreg[nreg]->x1 != 1) ||
+			    (tmpreg[nreg]->y2 - tmpreg[nreg]->y1 != 1)))
+				yyerror("Vaults must be exactly 2x2!");
+			if(want_warnings && !tmpreg[nreg]->rirreg &&
+			   current_region.x1 > 0 && current_region.y1 > 0 &&
+			   current_region.x2 < (int)max_x_map &&
+			   current_region.y2 < (int)max_y_map) {
+			    /* check for walls in the room */
+			    char ebuf[60];
+			    int x, y, nrock = 0;
+
+			    for(y=current_region.y1; y<=current_region.y2; y++)
+				for(x=current_region.x1;
+				    x<=current_region.x2; x++)
+				    if(IS_ROCK(tmpmap[y][x]) ||
+				       IS_DOOR(tmpmap[y][x])) nrock++;
+			    if(nrock) {
+				snprintf(ebuf, SIZE(ebuf),
+					"Rock in room (%02d,%02d,%02d,%02d)?!",
+					current_region.x1, current_region.y1,
+					current_region.x2, current_region.y2);
+				yywarning(ebuf);
+			    }
+			    if (
+		!IS_ROCK(tmpmap[current_region.y1-1][current_region.x1-1]) ||
+		!IS_ROCK(tmpmap[current_region.y2+1][current_region.x1-1]) ||
+		!IS_ROCK(tmpmap[current_region.y1-1][current_region.x2+1]) ||
+		!IS_ROCK(tmpmap[current_region.y2+1][current_region.x2+1])) {
+				snprintf(ebuf, SIZE(ebuf),
+				"NonRock edge in room (%02d,%02d,%02d,%02d)?!",
+					current_region.x1, current_region.y1,
+					current_region.x2, current_region.y2);
+				yywarning(ebuf);
+			    }
+			} else if(tmpreg[nreg]->rirreg &&
+		!IS_ROOM(tmpmap[current_region.y1][current_region.x1])) {
+			    char ebuf[60];
+			    snprintf(ebuf, SIZE(ebuf),
+				    "Rock in irregular room (%02d,%02d)?!",
+				    current_region.x1, current_region.y1);
+			    yyerror(ebuf);
+			}
+			nreg++;
+			if (nreg >= MAX_OF_TYPE) {
+				yyerror("Too many regions in mazepart!");
+				nreg--;
+			}
+		  }
+#line 3137 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 180: /* altar_detail: ALTAR_ID ':' coordinate ',' alignment ',' altar_type  */
+#line 1411 "libnethack/util/lev_comp.y"
+                  {
+			tmpaltar[naltar] = New(altar);
+			tmpaltar[naltar]->x = current_coord.x;
+			tmpaltar[naltar]->y = current_coord.y;
+			tmpaltar[naltar]->align = (yyvsp[-2].i);
+			tmpaltar[naltar]->shrine = (yyvsp[0].i);
+			if (!in_room)
+			    check_coord(current_coord.x, current_coord.y,
+					"Altar");
+			naltar++;
+			if (naltar >= MAX_OF_TYPE) {
+				yyerror("Too many altars in room or mazepart!");
+				naltar--;
+			}
+		  }
+#line 3157 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 181: /* gold_detail: GOLD_ID ':' amount ',' coordinate  */
+#line 1429 "libnethack/util/lev_comp.y"
+                  {
+			tmpgold[ngold] = New(gold);
+			tmpgold[ngold]->x = current_coord.x;
+			tmpgold[ngold]->y = current_coord.y;
+			tmpgold[ngold]->amount = (yyvsp[-2].i);
+			if (!in_room)
+			    check_coord(current_coord.x, current_coord.y,
+					"Gold");
+			ngold++;
+			if (ngold >= MAX_OF_TYPE) {
+				yyerror("Too many golds in room or mazepart!");
+				ngold--;
+			}
+		  }
+#line 3176 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 182: /* engraving_detail: ENGRAVING_ID ':' coordinate ',' engraving_type ',' string  */
+#line 1446 "libnethack/util/lev_comp.y"
+                  {
+			tmpengraving[nengraving] = New(engraving);
+			tmpengraving[nengraving]->x = current_coord.x;
+			tmpengraving[nengraving]->y = current_coord.y;
+			tmpengraving[nengraving]->engr.str = (yyvsp[0].map);
+			tmpengraving[nengraving]->etype = (yyvsp[-2].i);
+			if (!in_room)
+			    check_coord(current_coord.x, current_coord.y,
+					"Engraving");
+			nengraving++;
+			if (nengraving >= MAX_OF_TYPE) {
+			    yyerror("Too many engravings in room or mazepart!");
+			    nengraving--;
+			}
+		  }
+#line 3196 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 184: /* monster_c: RANDOM_TYPE  */
+#line 1465 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = - MAX_REGISTERS - 1;
+		  }
+#line 3204 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 187: /* object_c: RANDOM_TYPE  */
+#line 1473 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = - MAX_REGISTERS - 1;
+		  }
+#line 3212 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 190: /* m_name: RANDOM_TYPE  */
+#line 1481 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.map) = NULL;
+		  }
+#line 3220 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 192: /* o_name: RANDOM_TYPE  */
+#line 1488 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.map) = NULL;
+		  }
+#line 3228 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 193: /* trap_name: string  */
+#line 1494 "libnethack/util/lev_comp.y"
+                  {
+			int token = get_trap_type((yyvsp[0].map));
+			if (token == ERR)
+				yyerror("Unknown trap type!");
+			(yyval.i) = token;
+			Free((yyvsp[0].map));
+		  }
+#line 3240 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 195: /* room_type: string  */
+#line 1505 "libnethack/util/lev_comp.y"
+                  {
+			int token = get_room_type((yyvsp[0].map));
+			if (token == ERR) {
+				yywarning("Unknown room type!  Making ordinary room...");
+				(yyval.i) = OROOM;
+			} else
+				(yyval.i) = token;
+			Free((yyvsp[0].map));
+		  }
+#line 3254 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 197: /* prefilled: %empty  */
+#line 1518 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = 0;
+		  }
+#line 3262 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 198: /* prefilled: ',' FILLING  */
+#line 1522 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = (yyvsp[0].i);
+		  }
+#line 3270 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 199: /* prefilled: ',' FILLING ',' BOOLEAN  */
+#line 1526 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = (yyvsp[-2].i) + ((yyvsp[0].i) << 1);
+		  }
+#line 3278 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 202: /* coordinate: RANDOM_TYPE  */
+#line 1534 "libnethack/util/lev_comp.y"
+                  {
+			current_coord.x = current_coord.y = -MAX_REGISTERS-1;
+		  }
+#line 3286 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 209: /* alignment: RANDOM_TYPE  */
+#line 1550 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = - MAX_REGISTERS - 1;
+		  }
+#line 3294 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 212: /* p_register: P_REGISTER '[' INTEGER ']'  */
+#line 1560 "libnethack/util/lev_comp.y"
+                  {
+			if ( (yyvsp[-1].i) >= MAX_REGISTERS )
+				yyerror("Register Index overflow!");
+			else
+				current_coord.x = current_coord.y = - (yyvsp[-1].i) - 1;
+		  }
+#line 3305 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 213: /* o_register: O_REGISTER '[' INTEGER ']'  */
+#line 1569 "libnethack/util/lev_comp.y"
+                  {
+			if ( (yyvsp[-1].i) >= MAX_REGISTERS )
+				yyerror("Register Index overflow!");
+			else
+				(yyval.i) = - (yyvsp[-1].i) - 1;
+		  }
+#line 3316 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 214: /* m_register: M_REGISTER '[' INTEGER ']'  */
+#line 1578 "libnethack/util/lev_comp.y"
+                  {
+			if ( (yyvsp[-1].i) >= MAX_REGISTERS )
+				yyerror("Register Index overflow!");
+			else
+				(yyval.i) = - (yyvsp[-1].i) - 1;
+		  }
+#line 3327 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 215: /* a_register: A_REGISTER '[' INTEGER ']'  */
+#line 1587 "libnethack/util/lev_comp.y"
+                  {
+			if ( (yyvsp[-1].i) >= 3 )
+				yyerror("Register Index overflow!");
+			else
+				(yyval.i) = - (yyvsp[-1].i) - 1;
+		  }
+#line 3338 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 217: /* monster: CHAR  */
+#line 1599 "libnethack/util/lev_comp.y"
+                  {
+			if (check_monster_char((char) (yyvsp[0].i)))
+				(yyval.i) = (yyvsp[0].i) ;
+			else {
+				yyerror("Unknown monster class!");
+				(yyval.i) = ERR;
+			}
+		  }
+#line 3351 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 218: /* object: CHAR  */
+#line 1610 "libnethack/util/lev_comp.y"
+                  {
+			char c = (yyvsp[0].i);
+			if (check_object_char(c))
+				(yyval.i) = c;
+			else {
+				yyerror("Unknown char class!");
+				(yyval.i) = ERR;
+			}
+		  }
+#line 3365 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 222: /* chance: %empty  */
+#line 1629 "libnethack/util/lev_comp.y"
+                  {
+			(yyval.i) = 100;	/* default is 100% */
+		  }
+#line 3373 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 223: /* chance: PERCENT  */
+#line 1633 "libnethack/util/lev_comp.y"
+                  {
+			if ((yyvsp[0].i) <= 0 || (yyvsp[0].i) > 100)
+			    yyerror("Expected percentile chance.");
+			(yyval.i) = (yyvsp[0].i);
+		  }
+#line 3383 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 226: /* coord: '(' INTEGER ',' INTEGER ')'  */
+#line 1645 "libnethack/util/lev_comp.y"
+                  {
+			if (!in_room && !init_lev.init_present &&
+			    ((yyvsp[-3].i) < 0 || (yyvsp[-3].i) > (int)max_x_map ||
+			     (yyvsp[-1].i) < 0 || (yyvsp[-1].i) > (int)max_y_map))
+			    yyerror("Coordinates out of map range!");
+			current_coord.x = (yyvsp[-3].i);
+			current_coord.y = (yyvsp[-1].i);
+		  }
+#line 3396 "libnethack/util/lev_yacc.c"
+    break;
+
+  case 227: /* region: '(' INTEGER ',' INTEGER ',' INTEGER ',' INTEGER ')'  */
+#line 1656 "libnethack/util/lev_comp.y"
+                  {
+/* This series of if statements is a hack for MSC 5.1.  It seems that its
+   tiny little brain cannot compile if these are all one big if statement. */
+			if ((yyvsp[-7].i) < 0 || (yyvsp[-7].i) > (int)max_x_map)
+				yyerror("Region out of map range!");
+			else if ((yyvsp[-5].i) < 0 || (yyvsp[-5].i) > (int)max_y_map)
+				yyerror("Region out of map range!");
+			else if ((yyvsp[-3].i) < 0 || (yyvsp[-3].i) > (int)max_x_map)
+				yyerror("Region out of map range!");
+			else if ((yyvsp[-1].i) < 0 || (yyvsp[-1].i) > (int)max_y_map)
+				yyerror("Region out of map range!");
+			current_region.x1 = (yyvsp[-7].i);
+			current_region.y1 = (yyvsp[-5].i);
+			current_region.x2 = (yyvsp[-3].i);
+			current_region.y2 = (yyvsp[-1].i);
+		  }
+#line 3417 "libnethack/util/lev_yacc.c"
+    break;
+
+
+#line 3421 "libnethack/util/lev_yacc.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 1674 "libnethack/util/lev_comp.y"
+
+
+/*lev_comp.y*/
+
@@ -25,6 +25,7 @@
 /* version information */
 #include "nethack.h"
 #include "patchlevel.h"
+#include "dataidx.h"
 
 #define rewind(fp) fseek((fp),0L,SEEK_SET)      /* guarantee a return value */
 
@@ -65,6 +66,9 @@ static char *xcrypt(const char *);
 static int check_control(char *);
 static char *without_control(char *);
 static boolean d_filter(char *);
+static void *d_realloc(void *, size_t);
+static void d_perfect_hash(const struct data_key *, const int *, int,
+                           unsigned int *, int, int *, int);
 static boolean h_filter(char *);
 static boolean ranged_attk(const struct permonst *);
 static int mstrength(const struct permonst *);
@@ -414,18 +418,12 @@ d_filter(char *line)
     return FALSE;
 }
 
-   /* 
+   /*
     *
     New format (v3.1) of 'data' file which allows much faster lookups [pr]
     "do not edit"               first record is a comment line
     01234567                    hexadecimal formatted offset to text area
-    name-a                      first name of interest
-    123,4                       offset to name's text, and number of lines for it
-    name-b                      next name of interest
-    name-c                      multiple names which share same description also
-    456,7                       share a single offset,count line
-    .                           sentinel to mark end of names
-    789,0                       dummy record containing offset, count of EOF
+    ...                         index of the names of interest (see dataidx.h)
     text-a                      4 lines of descriptive text for name-a
     text-a                      at file position 0x01234567L + 123L
     text-a
@@ -436,13 +434,93 @@ d_filter(char *line)
     *
     */
 
+static void *
+d_realloc(void *ptr, size_t size)
+{
+    ptr = realloc(ptr, size);
+    if (!ptr) {
+        perror("realloc");
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+/* Places the distinct texts of the keys without wildcards into a perfect hash
+   table (as described in dataidx.h). texts holds the number of the first key
+   with each text. */
+static void
+d_perfect_hash(const struct data_key *keys, const int *texts, int ntexts,
+               unsigned int *seeds, int nbuckets, int *slots, int nslots)
+{
+    int *bucket = d_realloc(NULL, (ntexts + 1) * sizeof (int));
+    int *bucketsize = d_realloc(NULL, nbuckets * sizeof (int));
+    int *members = d_realloc(NULL, (ntexts + 1) * sizeof (int));
+    int *tried = d_realloc(NULL, nslots * sizeof (int));
+    int i, j, b, size, maxsize = 0, nmembers, slot;
+    unsigned int seed;
+
+    for (b = 0; b < nbuckets; b++)
+        bucketsize[b] = seeds[b] = 0;
+    for (i = 0; i < nslots; i++)
+        slots[i] = -1;
+    for (i = 0; i < ntexts; i++) {
+        bucket[i] = data_key_hash(keys[texts[i]].text, 0) % nbuckets;
+        if (++bucketsize[bucket[i]] > maxsize)
+            maxsize = bucketsize[bucket[i]];
+    }
+
+    /* Place the biggest buckets first, while there's the most room: for each,
+       find a seed that puts all its texts into different empty slots. */
+    for (size = maxsize; size > 0; size--) {
+        for (b = 0; b < nbuckets; b++) {
+            if (bucketsize[b] != size)
+                continue;
+
+            for (i = 0, nmembers = 0; i < ntexts; i++)
+                if (bucket[i] == b)
+                    members[nmembers++] = i;
+
+            for (seed = 1;; seed++) {
+                if (seed > 100000000) {
+                    fprintf(stderr, "Can't build a hash table for data\n");
+                    exit(EXIT_FAILURE);
+                }
+                for (j = 0; j < nmembers; j++) {
+                    slot = data_key_hash(keys[texts[members[j]]].text, seed) %
+                        nslots;
+                    if (slots[slot] >= 0)
+                        break;
+                    tried[j] = slot;
+                    slots[slot] = texts[members[j]];
+                }
+                if (j == nmembers)
+                    break;
+                /* didn't fit; undo and try the next seed */
+                while (j--)
+                    slots[tried[j]] = -1;
+            }
+            seeds[b] = seed;
+        }
+    }
+
+    free(bucket);
+    free(bucketsize);
+    free(members);
+    free(tried);
+}
+
 void
 do_data(const char *infile, const char *outfile)
 {
-    char tempfile[256];
+    char tempfile[256], *ep;
     boolean ok;
     long txt_offset;
-    int entry_cnt, line_cnt;
+    long *group_offset = NULL;
+    int *group_count = NULL, *texts, *slots;
+    unsigned int *seeds;
+    struct data_key *keys = NULL;
+    int ngroups = 0, nkeys = 0, ntexts = 0, nwild = 0, nslots, nbuckets;
+    int line_cnt, i, j;
 
     snprintf(tempfile, SIZE(tempfile), "%s.%s", outfile, "tmp");
 
@@ -466,34 +544,97 @@ do_data(const char *infile, const char *outfile)
     /* output a dummy header record; we'll rewind and overwrite it later */
     fprintf(ofp, "%s%08lx\n", Dont_Edit_Data, 0L);
 
-    entry_cnt = line_cnt = 0;
-    /* read through the input file and split it into two sections */
+    line_cnt = 0;
+    /* read through the input file, collecting the names and saving the text
+       in the scratch file */
     while (fgets(in_line, sizeof in_line, ifp)) {
         if (d_filter(in_line))
             continue;
         if (*in_line > ' ') {   /* got an entry name */
-            /* first finish previous entry */
-            if (line_cnt)
-                fprintf(ofp, "%d\n", line_cnt), line_cnt = 0;
-            /* output the entry name */
-            fputs(in_line, ofp);
-            entry_cnt++;        /* update number of entries */
-        } else if (entry_cnt) { /* got some descriptive text */
-            /* update previous entry with current text offset */
+            /* names share a description until there's some text */
+            if (!ngroups || line_cnt) {
+                group_offset = d_realloc(group_offset,
+                                         (ngroups + 1) * sizeof (long));
+                group_count = d_realloc(group_count,
+                                        (ngroups + 1) * sizeof (int));
+                group_offset[ngroups] = -1;
+                group_count[ngroups] = 0;
+                ngroups++;
+                line_cnt = 0;
+            }
+
+            if ((ep = strchr(in_line, '\n')) != 0)
+                *ep = '\0';
+            keys = d_realloc(keys, (nkeys + 1) * sizeof (struct data_key));
+            keys[nkeys].group = ngroups - 1;
+            keys[nkeys].neg = *in_line == '~';
+            keys[nkeys].next = -1;
+            keys[nkeys].text = d_realloc(NULL, strlen(in_line) + 1);
+            strcpy(keys[nkeys].text, in_line + keys[nkeys].neg);
+            nkeys++;
+        } else if (ngroups) {   /* got some descriptive text */
+            /* update the current group with the text offset */
             if (!line_cnt)
-                fprintf(ofp, "%ld,", ftell(tfp));
+                group_offset[ngroups - 1] = ftell(tfp);
             /* save the text line in the scratch file */
             fputs(in_line, tfp);
-            line_cnt++; /* update line counter */
+            group_count[ngroups - 1] = ++line_cnt;
         }
     }
-    /* output an end marker and then record the current position */
-    if (line_cnt)
-        fprintf(ofp, "%d\n", line_cnt);
-    fprintf(ofp, ".\n%ld,%d\n", ftell(tfp), 0);
-    txt_offset = ftell(ofp);
     fclose(ifp);        /* all done with original input file */
 
+    /* names at the end with no text point at the end of the text */
+    if (ngroups && group_offset[ngroups - 1] < 0)
+        group_offset[ngroups - 1] = ftell(tfp);
+
+    /* chain together keys with the same text, and list the distinct texts of
+       the keys without wildcards */
+    texts = d_realloc(NULL, (nkeys + 1) * sizeof (int));
+    for (i = 0; i < nkeys; i++) {
+        if (strpbrk(keys[i].text, "*?")) {
+            nwild++;
+            continue;
+        }
+        for (j = i - 1; j >= 0; j--)
+            if (!strcmp(keys[j].text, keys[i].text))
+                break;
+        if (j >= 0)
+            keys[j].next = i;
+        else
+            texts[ntexts++] = i;
+    }
+
+    nbuckets = ntexts / 4 + 1;
+    nslots = ntexts + ntexts / 4 + 1;
+    seeds = d_realloc(NULL, nbuckets * sizeof (unsigned int));
+    slots = d_realloc(NULL, nslots * sizeof (int));
+    d_perfect_hash(keys, texts, ntexts, seeds, nbuckets, slots, nslots);
+
+    /* output the index */
+    fprintf(ofp, "%d %d %d %d %d\n", ngroups, nkeys, nslots, nbuckets, nwild);
+    for (i = 0; i < ngroups; i++)
+        fprintf(ofp, "%ld,%d\n", group_offset[i], group_count[i]);
+    for (i = 0; i < nkeys; i++)
+        fprintf(ofp, "%d %d %d %s\n", keys[i].group, keys[i].neg,
+                keys[i].next, keys[i].text);
+    for (i = 0; i < nbuckets; i++)
+        fprintf(ofp, "%u\n", seeds[i]);
+    for (i = 0; i < nslots; i++)
+        fprintf(ofp, "%d\n", slots[i]);
+    for (i = 0; i < nkeys; i++)
+        if (strpbrk(keys[i].text, "*?"))
+            fprintf(ofp, "%d\n", i);
+    txt_offset = ftell(ofp);
+
+    for (i = 0; i < nkeys; i++)
+        free(keys[i].text);
+    free(keys);
+    free(group_offset);
+    free(group_count);
+    free(texts);
+    free(seeds);
+    free(slots);
+
     /* reprocess the scratch file; 1st format an error msg, just in case */
     snprintf(in_line, SIZE(in_line), "rewind of \"%s\"", tempfile);
     if (rewind(tfp) != 0)
@@ -19,11 +19,15 @@
 
 # define DEFAULT_PORT 53430
 
+/* optional protocol features that the server agreed to at auth time */
+# define SERVER_CAP_PAYLOAD_HASH 0x01   /* NHNET_CAP_PAYLOAD_HASH */
+
 extern struct nh_window_procs client_windowprocs;
 extern int current_game;
 extern jmp_buf ex_jmp_buf;
 extern int ex_jmp_buf_valid;
 extern int conn_err;
+extern int server_caps;
 extern int error_retry_ok;
 extern char saved_password[];
 
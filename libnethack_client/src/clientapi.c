@@ -22,6 +22,10 @@ static struct sigaction oldaction;
    does not deallocate the pointers). */
 static struct xmalloc_block *xm_blocklist = NULL;
 
+/* Where to cache drawing info and roles information between connections (with
+   a trailing path separator), or empty for no caching. */
+static char cache_dir[1024];
+
 void
 nhnet_lib_init(const struct nh_window_procs *winprocs)
 {
@@ -42,6 +46,15 @@ nhnet_lib_init(const struct nh_window_procs *winprocs)
 }
 
 
+void
+nhnet_set_cache_dir(const char *dir)
+{
+    if (!dir || strlen(dir) >= sizeof cache_dir)
+        dir = "";
+    strcpy(cache_dir, dir);
+}
+
+
 void
 nhnet_lib_exit(void)
 {
@@ -391,6 +404,46 @@ read_symdef_array(json_t * jarr)
 }
 
 
+/* Like send_receive_msg with an empty parameter list, for commands whose
+   replies are cached on disk (see send_cached_payload in the server). If we
+   have a cached copy, we send its hash; a reply consisting only of the same
+   hash means that the cached copy is current. The "hash" field is removed
+   from whichever object is returned. */
+static json_t *
+send_receive_cached(const char *msgtype)
+{
+    char path[sizeof cache_dir + 64];
+    json_t *params, *cached = NULL, *jmsg;
+    const char *hash = NULL, *newhash;
+
+    params = json_object();
+    if (*cache_dir && (server_caps & SERVER_CAP_PAYLOAD_HASH)) {
+        snprintf(path, sizeof path, "%snetcache_%s.json", cache_dir,
+                 msgtype);
+        cached = json_load_file(path, 0, NULL);
+        if (cached && json_unpack(cached, "{ss*}", "hash", &hash) != -1)
+            json_object_set_new(params, "hash", json_string(hash));
+    }
+
+    jmsg = send_receive_msg(msgtype, params);
+
+    if (hash && json_unpack(jmsg, "{ss!}", "hash", &newhash) != -1 &&
+        !strcmp(hash, newhash)) {
+        json_decref(jmsg);
+        jmsg = cached;
+    } else {
+        if (cached)
+            json_decref(cached);
+        if (*cache_dir && (server_caps & SERVER_CAP_PAYLOAD_HASH) &&
+            json_unpack(jmsg, "{ss*}", "hash", &newhash) != -1)
+            json_dump_file(jmsg, path, JSON_COMPACT);
+    }
+
+    json_object_del(jmsg, "hash");
+    return jmsg;
+}
+
+
 struct nh_drawing_info *
 nhnet_get_drawing_info(void)
 {
@@ -406,7 +459,7 @@ nhnet_get_drawing_info(void)
 
     xmalloc_cleanup(&xm_blocklist);
 
-    jmsg = send_receive_msg("get_drawing_info", json_object());
+    jmsg = send_receive_cached("get_drawing_info");
     di = xmalloc(&xm_blocklist, sizeof (struct nh_drawing_info));
     if (json_unpack
         (jmsg,
@@ -765,7 +818,7 @@ nhnet_get_roles(void)
 
     xmalloc_cleanup(&xm_blocklist);
 
-    jmsg = send_receive_msg("get_roles", json_object());
+    jmsg = send_receive_cached("get_roles");
     ri = xmalloc(&xm_blocklist, sizeof (struct nh_roles_info));
     if (json_unpack
         (jmsg, "{si,si,si,si,so,so,so,so,so,so}", "num_roles",
@@ -8,6 +8,8 @@
 
 #include "nhclient.h"
 #include "netconnect.h"
+#include "dbufcodec.h"
+#include <zlib.h>
 
 struct nhnet_server_version nhnet_server_ver;
 
@@ -21,7 +23,15 @@ static char unread_messages[1024 * 1024 * 16];
 static char *unread_message_startptr = unread_messages;
 static char *unread_message_endptr = unread_messages;
 static int net_active;
+
+/* When the server agreed to NHNET_CAP_DEFLATE, everything it sends after the
+   auth reply is a single deflate stream; data from recv() is staged in
+   compressed_buf, and decompressed into unread_messages. */
+static z_stream inflate_strm;
+static int inflating;
+static unsigned char compressed_buf[65536];
 int conn_err, error_retry_ok;
+int server_caps;        /* SERVER_CAP_* the server agreed to */
 
 /* Prevent automatic retries during connection setup or teardown. When the
    connection is being set up, it is better to report a failure immediately;
@@ -112,6 +122,103 @@ send_json_msg(json_t * jmsg)
 }
 
 
+#define RECV_CORRUPT -2     /* compressed data was corrupt or didn't fit */
+#define RECV_PARTIAL -3     /* not enough compressed data to decode yet */
+
+/* Decompresses len bytes of data from the server onto the end of the unread
+   data in unread_messages. Returns the number of bytes added, or RECV_CORRUPT
+   or RECV_PARTIAL. */
+static int
+inflate_into_unread(unsigned char *in, int len)
+{
+    int space = unread_messages + sizeof unread_messages -
+        unread_message_endptr;
+    int ret;
+
+    inflate_strm.next_in = in;
+    inflate_strm.avail_in = len;
+    inflate_strm.next_out = (unsigned char *)unread_message_endptr;
+    inflate_strm.avail_out = space;
+    while (inflate_strm.avail_in) {
+        ret = inflate(&inflate_strm, Z_SYNC_FLUSH);
+        if (ret != Z_OK && ret != Z_BUF_ERROR)
+            return RECV_CORRUPT;
+        if (inflate_strm.avail_out == 0 && inflate_strm.avail_in)
+            return RECV_CORRUPT;
+        if (ret == Z_BUF_ERROR)
+            break;      /* no progress possible, so wait for more input */
+    }
+
+    if (inflate_strm.avail_out == space)
+        return RECV_PARTIAL;
+    return space - inflate_strm.avail_out;
+}
+
+
+static void
+set_inflating(nh_bool on)
+{
+    unsigned char *pending;
+    int len, ret;
+
+    if (inflating)
+        inflateEnd(&inflate_strm);
+    inflating = FALSE;
+
+    if (!on)
+        return;
+
+    memset(&inflate_strm, 0, sizeof inflate_strm);
+    if (inflateInit(&inflate_strm) != Z_OK) {
+        print_error("Could not initialize decompression.");
+        return;
+    }
+    inflating = TRUE;
+
+    /* The server compresses everything it sends after the auth reply, so
+       anything that arrived along with the reply (i.e. is still unread) is
+       the start of the compressed stream. */
+    len = unread_message_endptr - unread_message_startptr;
+    if (!len)
+        return;
+    pending = malloc(len);
+    if (!pending) {
+        print_error("Out of memory decompressing data from the server.");
+        return;
+    }
+    memcpy(pending, unread_message_startptr, len);
+    unread_message_startptr = unread_message_endptr = unread_messages;
+    ret = inflate_into_unread(pending, len);
+    free(pending);
+
+    if (ret == RECV_CORRUPT)
+        print_error("Broken compressed data received from server");
+    else if (ret > 0)
+        unread_message_endptr += ret;
+}
+
+
+/* Reads data from the server into unread_messages, decompressing it if
+   necessary. Returns the number of bytes added, or the return value of a
+   failed recv() (0 if the connection was closed, -1 with errno set on error),
+   or RECV_CORRUPT or RECV_PARTIAL. */
+static int
+recv_into_unread(void)
+{
+    int space = unread_messages + sizeof unread_messages -
+        unread_message_endptr;
+    int ret;
+
+    if (!inflating)
+        return recv(sockfd, unread_message_endptr, space, 0);
+
+    ret = recv(sockfd, compressed_buf, sizeof compressed_buf, 0);
+    if (ret <= 0)
+        return ret;
+    return inflate_into_unread(compressed_buf, ret);
+}
+
+
 /* receive one JSON object from the server.
  * Returns: - NULL after a network error OR
  *          - an empty JSON object if there is a parsing error OR
@@ -166,12 +273,15 @@ receive_json_msg(void)
                 return NULL;
             }
 
-            ret = recv(sockfd, unread_message_endptr,
-                       unread_messages + sizeof unread_messages -
-                       unread_message_endptr, 0);
-            if (ret == -1 && errno == EINTR)
+            ret = recv_into_unread();
+            if ((ret == -1 && errno == EINTR) || ret == RECV_PARTIAL)
                 continue;
-            else if (ret <= 0)
+            else if (ret == RECV_CORRUPT) {
+                unread_message_startptr = unread_message_endptr =
+                    unread_messages;
+                print_error("Broken compressed data received from server");
+                return NULL;
+            } else if (ret <= 0)
                 return NULL;
             if (unread_message_endptr >
                 unread_messages + sizeof unread_messages - 2) {
@@ -459,7 +569,14 @@ do_connect(const char *host, int port, const char *user, const char *pass,
 
     in_connect_disconnect = TRUE;
     sockfd = fd;
-    jmsg = json_pack("{ss,ss}", "username", user, "password", pass);
+    set_inflating(FALSE);
+    server_caps = 0;
+    /* The server uses the binary screen format if it understands it; the
+       reply's "caps" list says so, but update_screen messages identify their
+       format anyway, so there's no need to track that here. */
+    jmsg = json_pack("{ss,ss,s[sss]}", "username", user, "password", pass,
+                     "caps", NHNET_CAP_BINARY_DBUF, NHNET_CAP_DEFLATE,
+                     NHNET_CAP_PAYLOAD_HASH);
     if (reg_user) {
         if (email)
             json_object_set_new(jmsg, "email", json_string(email));
@@ -486,6 +603,20 @@ do_connect(const char *host, int port, const char *user, const char *pass,
         nhnet_server_ver.patchlevel =
             json_integer_value(json_array_get(jarr, 2));
     }
+    /* and so is "caps" */
+    if (json_unpack(jmsg, "{so*}", "caps", &jarr) != -1 &&
+        json_is_array(jarr)) {
+        int i;
+
+        for (i = 0; i < json_array_size(jarr); i++) {
+            const char *cap = json_string_value(json_array_get(jarr, i));
+
+            if (cap && !strcmp(cap, NHNET_CAP_DEFLATE))
+                set_inflating(TRUE);
+            else if (cap && !strcmp(cap, NHNET_CAP_PAYLOAD_HASH))
+                server_caps |= SERVER_CAP_PAYLOAD_HASH;
+        }
+    }
     json_decref(jmsg);
 
     if (host != saved_hostname)
@@ -535,6 +666,8 @@ nhnet_disconnect(void)
     sockfd = -1;
     conn_err = FALSE;
     net_active = FALSE;
+    set_inflating(FALSE);
+    server_caps = 0;
     memset(&nhnet_server_ver, 0, sizeof (nhnet_server_ver));
 }
 
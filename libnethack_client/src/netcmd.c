@@ -8,6 +8,7 @@
 
 #include "nhclient.h"
 #include "menulist.h"
+#include "dbufcodec.h"
 
 struct netcmd {
     const char *name;
@@ -286,8 +287,19 @@ cmd_update_screen(json_t *params, int display_only)
     int x, y, effect, bg, trap, obj, obj_mn, mon, monflags, branding, invis,
         visible;
     json_t *jdbuf, *col, *elem;
+    const char *bin;
     int ok = 1;
 
+    if (json_unpack(params, "{si,si,ss!}", "ux", &ux, "uy", &uy,
+                    "dbuf_bin", &bin) != -1) {
+        if (!dbuf_decode(bin, dbuf)) {
+            print_error("Incorrect binary dbuf in cmd_update_screen");
+            return NULL;
+        }
+        client_windowprocs.win_update_screen(dbuf, ux, uy);
+        return NULL;
+    }
+
     if (json_unpack(params, "{si,si,so!}", "ux", &ux, "uy", &uy, "dbuf", &jdbuf)
         == -1) {
         print_error("Incorrect parameters in cmd_update_screen");
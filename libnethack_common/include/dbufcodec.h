@@ -0,0 +1,55 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* This network protocol library may be freely redistributed under the terms of
+ * either:
+ *  - the NetHack license
+ *  - the GNU General Public license v2 or later
+ * Note that you do not have a warranty under either license.
+ */
+
+#ifndef DBUFCODEC_H
+# define DBUFCODEC_H
+
+# include "nethack_types.h"
+
+/* The name of the optional capability that a client lists in its "auth" or
+   "register" message (in a "caps" array) to ask for screen updates in the
+   binary format below; the server repeats it in its reply if it agrees. */
+# define NHNET_CAP_BINARY_DBUF "dbuf_bin1"
+
+/*
+ * Binary format for update_screen messages ("dbuf_bin", base 64 encoded in
+ * the JSON message, because the protocol is otherwise text).
+ *
+ * The display buffer is visited in row-major order (all of row 0, then all of
+ * row 1, and so on). It is described by a sequence of runs, each starting
+ * with a byte whose top two bits give the type of the run, and whose bottom
+ * six bits give its length minus 1:
+ *
+ *   DBUF_RUN_SAME: the locations are unchanged since the previous update;
+ *   DBUF_RUN_ZERO: the locations become all zero;
+ *   DBUF_RUN_DATA: the run byte is followed by DBUF_CELL_SIZE bytes for each
+ *                  location, in the layout below.
+ *
+ * The runs must cover exactly ROWNO * COLNO locations. A location is encoded
+ * as: effect (4 bytes), then bg, trap, obj, obj_mn, mon, monflags, branding
+ * (2 bytes each), then invis, visible (1 byte each); all little-endian, with
+ * signed values in two's complement.
+ */
+# define DBUF_RUN_SAME  0x00
+# define DBUF_RUN_ZERO  0x40
+# define DBUF_RUN_DATA  0x80
+# define DBUF_RUN_MASK  0xC0
+# define DBUF_RUN_MAX   64
+# define DBUF_CELL_SIZE 20
+
+/* Returns the changes from old to new in the format above, base 64 encoded,
+   as a string allocated with malloc(); or NULL if nothing changed. */
+extern char *dbuf_encode(struct nh_dbuf_entry new[ROWNO][COLNO],
+                         struct nh_dbuf_entry old[ROWNO][COLNO]);
+
+/* Applies changes produced by dbuf_encode to dbuf. Returns FALSE (in which
+   case dbuf may have been partially updated) if the string is malformed. */
+extern nh_bool dbuf_decode(const char *str,
+                           struct nh_dbuf_entry dbuf[ROWNO][COLNO]);
+
+#endif
@@ -20,6 +20,15 @@ enum authresult {
     AUTH_SUCCESS_NEW
 };
 
+/* Capability (see "caps" in the auth message) for compressing everything the
+   server sends after the auth reply as a single deflate stream, flushed with
+   Z_SYNC_FLUSH after each message. */
+# define NHNET_CAP_DEFLATE "deflate1"
+
+/* Capability for sending a content hash with get_drawing_info and get_roles
+   replies, so that clients can cache them; see nhnet_set_cache_dir. */
+# define NHNET_CAP_PAYLOAD_HASH "payload_hash1"
+
 
 struct nhnet_game {
     int gameid;
@@ -49,6 +58,7 @@ extern void EXPORT(nhnet_check_socket_fd) (void);
 
 extern void EXPORT(nhnet_lib_init) (const struct nh_window_procs *);
 extern void EXPORT(nhnet_lib_exit) (void);
+extern void EXPORT(nhnet_set_cache_dir) (const char *dir);
 extern nh_bool EXPORT(nhnet_exit_game) (int exit_type);
  extern int EXPORT(nhnet_play_game) (int gid, enum nh_followmode);
 extern enum nh_create_response EXPORT(nhnet_create_game) (
@@ -44,12 +44,12 @@ struct trietable {
     unsigned key;                /* key at this location */
 };
 
-/* The operations NetHack 4 actually uses: add, find, empty. Delete can be
-   implemented in this data structure, but there hasn't been a need for it
-   yet. Adding a key that already exists to a trietable will overwrite whatever
-   is already there. */
+/* The operations NetHack 4 actually uses: add, find, remove, empty. Adding a
+   key that already exists to a trietable will overwrite whatever is already
+   there. */
 extern void trietable_add(struct trietable **table, unsigned key, void *value);
 extern void *trietable_find(struct trietable **table, unsigned key);
+extern void trietable_remove(struct trietable **table, unsigned key);
 extern void trietable_empty(struct trietable **table);
 
 #endif
@@ -0,0 +1,252 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* This network protocol library may be freely redistributed under the terms of
+ * either:
+ *  - the NetHack license
+ *  - the GNU General Public license v2 or later
+ * Note that you do not have a warranty under either license.
+ */
+
+#include "dbufcodec.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Worst case: every location in its own data run. */
+#define DBUF_MAX_ENCODED (ROWNO * COLNO * (DBUF_CELL_SIZE + 1))
+
+static const char b64_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static const struct nh_dbuf_entry zero_dbe;
+
+static unsigned char *
+put_le(unsigned char *out, unsigned long val, int bytes)
+{
+    while (bytes--) {
+        *out++ = val & 0xff;
+        val >>= 8;
+    }
+    return out;
+}
+
+static unsigned long
+get_le(const unsigned char **in, int bytes)
+{
+    unsigned long val = 0;
+    int i;
+
+    for (i = 0; i < bytes; i++)
+        val |= (unsigned long)*(*in)++ << (8 * i);
+    return val;
+}
+
+static unsigned char *
+put_cell(unsigned char *out, const struct nh_dbuf_entry *dbe)
+{
+    out = put_le(out, (unsigned long)(unsigned int)dbe->effect, 4);
+    out = put_le(out, (unsigned short)dbe->bg, 2);
+    out = put_le(out, (unsigned short)dbe->trap, 2);
+    out = put_le(out, (unsigned short)dbe->obj, 2);
+    out = put_le(out, (unsigned short)dbe->obj_mn, 2);
+    out = put_le(out, (unsigned short)dbe->mon, 2);
+    out = put_le(out, (unsigned short)dbe->monflags, 2);
+    out = put_le(out, (unsigned short)dbe->branding, 2);
+    *out++ = dbe->invis;
+    *out++ = dbe->visible;
+    return out;
+}
+
+static void
+get_cell(const unsigned char **in, struct nh_dbuf_entry *dbe)
+{
+    /* conversion to the signed types is done via unsigned arithmetic, so as
+       not to rely on implementation-defined conversions */
+#define SIGNED16(v) ((short)((long)(v) - ((v) & 0x8000 ? 0x10000L : 0)))
+    unsigned long v;
+
+    v = get_le(in, 4);
+    dbe->effect = (int)((long long)v - (v & 0x80000000UL ? 0x100000000LL : 0));
+    v = get_le(in, 2);
+    dbe->bg = SIGNED16(v);
+    v = get_le(in, 2);
+    dbe->trap = SIGNED16(v);
+    v = get_le(in, 2);
+    dbe->obj = SIGNED16(v);
+    v = get_le(in, 2);
+    dbe->obj_mn = SIGNED16(v);
+    v = get_le(in, 2);
+    dbe->mon = SIGNED16(v);
+    v = get_le(in, 2);
+    dbe->monflags = SIGNED16(v);
+    v = get_le(in, 2);
+    dbe->branding = SIGNED16(v);
+    dbe->invis = *(*in)++;
+    dbe->visible = *(*in)++;
+#undef SIGNED16
+}
+
+static char *
+base64_encode(const unsigned char *in, int len)
+{
+    char *out = malloc((len + 2) / 3 * 4 + 1);
+    char *o = out;
+    int i;
+
+    if (!out)
+        return NULL;
+
+    for (i = 0; i + 2 < len; i += 3) {
+        *o++ = b64_chars[in[i] >> 2];
+        *o++ = b64_chars[((in[i] & 0x03) << 4) | (in[i + 1] >> 4)];
+        *o++ = b64_chars[((in[i + 1] & 0x0f) << 2) | (in[i + 2] >> 6)];
+        *o++ = b64_chars[in[i + 2] & 0x3f];
+    }
+    if (i < len) {
+        *o++ = b64_chars[in[i] >> 2];
+        if (i + 1 < len) {
+            *o++ = b64_chars[((in[i] & 0x03) << 4) | (in[i + 1] >> 4)];
+            *o++ = b64_chars[(in[i + 1] & 0x0f) << 2];
+        } else {
+            *o++ = b64_chars[(in[i] & 0x03) << 4];
+            *o++ = '=';
+        }
+        *o++ = '=';
+    }
+    *o = '\0';
+
+    return out;
+}
+
+/* Returns the decoded length, or -1 if the input is malformed or too long. */
+static int
+base64_decode(const char *in, unsigned char *out, int outlen)
+{
+    int len = 0, bits = 0, nbits = 0;
+    const char *p;
+
+    for (; *in && *in != '='; in++) {
+        if (!(p = strchr(b64_chars, *in)))
+            return -1;
+        bits = (bits << 6) | (p - b64_chars);
+        nbits += 6;
+        if (nbits >= 8) {
+            nbits -= 8;
+            if (len >= outlen)
+                return -1;
+            out[len++] = (bits >> nbits) & 0xff;
+        }
+    }
+
+    return len;
+}
+
+static unsigned char *
+put_run(unsigned char *out, int type, int len,
+        const struct nh_dbuf_entry *cells)
+{
+    while (len > 0) {
+        int n = len > DBUF_RUN_MAX ? DBUF_RUN_MAX : len;
+
+        *out++ = type | (n - 1);
+        if (type == DBUF_RUN_DATA) {
+            int i;
+
+            for (i = 0; i < n; i++)
+                out = put_cell(out, cells++);
+        }
+        len -= n;
+    }
+    return out;
+}
+
+char *
+dbuf_encode(struct nh_dbuf_entry new[ROWNO][COLNO],
+            struct nh_dbuf_entry old[ROWNO][COLNO])
+{
+    const struct nh_dbuf_entry *newp = &new[0][0], *oldp = &old[0][0];
+    unsigned char *buf, *out;
+    char *str;
+    int i, runstart = 0, runtype = -1, changed = FALSE;
+
+    buf = malloc(DBUF_MAX_ENCODED);
+    if (!buf)
+        return NULL;
+    out = buf;
+
+    for (i = 0; i <= ROWNO * COLNO; i++) {
+        int type = -1;
+
+        if (i < ROWNO * COLNO) {
+            if (!memcmp(newp + i, oldp + i, sizeof (struct nh_dbuf_entry)))
+                type = DBUF_RUN_SAME;
+            else if (!memcmp(newp + i, &zero_dbe,
+                             sizeof (struct nh_dbuf_entry)))
+                type = DBUF_RUN_ZERO;
+            else
+                type = DBUF_RUN_DATA;
+        }
+
+        if (type != runtype) {
+            if (runtype != -1)
+                out = put_run(out, runtype, i - runstart, newp + runstart);
+            if (type != DBUF_RUN_SAME)
+                changed = TRUE;
+            runtype = type;
+            runstart = i;
+        }
+    }
+
+    str = changed ? base64_encode(buf, out - buf) : NULL;
+    free(buf);
+    return str;
+}
+
+nh_bool
+dbuf_decode(const char *str, struct nh_dbuf_entry dbuf[ROWNO][COLNO])
+{
+    struct nh_dbuf_entry *dbp = &dbuf[0][0];
+    unsigned char *buf;
+    const unsigned char *in, *end;
+    int len, pos = 0;
+
+    buf = malloc(DBUF_MAX_ENCODED);
+    if (!buf)
+        return FALSE;
+
+    len = base64_decode(str, buf, DBUF_MAX_ENCODED);
+    if (len < 0) {
+        free(buf);
+        return FALSE;
+    }
+
+    in = buf;
+    end = buf + len;
+    while (in < end) {
+        int type = *in & DBUF_RUN_MASK;
+        int n = (*in & ~DBUF_RUN_MASK) + 1;
+
+        in++;
+        if (pos + n > ROWNO * COLNO ||
+            (type == DBUF_RUN_DATA && end - in < n * DBUF_CELL_SIZE))
+            break;
+
+        switch (type) {
+        case DBUF_RUN_SAME:
+            break;
+        case DBUF_RUN_ZERO:
+            memset(dbp + pos, 0, n * sizeof (struct nh_dbuf_entry));
+            break;
+        case DBUF_RUN_DATA:
+            for (; n; n--)
+                get_cell(&in, dbp + pos++);
+            break;
+        default:
+            free(buf);
+            return FALSE;
+        }
+        pos += n;
+    }
+
+    free(buf);
+    return in == end && pos == ROWNO * COLNO;
+}
@@ -17,6 +17,8 @@ trietable_add(struct trietable **table, unsigned key, void *value)
         (*table)->ptr1 = NULL;
         (*table)->value = value;
         (*table)->key = key;
+    } else if ((*table)->key == key) {
+        (*table)->value = value;
     } else if (key == 0) {
         unsigned oldkey = (*table)->key;
         void *oldvalue = (*table)->value;
@@ -44,6 +46,42 @@ trietable_find(struct trietable **table, unsigned key)
         return trietable_find(&(*table)->ptr0, key >> 1);
 }
 
+/* Does nothing if the key isn't there. */
+void
+trietable_remove(struct trietable **table, unsigned key)
+{
+    struct trietable **leaf;
+    unsigned bits = 0, depth = 0;
+
+    while (*table && (*table)->key != key) {
+        table = (key & 1) ? &(*table)->ptr1 : &(*table)->ptr0;
+        key >>= 1;
+    }
+    if (*table == NULL)
+        return;
+
+    /* Any element further down the trie lies on the path to this node, so
+       can be moved into it (with the bits of the path put back onto its key);
+       that way, only a leaf ever has to be freed. */
+    leaf = table;
+    while ((*leaf)->ptr0 || (*leaf)->ptr1) {
+        if ((*leaf)->ptr0)
+            leaf = &(*leaf)->ptr0;
+        else {
+            leaf = &(*leaf)->ptr1;
+            bits |= 1U << depth;
+        }
+        depth++;
+    }
+
+    if (leaf != table) {
+        (*table)->key = ((*leaf)->key << depth) | bits;
+        (*table)->value = (*leaf)->value;
+    }
+    free(*leaf);
+    *leaf = NULL;
+}
+
 void
 trietable_empty(struct trietable **table)
 {
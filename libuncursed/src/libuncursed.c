@@ -50,6 +50,12 @@ AIMAKE_ABI_VERSION(1.0.2)
 static WINDOW *nout_win = 0;        /* Window drawn onto by wnoutrefresh */
 static WINDOW *disp_win = 0;        /* Window drawn onto by doupdate */
 
+/* The columns of each line of nout_win that might not match disp_win, and so
+   need to be looked at by doupdate; first > last if the line is untouched. */
+static struct touched_line {
+    int first, last;
+} *nout_touched = 0;
+
 /* uncursed hook handling */
 struct uncursed_hooks *uncursed_hook_list = NULL;
 static int uncursed_hooks_inited = 0;
@@ -58,6 +64,12 @@ static int uncursed_hooks_inited = 0;
 #define SCREND 3
 static int add_wch_core(WINDOW *win, const cchar_t *ch);
 
+static bool alloc_nout_touched(void);
+static void touch_nout(int y, int first, int last);
+static void untouch_nout_if_drawn(int y);
+static inline bool same_chars(const wchar_t *a, const wchar_t *b);
+static inline bool nout_cell_needs_update(int idx);
+
 void
 initialize_uncursed(int *p_argc, char **argv)
 {
@@ -534,11 +546,17 @@ delete_tiles_region)
     int i;
 
     for (i = 0; i < (disp_win->maxx + 1) * (disp_win->maxy + 1); i++)
-        if (disp_win->regionarray[i] == win->region)
+        if (disp_win->regionarray[i] == win->region) {
             disp_win->regionarray[i] = &invalid_region;
+            touch_nout(i / (disp_win->maxx + 1), i % (disp_win->maxx + 1),
+                       i % (disp_win->maxx + 1));
+        }
     for (i = 0; i < (nout_win->maxx + 1) * (nout_win->maxy + 1); i++)
-        if (nout_win->regionarray[i] == win->region)
+        if (nout_win->regionarray[i] == win->region) {
             nout_win->regionarray[i] = NULL;
+            touch_nout(i / (nout_win->maxx + 1), i % (nout_win->maxx + 1),
+                       i % (nout_win->maxx + 1));
+        }
     for (i = 0; i < (win->maxx + 1) * (win->maxy + 1); i++)
         win->regionarray[i] = NULL;
 
@@ -933,6 +951,10 @@ add_wch_core(WINDOW * win, const cchar_t *ch)
         memcpy(win->chararray + idx, ch, sizeof *ch);
         win->chararray[idx].attr =
             add_window_attrs(win->chararray[idx].attr, win->current_attr);
+        /* not needed to draw the character, but keeps unchanged rows
+           identical to nout_win's copy of them, for copywin */
+        win->chararray[idx].color_on_screen =
+            color_on_screen_for_attr(win->chararray[idx].attr);
         memcpy(&(win->chararray[idx].bindings), &(win->current_bindings),
                sizeof win->current_bindings);
 
@@ -1650,17 +1672,52 @@ copywin(const WINDOW *from, const WINDOW *to, int from_miny, int from_minx,
         void **tr = to->regionarray + xoffset +
             ((j + yoffset) * (to->maxx + 1));
 
-        if (skip_blanks) {
+        if (to == nout_win) {
+            /* Only overwrite the characters that actually change, and record
+               where they are, so that doupdate doesn't have to compare the
+               whole screen against disp_win to find them. */
+            int first = -1, last = -1;
+
+            /* Most rows haven't changed since the last refresh, in which case
+               they're byte-for-byte the same as nout_win already has; that's
+               much cheaper to check a row at a time than a cell at a time. */
+            if (irange <= 0 || (!memcmp(tc, fc, irange * sizeof *tc) &&
+                                !memcmp(tr, fr, irange * sizeof *tr)))
+                continue;
+
+            for (i = imin; i <= imax; i++) {
+                if (!skip_blanks || fc->chars[0] != 32) {
+                    if (tc->attr == fc->attr && *tr == *fr &&
+                        same_chars(tc->chars, fc->chars)) {
+                        memcpy(&(tc->bindings), &(fc->bindings),
+                               sizeof fc->bindings);
+                    } else {
+                        *tc = *fc;
+                        *tr = *fr;
+                        tc->color_on_screen =
+                            color_on_screen_for_attr(tc->attr);
+
+                        if (first == -1)
+                            first = i;
+                        last = i;
+                    }
+                }
+
+                tc++;
+                fc++;
+                tr++;
+                fr++;
+            }
+
+            if (first != -1)
+                touch_nout(j + yoffset, first + xoffset, last + xoffset);
+        } else if (skip_blanks) {
             /* Conceptually "for (i = imin; i <= imax; i++)", but we don't use
                the value of i, so make the loop as optimizable as possible. */
             for (i = 0; i < irange; i++) {
                 if (fc->chars[0] != 32) {
                     *tc = *fc;
                     *tr = *fr;
-
-                    if (to == nout_win)
-                        tc->color_on_screen =
-                            color_on_screen_for_attr(tc->attr);
                 }
 
                 /* Dead-reckon these pointers for performance. This function is
@@ -1677,13 +1734,6 @@ copywin(const WINDOW *from, const WINDOW *to, int from_miny, int from_minx,
                when we could copy as opaque objects (which is even faster). */
             memcpy(tc, fc, irange * sizeof *tc);
             memcpy(tr, fr, irange * sizeof *tr);
-
-            if (to == nout_win)
-                for (i = 0; i < irange; i++) {
-                    tc->color_on_screen =
-                        color_on_screen_for_attr(tc->attr);
-                    tc++;
-                }
         }
     }
     return OK;
@@ -2165,7 +2215,7 @@ initscr(void)
     disp_win = newwin(0, 0, 0, 0);
     stdscr = newwin(0, 0, 0, 0);
 
-    if (!nout_win || !disp_win || !stdscr) {
+    if (!nout_win || !disp_win || !stdscr || !alloc_nout_touched()) {
         fprintf(stderr, "uncursed: could not allocate memory!\n");
         exit(5);
     }
@@ -2197,6 +2247,10 @@ uncursed_rhook_setsize(int h, int w)
     COLS = w;
     wresize(stdscr, h, w);
     wresize(nout_win, h, w);
+    if (!alloc_nout_touched()) {
+        fprintf(stderr, "uncursed: could not allocate memory!\n");
+        exit(5);
+    }
     wresize(disp_win, h, w);
     redrawwin(stdscr); /* we need to touch every character */
 
@@ -2367,7 +2421,8 @@ mvderwin(WINDOW *win, int y, int x)
     return OK;
 }
 
-/* Synch routines are mostly no-ops because touchwin is also a no-op */
+/* Synch routines are mostly no-ops because wnoutrefresh always copies the
+   entire window, so windows never need to know about changes to each other */
 void
 wsyncup(WINDOW *win)
 {
@@ -2426,15 +2481,18 @@ wredrawln(WINDOW *win, int first, int num)
     int j, i;
     for (j = win->scry + first;
          j < win->scry + first + num && j <= disp_win->maxy; j++) {
-        if (j >= 0)
+        if (j >= 0) {
             for (i = win->scrx;
                  i <= win->scrx + win->maxx && i <= disp_win->maxx; i++) {
                 if (i >= 0) {
-                    disp_win->chararray[i + j * win->stride].attr = -1;
-                    disp_win->chararray[i + j * win->stride].color_on_screen =
-                        (unsigned short)-1;
+                    cchar_t *q = disp_win->chararray + i + j * disp_win->stride;
+
+                    q->attr = -1;
+                    q->color_on_screen = (unsigned short)-1;
                 }
             }
+            touch_nout(j, win->scrx, win->scrx + win->maxx);
+        }
     }
     return touchline(win, first, num);
 }
@@ -2471,6 +2529,109 @@ wnoutrefresh(WINDOW *win)
     return wmove(nout_win, win->scry + win->y, win->scrx + win->x);
 }
 
+/* (Re)allocates nout_touched to fit nout_win, touching every line. */
+static bool
+alloc_nout_touched(void)
+{
+    struct touched_line *t =
+        realloc(nout_touched, (nout_win->maxy + 1) * sizeof *nout_touched);
+    int j;
+
+    if (!t)
+        return false;
+    nout_touched = t;
+
+    for (j = 0; j <= nout_win->maxy; j++) {
+        nout_touched[j].first = 0;
+        nout_touched[j].last = nout_win->maxx;
+    }
+    return true;
+}
+
+static void
+touch_nout(int y, int first, int last)
+{
+    if (!nout_touched || y < 0 || y > nout_win->maxy)
+        return;
+    if (first < 0)
+        first = 0;
+    if (last > nout_win->maxx)
+        last = nout_win->maxx;
+    if (first > last)
+        return;
+
+    if (first < nout_touched[y].first)
+        nout_touched[y].first = first;
+    if (last > nout_touched[y].last)
+        nout_touched[y].last = last;
+}
+
+/* Shrinks the touched part of a line to the characters in it that still need
+   drawing. */
+static void
+untouch_nout_if_drawn(int y)
+{
+    struct touched_line *t = nout_touched + y;
+    int idx = y * nout_win->stride;
+
+    if (t->first > t->last)
+        return;
+
+    /* disp_win's characters are copied from nout_win as they're drawn, so in
+       the usual case, the whole range is identical. */
+    if (!memcmp(nout_win->chararray + idx + t->first,
+                disp_win->chararray + idx + t->first,
+                (t->last - t->first + 1) * sizeof *nout_win->chararray) &&
+        !memcmp(nout_win->regionarray + idx + t->first,
+                disp_win->regionarray + idx + t->first,
+                (t->last - t->first + 1) * sizeof *nout_win->regionarray)) {
+        t->first = nout_win->maxx + 1;
+        t->last = -1;
+        return;
+    }
+
+    while (t->first <= t->last && !nout_cell_needs_update(idx + t->first))
+        t->first++;
+    while (t->last >= t->first && !nout_cell_needs_update(idx + t->last))
+        t->last--;
+}
+
+/* Compares the characters of two cchar_ts, ignoring anything after the
+   terminating 0. */
+static inline bool
+same_chars(const wchar_t *a, const wchar_t *b)
+{
+    int k;
+
+    for (k = 0; k < CCHARW_MAX; k++) {
+        if (a[k] != b[k])
+            return false;
+        if (a[k] == 0)
+            return true;
+    }
+    return true;
+}
+
+/* Whether the character at the given index of nout_win is different from the
+   one at the same index of disp_win (the two windows have the same shape). */
+static inline bool
+nout_cell_needs_update(int idx)
+{
+    cchar_t *p = nout_win->chararray + idx;
+    cchar_t *q = disp_win->chararray + idx;
+
+    if (p->color_on_screen != q->color_on_screen)
+        return true;
+
+    if (disp_win->regionarray[idx] == &invalid_region)
+        return true;
+
+    if (nout_win->regionarray[idx] != disp_win->regionarray[idx])
+        return true;
+
+    return !same_chars(p->chars, q->chars);
+}
+
 int
 doupdate(void)
 {
@@ -2482,36 +2643,30 @@ doupdate(void)
     }
     nout_win->clear_on_refresh = 0;
 
-    cchar_t *p = nout_win->chararray;
-    cchar_t *q = disp_win->chararray;
-    void **rp = nout_win->regionarray;
-    void **rq = disp_win->regionarray;
-
-    for (j = 0; j <= nout_win->maxy; j++) {
-        for (i = 0; i <= nout_win->maxx; i++) {
-            int k;
+    if (need_noutwin_recolor) {
+        cchar_t *p = nout_win->chararray;
 
-            if (need_noutwin_recolor)
-                p->color_on_screen = color_on_screen_for_attr(p->attr);
+        for (i = 0; i < (nout_win->maxx + 1) * (nout_win->maxy + 1); i++, p++)
+            p->color_on_screen = color_on_screen_for_attr(p->attr);
+        for (j = 0; j <= nout_win->maxy; j++)
+            touch_nout(j, 0, nout_win->maxx);
+    }
 
-            if (p->color_on_screen != q->color_on_screen ||
-                *rp != *rq || *rq == &invalid_region)
+    for (j = 0; j <= nout_win->maxy; j++)
+        for (i = nout_touched[j].first; i <= nout_touched[j].last; i++)
+            if (nout_cell_needs_update(i + j * nout_win->stride))
                 uncursed_hook_update(j, i);
 
-            for (k = 0; k < CCHARW_MAX; k++) {
-                if (p->chars[k] != q->chars[k])
-                    uncursed_hook_update(j, i);
-                if (p->chars[k] == 0)
-                    break;
-            }
-
-            p++; q++; rp++; rq++;
-        }
-    }
-
     uncursed_hook_positioncursor(nout_win->y, nout_win->x);
     uncursed_hook_flush();
     need_noutwin_recolor = false;
+
+    /* Normally, everything was just drawn; but an interface might not have
+       drawn everything it was asked to, so keep whatever still differs in
+       the touched area touched. */
+    for (j = 0; j <= nout_win->maxy; j++)
+        untouch_nout_if_drawn(j);
+
     return OK;
 }
 
@@ -2533,30 +2688,7 @@ uncursed_rhook_needsupdate(int y, int x)
     if (y > nout_win->maxy || x > nout_win->maxx)
         return 0;
 
-    cchar_t *p = nout_win->chararray + x + y * nout_win->stride;
-    cchar_t *q = disp_win->chararray + x + y * disp_win->stride;
-
-    if (p->color_on_screen != q->color_on_screen)
-        return 1;
-
-    if (disp_win->regionarray[x + y * (disp_win->maxx + 1)] ==
-        &invalid_region)
-        return 1;
-
-    if (nout_win->regionarray[x + y * (nout_win->maxx + 1)] !=
-        disp_win->regionarray[x + y * (disp_win->maxx + 1)])
-        return 1;
-
-    int k;
-
-    for (k = 0; k < CCHARW_MAX; k++) {
-        if (p->chars[k] != q->chars[k])
-            return 1;
-        if (p->chars[k] == 0)
-            return 0;
-    }
-
-    return 0;
+    return nout_cell_needs_update(x + y * nout_win->stride);
 }
 
 void *
@@ -2855,11 +2987,13 @@ move, (int y, int x), (y, x))
 }
 
 /* manual page 3ncurses touch */
+/* wnoutrefresh always copies the entire window, so these don't need to affect
+   the window itself; they just make doupdate look at the corresponding part of
+   the screen again. */
 int
 touchwin(WINDOW *win)
 {
-    (void)win;
-    return OK;
+    return wtouchln(win, 0, win->maxy + 1, 1);
 }
 
 int
@@ -2872,19 +3006,22 @@ untouchwin(WINDOW *win)
 int
 touchline(WINDOW *win, int first, int count)
 {
-    (void)win;
-    (void)first;
-    (void)count;
-    return OK;
+    return wtouchln(win, first, count, 1);
 }
 
 int
 wtouchln(WINDOW *win, int first, int count, int touched)
 {
-    (void)win;
-    (void)first;
-    (void)count;
-    (void)touched;
+    int j;
+
+    /* Untouching is a no-op; doupdate works out whether the screen actually
+       needs changing, so touched lines only cost time. */
+    if (!touched)
+        return OK;
+
+    for (j = first; j < first + count && j <= win->maxy; j++)
+        touch_nout(win->scry + j, win->scrx, win->scrx + win->maxx);
+
     return OK;
 }
 
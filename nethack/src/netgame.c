@@ -708,8 +708,17 @@ netgame(void)
     struct server_info *servlist, *server;
     struct server_info localserver = { 0, 0, 0, 0 };
     int fd;
+    char cachedir[
+#ifdef AIMAKE_BUILDOS_MSWin32
+        MAX_PATH
+#else
+        BUFSZ
+#endif
+        ];
 
     nhnet_lib_init(&curses_windowprocs);
+    if (get_gamedirA(CONFIG_DIR, cachedir))
+        nhnet_set_cache_dir(cachedir);
 
     if (ui_flags.connection_only) {
         servlist = NULL;
@@ -45,6 +45,15 @@
 #  define DEFAULT_CLIENT_TIMEOUT (15 * 60)      /* 15 minutes */
 # endif
 
+/* daemon mode (only used if a port is configured) */
+# define DEFAULT_WORKERS 4
+# define MAX_WORKERS     64
+
+/* optional protocol features that the client asked for at auth time */
+# define CLIENT_CAP_BINARY_DBUF 0x01    /* NHNET_CAP_BINARY_DBUF */
+# define CLIENT_CAP_DEFLATE     0x02    /* NHNET_CAP_DEFLATE */
+# define CLIENT_CAP_PAYLOAD_HASH 0x04   /* NHNET_CAP_PAYLOAD_HASH */
+
 
 enum getgame_result {
     GGR_NOT_FOUND,
@@ -57,6 +66,8 @@ struct settings {
     char *workdir;
     char *pidfile;
     int client_timeout;
+    int port;           /* nonzero: listen on this port ourselves */
+    int workers;        /* number of idle workers to keep ready */
     char *dbhost, *dbname, *dbport, *dbuser, *dbpass;
 };
 
@@ -91,6 +102,7 @@ extern int gamefd;
 extern long gameid;
 extern const struct client_command clientcmd[];
 extern struct nh_player_info player_info;
+extern int client_caps;
 
 /*---------------------------------------------------------------------------*/
 
@@ -98,6 +110,9 @@ extern struct nh_player_info player_info;
 extern int auth_user(char *authbuf, int *reconnect_id);
 extern void auth_send_result(int sockfd, enum authresult, int is_reg);
 
+/* clientcmd.c */
+extern void build_cached_payloads(void);
+
 /* clientmain.c */
 extern noreturn void client_main(int userid, int infd, int outfd);
 extern noreturn void exit_client(const char *err, int coredumpsignal);
@@ -114,6 +129,7 @@ extern void free_config(void);
 /* db.c */
 extern int init_database(void);
 extern int check_database(void);
+extern int prepare_database(void);
 extern void close_database(void);
 extern int db_auth_user(const char *name, const char *pass);
 extern int db_register_user(const char *name, const char *pass,
@@ -149,6 +165,7 @@ extern int init_workdir(void);
 
 /* server.c */
 extern noreturn void runserver(void);
+extern noreturn void rundaemon(void);
 extern noreturn void exit_server(int exitstatus, int coredumpsignal);
 
 /* winprocs.c */
@@ -7,8 +7,11 @@
  */
 
 #include "nhserver.h"
+#include "dbufcodec.h"
 #include <wctype.h>
 
+int client_caps;
+
 
 /* check various rules that apply to names:
  * - it must be a valid multibyte (UTF8) string
@@ -49,6 +52,32 @@ is_valid_username(const char *name)
 }
 
 
+/* The client can list protocol extensions it understands in a "caps" array;
+   unknown ones are ignored, so that newer clients can talk to older servers
+   and vice versa. */
+static int
+parse_client_caps(json_t *caps)
+{
+    int i, result = 0;
+    const char *cap;
+
+    if (!caps || !json_is_array(caps))
+        return 0;
+
+    for (i = 0; i < json_array_size(caps); i++) {
+        cap = json_string_value(json_array_get(caps, i));
+        if (cap && !strcmp(cap, NHNET_CAP_BINARY_DBUF))
+            result |= CLIENT_CAP_BINARY_DBUF;
+        else if (cap && !strcmp(cap, NHNET_CAP_DEFLATE))
+            result |= CLIENT_CAP_DEFLATE;
+        else if (cap && !strcmp(cap, NHNET_CAP_PAYLOAD_HASH))
+            result |= CLIENT_CAP_PAYLOAD_HASH;
+    }
+
+    return result;
+}
+
+
 int
 auth_user(char *authbuf, int *is_reg)
 {
@@ -79,6 +108,7 @@ auth_user(char *authbuf, int *is_reg)
     name = json_object_get(cmd, "username");
     pass = json_object_get(cmd, "password");
     email = json_object_get(cmd, "email");      /* is null for auth */
+    client_caps = parse_client_caps(json_object_get(cmd, "caps"));
 
     if (!name || !pass) {
         log_msg("auth packet is missing name or password");
@@ -152,6 +182,20 @@ auth_send_result(int sockfd, enum authresult result, int is_reg)
     jval =
         json_pack("{s:{si,s:[i,i,i]}}", key, "return", result,
                   "version", VERSION_MAJOR, VERSION_MINOR, PATCHLEVEL);
+
+    /* only echo capabilities to clients that asked for them, and only once
+       they're logged in; the reply is otherwise unchanged for old clients */
+    if (client_caps && result == AUTH_SUCCESS_NEW) {
+        json_t *caps = json_array();
+
+        if (client_caps & CLIENT_CAP_BINARY_DBUF)
+            json_array_append_new(caps, json_string(NHNET_CAP_BINARY_DBUF));
+        if (client_caps & CLIENT_CAP_DEFLATE)
+            json_array_append_new(caps, json_string(NHNET_CAP_DEFLATE));
+        if (client_caps & CLIENT_CAP_PAYLOAD_HASH)
+            json_array_append_new(caps, json_string(NHNET_CAP_PAYLOAD_HASH));
+        json_object_set_new(json_object_get(jval, key), "caps", caps);
+    }
     jstr = json_dumps(jval, JSON_COMPACT);
     len = strlen(jstr);
     written = 0;
@@ -27,6 +27,8 @@ static void ccmd_get_pl_prompt(json_t * params);
 static void ccmd_get_root_pl_prompt(json_t * params);
 static void ccmd_set_email(json_t * params);
 static void ccmd_set_password(json_t * params);
+static json_t *build_drawing_info(void);
+static json_t *build_roles(void);
 
 const struct client_command clientcmd[] = {
     {"shutdown", ccmd_shutdown, 0},
@@ -471,16 +473,79 @@ json_symarray(const struct nh_symdef *array, int len)
 }
 
 
+/* The drawing info and roles information depend only on the server binary, so
+   they're built once, by the daemon before it forks its workers (or, when
+   started from a superserver, once per process). Clients with
+   CLIENT_CAP_PAYLOAD_HASH are also sent a hash of the content, which they can
+   send back as a "hash" parameter next time; if it's still current, only the
+   hash is sent back, and the client uses its cached copy. */
+struct cached_payload {
+    json_t *obj;
+    char hash[17];
+};
+
+static struct cached_payload drawing_info_payload, roles_payload;
+
 static void
-ccmd_get_drawing_info(json_t * params)
+build_cached_payload(struct cached_payload *cp, json_t *(*build)(void))
+{
+    unsigned long long h = 0xcbf29ce484222325ULL;  /* 64-bit FNV-1a */
+    char *str, *p;
+
+    if (cp->obj)
+        return;
+
+    cp->obj = build();
+    str = json_dumps(cp->obj, JSON_COMPACT | JSON_SORT_KEYS);
+    for (p = str; *p; p++)
+        h = (h ^ (unsigned char)*p) * 0x100000001b3ULL;
+    free(str);
+    snprintf(cp->hash, sizeof cp->hash, "%016llx", h);
+}
+
+void
+build_cached_payloads(void)
+{
+    build_cached_payload(&drawing_info_payload, build_drawing_info);
+    build_cached_payload(&roles_payload, build_roles);
+}
+
+static void
+send_cached_payload(const char *cmd, json_t *params,
+                    struct cached_payload *cp, json_t *(*build)(void))
+{
+    const char *client_hash = NULL;
+    char errmsg[64];
+    json_t *reply;
+
+    if (json_object_iter(params) &&
+        (!(client_caps & CLIENT_CAP_PAYLOAD_HASH) ||
+         json_unpack(params, "{ss!}", "hash", &client_hash) == -1)) {
+        snprintf(errmsg, sizeof errmsg, "non-empty parameter list for %s",
+                 cmd);
+        exit_client(errmsg, 0);
+    }
+
+    build_cached_payload(cp, build);
+
+    if (!(client_caps & CLIENT_CAP_PAYLOAD_HASH)) {
+        json_incref(cp->obj);
+        client_msg(cmd, cp->obj);
+    } else if (client_hash && !strcmp(client_hash, cp->hash)) {
+        client_msg(cmd, json_pack("{ss}", "hash", cp->hash));
+    } else {
+        reply = json_copy(cp->obj);
+        json_object_set_new(reply, "hash", json_string(cp->hash));
+        client_msg(cmd, reply);
+    }
+}
+
+
+static json_t *
+build_drawing_info(void)
 {
     json_t *jobj;
     struct nh_drawing_info *di;
-    void *iter;
-
-    iter = json_object_iter(params);
-    if (iter)
-        exit_client("non-empty parameter list for get_drawing_info", 0);
 
     di = nh_get_drawing_info();
     jobj =
@@ -514,21 +579,24 @@ ccmd_get_drawing_info(json_t * params)
                         json_symarray(di->swallowsyms, NUMSWALLOWCHARS));
     json_object_set_new(jobj, "invis", json_symarray(di->invis, 1));
 
-    client_msg("get_drawing_info", jobj);
+    return jobj;
 }
 
 
 static void
-ccmd_get_roles(json_t * params)
+ccmd_get_drawing_info(json_t * params)
+{
+    send_cached_payload("get_drawing_info", params, &drawing_info_payload,
+                        build_drawing_info);
+}
+
+
+static json_t *
+build_roles(void)
 {
     int i, len;
     struct nh_roles_info *ri;
     json_t *jmsg, *jarr, *j_tmp;
-    void *iter;
-
-    iter = json_object_iter(params);
-    if (iter)
-        exit_client("non-empty parameter list for get_roles", 0);
 
     ri = nh_get_roles();
     jmsg =
@@ -587,7 +655,14 @@ ccmd_get_roles(json_t * params)
     }
     json_object_set_new(jmsg, "matrix", jarr);
 
-    client_msg("get_roles", jmsg);
+    return jmsg;
+}
+
+
+static void
+ccmd_get_roles(json_t * params)
+{
+    send_cached_payload("get_roles", params, &roles_payload, build_roles);
 }
 
 
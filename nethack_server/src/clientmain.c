@@ -13,6 +13,7 @@
 
 #include "nhserver.h"
 #include <ctype.h>
+#include <zlib.h>
 
 #define DEFAULT_NETHACKDIR "/usr/share/NetHack4/"
 
@@ -26,6 +27,14 @@ static int can_send_msg;
 static volatile sig_atomic_t currently_sending_message;
 static volatile sig_atomic_t send_server_cancel;
 
+/* If the client asked for CLIENT_CAP_DEFLATE, all our output goes through this
+   stream, which lasts as long as the connection does. deflate() doesn't
+   allocate memory once the stream is initialized, so using it (and the static
+   output buffer) is safe in send_string_to_client's async-signal case. */
+static z_stream deflate_strm;
+static int deflating;
+static unsigned char deflate_buf[16384];
+
 static char **
 init_game_paths(void)
 {
@@ -84,32 +93,21 @@ init_game_paths(void)
     return pathlist_copy;
 }
 
-/* The low-level function responsible for doing the actual sending. This is
-   async-signal-safe if the second argument is TRUE (this happens in signal
-   handlers; also during exits for any reason, to prevent the exit code running
-   recursively). */
-void
-send_string_to_client(const char *jsonstr, int defer_errors)
+/* Writes exactly len bytes to outfd. Returns FALSE if the write failed and
+   defer_errors is set; otherwise, failure exits the client process. */
+static nh_bool
+write_all_to_client(const void *buf, int len, int defer_errors)
 {
-    int len = strlen(jsonstr);
     int pos = 0;
     int ret;
 
-    currently_sending_message++;
-    do {
-        /* For NetHack 4.3, we separate the messages we send with NUL characters
-           (which are not legal in JSON), so that the client can more easily
-           find the boundary between messages. (NitroHack relied on separating
-           messages using the boundary between packets, which doesn't work in
-           practice.) The NUL is added using the terminating NUL of jsonstr. */
-        ret = write(outfd, jsonstr + pos, len + 1 - pos);
+    while (pos < len) {
+        ret = write(outfd, (const char *)buf + pos, len - pos);
         if (ret == -1 && (errno == EINTR || errno == EAGAIN))
             continue;
         else if (ret == -1 || ret == 0) {   /* bad news */
-            if (defer_errors) {
-                currently_sending_message--;
-                return; /* handle the error later */
-            }
+            if (defer_errors)
+                return FALSE;   /* handle the error later */
 
             /* since we just found we can't write output to the pipe,
                prevent any more tries */
@@ -119,7 +117,59 @@ send_string_to_client(const char *jsonstr, int defer_errors)
             exit_client(NULL, 0);      /* Goodbye. */
         }
         pos += ret;
-    } while (pos < len);
+    }
+
+    return TRUE;
+}
+
+/* The low-level function responsible for doing the actual sending. This is
+   async-signal-safe if the second argument is TRUE (this happens in signal
+   handlers; also during exits for any reason, to prevent the exit code running
+   recursively). */
+void
+send_string_to_client(const char *jsonstr, int defer_errors)
+{
+    /* For NetHack 4.3, we separate the messages we send with NUL characters
+       (which are not legal in JSON), so that the client can more easily find
+       the boundary between messages. (NitroHack relied on separating messages
+       using the boundary between packets, which doesn't work in practice.) The
+       NUL is added using the terminating NUL of jsonstr. */
+    int len = strlen(jsonstr) + 1;
+
+    currently_sending_message++;
+
+    if (!deflating) {
+        write_all_to_client(jsonstr, len, defer_errors);
+        currently_sending_message--;
+        return;
+    }
+
+    /* Compress the message as a continuation of everything sent so far, then
+       sync flush so that the client can decode it without waiting for more
+       data; the flush points act as message boundaries on the wire, and the
+       NUL separates the messages once decompressed. */
+    deflate_strm.next_in = (unsigned char *)jsonstr;
+    deflate_strm.avail_in = len;
+    do {
+        deflate_strm.next_out = deflate_buf;
+        deflate_strm.avail_out = sizeof deflate_buf;
+        if (deflate(&deflate_strm, Z_SYNC_FLUSH) == Z_STREAM_ERROR) {
+            /* can't happen unless the stream is corrupt; there's no way to
+               resynchronize with the client, so just drop the connection */
+            deflating = FALSE;
+            close(infd);
+            close(outfd);
+            infd = outfd = -1;
+            if (!defer_errors)
+                exit_client(NULL, 0);
+            break;
+        }
+        if (!write_all_to_client(deflate_buf,
+                                 sizeof deflate_buf - deflate_strm.avail_out,
+                                 defer_errors))
+            break;
+    } while (deflate_strm.avail_out == 0);
+
     currently_sending_message--;
 }
 
@@ -231,62 +281,114 @@ exit_client(const char *err, int coredumpsignal)
 }
 
 
+/* Input from the client is scanned incrementally as it arrives, tracking just
+   enough of the JSON syntax (nesting depth, and whether we're inside a string)
+   to find where each top-level value ends. Only then is the message handed to
+   the JSON parser, so each byte is looked at a bounded number of times no
+   matter how many packets a large message is split into. Anything received
+   after the end of a message is kept for the next call. */
+static char commbuf[COMMBUF_SIZE];
+static struct {
+    int datalen;        /* bytes in commbuf */
+    int scanpos;        /* bytes of commbuf scanned so far */
+    int msgstart;       /* where the current message starts */
+    int depth;          /* nesting level of {} and [] at scanpos */
+    nh_bool in_string;
+    nh_bool escaped;    /* after a backslash in a string */
+} input_scan;
+
+static void
+discard_input(int len)
+{
+    memmove(commbuf, commbuf + len, input_scan.datalen - len);
+    input_scan.datalen -= len;
+    input_scan.scanpos = input_scan.msgstart = 0;
+    input_scan.depth = 0;
+    input_scan.in_string = input_scan.escaped = FALSE;
+}
+
+/* Scans newly received data. Returns the length of the complete message
+   starting at input_scan.msgstart, or 0 if more data is needed. */
+static int
+scan_input(void)
+{
+    while (input_scan.scanpos < input_scan.datalen) {
+        char c = commbuf[input_scan.scanpos++];
+
+        if (c == '\033') {
+            /* this is a request to reset the buffer when recovering from a
+               connection error. After such an error it simply isn't possible
+               to know what data actually arrived. (An ESC can't be part of
+               valid JSON, even in a string, so it's unambiguous.) Keep
+               anything that was queued after the reset request. */
+            discard_input(input_scan.scanpos);
+            continue;
+        }
+
+        if (input_scan.in_string) {
+            if (input_scan.escaped)
+                input_scan.escaped = FALSE;
+            else if (c == '\\')
+                input_scan.escaped = TRUE;
+            else if (c == '"')
+                input_scan.in_string = FALSE;
+        } else if (c == '"') {
+            input_scan.in_string = TRUE;
+        } else if (c == '{' || c == '[') {
+            input_scan.depth++;
+        } else if (c == '}' || c == ']') {
+            if (--input_scan.depth == 0)
+                return input_scan.scanpos - input_scan.msgstart;
+            if (input_scan.depth < 0)
+                exit_client("Bad JSON data received", 0);
+        } else if (input_scan.depth == 0) {
+            /* between messages, allow whitespace, and NULs for symmetry with
+               the server-to-client direction */
+            if (c != '\0' && !isspace((unsigned char)c))
+                exit_client("Bad JSON data received", 0);
+            input_scan.msgstart = input_scan.scanpos;
+        }
+    }
+
+    return 0;
+}
+
 json_t *
 read_input(void)
 {
-    int ret, datalen, done;
-    static char commbuf[COMMBUF_SIZE];
-    char *bp;
+    int ret, msglen;
     json_t *jval = NULL;
     json_error_t err;
     struct pollfd pfd[1] =
         { {infd, POLLIN | POLLRDHUP | POLLERR | POLLHUP, 0} };
 
-    done = FALSE;
-    datalen = 0;
-    while (!done && !termination_flag) {
+    while (!termination_flag) {
+        msglen = scan_input();
+        if (msglen) {
+            jval = json_loadb(commbuf + input_scan.msgstart, msglen,
+                              JSON_REJECT_DUPLICATES, &err);
+            if (!jval)
+                exit_client("Bad JSON data received", 0);
+            discard_input(input_scan.msgstart + msglen);
+            break;
+        }
+
+        /* too much data received */
+        if (input_scan.datalen >= COMMBUF_SIZE)
+            exit_client("Max allowed input length exceeded", 0);
+
         ret = poll(pfd, 1, settings.client_timeout * 1000);
         if (ret == 0)
             exit_client("Inactivity timeout", 0);
 
-        ret = read(infd, &commbuf[datalen], COMMBUF_SIZE - datalen - 1);
+        ret = read(infd, &commbuf[input_scan.datalen],
+                   COMMBUF_SIZE - input_scan.datalen);
         if (ret == -1)
             continue;   /* sone signals will set termination_flag, others won't 
                          */
         else if (ret == 0)
             exit_client("Input pipe lost", 0);
-        datalen += ret;
-
-        if (commbuf[datalen - ret] == '\033') {
-            /* this is a request to reset the buffer when recovering from a
-               connection error. After such an error it simply isn't possible
-               to know what data actually arrived. */
-            /* do a memmove in case there was already some new legitimate data
-               queued after the '\033' reset request. */
-            memmove(commbuf, &commbuf[datalen - ret + 1], ret - 1);
-            datalen = ret - 1;
-            /* also reset the cached display data to make sure all display
-               state is re-sent */
-            continue;
-        }
-
-        commbuf[datalen] = '\0';        /* terminate the string */
-        bp = &commbuf[datalen - 1];
-        while (isspace(*bp))
-            bp--;
-
-        jval = NULL;
-        if (*bp == '}') {       /* possibly the end of the json object */
-            jval = json_loads(commbuf, JSON_REJECT_DUPLICATES, &err);
-            if (jval)
-                done = TRUE;
-            else if (err.position < datalen)
-                exit_client("Bad JSON data received", 0);
-        }
-
-        if (!jval && datalen >= COMMBUF_SIZE - 1)
-            exit_client("Max allowed input length exceeded", 0);
-        /* too much data received */
+        input_scan.datalen += ret;
     }
     /* message received; now it's our turn to send */
     can_send_msg = TRUE;
@@ -355,6 +457,14 @@ client_main(int userid, int _infd, int _outfd)
     outfd = _outfd;
     gamefd = -1;
 
+    /* the auth reply has been sent uncompressed; everything after it is
+       compressed, if the client asked for that */
+    if (client_caps & CLIENT_CAP_DEFLATE) {
+        if (deflateInit(&deflate_strm, Z_DEFAULT_COMPRESSION) != Z_OK)
+            exit_client("could not initialize compression", 0);
+        deflating = TRUE;
+    }
+
     if (!db_get_user_info(userid, &user_info)) {
         log_msg("get_user_info error for uid %d!", userid);
         exit_client("database error", SIGABRT);
@@ -97,6 +97,24 @@ parse_config_line(char *line)
                     " range [30, 86400].\n");
             return FALSE;
         }
+    } else if (!strcmp(line, "port")) {
+        if (!settings.port)
+            settings.port = atoi(val);
+
+        if (settings.port < 1 || settings.port > 65535) {
+            fprintf(stderr, "Error: the value for port must be in the"
+                    " range [1, 65535].\n");
+            return FALSE;
+        }
+    } else if (!strcmp(line, "workers")) {
+        if (!settings.workers)
+            settings.workers = atoi(val);
+
+        if (settings.workers < 1 || settings.workers > MAX_WORKERS) {
+            fprintf(stderr, "Error: the value for workers must be in the"
+                    " range [1, %d].\n", MAX_WORKERS);
+            return FALSE;
+        }
     }
     else
         /* it's a warning, no need to return FALSE */
@@ -201,6 +219,9 @@ setup_defaults(void)
 
     if (!settings.client_timeout)
         settings.client_timeout = DEFAULT_CLIENT_TIMEOUT;
+
+    if (!settings.workers)
+        settings.workers = DEFAULT_WORKERS;
 }
 
 
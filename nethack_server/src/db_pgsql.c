@@ -133,6 +133,7 @@ init_database(void)
 
 err:
     PQfinish(conn);
+    conn = NULL;
     return FALSE;
 }
 
@@ -198,9 +199,22 @@ check_database(void)
         !check_create_table("topten", SQL_init_topten_table))
         goto err;
 
-    /* 
-     * Create prepared statements
-     */
+    return prepare_database();
+
+err:
+    PQfinish(conn);
+    conn = NULL;
+    return FALSE;
+}
+
+
+/* Prepared statements belong to a connection, so this must be done for each
+   connection (check_database does it too). */
+int
+prepare_database(void)
+{
+    PGresult *res;
+
     res = PQprepare(conn, PREP_REGISTER, SQL_register_user, 0, NULL);
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
         fprintf(stderr, "prepare statement failed: %s", PQerrorMessage(conn));
@@ -221,6 +235,7 @@ check_database(void)
 
 err:
     PQfinish(conn);
+    conn = NULL;
     return FALSE;
 }
 
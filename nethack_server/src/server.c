@@ -122,6 +122,169 @@ runserver(void)
         exit_server(EXIT_FAILURE, 0);
 }
 
+
+/* Daemon mode: rather than being started by a superserver for each
+   connection, we listen on settings.port ourselves, and keep a pool of
+   settings.workers idle worker processes that have already done all the
+   connection-independent setup (config, logging, and a connection to the
+   database). Each idle worker blocks in accept() on the shared listening
+   socket; the one that gets a connection tells the parent (by writing its PID
+   to a pipe), and from then on behaves exactly like a superserver-spawned
+   process. The parent forks a replacement whenever a worker stops being idle,
+   and reaps the workers when their games end. */
+
+static int
+listen_on_port(int port)
+{
+    struct sockaddr_in6 sa6;
+    struct sockaddr_in sa4;
+    int fd, one = 1, zero = 0;
+
+    /* prefer a dual-stack IPv6 socket; fall back to IPv4 */
+    fd = socket(AF_INET6, SOCK_STREAM, 0);
+    if (fd != -1) {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+        setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof zero);
+        memset(&sa6, 0, sizeof sa6);
+        sa6.sin6_family = AF_INET6;
+        sa6.sin6_addr = in6addr_any;
+        sa6.sin6_port = htons(port);
+        if (bind(fd, (struct sockaddr *)&sa6, sizeof sa6) == 0 &&
+            listen(fd, SOMAXCONN) == 0)
+            return fd;
+        close(fd);
+    }
+
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd == -1) {
+        log_msg("Could not create a socket: %s", strerror(errno));
+        return -1;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+    memset(&sa4, 0, sizeof sa4);
+    sa4.sin_family = AF_INET;
+    sa4.sin_addr.s_addr = htonl(INADDR_ANY);
+    sa4.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&sa4, sizeof sa4) == -1 ||
+        listen(fd, SOMAXCONN) == -1) {
+        log_msg("Could not listen on port %d: %s", port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static noreturn void
+worker_main(int listenfd, int notifyfd)
+{
+    union {
+        struct sockaddr_in6 sa6;
+        struct sockaddr_in sa4;
+    } addr;
+    socklen_t addrlen;
+    pid_t pid = getpid();
+    int fd = -1, one = 1;
+
+    if (!init_database() || !prepare_database())
+        exit_server(EXIT_FAILURE, 0);
+
+    while (fd == -1) {
+        if (termination_flag)
+            exit_server(EXIT_SUCCESS, 0);
+        addrlen = sizeof addr;
+        fd = accept(listenfd, (struct sockaddr *)&addr, &addrlen);
+        /* on failure (e.g. EINTR or ECONNABORTED), just try again */
+    }
+
+    close(listenfd);
+    if (write(notifyfd, &pid, sizeof pid) != sizeof pid)
+        log_msg("Could not notify the daemon of a new connection");
+    close(notifyfd);
+
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+    log_msg("new connection from %s", addr2str(&addr));
+
+    infd = outfd = fd;
+    runserver();
+}
+
+static void
+write_pidfile(void)
+{
+    FILE *pidfile = fopen(settings.pidfile, "w");
+
+    if (!pidfile) {
+        log_msg("Could not write %s: %s", settings.pidfile, strerror(errno));
+        return;
+    }
+    fprintf(pidfile, "%d\n", (int)getpid());
+    fclose(pidfile);
+}
+
+noreturn void
+rundaemon(void)
+{
+    pid_t idle[MAX_WORKERS], pid;
+    int nidle = 0, listenfd, notifypipe[2], i;
+    struct pollfd pfd;
+
+    listenfd = listen_on_port(settings.port);
+    if (listenfd == -1 || pipe(notifypipe) == -1)
+        exit_server(EXIT_FAILURE, 0);
+    write_pidfile();
+
+    /* each worker makes its own database connection; a connection can't be
+       shared between processes */
+    close_database();
+
+    /* the workers inherit these, rather than each building its own */
+    build_cached_payloads();
+
+    pfd.fd = notifypipe[0];
+    pfd.events = POLLIN;
+
+    while (!termination_flag) {
+        while (nidle < settings.workers) {
+            pid = fork();
+            if (pid == 0) {
+                close(notifypipe[0]);
+                worker_main(listenfd, notifypipe[1]);
+            } else if (pid == -1) {
+                log_msg("Could not fork a worker: %s", strerror(errno));
+                break;
+            }
+            idle[nidle++] = pid;
+        }
+
+        /* the timeout means that we retry failed forks, and reap workers that
+           exit, at least once a second */
+        if (poll(&pfd, 1, 1000) > 0 &&
+            read(notifypipe[0], &pid, sizeof pid) == sizeof pid) {
+            for (i = 0; i < nidle; i++)
+                if (idle[i] == pid)
+                    idle[i] = idle[--nidle];
+        }
+
+        while ((pid = waitpid(-1, NULL, WNOHANG)) > 0) {
+            /* a worker that exits while idle has failed somehow (perhaps it
+               couldn't connect to the database); it will be replaced */
+            for (i = 0; i < nidle; i++)
+                if (idle[i] == pid)
+                    idle[i] = idle[--nidle];
+        }
+    }
+
+    /* Stop the idle workers. Busy workers keep running until their games end,
+       just like superserver-spawned processes. */
+    log_msg("daemon shutting down");
+    for (i = 0; i < nidle; i++)
+        kill(idle[i], SIGTERM);
+    unlink(settings.pidfile);
+
+    exit_server(EXIT_SUCCESS, 0);
+}
+
 noreturn void
 exit_server(int exitstatus, int coredumpsignal)
 {
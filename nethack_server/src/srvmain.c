@@ -36,12 +36,16 @@ main(int argc, char *argv[])
     if (request_kill) {
         fprintf(stderr, "There is no longer a centralized server daemon.\n");
         fprintf(stderr, "Send SIGTERM to the server processes manually.\n");
+        fprintf(stderr, "(In daemon mode, the daemon's PID is in %s.)\n",
+                settings.pidfile);
         return 0;
     }
 
     if (show_message) {
         fprintf(stderr, "There is no longer a centralized server daemon.\n");
         fprintf(stderr, "Send SIGUSR2 to the server processes manually.\n");
+        fprintf(stderr, "(In daemon mode, signal the worker processes, not "
+                "the daemon.)\n");
         return 0;
     }
 
@@ -53,6 +57,11 @@ main(int argc, char *argv[])
         !begin_logging())
         return 1;
 
+    if (settings.port) {
+        log_msg("daemon started on port %d", settings.port);
+        rundaemon(); /* does not return */
+    }
+
     log_msg("new process spawned");
 
     runserver(); /* does not return */
@@ -64,6 +73,12 @@ print_usage(const char *progname)
     printf("Usage: %s [OPTIONS]\n", progname);
     printf("  -c <file name>   Config file to use insted of the default.\n");
     printf("  -l <file name>   Alternate log file name.\n");
+    printf("  -n <number>      Number of idle workers to keep ready in\n");
+    printf("                     daemon mode. Default: %d.\n",
+           DEFAULT_WORKERS);
+    printf("  -p <port>        Run as a daemon listening on this port,\n");
+    printf("                     rather than serving a single connection\n");
+    printf("                     on stdin/stdout.\n");
     printf("  -t <seconds>     Client timeout in seconds. Default: %d.\n",
            DEFAULT_CLIENT_TIMEOUT);
     printf("  -w <directory>   Working directory which will store user\n");
@@ -91,7 +106,7 @@ read_parameters(int argc, char *argv[], char **conffile, int *request_kill,
     int opt;
 
     while ((opt =
-            getopt(argc, argv, "a:c:D:H:kl:mo:t:u:w:")) != -1) {
+            getopt(argc, argv, "a:c:D:H:kl:mn:o:p:t:u:w:")) != -1) {
         switch (opt) {
         case 'a':
             settings.dbpass = strdup(optarg);
@@ -122,10 +137,28 @@ read_parameters(int argc, char *argv[], char **conffile, int *request_kill,
             *show_message = TRUE;
             break;
 
+        case 'n':
+            settings.workers = atoi(optarg);
+            if (settings.workers < 1 || settings.workers > MAX_WORKERS) {
+                fprintf(stderr,
+                        "Error: The number of workers must be between 1 and "
+                        "%d.\n", MAX_WORKERS);
+                return FALSE;
+            }
+            break;
+
         case 'o':
             settings.dbport = strdup(optarg);
             break;
 
+        case 'p':
+            settings.port = atoi(optarg);
+            if (settings.port < 1 || settings.port > 65535) {
+                fprintf(stderr, "Error: Invalid port number %s.\n", optarg);
+                return FALSE;
+            }
+            break;
+
         case 't':
             settings.client_timeout = atoi(optarg);
             if (settings.client_timeout <= 30 ||
@@ -8,6 +8,7 @@
 
 #include "nhserver.h"
 #include "menulist.h"
+#include "dbufcodec.h"
 
 static void srv_raw_print(const char *str);
 static void srv_pause(enum nh_pause_reason r);
@@ -298,6 +299,19 @@ srv_update_screen(struct nh_dbuf_entry dbuf[ROWNO][COLNO], int ux, int uy)
     int i, x, y, samedbe, samecols, zerodbe, zerocols, is_same, is_zero;
     json_t *jmsg, *jdbuf, *dbufcol, *dbufent;
 
+    if (client_caps & CLIENT_CAP_BINARY_DBUF) {
+        char *bin = dbuf_encode(dbuf, prev_dbuf);
+
+        if (!bin)
+            return; /* nothing changed */
+
+        jmsg = json_pack("{si,si,ss}", "ux", ux, "uy", uy, "dbuf_bin", bin);
+        free(bin);
+        add_display_data("update_screen", jmsg);
+        memcpy(prev_dbuf, dbuf, sizeof prev_dbuf);
+        return;
+    }
+
     samecols = 0;
     zerocols = 0;
     jdbuf = json_array();
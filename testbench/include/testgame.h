@@ -6,7 +6,12 @@
 #include "compilers.h"
 #include <stdbool.h>
 
+extern int testnumber;
+
 extern void init_test_system(unsigned long long, const char[static 4], int);
 extern void shutdown_test_system(void);
 extern void play_test_game(const char *, bool);
+extern void play_checked_test_game(const char *, bool, bool (*)(void));
+extern bool play_unreported_test_game(const char *, bool (*)(void));
+extern void with_initialised_game(bool (*)(void));
 extern void skip_test_game(const char *, bool);
@@ -0,0 +1,28 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+/* Unit tests for the internals of the game engine. These need access to
+   symbols that libnethack doesn't export, so they're only built by dumbmake,
+   which links the engine statically. Each test function reports the number of
+   TAP tests given for it in testunit.c. */
+
+extern unsigned long long unit_rng_state;
+extern unsigned unit_rng(unsigned);
+
+extern void test_base64_kernels(void);
+extern void test_clear_path_cache(void);
+extern void test_data_index(void);
+extern void test_dbuf_codec(void);
+extern void test_distmap_cache(void);
+extern void test_id_index(void);
+extern void test_level_save_cache(void);
+extern void test_light_footprints(void);
+extern void test_mwrite_runs(void);
+extern void test_replay_checkpoints(void);
+extern void test_rng_lookahead(void);
+extern void test_save_line_index(void);
+extern void test_save_verification(void);
+extern void test_timer_order(void);
+extern void test_topten_index(void);
+extern void test_travel_cache(void);
+extern void test_trietable(void);
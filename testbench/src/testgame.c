@@ -24,13 +24,17 @@
 #include <fcntl.h>
 #include <errno.h>
 
+#define SEEDBUF_SIZE 80
+
 static unsigned long long test_seed;
 static char temp_directory[] = "nethack4-testsuite-XXXXXX\0";
 static bool test_system_inited = false;
 static bool test_verbose = false;
-static int testnumber = 1;
+int testnumber = 1;
 static int cmdnumber = 0;
 static const char *curcmd, *curcmd_ptr;
+static bool (*end_of_game_check)(void);
+static bool end_of_game_check_ok;
 static char test_crga[4];
 static int last_monster_d, last_monster_x, last_monster_y;
 
@@ -140,7 +144,7 @@ void
 shutdown_test_system(void)
 {
     nh_lib_exit();
-    char logfiles[strlen(temp_directory) + 9];
+    char logfiles[strlen(temp_directory) + 11];
 
     strcpy(logfiles, temp_directory);
     strcat(logfiles, "paniclog");
@@ -158,6 +162,10 @@ shutdown_test_system(void)
     strcat(logfiles, "record");
     remove(logfiles);
 
+    strcpy(logfiles, temp_directory);
+    strcat(logfiles, "record.idx");
+    remove(logfiles);
+
     rmdir(temp_directory);
 }
 
@@ -202,9 +210,20 @@ shutdown_test_system(void)
  */
 void
 play_test_game(const char *commands, bool verbose)
+{
+    play_checked_test_game(commands, verbose, NULL);
+}
+
+/* Plays a test game, writing its seed into seedbuf, and returns whether it
+   passed. */
+static bool
+run_test_game(const char *commands, bool verbose, bool (*check)(void),
+              char seedbuf[static SEEDBUF_SIZE])
 {
     curcmd = commands;
     curcmd_ptr = curcmd;
+    end_of_game_check = check;
+    end_of_game_check_ok = !check;
 
     /* Our starting seed is based on the test seed as a whole, and the test
        count. (Basing it on the test count means that we're not generating the
@@ -236,7 +255,6 @@ play_test_game(const char *commands, bool verbose)
         "seed", "mode", "role", "race", "gender", "align"
     };
     int i;
-    char seedbuf[80] = "<uninitialized>";
     for (i = 0; i < sizeof required_options / sizeof *required_options; i++) {
         struct nh_option_desc *opt =
             nhlib_find_option(newgame_options, required_options[i]);
@@ -248,7 +266,7 @@ play_test_game(const char *commands, bool verbose)
         if (i == 0) {
             v.s = seedbuf;
             /* Seeds are 16 characters of base64. We use just the digits. */
-            snprintf(seedbuf, sizeof seedbuf, "%016llu", this_test_seed);
+            snprintf(seedbuf, SEEDBUF_SIZE, "%016llu", this_test_seed);
             seedbuf[17] = '\0';
         } else if (i == 1) {
             v.e = MODE_WIZARD;
@@ -398,11 +416,60 @@ play_test_game(const char *commands, bool verbose)
             tap_comment("Couldn't back savefile up at %s", savefilename);
     }
 
-    tap_test(&testnumber, ok, "%s [seed %s]", commands, seedbuf);
+    if (ok && !end_of_game_check_ok) {
+        tap_comment("playing game: end-of-game check failed");
+        ok = false;
+    }
 
     fclose(savefile);
     close(paniclogfd);
     nhlib_free_optlist(newgame_options);
+
+    return ok;
+}
+
+/*
+ * Like play_test_game, but once the commands have run out, calls "check"
+ * before quitting; the test fails unless it returns true. The check runs inside
+ * the game (while the engine is waiting for a command), so it can inspect and
+ * manipulate the game's internals, as long as it leaves them in a consistent
+ * state.
+ */
+void
+play_checked_test_game(const char *commands, bool verbose, bool (*check)(void))
+{
+    char seedbuf[SEEDBUF_SIZE] = "<uninitialized>";
+    bool ok = run_test_game(commands, verbose, check, seedbuf);
+
+    tap_test(&testnumber, ok, "%s [seed %s]", commands, seedbuf);
+}
+
+/*
+ * Like play_checked_test_game, but doesn't print a TAP result; instead, it
+ * returns whether the test passed, and the caller reports it. The seed only
+ * depends on the test count, so calling this repeatedly for the same test plays
+ * the same game each time (which is useful for comparing the effects of
+ * settings that shouldn't change how the game plays).
+ */
+bool
+play_unreported_test_game(const char *commands, bool (*check)(void))
+{
+    char seedbuf[SEEDBUF_SIZE] = "<uninitialized>";
+
+    return run_test_game(commands, false, check, seedbuf);
+}
+
+/*
+ * Calls "check" with a game in progress, for unit tests of engine internals.
+ * Most of those need state that only starting a game sets up: the data library
+ * is open, the dungeon and the first level exist, and the hero is on it. There
+ * isn't a way to get that other than to play a game, so this plays one that
+ * just waits a turn, then runs the check before quitting.
+ */
+void
+with_initialised_game(bool (*check)(void))
+{
+    play_checked_test_game("wait", false, check);
 }
 
 /* Like play_test_game, but doesn't actually run the game. */
@@ -519,6 +586,10 @@ test_request_command(
        gets tested, and that we finally end up sending our success return to the
        game engine. */
     if (!*curcmd_ptr) {
+        if (end_of_game_check) {
+            end_of_game_check_ok = end_of_game_check();
+            end_of_game_check = NULL;
+        }
         nh_exit_game(EXIT_QUIT);
         /* should be unreachable; nh_exit_game returns only if the game wasn't
            running, in which case we shouldn't have been called in the first
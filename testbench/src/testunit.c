@@ -0,0 +1,85 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* A small deterministic PRNG, so that the randomized tests are reproducible
+   regardless of the test seed, and don't disturb the game's own RNGs. */
+unsigned long long unit_rng_state;
+
+unsigned
+unit_rng(unsigned n)
+{
+    unit_rng_state ^= unit_rng_state << 13;
+    unit_rng_state ^= unit_rng_state >> 7;
+    unit_rng_state ^= unit_rng_state << 17;
+    return (unsigned)(unit_rng_state >> 16) % n;
+}
+
+static const struct unit_test {
+    void (*run)(void);
+    int testcount;
+} unit_tests[] = {
+    {test_base64_kernels, 1},
+    {test_clear_path_cache, 1},
+    {test_data_index, 1},
+    {test_dbuf_codec, 1},
+    {test_distmap_cache, 1},
+    {test_id_index, 1},
+    {test_level_save_cache, 1},
+    {test_light_footprints, 1},
+    {test_mwrite_runs, 1},
+    {test_replay_checkpoints, 1},
+    {test_rng_lookahead, 1},
+    {test_save_line_index, 1},
+    {test_save_verification, 1},
+    {test_timer_order, 1},
+    {test_topten_index, 1},
+    {test_travel_cache, 1},
+    {test_trietable, 1},
+};
+
+int
+main(int argc, char **argv)
+{
+    unsigned long long seed = time(NULL);
+    char *endptr;
+    int i, testcount = 0;
+
+    if (argc == 3 && strcmp(argv[1], "--seed") == 0) {
+        seed = strtoull(argv[2], &endptr, 10);
+        if (!*argv[2] || *endptr) {
+            fprintf(stderr, "Option value '%s' is not an integer\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+    } else if (argc != 1) {
+        fprintf(stderr, "Usage:\n"
+                "  testunit [--seed seed]\n\n"
+                "Outputs the results of the engine's unit tests in TAP\n"
+                "format. Must be run from the top of the source tree.\n");
+        return (argc == 2 && !strcmp(argv[1], "--help") ? 0 : EXIT_FAILURE);
+    }
+
+    /* the game engine aborts on a panic, so don't lose buffered results */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    for (i = 0; i < sizeof unit_tests / sizeof *unit_tests; i++)
+        testcount += unit_tests[i].testcount;
+
+    init_test_system(seed, "wgfn", testcount);
+    for (i = 0; i < sizeof unit_tests / sizeof *unit_tests; i++)
+        unit_tests[i].run();
+    shutdown_test_system();
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "dbufcodec.h"
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Binary display buffer encoding */
+
+#define DBUF_TEST_TRIALS 300
+
+/* Sets a location to random values, often at the extremes of their types so
+   that sign handling gets tested. */
+static void
+random_dbuf_entry(struct nh_dbuf_entry *dbe)
+{
+    static const int effects[] = {0, 1, -1, 0x7FFFFFFF, -0x7FFFFFFF - 1};
+    static const short shorts[] = {0, 1, -1, 0x7FFF, -0x7FFF - 1};
+    short *fields[] = {&dbe->bg, &dbe->trap, &dbe->obj, &dbe->obj_mn,
+                       &dbe->mon, &dbe->monflags, &dbe->branding};
+    int i;
+
+    dbe->effect = unit_rng(2) ? effects[unit_rng(5)] :
+        (int)(unit_rng(0x10000) << 16 | unit_rng(0x10000));
+    for (i = 0; i < 7; i++)
+        *fields[i] = unit_rng(2) ? shorts[unit_rng(5)] :
+            (short)(unit_rng(0x10000) - 0x8000);
+    dbe->invis = unit_rng(2);
+    dbe->visible = unit_rng(2);
+}
+
+/* Changes a random number of runs of locations in dbuf, each to random values,
+   to zero, or to the same value throughout. The runs are sometimes longer than
+   the format's maximum run length. */
+static void
+mutate_dbuf(struct nh_dbuf_entry dbuf[ROWNO][COLNO])
+{
+    struct nh_dbuf_entry *dbp = &dbuf[0][0], fill;
+    int runs = unit_rng(20), start, len, i, kind;
+
+    while (runs--) {
+        start = unit_rng(ROWNO * COLNO);
+        len = 1 + unit_rng(unit_rng(4) ? 8 : ROWNO * COLNO - start);
+        if (start + len > ROWNO * COLNO)
+            len = ROWNO * COLNO - start;
+        kind = unit_rng(3);
+        random_dbuf_entry(&fill);
+        for (i = start; i < start + len; i++) {
+            if (kind == 0)
+                random_dbuf_entry(dbp + i);
+            else if (kind == 1)
+                memset(dbp + i, 0, sizeof *dbp);
+            else
+                dbp[i] = fill;
+        }
+    }
+}
+
+/* Encodes the difference between pairs of display buffers, and checks that
+   decoding it on top of the old buffer gives the new one; and that truncated
+   encodings are rejected. */
+void
+test_dbuf_codec(void)
+{
+    static struct nh_dbuf_entry old[ROWNO][COLNO], new[ROWNO][COLNO];
+    static struct nh_dbuf_entry decoded[ROWNO][COLNO];
+    char *str;
+    int trial, len;
+    bool ok = true;
+
+    unit_rng_state = 0xD1B54A32D192ED03ULL;
+    memset(old, 0, sizeof old);
+
+    for (trial = 0; trial < DBUF_TEST_TRIALS && ok; trial++) {
+        memcpy(new, old, sizeof new);
+        mutate_dbuf(new);
+
+        str = dbuf_encode(new, old);
+        memcpy(decoded, old, sizeof decoded);
+        if (!str) {
+            if (memcmp(new, old, sizeof new) != 0) {
+                tap_comment("dbuf: trial %d: nothing encoded for a change",
+                            trial);
+                ok = false;
+            }
+        } else if (!dbuf_decode(str, decoded)) {
+            tap_comment("dbuf: trial %d: encoding rejected by the decoder",
+                        trial);
+            ok = false;
+        } else if (memcmp(decoded, new, sizeof new) != 0) {
+            tap_comment("dbuf: trial %d: decoding gives the wrong buffer",
+                        trial);
+            ok = false;
+        }
+
+        /* Cut the encoding short by at least one whole group of base 64
+           characters, so that the runs can't cover the whole buffer. */
+        if (str && (len = strlen(str)) > 4) {
+            str[unit_rng(len - 4)] = '\0';
+            memcpy(decoded, old, sizeof decoded);
+            if (dbuf_decode(str, decoded)) {
+                tap_comment("dbuf: trial %d: truncated encoding accepted",
+                            trial);
+                ok = false;
+            }
+        }
+
+        free(str);
+        memcpy(old, new, sizeof old);
+    }
+
+    tap_test(&testnumber, ok, "dbuf: binary screen updates decode to the "
+             "encoded buffer");
+}
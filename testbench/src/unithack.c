@@ -0,0 +1,399 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "hack.h"
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+
+/* Travel cache */
+
+#define TRAVEL_TEST_STEPS 200
+#define TRAVEL_TEST_TARGETS 6
+#define TRAVEL_TEST_BOULDERS 8
+
+static int travel_boulders[TRAVEL_TEST_BOULDERS][2];
+static int travel_nboulders;
+
+/* Works out the next step both with and without the search kept from the
+   previous step, which have to agree. */
+static bool
+check_travel_step(boolean autoexplore, const char *what, int step,
+                  schar *dx, schar *dy)
+{
+    enum occupation occ = autoexplore ? occ_autoexplore : occ_travel;
+    schar udx, udy;
+
+    /* findtravelpath() ends the occupation when it arrives, and whether the
+       hero is travelling matters to test_move() */
+    flags.occupation = occ;
+    travel_step(autoexplore, TRUE, dx, dy);
+    flags.occupation = occ;
+    travel_step(autoexplore, FALSE, &udx, &udy);
+
+    if (*dx != udx || *dy != udy) {
+        tap_comment("travel: %s, step %d from (%d,%d): cached (%d,%d), "
+                    "uncached (%d,%d)", what, step, u.ux, u.uy, *dx, *dy,
+                    udx, udy);
+        return false;
+    }
+    return true;
+}
+
+static void
+toggle_door(int x, int y)
+{
+    struct rm *loc = &level->locations[x][y];
+
+    if (loc->doormask == D_CLOSED) {
+        loc->doormask = D_ISOPEN;
+        unblock_point(x, y);
+    } else {
+        loc->doormask = D_CLOSED;
+        block_point(x, y);
+    }
+    newsym(x, y);
+}
+
+static void
+remove_boulder(int x, int y)
+{
+    struct obj *otmp;
+    int i;
+
+    while ((otmp = sobj_at(BOULDER, level, x, y))) {
+        obj_extract_self(otmp);
+        obfree(otmp, NULL);
+    }
+    unblock_point(x, y);
+    newsym(x, y);
+
+    for (i = 0; i < travel_nboulders; i++)
+        if (travel_boulders[i][0] == x && travel_boulders[i][1] == y)
+            travel_boulders[i][0] = -1;
+}
+
+/* Opens or closes a door somewhere on the level, or puts a boulder near the
+   hero or takes one away; any of these can change the path. */
+static void
+change_travel_terrain(void)
+{
+    int i, x, y;
+
+    if (unit_rng(2)) {
+        for (i = 0; i < 100; i++) {
+            x = 1 + unit_rng(COLNO - 1);
+            y = unit_rng(ROWNO);
+            if (IS_DOOR(level->locations[x][y].typ) &&
+                (level->locations[x][y].doormask == D_CLOSED ||
+                 level->locations[x][y].doormask == D_ISOPEN) &&
+                !MON_AT(level, x, y) && (x != u.ux || y != u.uy)) {
+                toggle_door(x, y);
+                return;
+            }
+        }
+        return;
+    }
+
+    x = u.ux - 3 + unit_rng(7);
+    y = u.uy - 3 + unit_rng(7);
+    if (!isok(x, y) || (x == u.ux && y == u.uy) || MON_AT(level, x, y) ||
+        (level->locations[x][y].typ != ROOM &&
+         level->locations[x][y].typ != CORR))
+        return;
+
+    if (sobj_at(BOULDER, level, x, y))
+        remove_boulder(x, y);
+    else if (travel_nboulders < TRAVEL_TEST_BOULDERS) {
+        mksobj_at(BOULDER, level, x, y, FALSE, FALSE, rng_main);
+        block_point(x, y);
+        newsym(x, y);
+        travel_boulders[travel_nboulders][0] = x;
+        travel_boulders[travel_nboulders][1] = y;
+        travel_nboulders++;
+    }
+}
+
+/* Follows autoexplore or travel for up to TRAVEL_TEST_STEPS steps, changing
+   the terrain now and then. A closed door or a boulder in the way is removed
+   instead of taking the step, as if it had been opened or pushed. */
+static bool
+follow_travel(boolean autoexplore, const char *what)
+{
+    schar dx, dy;
+    int step, nx, ny;
+
+    for (step = 0; step < TRAVEL_TEST_STEPS; step++) {
+        if (!check_travel_step(autoexplore, what, step, &dx, &dy))
+            return false;
+        if (!dx && !dy)
+            break;
+
+        nx = u.ux + dx;
+        ny = u.uy + dy;
+        if (MON_AT(level, nx, ny))
+            break;
+        if (closed_door(level, nx, ny))
+            toggle_door(nx, ny);
+        else if (sobj_at(BOULDER, level, nx, ny))
+            remove_boulder(nx, ny);
+        else {
+            teleds(nx, ny, FALSE);
+            level->locations[u.ux][u.uy].mem_stepped = 1;
+            vision_recalc(0);
+        }
+
+        if (!unit_rng(4))
+            change_travel_terrain();
+    }
+    return true;
+}
+
+static bool
+travel_cache_check(void)
+{
+    char what[BUFSZ];
+    int target, i, x, y;
+    bool ok = true;
+
+    unit_rng_state = 0x853C49E6748FEA9BULL;
+    travel_nboulders = 0;
+
+    ok &= follow_travel(TRUE, "autoexplore");
+
+    /* travel to squares that the hero knows about, or (so that travel has to
+       guess) ones that they don't */
+    for (target = 0; target < TRAVEL_TEST_TARGETS && ok; target++) {
+        for (i = 0; i < 1000; i++) {
+            x = 1 + unit_rng(COLNO - 1);
+            y = unit_rng(ROWNO);
+            if (ACCESSIBLE(level->locations[x][y].typ) &&
+                (target % 2 ||
+                 level->locations[x][y].mem_bg != S_unexplored))
+                break;
+        }
+        u.tx = x;
+        u.ty = y;
+        snprintf(what, sizeof what, "travel to (%d,%d)", x, y);
+        ok &= follow_travel(FALSE, what);
+    }
+
+    for (i = 0; i < travel_nboulders; i++)
+        if (travel_boulders[i][0] >= 0)
+            remove_boulder(travel_boulders[i][0], travel_boulders[i][1]);
+    flags.occupation = occ_none;
+
+    return ok;
+}
+
+/* Autoexplores and travels around a level, opening and closing doors and
+   adding and removing boulders on the way, and checks that each step is the
+   same with the travel search kept between steps as without it. */
+void
+test_travel_cache(void)
+{
+    with_initialised_game(travel_cache_check);
+}
+
+/* Monster distance maps */
+
+#define DISTMAP_TEST_ROUNDS 40
+#define DISTMAP_TEST_GOALS 3
+#define DISTMAP_TEST_QUERIES 40
+#define DISTMAP_TEST_CHANGES 30
+
+/* The monsters cover every property distmap_init() shares fields on, and
+   some share a field with each other. */
+static const struct {
+    int pm;
+    boolean pick;
+    const char *what;
+} distmap_test_monsters[] = {
+    {PM_NEWT, FALSE, "walker"},
+    {PM_JACKAL, FALSE, "another walker"},
+    {PM_CROCODILE, FALSE, "swimmer"},
+    {PM_GIANT_EEL, FALSE, "eel"},
+    {PM_BAT, FALSE, "flyer"},
+    {PM_SALAMANDER, FALSE, "lava-lover"},
+    {PM_XORN, FALSE, "wall-phaser"},
+    {PM_EARTH_ELEMENTAL, FALSE, "another wall-phaser"},
+    {PM_DWARF, FALSE, "tunneller without a pick"},
+    {PM_DWARF, TRUE, "tunneller with a pick"},
+    {PM_ROCK_MOLE, FALSE, "tunneller that needs no pick"},
+};
+#define DISTMAP_TEST_MONSTERS \
+    (int)(sizeof distmap_test_monsters / sizeof *distmap_test_monsters)
+
+/* A plain breadth-first search, done from scratch each time, that distmap()
+   has to agree with. */
+static void
+fresh_distmap(int dist[COLNO][ROWNO], int x1, int y1, struct monst *mon)
+{
+    static xchar queue[COLNO * ROWNO][2];
+    int mmflags = MM_IGNOREMONST | MM_IGNOREDOORS;
+    int head = 0, tail = 0, x, y, dx, dy;
+
+    if (tunnels(mon->data) &&
+        (!needspick(mon->data) || (MON_WEP(mon) && is_pick(MON_WEP(mon)))))
+        mmflags |= MM_CHEWROCK;
+
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            dist[x][y] = COLNO * ROWNO;
+
+    dist[x1][y1] = 0;
+    queue[tail][0] = x1;
+    queue[tail++][1] = y1;
+    while (head < tail) {
+        x = queue[head][0];
+        y = queue[head++][1];
+        for (dx = -1; dx <= 1; dx++)
+            for (dy = -1; dy <= 1; dy++)
+                if (isok(x + dx, y + dy) &&
+                    dist[x + dx][y + dy] == COLNO * ROWNO &&
+                    goodpos(level, x + dx, y + dy, mon, mmflags)) {
+                    dist[x + dx][y + dy] = dist[x][y] + 1;
+                    queue[tail][0] = x + dx;
+                    queue[tail++][1] = y + dy;
+                }
+    }
+}
+
+/* Turns a random square (other than the hero's) into water, lava, floor, wall
+   or undiggable wall; water sometimes starts out as ice and is melted. */
+static void
+change_distmap_terrain(void)
+{
+    struct rm *loc;
+    int x, y;
+
+    do {
+        x = 1 + unit_rng(COLNO - 1);
+        y = unit_rng(ROWNO);
+    } while (x == u.ux && y == u.uy);
+    loc = &level->locations[x][y];
+
+    switch (unit_rng(6)) {
+    case 0:
+        loc->typ = ICE;
+        loc->icedpool = ICED_POOL;
+        melt_ice(level, x, y);
+        break;
+    case 1:
+        loc->typ = POOL;
+        break;
+    case 2:
+        loc->typ = LAVAPOOL;
+        break;
+    case 3:
+        loc->typ = ROOM;
+        break;
+    case 4:
+        loc->typ = HWALL;
+        loc->wall_info = 0;
+        break;
+    default:
+        loc->typ = STONE;
+        loc->wall_info = W_NONDIGGABLE | W_NONPASSWALL;
+        break;
+    }
+    mark_terrain_changed();
+    newsym(x, y);
+}
+
+static bool
+distmap_cache_check(void)
+{
+    static int dist[COLNO][ROWNO];
+    struct monst *mon[DISTMAP_TEST_MONSTERS];
+    struct distmap_state *ds;
+    int goals[DISTMAP_TEST_GOALS][2];
+    int round, g, m, q, i, x, y, cached;
+    coord cc;
+    bool ok = true;
+
+    unit_rng_state = 0xBB67AE8584CAA73BULL;
+
+    for (m = 0; m < DISTMAP_TEST_MONSTERS; m++) {
+        const struct permonst *pm = &mons[distmap_test_monsters[m].pm];
+
+        /* a newt's place will do; the eel needn't be in water, because
+           where the monsters are doesn't matter */
+        if (!enexto(&cc, level, u.ux, u.uy, &mons[PM_NEWT]) ||
+            !(mon[m] = makemon(pm, level, cc.x, cc.y, NO_MINVENT))) {
+            tap_comment("distmap: could not create a %s",
+                        distmap_test_monsters[m].what);
+            while (m--)
+                mongone(mon[m]);
+            return false;
+        }
+        if (distmap_test_monsters[m].pick) {
+            struct obj *pick = mksobj(level, PICK_AXE, FALSE, FALSE,
+                                      rng_main);
+
+            mpickobj(mon[m], pick);
+            mon[m]->mw = pick;
+            pick->owornmask = W_MASK(os_wep);
+        }
+    }
+
+    /* the goals stay the same, so that later rounds hit fields that were
+       cached before the terrain changed */
+    for (g = 0; g < DISTMAP_TEST_GOALS; g++) {
+        goals[g][0] = g ? 1 + unit_rng(COLNO - 1) : u.ux;
+        goals[g][1] = g ? unit_rng(ROWNO) : u.uy;
+    }
+
+    for (round = 0; round < DISTMAP_TEST_ROUNDS && ok; round++) {
+        for (i = 0; round && i < DISTMAP_TEST_CHANGES; i++)
+            change_distmap_terrain();
+
+        for (i = 0; i < DISTMAP_TEST_GOALS * DISTMAP_TEST_MONSTERS && ok;
+             i++) {
+            g = unit_rng(DISTMAP_TEST_GOALS);
+            m = unit_rng(DISTMAP_TEST_MONSTERS);
+            fresh_distmap(dist, goals[g][0], goals[g][1], mon[m]);
+
+            /* a few nearby squares, so the search stops partway, then
+               squares anywhere */
+            ds = distmap_init(goals[g][0], goals[g][1], mon[m]);
+            for (q = 0; q < DISTMAP_TEST_QUERIES && ok; q++) {
+                if (q < DISTMAP_TEST_QUERIES / 4) {
+                    x = goals[g][0] - 3 + unit_rng(7);
+                    y = goals[g][1] - 3 + unit_rng(7);
+                    if (!isok(x, y))
+                        continue;
+                } else {
+                    x = 1 + unit_rng(COLNO - 1);
+                    y = unit_rng(ROWNO);
+                }
+                cached = distmap(ds, x, y);
+                if (cached != dist[x][y]) {
+                    tap_comment("distmap: %s, round %d, (%d,%d) to (%d,%d): "
+                                "cached %d, fresh %d",
+                                distmap_test_monsters[m].what, round,
+                                goals[g][0], goals[g][1], x, y, cached,
+                                dist[x][y]);
+                    ok = false;
+                }
+            }
+        }
+    }
+
+    for (m = 0; m < DISTMAP_TEST_MONSTERS; m++)
+        mongone(mon[m]);
+    return ok;
+}
+
+/* Asks for distances from a few goals on behalf of monsters that move in
+   different ways, changing the terrain between rounds, and checks that the
+   cached distance fields agree with a fresh search every time. */
+void
+test_distmap_cache(void)
+{
+    with_initialised_game(distmap_cache_check);
+}
@@ -0,0 +1,522 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "hack.h"
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* The log records the time of each input, so games played with the same
+   commands only have the same log if the clock is stopped while they run. */
+#define LOG_TEST_TIME 1420070400000000LL
+
+/* Enough turns that there are plenty of save diffs between save backups. */
+#define LOG_TEST_COMMANDS \
+    "autoexplore,wait,search,autoexplore,wait,wait,autoexplore,search," \
+    "autoexplore,wait,autoexplore,search,wait,autoexplore"
+
+static char *copied_log;
+static long copied_log_len;
+
+/* Copies the log as it stands at the end of the commands. */
+static bool
+copy_log_check(void)
+{
+    struct stat st;
+    long pos = 0, n;
+
+    if (fstat(program_state.logfile, &st) < 0) {
+        tap_comment("log: could not find the length of the log");
+        return false;
+    }
+
+    copied_log_len = st.st_size;
+    copied_log = malloc(copied_log_len ? copied_log_len : 1);
+    while (pos < copied_log_len) {
+        n = pread(program_state.logfile, copied_log + pos,
+                  copied_log_len - pos, pos);
+        if (n <= 0) {
+            tap_comment("log: could not read the log");
+            free(copied_log);
+            copied_log = NULL;
+            return false;
+        }
+        pos += n;
+    }
+    return true;
+}
+
+/* Plays the test game with the given value of an environment variable (or with
+   it unset, if value is NULL), running check at the end. */
+static bool
+play_log_test_game(const char *ev, const char *value, bool (*check)(void))
+{
+    bool ok;
+
+    if (value)
+        setenv(ev, value, 1);
+    ok = play_unreported_test_game(LOG_TEST_COMMANDS, check);
+    unsetenv(ev);
+
+    if (!ok)
+        tap_comment("log: the game with %s=%s failed", ev,
+                    value ? value : "(unset)");
+    return ok;
+}
+
+/* Save verification */
+
+static const char *const save_verify_modes[] = {
+    "full", "crc", "periodic:3", "periodic"
+};
+
+/* How thoroughly the saves are verified mustn't affect the game: plays the
+   same game with each setting of NH4SAVEVERIFY, and checks that the logs are
+   the same, byte for byte. */
+void
+test_save_verification(void)
+{
+    char *full_log = NULL;
+    long full_log_len = 0, i;
+    int mode;
+    bool ok = true;
+
+    freeze_utc_time(LOG_TEST_TIME);
+
+    for (mode = 0; mode < SIZE(save_verify_modes) && ok; mode++) {
+        copied_log = NULL;
+        if (!play_log_test_game("NH4SAVEVERIFY", save_verify_modes[mode],
+                                copy_log_check) || !copied_log) {
+            free(copied_log);
+            ok = false;
+            break;
+        }
+
+        if (!full_log) {
+            full_log = copied_log;
+            full_log_len = copied_log_len;
+            continue;
+        }
+
+        for (i = 0; i < full_log_len && i < copied_log_len; i++)
+            if (full_log[i] != copied_log[i])
+                break;
+        if (i < full_log_len || i < copied_log_len) {
+            tap_comment("save verification: the log with %s differs from "
+                        "the one with full at byte %ld",
+                        save_verify_modes[mode], i);
+            ok = false;
+        }
+        free(copied_log);
+    }
+
+    free(full_log);
+    freeze_utc_time(0);
+
+    tap_test(&testnumber, ok, "save verification: the game plays the same "
+             "whichever checks are done");
+}
+
+/* Replay checkpoints */
+
+#define REPLAY_TEST_STEPS 90
+
+/* No checkpoints, the default amount, and so little that they get evicted. */
+static const char *const replay_cache_sizes[] = {"0", NULL, "200k"};
+
+static struct {
+    long location;
+    struct memfile save;
+} replay_steps[SIZE(replay_cache_sizes)][REPLAY_TEST_STEPS];
+static int replay_step_count[SIZE(replay_cache_sizes)];
+static int replay_run;
+
+/* Moves around the log as a replay would, keeping the binary save from each
+   step: first back one save line at a time, then to random turns and random
+   places in the log. Afterwards, goes back to the end so that the game can
+   carry on. */
+static bool
+replay_steps_check(void)
+{
+    long end = program_state.end_of_gamestate_location;
+    unsigned endmoves = moves;
+    int step;
+
+    program_state.followmode = FM_REPLAY;
+    unit_rng_state = 0x3C6EF372FE94F82BULL;
+
+    for (step = 0; step < REPLAY_TEST_STEPS; step++) {
+        if (step < REPLAY_TEST_STEPS / 3)
+            log_sync(program_state.binary_save_location - 1, TLU_BYTES, FALSE);
+        else if (step % 2)
+            log_sync(1 + unit_rng(endmoves), TLU_TURNS, FALSE);
+        else
+            log_sync(unit_rng(end), TLU_BYTES, FALSE);
+
+        replay_steps[replay_run][step].location =
+            program_state.binary_save_location;
+        mclone(&replay_steps[replay_run][step].save,
+               &program_state.binary_save);
+        replay_step_count[replay_run] = step + 1;
+    }
+
+    log_sync(0, TLU_EOF, FALSE);
+    program_state.followmode = FM_PLAY;
+    return true;
+}
+
+/* Starting a replay step from a checkpoint has to give the same binary save as
+   starting from a save backup and applying diffs: makes the same moves around
+   the same game's log with various sizes of NH4REPLAYCACHE, and compares the
+   saves reached. */
+void
+test_replay_checkpoints(void)
+{
+    const char *reason;
+    int run, step;
+    bool ok = true;
+
+    freeze_utc_time(LOG_TEST_TIME);
+
+    for (run = 0; run < SIZE(replay_cache_sizes) && ok; run++) {
+        replay_run = run;
+        replay_step_count[run] = 0;
+        ok = play_log_test_game("NH4REPLAYCACHE", replay_cache_sizes[run],
+                                replay_steps_check);
+    }
+
+    for (run = 1; run < SIZE(replay_cache_sizes) && ok; run++)
+        for (step = 0; step < REPLAY_TEST_STEPS && ok; step++) {
+            if (replay_steps[run][step].location !=
+                replay_steps[0][step].location) {
+                tap_comment("replay: with NH4REPLAYCACHE=%s, step %d went to "
+                            "%ld, not %ld", replay_cache_sizes[run] ?
+                            replay_cache_sizes[run] : "(unset)", step,
+                            replay_steps[run][step].location,
+                            replay_steps[0][step].location);
+                ok = false;
+            } else if (!mequal(&replay_steps[0][step].save,
+                               &replay_steps[run][step].save, &reason)) {
+                tap_comment("replay: with NH4REPLAYCACHE=%s, step %d: %s",
+                            replay_cache_sizes[run] ?
+                            replay_cache_sizes[run] : "(unset)", step, reason);
+                ok = false;
+            }
+        }
+
+    for (run = 0; run < SIZE(replay_cache_sizes); run++)
+        for (step = 0; step < replay_step_count[run]; step++)
+            mfree(&replay_steps[run][step].save);
+    freeze_utc_time(0);
+
+    tap_test(&testnumber, ok, "replay: stepping around the log gives the same "
+             "saves whether or not checkpoints are kept");
+}
+
+/* Save line index */
+
+/* Each save backup needs many turns' worth of save diffs after it. */
+#define INDEX_TEST_START "autoexplore,"
+#define INDEX_TEST_ROUNDS 650
+#define INDEX_TEST_ROUND "wait,search,"
+
+static struct {
+    long offset;
+    long moves;
+    char type;
+} *logged_lines;
+static int logged_line_count;
+static int prev_backup_line, last_backup_line;
+
+/* Finds the save lines in the copied log, and the turn the index says each is
+   from. */
+static bool
+find_logged_lines(void)
+{
+    long i, moves, next;
+    int n = 1;
+
+    for (i = 0; i < copied_log_len; i++)
+        if (copied_log[i] == '\x0a')
+            n++;
+    logged_lines = malloc(n * sizeof *logged_lines);
+
+    logged_line_count = 0;
+    for (i = 0; i < copied_log_len; i++)
+        if ((i == 0 || copied_log[i - 1] == '\x0a') &&
+            (copied_log[i] == '*' || copied_log[i] == '~')) {
+            if (!log_save_line_indexed(i, &moves, &next)) {
+                tap_comment("save index: the game didn't index the line at "
+                            "%ld", i);
+                return false;
+            }
+            logged_lines[logged_line_count].offset = i;
+            logged_lines[logged_line_count].moves = moves;
+            logged_lines[logged_line_count].type = copied_log[i];
+            logged_line_count++;
+        }
+    return true;
+}
+
+/* Returns the location in the copied log of the nth save backup's index
+   record, or of the first entry in it if entry is set. */
+static long
+index_record_location(int n, bool entry)
+{
+    int i;
+    long o;
+
+    for (i = 0; i < logged_line_count; i++)
+        if (logged_lines[i].type == '*' && !n--)
+            break;
+    for (o = logged_lines[i].offset; copied_log[o] != '\x0a'; o++)
+        if (copied_log[o] == (entry ? ':' : '#'))
+            return o + 1;
+    return -1;
+}
+
+/* Loads the game from scratch, as a new process would, goes back to the start
+   of the log, runs check, and then goes to the given turn. The locations and
+   saves reached at the start and the turn are stored in the arguments. */
+static bool
+reload_log(long turn, long locations[2], struct memfile saves[2],
+           bool (*check)(void))
+{
+    bool ok;
+
+    log_forget_save_line_index();
+    program_state.binary_save_location = 0;
+    log_sync(0, TLU_EOF, FALSE);
+
+    log_sync(logged_lines[0].offset, TLU_BYTES, FALSE);
+    locations[0] = program_state.binary_save_location;
+    mclone(&saves[0], &program_state.binary_save);
+    ok = check();
+
+    log_sync(turn, TLU_TURNS, FALSE);
+    locations[1] = program_state.binary_save_location;
+    mclone(&saves[1], &program_state.binary_save);
+
+    return ok;
+}
+
+static bool
+compare_reloads(long expected_locations[2], struct memfile expected_saves[2],
+                long locations[2], struct memfile saves[2], const char *what)
+{
+    const char *reason;
+    bool ok = true;
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        if (locations[i] != expected_locations[i]) {
+            tap_comment("save index: %s: went to %ld, not %ld", what,
+                        locations[i], expected_locations[i]);
+            ok = false;
+        } else if (!mequal(&expected_saves[i], &saves[i], &reason)) {
+            tap_comment("save index: %s: %s", what, reason);
+            ok = false;
+        }
+        mfree(&saves[i]);
+    }
+    return ok;
+}
+
+/* Changes one character in the log, returning what was there before. */
+static char
+corrupt_log(long o, char c)
+{
+    if (pwrite(program_state.logfile, &c, 1, o) != 1)
+        tap_comment("save index: could not change the log");
+    return copied_log[o];
+}
+
+static void
+restore_log(long o, char c)
+{
+    if (pwrite(program_state.logfile, &c, 1, o) != 1)
+        tap_comment("save index: could not restore the log");
+}
+
+/* Going from the end to the start of the log only decodes save backups, so
+   the save diffs can only have been indexed from the records. */
+static bool
+all_lines_indexed(void)
+{
+    long moves, next;
+    int i;
+
+    for (i = 0; i < last_backup_line; i++) {
+        if (!log_save_line_indexed(logged_lines[i].offset, &moves, &next)) {
+            tap_comment("save index: the line at %ld wasn't indexed after "
+                        "reloading", logged_lines[i].offset);
+            return false;
+        }
+        if (moves != logged_lines[i].moves ||
+            next != logged_lines[i + 1].offset) {
+            tap_comment("save index: the line at %ld was indexed as turn %ld "
+                        "followed by %ld, not turn %ld followed by %ld",
+                        logged_lines[i].offset, moves, next,
+                        logged_lines[i].moves, logged_lines[i + 1].offset);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* The last save backup's record was corrupted, so nothing between it and the
+   previous save backup may have been indexed. */
+static bool
+last_record_ignored(void)
+{
+    long o, moves, next;
+
+    for (o = logged_lines[prev_backup_line].offset + 1;
+         o < logged_lines[last_backup_line].offset; o++)
+        if (log_save_line_indexed(o, &moves, &next)) {
+            tap_comment("save index: %ld was indexed from a corrupted record",
+                        o);
+            return false;
+        }
+    return true;
+}
+
+/* Going back to the start of the log only has to read the records on the save
+   backups in between, not decode them, so a wrong turn in the last record
+   hasn't been noticed yet. */
+static bool
+prev_backup_not_decoded(void)
+{
+    long moves, next;
+
+    if (!log_save_line_indexed(logged_lines[prev_backup_line].offset,
+                               &moves, &next) ||
+        moves == logged_lines[prev_backup_line].moves) {
+        tap_comment("save index: save backups were decoded on the way back "
+                    "to the start");
+        return false;
+    }
+    return true;
+}
+
+/* Reloads the log, checking that the index records on the save backups are
+   enough to index every save line; then corrupts the last record in a couple
+   of ways, checking that it doesn't change where log_sync() goes. */
+static bool
+save_line_index_check(void)
+{
+    long locations[2], clean_locations[2], turn, first_entry, turn_field;
+    long moves, next;
+    struct memfile saves[2], clean_saves[2];
+    int backups = 0, i;
+    char old;
+    bool ok = true;
+
+    if (!copy_log_check())
+        return false;
+    if (!find_logged_lines()) {
+        ok = false;
+        goto out;
+    }
+
+    prev_backup_line = last_backup_line = 0;
+    for (i = 0; i < logged_line_count; i++)
+        if (logged_lines[i].type == '*') {
+            prev_backup_line = last_backup_line;
+            last_backup_line = i;
+            backups++;
+        }
+    if (backups < 3) {
+        tap_comment("save index: the game only had %d save backups", backups);
+        ok = false;
+        goto out;
+    }
+
+    first_entry = index_record_location(backups - 1, true);
+    if (first_entry < 0) {
+        tap_comment("save index: the last save backup has no index record");
+        ok = false;
+        goto out;
+    }
+
+    program_state.followmode = FM_REPLAY;
+
+    turn = logged_lines[prev_backup_line].moves;
+    ok &= reload_log(turn, clean_locations, clean_saves, all_lines_indexed);
+    if (clean_locations[0] != logged_lines[0].offset) {
+        tap_comment("save index: went to %ld, not the start of the log",
+                    clean_locations[0]);
+        ok = false;
+    }
+
+    /* A record that points at something other than save lines has to be
+       ignored. */
+    old = corrupt_log(first_entry, copied_log[first_entry] == '1' ? '2' : '1');
+    ok &= reload_log(turn, locations, saves, last_record_ignored);
+    ok &= compare_reloads(clean_locations, clean_saves, locations, saves,
+                          "a record pointing to the wrong place");
+    restore_log(first_entry, old);
+
+    /* One with the wrong turn for the previous save backup mustn't lead
+       log_sync() astray, and the turn has to be corrected once the save backup
+       is decoded. */
+    turn_field = index_record_location(backups - 1, false);
+    old = corrupt_log(turn_field, copied_log[turn_field] == '0' ? '1' : '0');
+    ok &= reload_log(turn, locations, saves, prev_backup_not_decoded);
+    ok &= compare_reloads(clean_locations, clean_saves, locations, saves,
+                          "a record with the wrong turn");
+    restore_log(turn_field, old);
+
+    if (!log_save_line_indexed(logged_lines[prev_backup_line].offset,
+                               &moves, &next) ||
+        moves != logged_lines[prev_backup_line].moves) {
+        tap_comment("save index: a wrong turn from a record wasn't "
+                    "corrected");
+        ok = false;
+    }
+
+    for (i = 0; i < 2; i++)
+        mfree(&clean_saves[i]);
+
+    log_forget_save_line_index();
+    log_sync(0, TLU_EOF, FALSE);
+    program_state.followmode = FM_PLAY;
+
+out:
+    free(logged_lines);
+    free(copied_log);
+    copied_log = NULL;
+    return ok;
+}
+
+/* The save line index is kept in the log, on the save backups, so that loading
+   a game doesn't have to rebuild it from scratch; it has to be complete after a
+   reload, and it mustn't matter if it's been corrupted. */
+void
+test_save_line_index(void)
+{
+    char commands[sizeof INDEX_TEST_START +
+                  INDEX_TEST_ROUNDS * (sizeof INDEX_TEST_ROUND - 1)];
+    int i;
+    bool ok;
+
+    strcpy(commands, INDEX_TEST_START);
+    for (i = 0; i < INDEX_TEST_ROUNDS; i++)
+        strcat(commands, INDEX_TEST_ROUND);
+    commands[strlen(commands) - 1] = '\0';   /* no trailing comma */
+
+    freeze_utc_time(LOG_TEST_TIME);
+    ok = play_unreported_test_game(commands, save_line_index_check);
+    freeze_utc_time(0);
+
+    tap_test(&testnumber, ok, "save index: the save line index is restored "
+             "from the log, and corrupt records are ignored");
+}
@@ -0,0 +1,200 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "hack.h"
+#include "dlb.h"
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+
+#define DATA_BASE "libnethack/dat/data.base"
+
+/* data.base, as makedefs reads it: groups of keys, each followed by the text
+   that the keys share */
+struct data_base_key {
+    char *text;
+    boolean neg;
+};
+
+struct data_base_group {
+    struct data_base_key *keys;
+    int nkeys;
+    char **lines;
+    int nlines;
+};
+
+static struct data_base_group *data_base;
+static int data_base_ngroups;
+
+static void
+load_data_base(void)
+{
+    char line[BUFSZ], *ep;
+    struct data_base_group *g = NULL;
+    FILE *fp = fopen(DATA_BASE, "r");
+
+    if (!fp)
+        tap_bail("could not open " DATA_BASE);
+
+    while (fgets(line, sizeof line, fp)) {
+        if (*line == '#')
+            continue;
+        if (*line > ' ') {
+            if (!g || g->nlines) {
+                data_base = realloc(data_base, (data_base_ngroups + 1) *
+                                    sizeof (struct data_base_group));
+                g = data_base + data_base_ngroups++;
+                memset(g, 0, sizeof *g);
+            }
+            if ((ep = strchr(line, '\n')))
+                *ep = '\0';
+            g->keys = realloc(g->keys, (g->nkeys + 1) *
+                              sizeof (struct data_base_key));
+            g->keys[g->nkeys].neg = *line == '~';
+            g->keys[g->nkeys].text = strdup(line + g->keys[g->nkeys].neg);
+            g->nkeys++;
+        } else if (g) {
+            g->lines = realloc(g->lines, (g->nlines + 1) * sizeof (char *));
+            g->lines[g->nlines++] = strdup(line);
+        }
+    }
+
+    fclose(fp);
+}
+
+static void
+free_data_base(void)
+{
+    int i, j;
+
+    for (i = 0; i < data_base_ngroups; i++) {
+        for (j = 0; j < data_base[i].nkeys; j++)
+            free(data_base[i].keys[j].text);
+        for (j = 0; j < data_base[i].nlines; j++)
+            free(data_base[i].lines[j]);
+        free(data_base[i].keys);
+        free(data_base[i].lines);
+    }
+    free(data_base);
+    data_base = NULL;
+    data_base_ngroups = 0;
+}
+
+/* The lookup checkfile() used to do: try every key in turn with pmatch(), and
+   take the first group with a match, unless a "~" key matched first. */
+static const struct data_base_group *
+scan_data_base(const char *str, const char *alt)
+{
+    const struct data_base_key *k;
+    int i, j;
+
+    for (i = 0; i < data_base_ngroups; i++) {
+        for (j = 0; j < data_base[i].nkeys; j++) {
+            k = data_base[i].keys + j;
+            if (pmatch(k->text, str) || (alt && pmatch(k->text, alt))) {
+                if (k->neg)
+                    break;
+                return data_base + i;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Looks str up both ways, and checks that the same text is found. */
+static bool
+check_data_lookup(dlb *fp, const char *str, const char *alt)
+{
+    const struct data_base_group *g = scan_data_base(str, alt);
+    char buf[BUFSZ];
+    long pos;
+    int i, nlines = find_data_entry(fp, str, alt, &pos);
+
+    if (nlines < 0)
+        tap_bail("the 'data' file is in the wrong format");
+
+    if (nlines != (g ? g->nlines : 0)) {
+        tap_comment("data: '%s' (or '%s') finds %d lines, but data.base has "
+                    "%d", str, alt ? alt : "", nlines, g ? g->nlines : 0);
+        return false;
+    }
+    if (!nlines)
+        return true;
+
+    if (dlb_fseek(fp, pos, SEEK_SET) < 0)
+        tap_bail("could not seek in the 'data' file");
+    for (i = 0; i < nlines; i++) {
+        if (!dlb_fgets(buf, sizeof buf, fp) || strcmp(buf, g->lines[i])) {
+            tap_comment("data: '%s' (or '%s') finds the wrong text",
+                        str, alt ? alt : "");
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+data_index_check(void)
+{
+    const struct data_base_key *k, *altk;
+    char str[BUFSZ], *p;
+    dlb *fp;
+    int i, j, variant;
+    bool ok = true;
+
+    unit_rng_state = 521288629ULL;
+
+    load_data_base();
+    fp = dlb_fopen(DATAFILE, "r");
+    if (!fp)
+        tap_bail("could not open the 'data' file");
+
+    /* Look up every key, as it is and with its wildcards filled in, and with
+       some text around it (which only wildcard keys can match); both alone,
+       and with another key as the alternate name. */
+    for (i = 0; i < data_base_ngroups && ok; i++) {
+        for (j = 0; j < data_base[i].nkeys; j++) {
+            k = data_base[i].keys + j;
+            for (variant = 0; variant < 4; variant++) {
+                switch (variant) {
+                case 0:
+                    snprintf(str, sizeof str, "%s", k->text);
+                    break;
+                case 1:
+                    snprintf(str, sizeof str, "%s", k->text);
+                    for (p = str; *p; p++)
+                        if (*p == '*' || *p == '?')
+                            *p = 'x';
+                    break;
+                case 2:
+                    snprintf(str, sizeof str, "big %s", k->text);
+                    break;
+                case 3:
+                    snprintf(str, sizeof str, "%s of foo", k->text);
+                    break;
+                }
+
+                ok &= check_data_lookup(fp, str, NULL);
+
+                altk = data_base[unit_rng(data_base_ngroups)].keys;
+                ok &= check_data_lookup(fp, str, altk->text);
+            }
+        }
+    }
+
+    dlb_fclose(fp);
+    free_data_base();
+    return ok;
+}
+
+/* Compares lookups in the 'data' file, which go through the index that
+   makedefs writes, with scanning through every key in data.base. */
+void
+test_data_index(void)
+{
+    with_initialised_game(data_index_check);
+}
@@ -0,0 +1,108 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "hack.h"
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+
+/* RNG look-ahead cache */
+
+#define RNG_TEST_CALLS 20000
+
+static const enum rng rng_test_rngs[2] = {rng_main, rng_dungeon_gen};
+
+/* Sets one of the RNGs under test to a new seed, and the reference copy of its
+   seed to match. The seeds are mostly random, but sometimes end in a long
+   series of 0xFF bytes, so that incrementing them carries a long way. */
+static void
+set_test_rng_seed(int which, unsigned char refseeds[][RNG_SEED_SIZE_BYTES])
+{
+    int i, carry = unit_rng(RNG_SEED_SIZE_BYTES);
+
+    for (i = 0; i < RNG_SEED_SIZE_BYTES; i++)
+        refseeds[which][i] = i < carry ? 0xFF : unit_rng(256);
+    memcpy(flags.rngstate + rng_test_rngs[which] * RNG_SEED_SIZE_BYTES,
+           refseeds[which], RNG_SEED_SIZE_BYTES);
+}
+
+/* Generates random numbers from two RNGs at once, occasionally changing their
+   seeds (to random values, or back to earlier values, as loading a save file
+   would), and checks that each number is the same as it would be if each seed
+   were hashed directly rather than via the look-ahead cache. This is done with
+   each of the SHA-256 kernels that fill the cache. */
+void
+test_rng_lookahead(void)
+{
+    static const int ranges[] = {1, 2, 7, 1000, 0x7FFFFFFF};
+    unsigned char refseeds[2][RNG_SEED_SIZE_BYTES];
+    unsigned char snapshots[2][RNG_SEED_SIZE_BYTES];
+    unsigned char saved_rngstate[sizeof flags.rngstate];
+    int i, which, maxplus1, cached, uncached, maxlevel, level;
+    bool ok = true;
+
+    memcpy(saved_rngstate, flags.rngstate, sizeof saved_rngstate);
+    unit_rng_state = 0x2545F4914F6CDD1DULL;
+
+    maxlevel = select_sha256_kernel(2);
+    if (maxlevel < 2)
+        tap_comment("rng: no 8-lane SHA-256 kernel on this CPU");
+
+    for (level = 0; level <= maxlevel && ok; level++) {
+        select_sha256_kernel(level);
+
+        for (which = 0; which < 2; which++) {
+            set_test_rng_seed(which, refseeds);
+            memcpy(snapshots[which], refseeds[which], RNG_SEED_SIZE_BYTES);
+        }
+
+        for (i = 0; i < RNG_TEST_CALLS && ok; i++) {
+            which = unit_rng(2);
+
+            switch (unit_rng(100)) {
+            case 0:
+                set_test_rng_seed(which, refseeds);
+                break;
+            case 1:
+                memcpy(snapshots[which], refseeds[which], RNG_SEED_SIZE_BYTES);
+                break;
+            case 2:
+                memcpy(refseeds[which], snapshots[which], RNG_SEED_SIZE_BYTES);
+                memcpy(flags.rngstate +
+                       rng_test_rngs[which] * RNG_SEED_SIZE_BYTES,
+                       refseeds[which], RNG_SEED_SIZE_BYTES);
+                break;
+            }
+
+            maxplus1 = unit_rng(4) ? ranges[unit_rng(SIZE(ranges))] :
+                1 + unit_rng(0x7FFFFFFF);
+            cached = rn2_on_rng(maxplus1, rng_test_rngs[which]);
+            uncached = rn2_on_seed_uncached(maxplus1, refseeds[which]);
+
+            if (cached != uncached) {
+                tap_comment("rng: level %d, call %d on RNG %d, range %d: got "
+                            "%d from the look-ahead cache, %d directly",
+                            level, i, (int)rng_test_rngs[which], maxplus1,
+                            cached, uncached);
+                ok = false;
+            }
+            if (memcmp(flags.rngstate +
+                       rng_test_rngs[which] * RNG_SEED_SIZE_BYTES,
+                       refseeds[which], RNG_SEED_SIZE_BYTES) != 0) {
+                tap_comment("rng: level %d, call %d on RNG %d advanced the "
+                            "seed wrongly", level, i,
+                            (int)rng_test_rngs[which]);
+                ok = false;
+            }
+        }
+    }
+
+    select_sha256_kernel(2);
+    memcpy(flags.rngstate, saved_rngstate, sizeof saved_rngstate);
+    tap_test(&testnumber, ok, "rng: the look-ahead cache matches hashing each "
+             "seed directly");
+}
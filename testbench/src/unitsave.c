@@ -0,0 +1,370 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "hack.h"
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+
+/* Save diffing */
+
+#define MWRITE_RECORDS 12
+#define MWRITE_RECORD_MAX 300
+
+struct mwrite_record {
+    int len;
+    char data[MWRITE_RECORD_MAX];
+};
+
+/* Fills in some tagged records, with few enough distinct byte values that long
+   runs of equal bytes are common. */
+static void
+make_mwrite_records(struct mwrite_record *records)
+{
+    int i, j;
+
+    for (i = 0; i < MWRITE_RECORDS; i++) {
+        records[i].len = unit_rng(MWRITE_RECORD_MAX + 1);
+        for (j = 0; j < records[i].len; j++)
+            records[i].data[j] = unit_rng(4) ? 0 : unit_rng(256);
+    }
+}
+
+/* Changes some of the records, in a mix of ways: scattered bytes, long spans,
+   lengths, and deleting them outright. */
+static void
+mutate_mwrite_records(struct mwrite_record *records)
+{
+    int i, j, k;
+
+    for (i = 0; i < MWRITE_RECORDS; i++) {
+        struct mwrite_record *r = records + i;
+
+        switch (unit_rng(6)) {
+        case 0:
+            for (k = unit_rng(8); k && r->len; k--)
+                r->data[unit_rng(r->len)] ^= 1 + unit_rng(255);
+            break;
+        case 1:
+            if (r->len) {
+                j = unit_rng(r->len);
+                for (k = j + unit_rng(r->len - j + 1); j < k; j++)
+                    r->data[j] = unit_rng(256);
+            }
+            break;
+        case 2:
+            r->len = unit_rng(r->len + 1);
+            break;
+        case 3:
+            for (j = r->len; j < MWRITE_RECORD_MAX; j++)
+                r->data[j] = unit_rng(256);
+            r->len += unit_rng(MWRITE_RECORD_MAX - r->len + 1);
+            break;
+        case 4:
+            r->len = -1;        /* record omitted */
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/* Writes the records to mf, splitting each record into chunks of at most
+   maxchunk bytes (0 means random chunk sizes). */
+static void
+write_mwrite_records(struct memfile *mf, const struct mwrite_record *records,
+                     int maxchunk)
+{
+    int i, j, chunk;
+
+    for (i = 0; i < MWRITE_RECORDS; i++) {
+        if (records[i].len < 0)
+            continue;
+        mtag(mf, i, MTAG_OBJ);
+        for (j = 0; j < records[i].len; j += chunk) {
+            chunk = maxchunk ? maxchunk : 1 + unit_rng(64);
+            if (chunk > records[i].len - j)
+                chunk = records[i].len - j;
+            mwrite(mf, records[i].data + j, chunk);
+        }
+    }
+}
+
+static void
+mdiffapply_error(const char *message, char *diff)
+{
+    (void) diff;
+    tap_bail(message);
+}
+
+/* mwrite() handles runs of equal and differing bytes at once. Writing a byte
+   at a time makes it decide each byte separately, as it used to, so the diffs
+   produced both ways should be identical, with each of the diffing kernels;
+   and the diff has to reproduce the new file from the old one. */
+void
+test_mwrite_runs(void)
+{
+    struct mwrite_record oldrecords[MWRITE_RECORDS];
+    struct mwrite_record newrecords[MWRITE_RECORDS];
+    static const int chunk_sizes[] = {MWRITE_RECORD_MAX, 0, 1};
+    struct memfile base, diffs[3], applied;
+    int trial, i, maxlevel, level;
+    bool ok = true;
+
+    unit_rng_state = 88172645463325252ULL;
+
+    maxlevel = select_mdiff_kernel(2);
+    if (!maxlevel)
+        tap_comment("mwrite: no vectorized kernels on this CPU");
+
+    for (trial = 0; trial < 500 && ok; trial++) {
+        make_mwrite_records(oldrecords);
+        memcpy(newrecords, oldrecords, sizeof newrecords);
+        mutate_mwrite_records(newrecords);
+
+        mnew(&base, NULL);
+        write_mwrite_records(&base, oldrecords, MWRITE_RECORD_MAX);
+        for (level = 0; level <= maxlevel; level++) {
+            select_mdiff_kernel(level);
+            for (i = 0; i < 3; i++) {
+                mnew(diffs + i, &base);
+                write_mwrite_records(diffs + i, newrecords, chunk_sizes[i]);
+                mdiffflush(diffs + i, TRUE);
+            }
+
+            for (i = 0; i < 2; i++)
+                if (diffs[i].diffpos != diffs[2].diffpos ||
+                    memcmp(diffs[i].diffbuf, diffs[2].diffbuf,
+                           diffs[2].diffpos) != 0) {
+                    tap_comment("trial %d: level %d diff for chunk size %d "
+                                "differs from the byte-at-a-time diff", trial,
+                                level, chunk_sizes[i]);
+                    ok = false;
+                }
+
+            mnew(&applied, NULL);
+            mdiffapply(diffs[0].diffbuf, diffs[0].diffpos, &base, &applied,
+                       mdiffapply_error);
+            if (applied.pos != diffs[0].pos ||
+                memcmp(applied.buf, diffs[0].buf, applied.pos) != 0) {
+                tap_comment("trial %d: applying the level %d diff gives the "
+                            "wrong file", trial, level);
+                ok = false;
+            }
+
+            mfree(&applied);
+            for (i = 0; i < 3; i++)
+                mfree(diffs + i);
+        }
+        mfree(&base);
+    }
+
+    select_mdiff_kernel(2);
+    tap_test(&testnumber, ok, "mwrite: diffing runs at once matches diffing "
+             "byte by byte");
+}
+
+/* Base 64 */
+
+#define BASE64_TEST_MAXLEN 600
+
+/* Fills buf with either random bytes (which don't compress, so they're encoded
+   as they are) or mostly zeroes (which are compressed before encoding). */
+static void
+make_base64_input(unsigned char *buf, int len, boolean compressible)
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+        buf[i] = compressible && unit_rng(8) ? 0 : unit_rng(256);
+}
+
+/* The vectorized base 64 kernels only handle whole blocks, so encoding and
+   decoding with them has to give the same results as the scalar code for
+   every length, not just multiples of 3 or of the vector width. */
+void
+test_base64_kernels(void)
+{
+    static unsigned char in[BASE64_TEST_MAXLEN];
+    static char scalar[BASE64_TEST_MAXLEN * 2], encoded[BASE64_TEST_MAXLEN * 2];
+    static char decoded[BASE64_TEST_MAXLEN + 1];
+    int maxlevel, level, len, compressible;
+    bool ok = true;
+
+    unit_rng_state = 2463534242ULL;
+
+    maxlevel = select_base64_kernels(2);
+    if (!maxlevel)
+        tap_comment("base64: no vectorized kernels on this CPU");
+
+    for (len = 1; len <= BASE64_TEST_MAXLEN && ok; len++) {
+        for (compressible = 0; compressible <= 1; compressible++) {
+            if (base64size(len) >= sizeof scalar)
+                tap_bail("base64 test buffer too small");
+            make_base64_input(in, len, compressible);
+            select_base64_kernels(0);
+            base64_encode_binary(in, scalar, len);
+
+            for (level = 0; level <= maxlevel; level++) {
+                select_base64_kernels(level);
+                base64_encode_binary(in, encoded, len);
+                if (strcmp(encoded, scalar) != 0) {
+                    tap_comment("base64: level %d encodes %d bytes "
+                                "differently from the scalar code",
+                                level, len);
+                    ok = false;
+                }
+                memset(decoded, 0xAA, sizeof decoded);
+                base64_decode(scalar, decoded, sizeof decoded);
+                if (memcmp(decoded, in, len) != 0) {
+                    tap_comment("base64: level %d does not round-trip %d "
+                                "bytes", level, len);
+                    ok = false;
+                }
+            }
+        }
+    }
+
+    select_base64_kernels(2);
+    tap_test(&testnumber, ok, "base64: the vectorized kernels match the scalar "
+             "code");
+}
+
+/* Level save cache */
+
+static struct memfile last_save;
+
+/* Saves the game twice, once using the level save cache and once without it,
+   and checks that the two are identical (i.e. the cache wasn't stale). Unless
+   this is the first save, also checks that the save changed since the last
+   call (i.e. that the edit being tested actually affected the save). */
+static bool
+check_resave(const char *what)
+{
+    struct memfile cached, uncached;
+    bool ok = true;
+
+    mnew(&cached, NULL);
+    savegame(&cached);
+    free_level_save_cache();
+    mnew(&uncached, NULL);
+    savegame(&uncached);
+
+    if (cached.pos != uncached.pos ||
+        memcmp(cached.buf, uncached.buf, cached.pos) != 0) {
+        tap_comment("%s: the level save cache is stale", what);
+        ok = false;
+    }
+    if (last_save.buf && last_save.pos == uncached.pos &&
+        memcmp(last_save.buf, uncached.buf, uncached.pos) == 0) {
+        tap_comment("%s: the save didn't change", what);
+        ok = false;
+    }
+
+    mfree(&cached);
+    mfree(&last_save);
+    last_save = uncached;
+    return ok;
+}
+
+static bool
+level_save_cache_check(void)
+{
+    struct memfile mf;
+    struct level *lev = NULL;
+    struct obj *box, *rock;
+    struct monst *mon;
+    int i, x, y;
+    bool ok = true;
+
+    /* Reload the game from a save of itself, as the engine does after every
+       turn. Nothing has changed the other levels since they were saved, so
+       their cached save data should survive the reload. */
+    mnew(&mf, NULL);
+    savegame(&mf);
+    freedynamicdata();
+    init_data(FALSE);
+    startup_common(FALSE);
+    dorecover(&mf);
+    mfree(&mf);
+
+    for (i = 1; i <= maxledgerno(); i++)
+        if (levels[i] && levels[i] != level)
+            lev = levels[i];
+    if (!lev) {
+        tap_comment("level save cache: no level other than the current one");
+        return false;
+    }
+    if (!lev->save_cached) {
+        tap_comment("level save cache: not kept across a reload");
+        ok = false;
+    }
+
+    for (x = 1; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            if (ACCESSIBLE(lev->locations[x][y].typ) &&
+                !lev->monsters[x][y])
+                goto found;
+    tap_comment("level save cache: no free space on the level");
+    return false;
+
+found:
+    ok &= check_resave("initial save");
+
+    box = mksobj(lev, LARGE_BOX, FALSE, FALSE, rng_main);
+    place_object(box, lev, x, y);
+    ok &= check_resave("place_object");
+
+    rock = mksobj(lev, ROCK, FALSE, FALSE, rng_main);
+    add_to_container(box, rock);
+    ok &= check_resave("add_to_container");
+    obj_extract_self(rock);
+    ok &= check_resave("obj_extract_self from a container");
+
+    mon = makemon(&mons[PM_NEWT], lev, x, y, NO_MINVENT);
+    if (!mon) {
+        tap_comment("level save cache: could not create a monster");
+        obfree(rock, NULL);
+        return false;
+    }
+    ok &= check_resave("makemon");
+    add_to_minv(mon, rock);
+    ok &= check_resave("add_to_minv");
+    obj_extract_self(rock);
+    ok &= check_resave("obj_extract_self from a monster");
+
+    relmon(mon);
+    ok &= check_resave("relmon");
+    mon->nmon = lev->monlist;
+    lev->monlist = mon;
+    place_monster(mon, x, y);
+    ok &= check_resave("place_monster");
+
+    rock->ox = x;
+    rock->oy = y;
+    add_to_buried(rock);
+    ok &= check_resave("add_to_buried");
+    obj_extract_self(rock);
+    ok &= check_resave("obj_extract_self from under the floor");
+    obfree(rock, NULL);
+
+    obj_extract_self(box);
+    ok &= check_resave("obj_extract_self from the floor");
+    obfree(box, NULL);
+
+    mfree(&last_save);
+    return ok;
+}
+
+/* Edits each kind of state of a level other than the current one, checking
+   that each edit invalidates the level's cached save data. */
+void
+test_level_save_cache(void)
+{
+    play_checked_test_game("levelteleport,\"2\",wait,wait,wait", false,
+                           level_save_cache_check);
+}
@@ -0,0 +1,326 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "hack.h"
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+
+/* Timer queue order */
+
+/* Half of the objects are on the floor, so their timers stay with the level;
+   the other half are in the hero's inventory, so theirs are global. The test
+   only ever uses two timer functions, and only looks at the timers, so these
+   never go off as such. */
+#define TIMER_TEST_OBJECTS 6
+#define TIMER_TEST_FUNCS 2
+#define TIMER_TEST_MAX (TIMER_TEST_OBJECTS * TIMER_TEST_FUNCS)
+#define TIMER_TEST_ROUNDS 400
+
+static const short timer_test_funcs[TIMER_TEST_FUNCS] = {
+    ROT_CORPSE, HATCH_EGG
+};
+
+/* A model of the timer list as it was before it became a heap: a list sorted
+   by timeout, with each new timer going in front of any that have the same
+   timeout. The order of this list is what the save file has to show. */
+struct model_timer {
+    struct obj *obj;
+    short func;
+    unsigned timeout;
+};
+
+struct model_list {
+    int count;
+    struct model_timer t[TIMER_TEST_MAX];
+};
+
+static void
+model_insert(struct model_list *m, struct model_timer t)
+{
+    int i;
+
+    for (i = 0; i < m->count && m->t[i].timeout < t.timeout; i++)
+        ;
+    memmove(m->t + i + 1, m->t + i, (m->count - i) * sizeof *m->t);
+    m->t[i] = t;
+    m->count++;
+}
+
+static void
+model_remove(struct model_list *m, int i)
+{
+    memmove(m->t + i, m->t + i + 1, (m->count - i - 1) * sizeof *m->t);
+    m->count--;
+}
+
+static int
+model_find(const struct model_list *m, const struct obj *obj, short func)
+{
+    int i;
+
+    for (i = 0; i < m->count; i++)
+        if (m->t[i].obj == obj && (func < 0 || m->t[i].func == func))
+            return i;
+    return -1;
+}
+
+/* Moves the timers of obj (or the global timers, if obj is NULL) from one list
+   to the other, visiting them in list order, as transfer_timers() used to. */
+static void
+model_transfer(struct model_list *from, struct model_list *to,
+               const struct obj *obj)
+{
+    struct model_list moving = {0};
+    int i;
+
+    for (i = 0; i < from->count;) {
+        if (obj ? from->t[i].obj == obj : !obj_is_local(from->t[i].obj)) {
+            moving.t[moving.count++] = from->t[i];
+            model_remove(from, i);
+        } else
+            i++;
+    }
+    for (i = 0; i < moving.count; i++)
+        model_insert(to, moving.t[i]);
+}
+
+/* Rebuilds the list as restore_timers() does after a save_test_timers(): each
+   range's timers, as saved in list order, are inserted in reverse order, the
+   global timers first. */
+static void
+model_restore(struct model_list *m)
+{
+    struct model_list saved = *m;
+    int local, i;
+
+    m->count = 0;
+    for (local = 0; local < 2; local++)
+        for (i = saved.count - 1; i >= 0; i--)
+            if (obj_is_local(saved.t[i].obj) == local)
+                model_insert(m, saved.t[i]);
+}
+
+/* Saves the global timers and then the level timers of lev to mf. */
+static void
+save_test_timers(struct memfile *mf, struct level *lev)
+{
+    mnew(mf, NULL);
+    save_timers(mf, lev, RANGE_GLOBAL);
+    save_timers(mf, lev, RANGE_LEVEL);
+}
+
+/* Checks that the timers in a file written by save_test_timers() are those in
+   the model, in the same order. */
+static bool
+check_saved_timers(struct memfile *mf, const struct model_list *m,
+                   const char *what)
+{
+    static const int ranges[2] = {RANGE_GLOBAL, RANGE_LEVEL};
+    const struct model_timer *t;
+    int r, i, j, count;
+    unsigned timeout, id;
+    short func;
+
+    mf->len = mf->pos;
+    mf->pos = 0;
+    for (r = 0; r < 2; r++) {
+        if (ranges[r] == RANGE_GLOBAL)
+            mread32(mf);        /* timer_id */
+        count = mread32(mf);
+        for (i = j = 0; j < m->count; j++) {
+            t = &m->t[j];
+            if (obj_is_local(t->obj) != (ranges[r] == RANGE_LEVEL))
+                continue;
+            if (i++ == count) {
+                tap_comment("timers: after %s, a timer is missing", what);
+                return false;
+            }
+            mread32(mf);        /* tid */
+            timeout = mread32(mf);
+            id = mread32(mf);
+            mread16(mf);        /* kind */
+            func = mread8(mf);
+            mread8(mf);         /* needs_fixup */
+            if (t->obj->o_id != id || t->func != func ||
+                t->timeout != timeout) {
+                tap_comment("timers: after %s, timer %d is out of order",
+                            what, j);
+                return false;
+            }
+        }
+        if (i != count) {
+            tap_comment("timers: after %s, there are extra timers", what);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+check_timer_order(struct level *lev, const struct model_list *m,
+                  const char *what)
+{
+    struct memfile mf;
+    bool ok;
+
+    save_test_timers(&mf, lev);
+    ok = check_saved_timers(&mf, m, what);
+    mfree(&mf);
+    return ok;
+}
+
+static bool
+timer_order_check(void)
+{
+    static const int otyps[TIMER_TEST_OBJECTS] = {
+        LARGE_BOX, CHEST, ICE_BOX, SACK, OILSKIN_SACK, BAG_OF_HOLDING
+    };
+    struct obj *objs[TIMER_TEST_OBJECTS], *obj, *dest;
+    struct timer_queue saved_timers = level->lev_timers;
+    struct level *other = calloc(1, sizeof (struct level));
+    struct model_list here = {0}, there = {0}, copies;
+    struct model_timer t;
+    struct memfile before, after;
+    timer_element *first;
+    int round, i, f;
+    bool ok = true;
+
+    unit_rng_state = 0x2545F4914F6CDD1DULL;
+
+    /* work on an empty queue, rather than the timers the level already has */
+    memset(&level->lev_timers, 0, sizeof level->lev_timers);
+
+    for (i = 0; i < TIMER_TEST_OBJECTS; i++) {
+        objs[i] = mksobj(level, otyps[i], FALSE, FALSE, rng_main);
+        if (i < TIMER_TEST_OBJECTS / 2)
+            place_object(objs[i], level, u.ux, u.uy);
+        else
+            objs[i] = addinv(objs[i]);
+    }
+
+    for (round = 0; round < TIMER_TEST_ROUNDS && ok; round++) {
+        obj = objs[unit_rng(TIMER_TEST_OBJECTS)];
+        switch (unit_rng(6)) {
+        case 0:
+        case 1:
+            /* few enough distinct timeouts that most are tied */
+            f = timer_test_funcs[unit_rng(TIMER_TEST_FUNCS)];
+            if (here.count == TIMER_TEST_MAX || model_find(&here, obj, f) >= 0)
+                break;
+            t.obj = obj;
+            t.func = f;
+            t.timeout = moves + 1 + unit_rng(3);
+            start_timer(level, t.timeout - moves, TIMER_OBJECT, f, obj);
+            model_insert(&here, t);
+            ok &= check_timer_order(level, &here, "start_timer");
+            break;
+        case 2:
+            dest = objs[unit_rng(TIMER_TEST_OBJECTS)];
+            if (dest == obj || model_find(&here, dest, -1) >= 0)
+                break;
+            /* the copies are started in the order the originals go off */
+            copies.count = 0;
+            for (i = 0; i < here.count; i++)
+                if (here.t[i].obj == obj) {
+                    copies.t[copies.count] = here.t[i];
+                    copies.t[copies.count++].obj = dest;
+                }
+            for (i = 0; i < copies.count; i++)
+                model_insert(&here, copies.t[i]);
+            obj_split_timers(obj, dest);
+            ok &= check_timer_order(level, &here, "obj_split_timers");
+            break;
+        case 3:
+            /* off the level and back again, which reinserts the timers */
+            transfer_timers(level, other, obj->o_id);
+            model_transfer(&here, &there, obj);
+            transfer_timers(other, level, obj->o_id);
+            model_transfer(&there, &here, obj);
+            ok &= check_timer_order(level, &here, "transfer_timers of an "
+                                    "object");
+            break;
+        case 4:
+            transfer_timers(level, other, 0);
+            model_transfer(&here, &there, NULL);
+            transfer_timers(other, level, 0);
+            model_transfer(&there, &here, NULL);
+            ok &= check_timer_order(level, &here, "transfer_timers of the "
+                                    "global timers");
+            break;
+        case 5:
+            i = model_find(&here, obj, -1);
+            if (i < 0)
+                break;
+            stop_timer(level, here.t[i].func, obj);
+            model_remove(&here, i);
+            ok &= check_timer_order(level, &here, "stop_timer");
+            break;
+        }
+    }
+
+    /* Saving and restoring has to give back the same queue, which saves the
+       same way; the restored timers refer to objects by ID until they're
+       relinked. */
+    save_test_timers(&before, level);
+    free_timers(level);
+    before.len = before.pos;
+    before.pos = 0;
+    restore_timers(&before, level, RANGE_GLOBAL, FALSE, 0);
+    restore_timers(&before, level, RANGE_LEVEL, FALSE, 0);
+    relink_timers(FALSE, level, NULL);
+    save_test_timers(&after, level);
+    if (after.pos != before.len ||
+        memcmp(after.buf, before.buf, after.pos) != 0) {
+        tap_comment("timers: saving again after a restore gives a "
+                    "different file");
+        ok = false;
+    }
+    mfree(&before);
+    ok = ok && check_saved_timers(&after, &here, "restore_timers");
+    mfree(&after);
+    model_restore(&here);
+
+    /* The timers have to go off in list order too. After a restore, that
+       isn't quite the order they were saved in: the level timers are restored
+       after the global ones, so they come first when timeouts are tied.
+       run_timers() would call the timer functions, so take the timers off the
+       front of the queue instead, which is what it does. */
+    for (i = 0; i < here.count && ok; i++) {
+        first = level->lev_timers.heap[0];
+        if (first->arg != here.t[i].obj || first->func_index != here.t[i].func ||
+            first->timeout != here.t[i].timeout) {
+            tap_comment("timers: timer %d goes off out of order", i);
+            ok = false;
+        }
+        stop_timer(level, first->func_index, first->arg);
+    }
+
+    for (i = 0; i < TIMER_TEST_OBJECTS; i++) {
+        obj_stop_timers(objs[i]);
+        if (objs[i]->where == OBJ_INVENT)
+            freeinv(objs[i]);
+        else
+            obj_extract_self(objs[i]);
+        obfree(objs[i], NULL);
+    }
+
+    free_timers(level);
+    level->lev_timers = saved_timers;
+    free_timers(other);
+    free(other);
+    return ok;
+}
+
+/* Starts, splits and moves object timers with equal timeouts, then saves and
+   restores them, checking that the order they're saved and go off in is the
+   order the timer list had before it became a heap. */
+void
+test_timer_order(void)
+{
+    with_initialised_game(timer_order_check);
+}
@@ -0,0 +1,248 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "hack.h"
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+
+#include <limits.h>
+#include <sys/stat.h>
+
+#define TOPTEN_TEST_ENTRIES 40
+
+static const char *const topten_players[] = {"alice", "bob", "carol", ""};
+
+/* Returns a copy (allocated with malloc()) of the scores nh_get_topten() gives
+   for player; *n is set to their number. */
+static struct nh_topten_entry *
+copy_topten(const char *player, int top, int *n)
+{
+    struct nh_topten_entry *scores, *copy;
+    char statusbuf[BUFSZ];
+
+    scores = nh_get_topten(n, statusbuf, player, top, 0, TRUE);
+    copy = malloc((*n ? *n : 1) * sizeof (struct nh_topten_entry));
+    if (scores)
+        memcpy(copy, scores, *n * sizeof (struct nh_topten_entry));
+    else
+        *n = 0;
+    return copy;
+}
+
+/* Checks that the scores read through the index are the ones read by parsing
+   the record, for the whole list and for each player's own scores. */
+static bool
+check_topten_index(const char *what)
+{
+    char idxname[BUFSZ], hidden[BUFSZ];
+    struct nh_topten_entry *indexed, *parsed;
+    struct stat st;
+    int i, top, nindexed, nparsed;
+    bool ok = true;
+
+    snprintf(idxname, sizeof idxname, "%s%s", fqn_prefix[SCOREPREFIX],
+             RECORD_INDEX);
+    snprintf(hidden, sizeof hidden, "%s.hidden", idxname);
+    if (stat(idxname, &st) < 0) {
+        tap_comment("%s: the score index was not written", what);
+        return false;
+    }
+
+    for (i = 0; i < sizeof topten_players / sizeof *topten_players; i++) {
+        for (top = -1; top <= 3; top += 4) {
+            indexed = copy_topten(topten_players[i], top, &nindexed);
+            if (rename(idxname, hidden) < 0)
+                tap_bail("could not move the score index aside");
+            parsed = copy_topten(topten_players[i], top, &nparsed);
+            if (rename(hidden, idxname) < 0)
+                tap_bail("could not restore the score index");
+
+            if (nindexed != nparsed ||
+                memcmp(indexed, parsed,
+                       nparsed * sizeof (struct nh_topten_entry)) != 0) {
+                tap_comment("%s: the index gives different scores from the "
+                            "record (player '%s', top %d)", what,
+                            topten_players[i], top);
+                ok = false;
+            }
+
+            free(indexed);
+            free(parsed);
+        }
+    }
+
+    return ok;
+}
+
+/* Checks that out-of-range counts from a client select the whole list rather
+   than overrunning anything: a negative top other than -1, and an around so
+   large that doubling it would overflow. The game is treated as complete, as
+   the player who added the last score, so that the scores around it are
+   selected too. */
+static bool
+check_topten_bounds(void)
+{
+    static const struct {
+        int top, around;
+    } args[] = {{-5, 0}, {-1, INT_MAX}, {-5, INT_MAX}, {0, INT_MAX}};
+    struct nh_topten_entry *scores;
+    char statusbuf[BUFSZ];
+    int saved_gameover = program_state.gameover;
+    int i, j, n;
+    bool ok = true;
+
+    program_state.gameover = 1;
+    for (i = 0; i < sizeof args / sizeof *args && ok; i++) {
+        scores = nh_get_topten(&n, statusbuf, NULL, args[i].top,
+                               args[i].around, TRUE);
+        /* with top 0, only the player's own scores and the ones around the
+           game are selected, which needn't be all of them */
+        if (args[i].top == 0) {
+            for (j = 1; j < n; j++)
+                if (scores[j].rank <= scores[j - 1].rank) {
+                    tap_comment("topten: top %d, around %d: ranks out of "
+                                "order", args[i].top, args[i].around);
+                    ok = false;
+                    break;
+                }
+            continue;
+        }
+        if (n != TOPTEN_TEST_ENTRIES) {
+            tap_comment("topten: top %d, around %d gave %d scores, not %d",
+                        args[i].top, args[i].around, n, TOPTEN_TEST_ENTRIES);
+            ok = false;
+            continue;
+        }
+        for (j = 0; j < n; j++)
+            if (scores[j].rank != j + 1) {
+                tap_comment("topten: top %d, around %d: rank %d is missing",
+                            args[i].top, args[i].around, j + 1);
+                ok = false;
+                break;
+            }
+    }
+    program_state.gameover = saved_gameover;
+
+    return ok;
+}
+
+/* Rewrites the record with the same size and the same modification time,
+   apart from the nanoseconds, as if it had been rewritten within a second of
+   the index being written. */
+static bool
+rewrite_record_same_size(void)
+{
+    char recname[BUFSZ], *buf, *p;
+    struct stat st;
+    struct timespec times[2];
+    FILE *fp;
+    long len;
+
+    snprintf(recname, sizeof recname, "%s%s", fqn_prefix[SCOREPREFIX],
+             RECORD);
+    fp = fopen(recname, "r+");
+    if (!fp || fstat(fileno(fp), &st) < 0)
+        tap_bail("could not open the record");
+
+    len = st.st_size;
+    buf = malloc(len + 1);
+    if (fread(buf, 1, len, fp) != len)
+        tap_bail("could not read the record");
+    buf[len] = '\0';
+
+    for (p = buf; (p = strstr(p, "test entry")); p++)
+        memcpy(p, "TEST ENTRY", 10);
+
+    rewind(fp);
+    if (fwrite(buf, 1, len, fp) != len || fflush(fp) != 0)
+        tap_bail("could not rewrite the record");
+    free(buf);
+
+    times[0] = st.st_atim;
+    times[1] = st.st_mtim;
+    times[1].tv_nsec ^= 1;
+    if (futimens(fileno(fp), times) < 0)
+        tap_bail("could not set the record's modification time");
+    fclose(fp);
+
+    return true;
+}
+
+static int
+points_cmp(const void *a, const void *b)
+{
+    return *(const int *)b - *(const int *)a;
+}
+
+static bool
+topten_index_check(void)
+{
+    char killer[BUFSZ], saved_name[PL_NSIZ];
+    char saved_setseed = flags.setseed[0];
+    boolean saved_debug = flags.debug;
+    int saved_urexp = u.urexp;
+    int points[TOPTEN_TEST_ENTRIES];
+    struct nh_topten_entry *scores;
+    int i, n;
+    bool ok = true;
+
+    unit_rng_state = 362436069ULL;
+
+    /* Debug mode and set seeds don't score, so pretend to be neither while we
+       add entries. */
+    flags.debug = FALSE;
+    flags.setseed[0] = '\0';
+    strcpy(saved_name, u.uplname);
+
+    for (i = 0; i < TOPTEN_TEST_ENTRIES; i++) {
+        /* few enough distinct scores that some are tied */
+        points[i] = u.urexp = 1 + unit_rng(100);
+        strcpy(u.uplname, topten_players[unit_rng(3)]);
+        snprintf(killer, sizeof killer, "test entry %02d", i);
+        update_topten(QUIT, killer, 0, "");
+    }
+
+    ok &= check_topten_bounds();
+
+    strcpy(u.uplname, saved_name);
+    u.urexp = saved_urexp;
+    flags.setseed[0] = saved_setseed;
+    flags.debug = saved_debug;
+
+    /* everything written has to be read back, in order */
+    qsort(points, TOPTEN_TEST_ENTRIES, sizeof (int), points_cmp);
+    scores = copy_topten("", -1, &n);
+    if (n != TOPTEN_TEST_ENTRIES) {
+        tap_comment("topten: wrote %d scores, read back %d",
+                    TOPTEN_TEST_ENTRIES, n);
+        ok = false;
+    } else {
+        for (i = 0; i < n; i++)
+            if (scores[i].points != points[i] || scores[i].rank != i + 1) {
+                tap_comment("topten: rank %d has the wrong score", i + 1);
+                ok = false;
+                break;
+            }
+    }
+    free(scores);
+
+    ok &= check_topten_index("after adding scores");
+    ok &= rewrite_record_same_size() &&
+        check_topten_index("after a same-size rewrite");
+
+    return ok;
+}
+
+/* Adds scores to the record, then checks that reading them through the index
+   gives the same results as parsing the record, including after the record is
+   changed without changing its size or the seconds of its timestamp. */
+void
+test_topten_index(void)
+{
+    with_initialised_game(topten_index_check);
+}
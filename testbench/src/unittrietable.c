@@ -0,0 +1,293 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "hack.h"
+#include "trietable.h"
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+
+/* Trietables */
+
+#define TRIE_TEST_KEYS 200
+#define TRIE_TEST_OPS 20000
+
+/* The values stored are pointers into this array, so that every key has a
+   value that's distinct and not NULL. */
+static char trie_values[TRIE_TEST_KEYS * 2];
+
+static bool
+check_trie_key(struct trietable **table, unsigned key, void *expected,
+               const char *what)
+{
+    void *found = trietable_find(table, key);
+
+    if (found != expected) {
+        tap_comment("trietable: %s: key %u has the wrong value", what, key);
+        return false;
+    }
+    return true;
+}
+
+/* Removes keys at particular places in a small trie: a leaf, a node with
+   children, the root, a key that isn't there, and key 0. */
+static bool
+trietable_cases_check(void)
+{
+    struct trietable *t = NULL;
+    void *v1 = trie_values, *v3 = trie_values + 1, *v7 = trie_values + 2;
+    void *v0 = trie_values + 3;
+    bool ok = true;
+
+    /* 1 is the root; 3 is its odd child; 7 is that node's odd child */
+    trietable_add(&t, 1, v1);
+    trietable_add(&t, 3, v3);
+    trietable_add(&t, 7, v7);
+
+    trietable_remove(&t, 7);
+    ok &= check_trie_key(&t, 7, NULL, "leaf removal");
+    ok &= check_trie_key(&t, 3, v3, "leaf removal");
+    if (t->ptr1->ptr1) {
+        tap_comment("trietable: leaf removal left the leaf in place");
+        ok = false;
+    }
+
+    trietable_add(&t, 7, v7);
+    ok &= check_trie_key(&t, 7, v7, "re-insert after removal");
+
+    trietable_remove(&t, 3);
+    ok &= check_trie_key(&t, 3, NULL, "interior removal");
+    ok &= check_trie_key(&t, 7, v7, "interior removal");
+    ok &= check_trie_key(&t, 1, v1, "interior removal");
+    if (t->ptr1->ptr1 || t->ptr1->ptr0) {
+        tap_comment("trietable: interior removal didn't free a leaf");
+        ok = false;
+    }
+
+    trietable_remove(&t, 5);
+    trietable_remove(&t, 0);
+    ok &= check_trie_key(&t, 1, v1, "removing a missing key");
+    ok &= check_trie_key(&t, 7, v7, "removing a missing key");
+
+    trietable_add(&t, 3, v3);
+    trietable_add(&t, 0, v0);
+    trietable_remove(&t, 0);
+    ok &= check_trie_key(&t, 0, NULL, "removing key 0");
+    ok &= check_trie_key(&t, 1, v1, "removing key 0");
+    ok &= check_trie_key(&t, 3, v3, "removing key 0");
+    ok &= check_trie_key(&t, 7, v7, "removing key 0");
+
+    trietable_remove(&t, 1);
+    ok &= check_trie_key(&t, 1, NULL, "root removal");
+    ok &= check_trie_key(&t, 3, v3, "root removal");
+    ok &= check_trie_key(&t, 7, v7, "root removal");
+
+    /* adding an existing key overwrites it */
+    trietable_add(&t, 3, v1);
+    ok &= check_trie_key(&t, 3, v1, "overwriting");
+
+    trietable_remove(&t, 3);
+    trietable_remove(&t, 7);
+    if (t) {
+        tap_comment("trietable: not empty after removing every key");
+        trietable_empty(&t);
+        ok = false;
+    }
+    return ok;
+}
+
+/* Adds, overwrites and removes random keys, comparing the table with an array
+   of what it should contain. The keys are a mix of small numbers, so that the
+   trie is dense, and large ones. */
+static bool
+trietable_random_check(void)
+{
+    unsigned keys[TRIE_TEST_KEYS];
+    void *expected[TRIE_TEST_KEYS] = {0};
+    struct trietable *t = NULL;
+    char what[BUFSZ];
+    int op, i, j;
+    bool ok = true;
+
+    for (i = 0; i < TRIE_TEST_KEYS; i++)
+        do {
+            keys[i] = i < TRIE_TEST_KEYS / 2 ? unit_rng(TRIE_TEST_KEYS) :
+                ((unsigned)unit_rng(1 << 16) << 16) | unit_rng(1 << 16);
+            for (j = 0; j < i && keys[j] != keys[i]; j++)
+                ;
+        } while (j < i);
+
+    for (op = 0; op < TRIE_TEST_OPS && ok; op++) {
+        i = unit_rng(TRIE_TEST_KEYS);
+        if (unit_rng(2)) {
+            expected[i] = trie_values + i * 2 + unit_rng(2);
+            trietable_add(&t, keys[i], expected[i]);
+            snprintf(what, sizeof what, "op %d: adding %u", op, keys[i]);
+        } else {
+            expected[i] = NULL;
+            trietable_remove(&t, keys[i]);
+            snprintf(what, sizeof what, "op %d: removing %u", op, keys[i]);
+        }
+        ok &= check_trie_key(&t, keys[i], expected[i], what);
+        if (op % 100 == 0)
+            for (j = 0; j < TRIE_TEST_KEYS; j++)
+                ok &= check_trie_key(&t, keys[j], expected[j], what);
+    }
+
+    for (i = 0; i < TRIE_TEST_KEYS; i++)
+        trietable_remove(&t, keys[i]);
+    if (t) {
+        tap_comment("trietable: not empty after removing every key");
+        trietable_empty(&t);
+        ok = false;
+    }
+    return ok;
+}
+
+void
+test_trietable(void)
+{
+    bool ok;
+
+    unit_rng_state = 0x6A09E667F3BCC909ULL;
+
+    ok = trietable_cases_check();
+    ok &= trietable_random_check();
+    tap_test(&testnumber, ok, "trietable: lookups after removing keys match "
+             "what was added");
+}
+
+/* Monster and object ID indexes */
+
+/* Every monster on the level and object on the floor or in the hero's
+   inventory has to be found by its ID. */
+static bool
+check_all_ids(const char *what)
+{
+    struct monst *mon;
+    struct obj *obj;
+    int pass;
+
+    for (mon = level->monlist; mon; mon = mon->nmon)
+        if (!DEADMONSTER(mon) && find_mid(level, mon->m_id, FM_FMON) != mon) {
+            tap_comment("id index: %s: monster %u not found", what,
+                        mon->m_id);
+            return false;
+        }
+    for (pass = 0; pass < 2; pass++)
+        for (obj = pass ? invent : level->objlist; obj; obj = obj->nobj)
+            if (find_oid(obj->o_id) != obj) {
+                tap_comment("id index: %s: object %u not found", what,
+                            obj->o_id);
+                return false;
+            }
+    return true;
+}
+
+static bool
+check_found(bool found, const char *what)
+{
+    if (!found)
+        tap_comment("id index: %s", what);
+    return found;
+}
+
+static bool
+id_index_check(void)
+{
+    struct memfile mf;
+    struct monst *mon;
+    struct obj *box, *rock;
+    unsigned mid, boxid, rockid;
+    coord cc;
+    bool ok = true;
+
+    ok &= check_all_ids("at the start");
+
+    if (!enexto(&cc, level, u.ux, u.uy, &mons[PM_NEWT]) ||
+        !(mon = makemon(&mons[PM_NEWT], level, cc.x, cc.y, NO_MINVENT))) {
+        tap_comment("id index: could not create a monster");
+        return false;
+    }
+    mid = mon->m_id;
+    ok &= check_found(find_mid(level, mid, FM_FMON) == mon, "makemon");
+
+    /* a monster that's been taken off the level mustn't be found there, even
+       though it's still in the index */
+    relmon(mon);
+    ok &= check_found(!find_mid(level, mid, FM_EVERYWHERE), "relmon");
+    mon->nmon = migrating_mons;
+    migrating_mons = mon;
+    ok &= check_found(!find_mid(level, mid, FM_FMON) &&
+                      find_mid(level, mid, FM_MIGRATE) == mon,
+                      "migrating monster");
+    migrating_mons = mon->nmon;
+    mon->nmon = level->monlist;
+    level->monlist = mon;
+    place_monster(mon, cc.x, cc.y);
+    ok &= check_found(find_mid(level, mid, FM_FMON) == mon,
+                      "monster placed again");
+
+    box = mksobj(level, LARGE_BOX, FALSE, FALSE, rng_main);
+    rock = mksobj(level, ROCK, FALSE, FALSE, rng_main);
+    boxid = box->o_id;
+    rockid = rock->o_id;
+    place_object(box, level, cc.x, cc.y);
+    ok &= check_found(find_oid(boxid) == box, "place_object");
+    add_to_container(box, rock);
+    ok &= check_found(find_oid(rockid) == rock, "add_to_container");
+    obj_extract_self(rock);
+    ok &= check_found(!find_oid(rockid), "obj_extract_self from a container");
+    add_to_minv(mon, rock);
+    ok &= check_found(find_oid(rockid) == rock, "add_to_minv");
+    obj_extract_self(rock);
+    ok &= check_found(!find_oid(rockid), "obj_extract_self from a monster");
+    add_to_container(box, rock);
+
+    /* after a save and restore, everything is somewhere else in memory */
+    mnew(&mf, NULL);
+    savegame(&mf);
+    freedynamicdata();
+    init_data(FALSE);
+    startup_common(FALSE);
+    dorecover(&mf);
+    mfree(&mf);
+
+    ok &= check_all_ids("after a restore");
+    mon = find_mid(level, mid, FM_FMON);
+    box = find_oid(boxid);
+    rock = find_oid(rockid);
+    ok &= check_found(mon && mon->m_id == mid && mon->mx == cc.x &&
+                      mon->my == cc.y, "monster after a restore");
+    ok &= check_found(box && box->o_id == boxid && box->where == OBJ_FLOOR,
+                      "object after a restore");
+    ok &= check_found(rock && rock->o_id == rockid &&
+                      rock->where == OBJ_CONTAINED && rock->ocontainer == box,
+                      "contained object after a restore");
+    if (!ok)
+        return false;
+
+    obj_extract_self(rock);
+    obfree(rock, NULL);
+    ok &= check_found(!find_oid(rockid), "obfree");
+    obj_extract_self(box);
+    obfree(box, NULL);
+
+    mongone(mon);
+    ok &= check_found(!find_mid(level, mid, FM_EVERYWHERE), "mongone");
+
+    return ok;
+}
+
+/* Moves a monster and some objects between the places find_mid() and
+   find_oid() look, and through a save and restore, checking that the ID
+   indexes never give a stale answer. */
+void
+test_id_index(void)
+{
+    with_initialised_game(id_index_check);
+}
@@ -0,0 +1,244 @@
+/* vim:set cin ft=c sw=4 sts=4 ts=8 et ai cino=Ls\:0t0(0 : -*- mode:c;fill-column:80;tab-width:8;c-basic-offset:4;indent-tabs-mode:nil;c-file-style:"k&r" -*-*/
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef DUMBMAKE
+# error !AIMAKE_FAIL_SILENTLY! The unit tests need access to engine internals.
+#endif
+
+#include "hack.h"
+#include "lev.h"
+#include "tap.h"
+#include "testgame.h"
+#include "testunit.h"
+
+/* Line of sight cache */
+
+/* The paths are between a fixed set of squares, so that the same paths are
+   asked about repeatedly (and so come from the cache). For the first half of
+   the test, only a few of the starting squares are used; for the second half,
+   more than the cache has room for, so that entries get evicted too. */
+#define LOS_TEST_SQUARES 80
+#define LOS_TEST_HOT_SQUARES 16
+#define LOS_TEST_ROUNDS 300
+#define LOS_TEST_QUERIES 300
+
+/* Compares cached and uncached paths between the test squares, after (x,y)
+   has been changed. */
+static bool
+check_clear_paths(int squares[][2], int round, int x, int y)
+{
+    int q, s, d;
+    bool cached, uncached;
+
+    for (q = 0; q < LOS_TEST_QUERIES; q++) {
+        s = unit_rng(round < LOS_TEST_ROUNDS / 2 ?
+                     LOS_TEST_HOT_SQUARES : LOS_TEST_SQUARES);
+        d = unit_rng(LOS_TEST_SQUARES);
+        cached = clear_path(squares[s][0], squares[s][1],
+                            squares[d][0], squares[d][1], NULL);
+        uncached = clear_path_uncached(squares[s][0], squares[s][1],
+                                       squares[d][0], squares[d][1]);
+        if (cached != uncached) {
+            tap_comment("clear_path: (%d,%d) to (%d,%d) after changing "
+                        "(%d,%d): cached %d, uncached %d", squares[s][0],
+                        squares[s][1], squares[d][0], squares[d][1], x, y,
+                        cached, uncached);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+clear_path_check(void)
+{
+    int squares[LOS_TEST_SQUARES][2];
+    int round, s, d, step, x, y;
+    bool ok = true;
+
+    unit_rng_state = 0x9E3779B97F4A7C15ULL;
+
+    /* Paths between rock squares are nearly always blocked, so use squares
+       that light can pass through. */
+    for (s = 0; s < LOS_TEST_SQUARES; s++) {
+        do {
+            x = 1 + unit_rng(COLNO - 1);
+            y = unit_rng(ROWNO);
+        } while (!ZAP_POS(level->locations[x][y].typ));
+        squares[s][0] = x;
+        squares[s][1] = y;
+    }
+
+    for (round = 0; round < LOS_TEST_ROUNDS && ok; round++) {
+        /* Block a square somewhere along a path between two of the squares,
+           then unblock it again; each change has to invalidate the cached
+           results for the paths that go through it. */
+        s = unit_rng(LOS_TEST_SQUARES);
+        d = unit_rng(LOS_TEST_SQUARES);
+        step = unit_rng(101);
+        x = squares[s][0] + (squares[d][0] - squares[s][0]) * step / 100;
+        y = squares[s][1] + (squares[d][1] - squares[s][1]) * step / 100;
+
+        block_point(x, y);
+        ok &= check_clear_paths(squares, round, x, y);
+        unblock_point(x, y);
+        ok &= check_clear_paths(squares, round, x, y);
+    }
+
+    /* Put the vision map back the way the level has it. */
+    vision_reset();
+    return ok;
+}
+
+/* Blocks and unblocks random squares on a level, checking that clear_path()
+   with the line of sight cache keeps agreeing with the uncached path code. */
+void
+test_clear_path_cache(void)
+{
+    with_initialised_game(clear_path_check);
+}
+
+/* Light source footprints */
+
+#define LIGHT_TEST_SOURCES 4
+#define LIGHT_TEST_ROUNDS 300
+
+/* Works out which squares the test's light sources light, reusing their
+   footprints from last time, and compares that with the squares that have an
+   uncached clear path to a source within its range. do_light_sources() lights
+   the squares next to the hero using the hero's line of sight rather than
+   footprints; the map of that here is empty, so those aren't lit at all. */
+static bool
+check_light_footprints(struct obj **objs, const char *what, int round)
+{
+    static char lit_rows[ROWNO][COLNO];
+    static char fresh_rows[ROWNO][COLNO];
+    char *rows[ROWNO];
+    const char *limits;
+    light_source *ls;
+    int i, x, y, sx, sy, offset;
+
+    memset(lit_rows, 0, sizeof lit_rows);
+    memset(fresh_rows, 0, sizeof fresh_rows);
+    for (y = 0; y < ROWNO; y++)
+        rows[y] = lit_rows[y];
+    do_light_sources(rows);
+
+    for (i = 0; i < LIGHT_TEST_SOURCES; i++) {
+        for (ls = level->lev_lights; ls->id != objs[i]; ls = ls->next)
+            ;
+        sx = objs[i]->ox;
+        sy = objs[i]->oy;
+        if (sx == u.ux && sy == u.uy)
+            continue;
+        limits = circle_ptr(ls->range);
+        for (y = max(sy - ls->range, 0);
+             y <= min(sy + ls->range, ROWNO - 1); y++) {
+            offset = limits[abs(y - sy)];
+            for (x = max(sx - offset, 0);
+                 x <= min(sx + offset, COLNO - 1); x++)
+                if ((x != u.ux || y != u.uy) &&
+                    clear_path_uncached(sx, sy, x, y))
+                    fresh_rows[y][x] |= TEMP_LIT;
+        }
+    }
+
+    for (y = 0; y < ROWNO; y++)
+        for (x = 0; x < COLNO; x++)
+            if ((lit_rows[y][x] & TEMP_LIT) != fresh_rows[y][x]) {
+                tap_comment("light: round %d, after %s: (%d,%d) is %s lit "
+                            "by the remembered footprints", round, what, x,
+                            y, fresh_rows[y][x] ? "not" : "wrongly");
+                return false;
+            }
+    return true;
+}
+
+/* A square that light can pass through near the hero, or the hero's own
+   square now and then. */
+static void
+light_test_square(int *x, int *y)
+{
+    if (!unit_rng(8)) {
+        *x = u.ux;
+        *y = u.uy;
+        return;
+    }
+    do {
+        *x = u.ux - 10 + unit_rng(21);
+        *y = u.uy - 6 + unit_rng(13);
+    } while (!isok(*x, *y) || !ZAP_POS(level->locations[*x][*y].typ));
+}
+
+static bool
+light_footprint_check(void)
+{
+    struct obj *objs[LIGHT_TEST_SOURCES];
+    light_source *saved_lights = level->lev_lights, *ls;
+    int round, i, x, y;
+    bool ok = true;
+
+    unit_rng_state = 0xB7E151628AED2A6BULL;
+
+    /* only the test's own light sources are compared */
+    level->lev_lights = NULL;
+
+    for (i = 0; i < LIGHT_TEST_SOURCES; i++) {
+        light_test_square(&x, &y);
+        objs[i] = mksobj(level, ROCK, FALSE, FALSE, rng_main);
+        place_object(objs[i], level, x, y);
+        new_light_source(level, x, y, 1 + unit_rng(MAX_RADIUS), LS_OBJECT,
+                         objs[i]);
+    }
+    ok &= check_light_footprints(objs, "adding the light sources", 0);
+
+    for (round = 1; round <= LIGHT_TEST_ROUNDS && ok; round++) {
+        i = unit_rng(LIGHT_TEST_SOURCES);
+        switch (unit_rng(3)) {
+        case 0:
+            /* the source's position is only updated by do_light_sources() */
+            light_test_square(&x, &y);
+            obj_extract_self(objs[i]);
+            place_object(objs[i], level, x, y);
+            ok &= check_light_footprints(objs, "moving a light source",
+                                         round);
+            break;
+        case 1:
+            /* as when candles are merged */
+            for (ls = level->lev_lights; ls->id != objs[i]; ls = ls->next)
+                ;
+            ls->range = 1 + unit_rng(MAX_RADIUS);
+            ok &= check_light_footprints(objs, "changing a light's range",
+                                         round);
+            break;
+        case 2:
+            light_test_square(&x, &y);
+            block_point(x, y);
+            ok &= check_light_footprints(objs, "block_point", round);
+            unblock_point(x, y);
+            ok = ok && check_light_footprints(objs, "unblock_point", round);
+            break;
+        }
+    }
+
+    for (i = 0; i < LIGHT_TEST_SOURCES; i++) {
+        del_light_source(level, LS_OBJECT, objs[i]);
+        obj_extract_self(objs[i]);
+        obfree(objs[i], NULL);
+    }
+    level->lev_lights = saved_lights;
+
+    /* Put the vision map back the way the level has it. */
+    vision_reset();
+    turnstate.vision_full_recalc = TRUE;
+    return ok;
+}
+
+/* Moves light sources, changes their ranges, and blocks and unblocks squares
+   near them, checking that the squares lit using the footprints remembered
+   from the last time are the squares they'd light if worked out afresh. */
+void
+test_light_footprints(void)
+{
+    with_initialised_game(light_footprint_check);
+}